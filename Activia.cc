@@ -1,3 +1,5 @@
+#include "Activia/ActProductionLibrary.hh"
+#include "Activia/ActQueryServer.hh"
 #include "Activia/ActXTermRun.hh"
 
 #ifdef ACT_USE_QT
@@ -5,15 +7,211 @@
 #include "QtGui/qapplication.h"
 #endif
 
+#include <cstdio>
 #include <cstdlib>
 #include <iostream>
+#include <streambuf>
+#include <string>
 using std::cout;
 using std::endl;
 
+/// Discards the messages of the calculations in server mode
+class ActNullBuffer : public std::streambuf {
+ protected:
+  virtual int overflow(int c) {return c;}
+  virtual std::streamsize xsputn(const char*, std::streamsize n) {return n;}
+};
+
 int main(int argc, char **argv) {
 
+  // Arguments: the run method (0 = xterm, 1 = GUI) and the options below; an unknown
+  // option gives a usage message and exit code 1.
+  // --checkpoint[=seconds], which saves checkpoints of the cross-section calculation
+  // at least the given number of seconds (default 60) apart, so that an interrupted
+  // run can be resumed, --shard i/n, which only calculates shard i (1 to n) of the
+  // products and writes its partial results, and --merge n, which combines the
+  // partial results of n shards into the normal output files.
+  // --spectra=list also calculates the production rates for the other spectra in the
+  // list, e.g. gordon,cosmic*2.5, in the same pass (see ActAbsRun::setOtherSpectra).
+  // --sigma-matrix[=file] stores the cross-sections vs energy, keeping values of at
+  // least --min-sigma=mb as --sigma-matrix-precision=32 (default) or 64 bit numbers,
+  // re-using those of earlier runs (see ActAbsRun::setSigmaMatrix).
+  // --ensemble=n also calculates the statistics of n replicas with perturbed inputs, using
+  // the --uncertainties=name:value,... the --seed=n and --threads=n (see ActEnsemble).
+  // --server[=socketPath] answers production requests (lines of JSON text, see
+  // ActQueryServer) from the standard input, or from a Unix domain socket, using
+  // --threads=n threads, --decay-data=file, --data-tables=file and --min-data-xsec=mb.
+  // The messages of the calculations are discarded, or written to the standard
+  // error with --verbose.
+  // --build-library=file calculates the library of production rates for all
+  // isotopes of the --abundances=file table (default abundanceData.dat) with the
+  // energies --energies=EStart,EEnd,dE (default 10,10000,10), and --library=file
+  // answers production requests from the library (see ActProductionLibrary) in the
+  // same way as the server mode, if the library is not stale.
+  // --stats writes the JSON report of the run statistics (see ActRunStatistics).
   int runMethod = 0;
-  if (argc > 1) {runMethod = atoi(argv[1]);}
+  double checkpointInterval(-1.0);
+  int iShard(0), nShards(0);
+  bool serverMode(false), verbose(false);
+  std::string socketPath(""), decayData("decayData.dat"), dataTables("");
+  std::string buildLibrary(""), library(""), abundances("abundanceData.dat");
+  std::string otherSpectra(""), sigmaMatrixFile("");
+  bool useSigmaMatrix(false), writeStatistics(false);
+  int nReplicas(0);
+  std::string uncertainties("");
+  unsigned long long seed(1);
+  double minSigma(0.0);
+  int sigmaMatrixPrecision(32);
+  double EStart(10.0), EEnd(10000.0), dE(10.0);
+  int nThreads(0);
+  double minDataXSec(0.0);
+  int i;
+  for (i = 1; i < argc; i++) {
+
+    std::string arg(argv[i]);
+    std::string value("");
+    size_t equals = arg.find('=');
+    if (arg.compare(0, 2, "--") == 0 && equals != std::string::npos) {
+      value = arg.substr(equals + 1);
+      arg.erase(equals);
+    }
+
+    if (arg.compare("--checkpoint") == 0) {
+      checkpointInterval = 60.0;
+      if (value.size() > 0) {checkpointInterval = atof(value.c_str());}
+    } else if (arg.compare("--shard") == 0 || arg.compare("--merge") == 0) {
+      if (value.size() == 0 && i+1 < argc) {value = argv[++i];}
+      if (arg.compare("--merge") == 0) {
+	iShard = 0; nShards = atoi(value.c_str());
+      } else if (sscanf(value.c_str(), "%d/%d", &iShard, &nShards) != 2 ||
+		 iShard < 1 || iShard > nShards) {
+	cout<<"Invalid shard "<<value<<"; use --shard i/n with i = 1 to n"<<endl;
+	return 1;
+      }
+      if (nShards < 1) {
+	cout<<"Invalid number of shards "<<value<<endl;
+	return 1;
+      }
+    } else if (arg.compare("--spectra") == 0) {
+      otherSpectra = value;
+    } else if (arg.compare("--sigma-matrix") == 0) {
+      useSigmaMatrix = true; sigmaMatrixFile = value;
+    } else if (arg.compare("--min-sigma") == 0) {
+      minSigma = atof(value.c_str());
+    } else if (arg.compare("--sigma-matrix-precision") == 0) {
+      sigmaMatrixPrecision = atoi(value.c_str());
+      if (sigmaMatrixPrecision != 32 && sigmaMatrixPrecision != 64) {
+	cout<<"Invalid sigma matrix precision "<<value<<"; use --sigma-matrix-precision=32 or 64"<<endl;
+	return 1;
+      }
+    } else if (arg.compare("--ensemble") == 0) {
+      nReplicas = atoi(value.c_str());
+    } else if (arg.compare("--uncertainties") == 0) {
+      uncertainties = value;
+    } else if (arg.compare("--seed") == 0) {
+      seed = strtoull(value.c_str(), 0, 10);
+    } else if (arg.compare("--server") == 0) {
+      serverMode = true; socketPath = value;
+    } else if (arg.compare("--threads") == 0) {
+      nThreads = atoi(value.c_str());
+    } else if (arg.compare("--decay-data") == 0) {
+      decayData = value;
+    } else if (arg.compare("--data-tables") == 0) {
+      dataTables = value;
+    } else if (arg.compare("--min-data-xsec") == 0) {
+      minDataXSec = atof(value.c_str());
+    } else if (arg.compare("--verbose") == 0) {
+      verbose = true;
+    } else if (arg.compare("--stats") == 0) {
+      writeStatistics = true;
+    } else if (arg.compare("--build-library") == 0) {
+      buildLibrary = value;
+    } else if (arg.compare("--library") == 0) {
+      library = value;
+    } else if (arg.compare("--abundances") == 0) {
+      abundances = value;
+    } else if (arg.compare("--energies") == 0) {
+      if (sscanf(value.c_str(), "%lf,%lf,%lf", &EStart, &EEnd, &dE) != 3) {
+	cout<<"Invalid energies "<<value<<"; use --energies=EStart,EEnd,dE"<<endl;
+	return 1;
+      }
+    } else if (arg.compare(0, 1, "-") == 0) {
+      cout<<"Unknown option "<<argv[i]<<endl;
+      cout<<"Usage: Activia [0|1] [--checkpoint[=seconds]] [--shard i/n] [--merge n]"
+	  <<" [--spectra=list] [--sigma-matrix[=file]] [--min-sigma=mb]"
+	  <<" [--sigma-matrix-precision=32|64] [--ensemble=n] [--uncertainties=list]"
+	  <<" [--seed=n] [--threads=n] [--server[=socketPath]] [--decay-data=file]"
+	  <<" [--data-tables=file] [--min-data-xsec=mb] [--verbose] [--stats]"
+	  <<" [--build-library=file] [--library=file] [--abundances=file]"
+	  <<" [--energies=EStart,EEnd,dE]"<<endl;
+      return 1;
+    } else {
+      runMethod = atoi(argv[i]);
+    }
+
+  }
+
+  if (buildLibrary.size() > 0) {
+
+    ActProductionLibrary productionLibrary;
+    bool ok = productionLibrary.build(decayData.c_str(), dataTables.c_str(), minDataXSec,
+				      abundances.c_str(), EStart, EEnd, dE, nThreads);
+    if (ok == true) {ok = productionLibrary.write(buildLibrary);}
+    if (ok == true) {cout<<"Written the library "<<buildLibrary<<endl;}
+    return ok ? 0 : 1;
+
+  }
+
+  if (library.size() > 0) {
+
+    ActProductionLibrary productionLibrary;
+    if (productionLibrary.read(library) == false) {return 1;}
+
+    // Checking the models needs a few calculations, whose messages are not wanted
+    std::ostream answers(cout.rdbuf());
+    ActNullBuffer nullBuffer;
+    std::streambuf* coutBuffer = cout.rdbuf(verbose ? std::cerr.rdbuf() : &nullBuffer);
+
+    std::string reason("");
+    bool ok = productionLibrary.isCurrent(decayData.c_str(), dataTables.c_str(),
+					  minDataXSec, reason);
+    if (ok == false) {
+      std::cerr<<"The library "<<library<<" is stale: "<<reason
+	       <<". Rebuild it with --build-library"<<endl;
+    } else {
+      productionLibrary.serveStream(std::cin, answers);
+    }
+
+    cout.rdbuf(coutBuffer);
+    return ok ? 0 : 1;
+
+  }
+
+  if (serverMode == true) {
+
+    // The answers are written to the standard output, so the messages
+    // of the calculations must not be
+    std::ostream answers(cout.rdbuf());
+    ActNullBuffer nullBuffer;
+    std::streambuf* coutBuffer = cout.rdbuf(verbose ? std::cerr.rdbuf() : &nullBuffer);
+
+    bool ok(true);
+    {
+      ActQueryServer server(decayData.c_str(), dataTables.c_str(), minDataXSec, nThreads);
+      if (socketPath.size() > 0) {
+	std::cerr<<"Answering requests on "<<socketPath<<" using "
+		 <<server.getNThreads()<<" threads"<<endl;
+	ok = server.serveSocket(socketPath);
+	if (ok == false) {std::cerr<<"Could not listen on "<<socketPath<<endl;}
+      } else {
+	server.serveStream(std::cin, answers);
+      }
+    }
+
+    cout.rdbuf(coutBuffer);
+    return ok ? 0 : 1;
+
+  }
 
   bool useGui(false);
 
@@ -26,6 +224,12 @@ int main(int argc, char **argv) {
     QApplication application(argc, argv);
 
     ActGuiRun run;
+    run.setCheckpointInterval(checkpointInterval);
+    run.setShard(iShard, nShards);
+    run.setOtherSpectra(otherSpectra);
+    run.setSigmaMatrix(useSigmaMatrix, sigmaMatrixFile, minSigma, sigmaMatrixPrecision);
+    run.setEnsemble(nReplicas, uncertainties, seed, nThreads);
+    run.setWriteStatistics(writeStatistics);
     run.makeGui();
     useGui = true;
     cout<<"HERE"<<endl;
@@ -40,6 +244,12 @@ int main(int argc, char **argv) {
     // Run the xterm command line version either by choice 
     // or because Qt isn't used
     ActXTermRun run;
+    run.setCheckpointInterval(checkpointInterval);
+    run.setShard(iShard, nShards);
+    run.setOtherSpectra(otherSpectra);
+    run.setSigmaMatrix(useSigmaMatrix, sigmaMatrixFile, minSigma, sigmaMatrixPrecision);
+    run.setEnsemble(nReplicas, uncertainties, seed, nThreads);
+    run.setWriteStatistics(writeStatistics);
     run.run();
 
   }
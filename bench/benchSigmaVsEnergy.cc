@@ -0,0 +1,157 @@
+// Benchmark of ActXSecEngine::calcSigmaVsEnergy for unsorted random energies, as
+// sampled by a transport code, compared with calculating one energy at a time.
+// It fails if any product is calculated at less than 1 million energies per second.
+
+#include "Activia/ActXSecEngine.hh"
+#include "Activia/ActSTXSecAlgorithm.hh"
+#include "Activia/ActNucleiData.hh"
+#include "Activia/ActNuclideFactory.hh"
+#include "Activia/ActProdNuclide.hh"
+#include "Activia/ActProdNuclideList.hh"
+#include "Activia/ActTarget.hh"
+#include "Activia/ActTargetNuclide.hh"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using std::cout;
+using std::endl;
+
+// Calculate the cross-section of the product at one energy without the energy
+// factor table, using the same selections and sums as ActXSecEngine
+double calcOneSigma(ActSTXSecAlgorithm* algorithm, ActTarget* target,
+		    ActProdNuclide* product, double energy) {
+
+  ActNuclide* beam = ActNuclideFactory::getInstance()->getNuclide(1, 1.0, 0.0);
+  std::vector<double> energies(1, energy), sigmas;
+  std::vector<int> passed;
+
+  double sigma(0.0);
+  int nSideBranches = product->getNSideBranches();
+
+  int it;
+  for (it = 0; it < target->getNIsotopes(); it++) {
+
+    ActNucleiData data;
+    data.setBeamData(beam);
+    data.setTargetData(target->getIsotope(it));
+    data.setProductData(product);
+    if (algorithm->passSelection(&data) == false) {continue;}
+
+    double productSigma(0.0);
+    int iSB;
+    for (iSB = 0; iSB < nSideBranches+1; iSB++) {
+
+      if (iSB < nSideBranches) {
+	data.setProductData(product->getSideBranch(iSB));
+	if (algorithm->passSelection(&data) == false) {continue;}
+      } else {
+	data.setProductData(product);
+      }
+
+      data.setOtherQuantities();
+      algorithm->setNucleiData(&data);
+      algorithm->calcCrossSections(energies, sigmas, passed);
+      if (passed[0] == 1) {productSigma += sigmas[0];}
+
+    }
+
+    sigma += productSigma*target->getFraction(it);
+
+  }
+
+  return sigma;
+
+}
+
+int main(int argc, char** argv) {
+
+  int nEnergies(1000000);
+  if (argc > 1) {nEnergies = atoi(argv[1]);}
+  if (nEnergies < 1) {nEnergies = 1;}
+
+  ActProdNuclideList prodList;
+  prodList.setVerbose(false);
+  prodList.storeTable("decayData.dat");
+
+  ActXSecEngine engine(&prodList, "", 0.0, false);
+
+  // Natural copper, and products without and with side branches
+  std::vector<double> A(2), fractions(2);
+  A[0] = 63.0; A[1] = 65.0; fractions[0] = 0.6917; fractions[1] = 0.3083;
+  ActTarget* target = engine.getTarget(29, A, fractions);
+
+  int zProducts[3] = {27, 25, 11};
+  double aProducts[3] = {60.0, 54.0, 22.0};
+
+  // Energies from 1 MeV to 100 GeV, in random order
+  std::mt19937 generator(12345);
+  std::uniform_real_distribution<double> uniform(1.0, 1.0e5);
+  std::vector<double> energies(nEnergies);
+  int i;
+  for (i = 0; i < nEnergies; i++) {energies[i] = uniform(generator);}
+
+  // The number of energies checked one at a time
+  int nCheck = std::min(nEnergies, 2000);
+
+  cout<<"Sigma vs energy benchmark: natural Cu target, "<<nEnergies
+      <<" random energies"<<endl;
+  cout<<std::setw(8)<<"Product"<<std::setw(12)<<"Time (ms)"
+      <<std::setw(16)<<"Evaluations/s"<<std::setw(12)<<"Identical"<<endl;
+
+  // The required number of evaluations per second
+  const double minRate(1.0e6);
+
+  bool allSame(true), allFast(true);
+
+  int ip;
+  for (ip = 0; ip < 3; ip++) {
+
+    std::vector<double> sigmas;
+
+    // Run a few energies first so that the tables are set up
+    std::vector<double> first(energies.begin(), energies.begin() + 10);
+    engine.calcSigmaVsEnergy(target, zProducts[ip], aProducts[ip], first, sigmas);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    engine.calcSigmaVsEnergy(target, zProducts[ip], aProducts[ip], energies, sigmas);
+    std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(stop - start).count();
+
+    ActProdNuclide* product = prodList.getProdNuclide(zProducts[ip], aProducts[ip]);
+    bool same = (product != 0);
+    for (i = 0; same == true && i < nCheck; i++) {
+      double sigma = calcOneSigma(engine.getAlgorithm(), target, product, energies[i]);
+      if (sigma != sigmas[i]) {same = false;}
+    }
+    if (same == false) {allSame = false;}
+
+    double rate(0.0);
+    if (ms > 0.0) {rate = nEnergies*1000.0/ms;}
+    if (ms > 0.0 && rate < minRate) {allFast = false;}
+
+    cout<<std::setw(4)<<zProducts[ip]<<"-"<<std::setw(3)<<std::left<<(int) aProducts[ip]
+	<<std::right<<std::fixed<<std::setprecision(1)<<std::setw(12)<<ms
+	<<std::setprecision(0)<<std::setw(16)<<rate
+	<<std::setw(12)<<(same ? "yes" : "NO")<<endl;
+    cout.unsetf(std::ios::fixed);
+
+  }
+
+  if (allSame == false) {
+    cout<<"Error. The cross-sections are different from those of single energies"<<endl;
+    return 1;
+  }
+
+  if (allFast == false) {
+    cout<<"Error. Fewer than "<<minRate<<" evaluations per second"<<endl;
+    return 1;
+  }
+
+  return 0;
+
+}
@@ -0,0 +1,621 @@
+// Benchmark suite for the cross-section models, data tables, SIMD maths,
+// decay calculations and complete runs. The results are written as JSON
+// so that they can be compared between versions of the code.
+//
+// Usage: benchSuite [JSON file (benchSuite.json)] [work directory (workdir)] [repeats (3)]
+
+#include "Activia/ActAbsRun.hh"
+#include "Activia/ActInput.hh"
+#include "Activia/ActAbsDecayAlgorithm.hh"
+#include "Activia/ActSTXSecAlgorithm.hh"
+#include "Activia/ActAbsXSecModel.hh"
+#include "Activia/ActXSecDataModel.hh"
+#include "Activia/ActXSecGraph.hh"
+#include "Activia/ActNucleiData.hh"
+#include "Activia/ActNuclide.hh"
+#include "Activia/ActNuclideFactory.hh"
+#include "Activia/ActNuclideTable.hh"
+#include "Activia/ActTargetNuclide.hh"
+#include "Activia/ActProdNuclideList.hh"
+#include "Activia/ActEnergyFactorCache.hh"
+#include "Activia/ActFormulae.hh"
+#include "Activia/ActSIMDMath.hh"
+#include "Activia/ActStreamOutput.hh"
+#include "Activia/ActRunStatistics.hh"
+#include "Activia/ActNumberFormat.hh"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+using std::cout;
+using std::endl;
+
+typedef std::chrono::steady_clock BenchClock;
+
+// Time since start in ms
+double msSince(BenchClock::time_point start) {
+
+  return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+
+}
+
+// Stream buffer that discards the (very verbose) output of the calculations
+class NullBuffer : public std::streambuf {
+ protected:
+  virtual int overflow(int c) {return c;}
+};
+
+// Collects "name": value pairs for one JSON object
+class BenchEntry {
+
+ public:
+
+  BenchEntry() : _text(""), _format(ActNumberFormat::Stream, 8) {;}
+
+  void add(const char* name, double value) {
+    this->addName(name);
+    if (std::isfinite(value)) {_format.append(_text, value);} else {_text += "null";}
+  }
+  void add(const char* name, int value) {this->addName(name); _format.append(_text, value);}
+  void add(const char* name, bool value) {this->addName(name); _text += value ? "true" : "false";}
+  void add(const char* name, const std::string& value) {
+    this->addName(name); _text += "\""; _text += value; _text += "\"";
+  }
+
+  std::string getString() {return "{" + _text + "}";}
+
+ private:
+
+  void addName(const char* name) {
+    if (_text.size() > 0) {_text += ", ";}
+    _text += "\""; _text += name; _text += "\": ";
+  }
+
+  std::string _text;
+  ActNumberFormat _format;
+
+};
+
+// Join JSON objects into an array
+std::string jsonArray(std::vector<BenchEntry>& entries) {
+
+  std::string text("[");
+  int n = (int) entries.size();
+  int i;
+  for (i = 0; i < n; i++) {
+    if (i > 0) {text += ",";}
+    text += "\n    "; text += entries[i].getString();
+  }
+  text += "\n  ]";
+  return text;
+
+}
+
+// Run the complete code using the answers of a run file
+class BenchRun : public ActAbsRun {
+
+ public:
+
+  BenchRun(const std::string& answers) : ActAbsRun(), _answers(answers) {;}
+
+  virtual void defineInput() {
+    ActInput* input = new ActInput(_outputSelection);
+    input->setInputStream(_answers);
+    _input = input;
+  }
+
+  ActAbsInput* getInput() {return _input;}
+
+ private:
+
+  std::istringstream _answers;
+
+};
+
+// Per-model cross-section timings over representative (target, product) pairs
+void benchModels(int nRepeat, std::vector<BenchEntry>& results) {
+
+  // Same energy grid as the example run files: 10 to 5000 MeV in 10 MeV steps
+  std::vector<double> energies;
+  int iE;
+  for (iE = 0; iE < 500; iE++) {energies.push_back(10.0 + iE*10.0);}
+
+  // Light, medium and heavy targets, using at most maxPairs products
+  // for each model and target
+  int zTargets[4] = {13, 29, 52, 79};
+  double aTargets[4] = {27.0, 63.0, 130.0, 197.0};
+  int maxPairs(25);
+
+  std::map<std::string, double> timeMap, sumMap;
+  std::map<std::string, int> nPairMap, nEvalMap;
+
+  ActSTXSecAlgorithm algorithm;
+  ActNuclideFactory* factory = ActNuclideFactory::getInstance();
+  ActNuclide beam(1, 1.0);
+
+  int iT;
+  for (iT = 0; iT < 4; iT++) {
+
+    int zt = zTargets[iT];
+    double at = aTargets[iT];
+    ActTargetNuclide target(zt, at, 0.0, 1.0, at, at, ActNuclideTable::calcEZero(at));
+
+    ActNucleiData data;
+    data.setBeamData(&beam);
+    data.setTargetData(&target);
+
+    ActEnergyFactorCache eFactorCache;
+    eFactorCache.build(&data, energies);
+
+    std::map<std::string, int> targetPairs;
+
+    int iz, ia;
+    for (iz = 1; iz <= zt; iz++) {
+      for (ia = iz; ia <= 3*iz && ia < (int) at; ia++) {
+
+	ActNuclide* product = factory->getNuclide(iz, ia*1.0, 0.0);
+	data.setProductData(product);
+	if (algorithm.passSelection(&data) == false) {continue;}
+
+	data.setOtherQuantities();
+	algorithm.setNucleiData(&data);
+
+	ActAbsXSecModel* model = algorithm.getCurrentModel();
+	if (model == 0) {continue;}
+
+	std::string name = model->getName();
+	if (targetPairs[name] >= maxPairs) {continue;}
+	targetPairs[name] += 1;
+	nPairMap[name] += 1;
+
+	BenchClock::time_point start = BenchClock::now();
+
+	int iR;
+	for (iR = 0; iR < nRepeat; iR++) {
+	  for (iE = 0; iE < (int) energies.size(); iE++) {
+	    data.setEnergy(energies[iE]);
+	    if (algorithm.passESelection(&data) == false) {continue;}
+	    double sigma = model->calcCrossSection(&data);
+	    if (iR == 0) {sumMap[name] += sigma;}
+	    nEvalMap[name] += 1;
+	  }
+	}
+
+	timeMap[name] += msSince(start);
+
+      }
+    }
+
+  }
+
+  std::map<std::string, double>::iterator iter;
+  for (iter = timeMap.begin(); iter != timeMap.end(); ++iter) {
+
+    std::string name = iter->first;
+    int nEval = nEvalMap[name];
+    double nsPerEval(0.0);
+    if (nEval > 0) {nsPerEval = 1e6*iter->second/nEval;}
+
+    BenchEntry entry;
+    entry.add("model", name);
+    entry.add("pairs", nPairMap[name]);
+    entry.add("evaluations", nEval);
+    entry.add("ms", iter->second);
+    entry.add("nsPerEvaluation", nsPerEval);
+    // Sum of the cross-sections, to check that the results do not change
+    entry.add("sigmaSum", sumMap[name]);
+    results.push_back(entry);
+
+  }
+
+}
+
+// Write a data table file in the format read by ActXSecDataModel::storeXSecGraphs
+int writeDataTable(const std::string& fileName, int zt, double at, int nProducts, int nEnergies) {
+
+  std::ofstream table(fileName.c_str());
+  table << "# Benchmark data table\n";
+  table << "Target " << zt << " " << at << "\n";
+
+  int nLines(2);
+  int ip, iE;
+  for (ip = 0; ip < nProducts; ip++) {
+
+    int z = 1 + ip%(zt - 1);
+    int a = z + 1 + ip/(zt - 1);
+    table << "# New table\n";
+    table << "Product " << z << " " << a << "\n";
+    nLines += 2;
+
+    for (iE = 0; iE < nEnergies; iE++) {
+      double energy = 5.0 + iE*10.0;
+      double sigma = 50.0*std::exp(-0.001*energy)*(1.0 + 0.1*z)/(1.0 + ip%7);
+      table << energy << " " << sigma << "\n";
+      nLines++;
+    }
+
+  }
+
+  table.close();
+  return nLines;
+
+}
+
+// Parsing of data tables (storeXSecGraphs), and the interpolation of the
+// stored graphs using ActXSecGraph::calcSigma and the data model lookup
+void benchDataTables(int nRepeat, std::vector<BenchEntry>& results) {
+
+  int zt(29), nProducts(200), nEnergies(150);
+  double at(63.0);
+  std::string fileName("benchSuiteTable.dat");
+  int nLines = writeDataTable(fileName, zt, at, nProducts, nEnergies);
+
+  ActProdNuclideList prodList;
+  ActNuclideFactory* factory = ActNuclideFactory::getInstance();
+  ActNuclide* targetNuclide = factory->getNuclide(zt, at, 0.0);
+
+  ActXSecDataModel dataModel("benchData", "", 0);
+
+  BenchClock::time_point start = BenchClock::now();
+  int iR;
+  for (iR = 0; iR < nRepeat; iR++) {
+    dataModel.storeXSecGraphs(fileName, targetNuclide, &prodList);
+  }
+  double parseMs = msSince(start)/nRepeat;
+
+  BenchEntry parseEntry;
+  parseEntry.add("benchmark", std::string("storeXSecGraphs"));
+  parseEntry.add("products", nProducts);
+  parseEntry.add("lines", nLines);
+  parseEntry.add("ms", parseMs);
+  parseEntry.add("linesPerSecond", parseMs > 0.0 ? 1e3*nLines/parseMs : 0.0);
+  results.push_back(parseEntry);
+
+  // Interpolate one graph at random energies
+  ActXSecGraph graph;
+  int iE;
+  for (iE = 0; iE < nEnergies; iE++) {
+    double energy = 5.0 + iE*10.0;
+    graph.addPoint(energy, 50.0*std::exp(-0.001*energy), 0.0);
+  }
+
+  std::mt19937 generator(12345);
+  std::uniform_real_distribution<double> eDist(0.0, 10.0*nEnergies + 10.0);
+  int nCalls(200000);
+  std::vector<double> eValues(nCalls);
+  int i;
+  for (i = 0; i < nCalls; i++) {eValues[i] = eDist(generator);}
+
+  double sum(0.0);
+  start = BenchClock::now();
+  for (i = 0; i < nCalls; i++) {sum += graph.calcSigma(eValues[i]);}
+  double sigmaMs = msSince(start);
+
+  BenchEntry sigmaEntry;
+  sigmaEntry.add("benchmark", std::string("calcSigma"));
+  sigmaEntry.add("points", nEnergies);
+  sigmaEntry.add("evaluations", nCalls);
+  sigmaEntry.add("ms", sigmaMs);
+  sigmaEntry.add("nsPerEvaluation", 1e6*sigmaMs/nCalls);
+  sigmaEntry.add("sigmaSum", sum);
+  results.push_back(sigmaEntry);
+
+  // Data model lookups, cycling through the products of the table
+  ActNuclide beam(1, 1.0);
+  ActTargetNuclide target(zt, at, 0.0, 1.0, at, at, ActNuclideTable::calcEZero(at));
+  ActNucleiData data;
+  data.setBeamData(&beam);
+  data.setTargetData(&target);
+
+  int nLookups(20000), nPerProduct(100);
+  sum = 0.0;
+  start = BenchClock::now();
+  for (i = 0; i < nLookups; i++) {
+    if (i%nPerProduct == 0) {
+      int ip = (i/nPerProduct)%nProducts;
+      int z = 1 + ip%(zt - 1);
+      int a = z + 1 + ip/(zt - 1);
+      data.setProductData(factory->getNuclide(z, a*1.0, 0.0));
+    }
+    data.setEnergy(eValues[i]);
+    sum += dataModel.calcCrossSection(&data);
+  }
+  double lookupMs = msSince(start);
+
+  BenchEntry lookupEntry;
+  lookupEntry.add("benchmark", std::string("dataModelLookup"));
+  lookupEntry.add("evaluations", nLookups);
+  lookupEntry.add("ms", lookupMs);
+  lookupEntry.add("nsPerEvaluation", 1e6*lookupMs/nLookups);
+  lookupEntry.add("sigmaSum", sum);
+  results.push_back(lookupEntry);
+
+  remove(fileName.c_str());
+
+}
+
+// Check that two results are the same, including NaN and infinite values
+bool sameValue(double a, double b) {
+
+  if (std::isnan(a) || std::isnan(b)) {return std::isnan(a) && std::isnan(b);}
+  return a == b;
+
+}
+
+// Check that the guards for special values give the same result: zero, infinite
+// and NaN values must be identical, while other values can differ by rounding
+bool sameGuard(double a, double b) {
+
+  if (a == 0.0 || b == 0.0 || std::isfinite(a) == false || std::isfinite(b) == false) {
+    return sameValue(a, b);
+  }
+  return std::fabs(a - b) <= 1e-12*std::fabs(b);
+
+}
+
+// Relative difference, or the absolute difference for small values
+double relDiff(double a, double b) {
+
+  if (std::isfinite(a) == false || std::isfinite(b) == false) {return sameValue(a, b) ? 0.0 : 1.0;}
+  double scale = std::fabs(b);
+  if (scale < 1e-300) {return std::fabs(a - b);}
+  return std::fabs(a - b)/scale;
+
+}
+
+// Accuracy and speed of the SIMD power and exp kernels compared with the
+// scalar ActFormulae functions, for each instruction set that the CPU supports
+void benchSIMD(int nRepeat, std::vector<BenchEntry>& results) {
+
+  int nValues(1000000);
+  std::mt19937 generator(54321);
+  std::uniform_real_distribution<double> expDist(-69.0, 69.0);
+  std::uniform_real_distribution<double> logDist(-7.0, 7.0);
+  std::uniform_real_distribution<double> nDist(-5.0, 5.0);
+
+  std::vector<double> expX(nValues), powX(nValues), powN(nValues);
+  int i;
+  for (i = 0; i < nValues; i++) {
+    expX[i] = expDist(generator);
+    powX[i] = std::exp(logDist(generator));
+    powN[i] = nDist(generator);
+  }
+
+  // Special values that need the NaN guards
+  double inf = std::numeric_limits<double>::infinity();
+  double nan = std::numeric_limits<double>::quiet_NaN();
+  double specialX[12] = {0.0, -1.0, 1e-31, -1e-31, 1e300, inf, -inf, nan, 69.99, 70.0, -70.0, 700.0};
+  double specialN[12] = {2.0, 0.5, 3.0, -2.0, 10.0, 1.0, 2.0, 1.0, 12.0, -11.0, 1.5, 0.2};
+
+  ActFormulae formulae;
+  std::vector<double> scalarExp(nValues), scalarPow(nValues);
+
+  BenchClock::time_point start = BenchClock::now();
+  int iR;
+  for (iR = 0; iR < nRepeat; iR++) {
+    for (i = 0; i < nValues; i++) {scalarExp[i] = formulae.expfun(expX[i]);}
+  }
+  double scalarExpMs = msSince(start)/nRepeat;
+
+  start = BenchClock::now();
+  for (iR = 0; iR < nRepeat; iR++) {
+    for (i = 0; i < nValues; i++) {scalarPow[i] = formulae.power(powX[i], powN[i]);}
+  }
+  double scalarPowMs = msSince(start)/nRepeat;
+
+  std::vector<double> result(nValues);
+  double specialResult[12];
+  int supported = ActSIMDMath::getSupportedInstructionSet();
+  int iSet;
+
+  for (iSet = ActSIMDMath::Scalar; iSet <= supported; iSet++) {
+
+    ActSIMDMath::setInstructionSet(iSet);
+    std::string setName = ActSIMDMath::getName(iSet);
+
+    // exp
+    start = BenchClock::now();
+    for (iR = 0; iR < nRepeat; iR++) {ActSIMDMath::expfun_n(&expX[0], &result[0], nValues);}
+    double expMs = msSince(start)/nRepeat;
+
+    double maxDiff(0.0);
+    for (i = 0; i < nValues; i++) {
+      double diff = relDiff(result[i], scalarExp[i]);
+      if (diff > maxDiff) {maxDiff = diff;}
+    }
+
+    bool specialSame(true);
+    ActSIMDMath::expfun_n(specialX, specialResult, 12);
+    for (i = 0; i < 12; i++) {
+      if (sameGuard(specialResult[i], formulae.expfun(specialX[i])) == false) {specialSame = false;}
+    }
+
+    BenchEntry expEntry;
+    expEntry.add("function", std::string("expfun"));
+    expEntry.add("instructionSet", setName);
+    expEntry.add("values", nValues);
+    expEntry.add("scalarMs", scalarExpMs);
+    expEntry.add("simdMs", expMs);
+    expEntry.add("speedUp", expMs > 0.0 ? scalarExpMs/expMs : 0.0);
+    expEntry.add("maxRelDiff", maxDiff);
+    expEntry.add("specialValuesSame", specialSame);
+    results.push_back(expEntry);
+
+    // x^n
+    start = BenchClock::now();
+    for (iR = 0; iR < nRepeat; iR++) {ActSIMDMath::power_n(&powX[0], &powN[0], &result[0], nValues);}
+    double powMs = msSince(start)/nRepeat;
+
+    maxDiff = 0.0;
+    for (i = 0; i < nValues; i++) {
+      double diff = relDiff(result[i], scalarPow[i]);
+      if (diff > maxDiff) {maxDiff = diff;}
+    }
+
+    specialSame = true;
+    ActSIMDMath::power_n(specialX, specialN, specialResult, 12);
+    for (i = 0; i < 12; i++) {
+      if (sameGuard(specialResult[i], formulae.power(specialX[i], specialN[i])) == false) {
+	specialSame = false;
+      }
+    }
+
+    BenchEntry powEntry;
+    powEntry.add("function", std::string("power"));
+    powEntry.add("instructionSet", setName);
+    powEntry.add("values", nValues);
+    powEntry.add("scalarMs", scalarPowMs);
+    powEntry.add("simdMs", powMs);
+    powEntry.add("speedUp", powMs > 0.0 ? scalarPowMs/powMs : 0.0);
+    powEntry.add("maxRelDiff", maxDiff);
+    powEntry.add("specialValuesSame", specialSame);
+    results.push_back(powEntry);
+
+  }
+
+  ActSIMDMath::setInstructionSet(supported);
+
+}
+
+// Run the complete calculation, mirroring one of the run files. The decay
+// yields are then recalculated nDecay times using the stored cross-sections.
+void benchRun(const std::string& name, const std::string& answers, int nDecay,
+	      std::vector<BenchEntry>& runResults, std::vector<BenchEntry>& decayResults) {
+
+  BenchRun run(answers);
+
+  BenchClock::time_point start = BenchClock::now();
+  run.run();
+  double runMs = msSince(start);
+
+  ActRunStatistics* statistics = ActRunStatistics::getInstance();
+
+  BenchEntry runEntry;
+  runEntry.add("run", name);
+  runEntry.add("ms", runMs);
+  runEntry.add("cpuMs", 1e3*statistics->getCPUTime("total"));
+  runEntry.add("decayMs", 1e3*statistics->getWallTime("decay"));
+  runEntry.add("outputMs", 1e3*statistics->getWallTime("output"));
+  runResults.push_back(runEntry);
+
+  // Remove the output files of the run
+  std::string prefix("output/benchSuite_"); prefix += name;
+  remove((prefix + "_xSec.root").c_str());
+  remove((prefix + "_Yields.root").c_str());
+
+  ActAbsInput* input = run.getInput();
+  ActAbsDecayAlgorithm* decayAlgorithm(0);
+  if (input != 0) {decayAlgorithm = input->getDecayAlgorithm();}
+  if (decayAlgorithm == 0 || nDecay < 1) {return;}
+
+  std::string decayFile = prefix + "_Decay.out";
+  ActStreamOutput decayOutput(decayFile.c_str(), 0);
+  decayOutput.openFile();
+
+  start = BenchClock::now();
+  int iD;
+  for (iD = 0; iD < nDecay; iD++) {decayAlgorithm->calculateDecays(&decayOutput);}
+  double decayMs = msSince(start)/nDecay;
+
+  decayOutput.closeFile();
+  remove(decayFile.c_str());
+
+  BenchEntry decayEntry;
+  decayEntry.add("run", name);
+  decayEntry.add("calls", nDecay);
+  decayEntry.add("msPerCall", decayMs);
+  decayResults.push_back(decayEntry);
+
+}
+
+int main(int argc, char** argv) {
+
+  std::string jsonFile("benchSuite.json");
+  std::string workDir("workdir");
+  int nRepeat(3);
+  if (argc > 1) {jsonFile = argv[1];}
+  if (argc > 2) {workDir = argv[2];}
+  if (argc > 3) {nRepeat = atoi(argv[3]);}
+  if (nRepeat < 1) {nRepeat = 1;}
+
+  std::ofstream json(jsonFile.c_str());
+  if (json.is_open() == false) {
+    cout<<"Error in benchSuite. Could not open "<<jsonFile<<endl;
+    return 1;
+  }
+
+  // Hide the output of the calculations
+  NullBuffer nullBuffer;
+  std::streambuf* coutBuffer = cout.rdbuf(&nullBuffer);
+
+  std::vector<BenchEntry> modelResults, dataResults, simdResults, runResults, decayResults;
+
+  benchModels(nRepeat, modelResults);
+  benchSIMD(nRepeat, simdResults);
+
+  // The data tables, decay data and run outputs are relative to the work directory
+  bool inWorkDir = (chdir(workDir.c_str()) == 0);
+
+  if (inWorkDir == true) {
+
+    benchDataTables(nRepeat, dataResults);
+
+    // Same as runFiles/runNatTe_All.sh, with a different output file name
+    std::string natTe("52\n8\n120 0.0009\n122 0.0255\n123 0.0089\n124 0.0474\n"
+		      "125 0.0707\n126 0.1884\n128 0.3174\n130 0.3408\n"
+		      "a\ndecayData.dat\n100.0 100000.0 100.0\n0\n120.0 730.0\n"
+		      "output/benchSuite_NatTe_All_xSec.root 1 1\n"
+		      "output/benchSuite_NatTe_All_Yields.root 1 1\n");
+    benchRun("NatTe_All", natTe, nRepeat, runResults, decayResults);
+
+    // Same as runFiles/runNatCu_Co60_DataTables.sh
+    std::string natCu("29\n2\n63 0.6917\n65 0.3083\n"
+		      "z\ndecayData.dat\n27 60\n10.0 10000.0 1.0\n"
+		      "listOfDataFiles.txt 0.001\n90.0 180.0\n"
+		      "output/benchSuite_NatCu_Co60_DataTables_xSec.root 1 1\n"
+		      "output/benchSuite_NatCu_Co60_DataTables_Yields.root 1 1\n");
+    benchRun("NatCu_Co60_DataTables", natCu, nRepeat, runResults, decayResults);
+
+  }
+
+  cout.rdbuf(coutBuffer);
+
+  if (inWorkDir == false) {
+    cout<<"Error in benchSuite. Could not find the work directory "<<workDir
+	<<"; skipping the data table and complete run benchmarks"<<endl;
+  }
+
+  BenchEntry info;
+  info.add("repeats", nRepeat);
+  info.add("instructionSet", ActSIMDMath::getName(ActSIMDMath::getSupportedInstructionSet()));
+
+  json << "{\n  \"info\": " << info.getString() << ",\n";
+  json << "  \"models\": " << jsonArray(modelResults) << ",\n";
+  json << "  \"dataTables\": " << jsonArray(dataResults) << ",\n";
+  json << "  \"simd\": " << jsonArray(simdResults) << ",\n";
+  json << "  \"decay\": " << jsonArray(decayResults) << ",\n";
+  json << "  \"runs\": " << jsonArray(runResults) << "\n}\n";
+  json.close();
+
+  // Short summary
+  int i;
+  for (i = 0; i < (int) runResults.size(); i++) {cout<<"Run "<<runResults[i].getString()<<endl;}
+  for (i = 0; i < (int) simdResults.size(); i++) {cout<<"SIMD "<<simdResults[i].getString()<<endl;}
+  cout<<"Written benchmark results to "<<jsonFile<<endl;
+
+  return 0;
+
+}
@@ -0,0 +1,45 @@
+
+PACKAGE = Activia
+SHELL = /bin/bash
+
+PREFIX = .
+ARCH = Linux
+COMPMODE = OPT
+
+CXX = g++
+CXXFLAGS = -g -O2 -Wall -Wextra -Woverloaded-virtual -Werror -fPIC -std=c++17 -pthread
+MFLAGS = -MM
+SOFLAGS = -shared -pthread
+
+# Set-up all of the include directories
+SRCDIR = src
+INCDIR = include
+FULLINCDIR = include/Activia
+LIBDIR = lib
+BINDIR = bin
+TMPDIR = tmp
+
+DEPDIR = $(TMPDIR)/dependencies
+OBJDIR = $(TMPDIR)/objects
+
+ROOTINCDIR = 
+ROOTLIBS = 
+ACT_USE_ROOT = 
+ACT_USE_QT = 
+# Set to 1 to compile in the tracing of the calculations (see ActTrace.hh)
+ACT_USE_TRACE = 
+
+EXTRAFLAGS = 
+
+CCLIST = src/ActAbsCalcStatus.cc src/ActAbsDecayAlgorithm.cc src/ActAbsGraph.cc src/ActAbsInput.cc src/ActAbsOutput.cc src/ActAbsRun.cc src/ActAbsXSecAlgorithm.cc src/ActAbsXSecModel.cc src/ActBeamSpectrum.cc src/ActBinaryFormat.cc src/ActBinaryOutput.cc src/ActBinaryReader.cc src/ActCInterface.cc src/ActCheckpoint.cc src/ActClassify.cc src/ActConstants.cc src/ActCosmicSpectrum.cc src/ActDecayGraph.cc src/ActEnergyFactorCache.cc src/ActEnsemble.cc src/ActFormulae.cc src/ActGordonSpectrum.cc src/ActGraphPoint.cc src/ActGuiCalcStatus.cc src/ActGuiInput.cc src/ActGuiRun.cc src/ActGuiWindow.cc src/ActGuiWorker.cc src/ActInput.cc src/ActIsotopeProduction.cc src/ActJSONValue.cc src/ActMassDef.cc src/ActModelVersion.cc src/ActNaturalAbundance.cc src/ActNucleiData.cc src/ActNuclide.cc src/ActNuclideFactory.cc src/ActNuclideKey.cc src/ActNuclideTable.cc src/ActNumberFormat.cc src/ActOutputSelection.cc src/ActOutputTable.cc src/ActProdNuclide.cc src/ActProdNuclideList.cc src/ActProdXSecData.cc src/ActProductionLibrary.cc src/ActQtDebugStream.cc src/ActQueryServer.cc src/ActROOTOutput.cc src/ActRunStatistics.cc src/ActSIMDMath.cc src/ActSTBreakup.cc src/ActSTEvaporation.cc src/ActSTFissBreakup.cc src/ActSTFissSpallGamma.cc src/ActSTFissSpallation.cc src/ActSTFission.cc src/ActSTPeripheral.cc src/ActSTSLite.cc src/ActSTSelect.cc src/ActSTSigUpdates.cc src/ActSTSpallation.cc src/ActSTXSecAlgorithm.cc src/ActScaledSpectrum.cc src/ActShard.cc src/ActSigmaMatrix.cc src/ActSimpleDecayAlgorithm.cc src/ActStreamOutput.cc src/ActString.cc src/ActTarget.cc src/ActTargetNuclide.cc src/ActTime.cc src/ActTrace.cc src/ActTritiumModel.cc src/ActXSecDataModel.cc src/ActXSecEngine.cc src/ActXSecGraph.cc src/ActXTermRun.cc 
+
+BINCCLIST = Activia.cc 
+
+ACT_QTINC = /usr/include
+ACT_QTLIB = /usr/lib
+ACT_MOC = /usr/bin/moc
+
+QTDEFINE = 
+QTINCLUDE = 
+QTLIBS = 
+
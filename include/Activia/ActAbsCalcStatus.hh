@@ -1,7 +1,12 @@
 #ifndef ACT_ABS_CALC_STATUS_HH
 #define ACT_ABS_CALC_STATUS_HH
 
+#include <atomic>
+
 /// \brief Keep track of what has been calculated (cross-sections, yields)
+///
+/// The run status can be changed from another thread (e.g. the GUI thread
+/// stopping a calculation that runs on a worker thread).
 
 class ActAbsCalcStatus {
 
@@ -55,7 +60,7 @@ public:
 
 protected:
   
-  bool _runCode;
+  std::atomic<bool> _runCode;
   int _nTIsotopes, _iTIsotope, _nPIsotopes, _iPIsotope;
 
 private:
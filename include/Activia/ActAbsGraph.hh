@@ -81,10 +81,26 @@ class ActAbsGraph {
   /// Get the name of the graph.
   std::string getName() {return _name;}
 
+  /// Describe the regular x grid that the points were selected from. The runs
+  /// are the lengths of consecutive bins that alternate between being omitted
+  /// (zero) and stored as points, starting with omitted bins, e.g. {120, 300, 580}
+  /// for a 1000 bin grid where only bins 120 to 419 are stored.
+  void setGrid(double xStart, double dx, std::vector<int> runs);
+  /// Check if the graph has a grid description (i.e. it is sparse)
+  bool hasGrid() {return !_gridRuns.empty();}
+  /// Get the x value of the first bin of the full grid
+  double getGridStart() {return _gridStart;}
+  /// Get the x spacing of the full grid
+  double getGridStep() {return _gridStep;}
+  /// Get the omitted/stored run lengths of the full grid
+  std::vector<int> getGridRuns() {return _gridRuns;}
+  /// Get the total number of bins of the full grid
+  int getGridSize();
+
   // Modifiers
   /// Add a vector of points to the graph
   void addPoints(std::vector<ActGraphPoint> points);
-  /// Reset the graph. This clears all points, axis names, units and x limits.
+  /// Reset the graph. This clears all points, axis names, units, x limits and the grid.
   void reset();
 
  protected:
@@ -94,6 +110,8 @@ class ActAbsGraph {
   double _minX, _maxX;
   std::string _xAxis, _xUnits;
   std::vector< std::string > _yAxes, _yUnits;
+  double _gridStart, _gridStep;
+  std::vector<int> _gridRuns;
   
  private:
 
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <fstream>
+#include <vector>
 
 class ActTarget;
 class ActProdNuclideList;
@@ -62,6 +63,15 @@ class ActAbsInput {
   ActProdNuclideList* getProdNuclideList() {return _prodNuclideList;}
   /// Get the input beam spectrum
   ActBeamSpectrum* getSpectrum() {return _spectrum;}
+
+  /// Add another beam spectrum, whose production rates are calculated in the same
+  /// pass as those of the input beam spectrum, using the same energies. The input
+  /// class then owns the spectrum.
+  void addOtherSpectrum(ActBeamSpectrum* spectrum);
+  /// Get the other beam spectra
+  std::vector<ActBeamSpectrum*> getOtherSpectra() {return _otherSpectra;}
+  /// Delete the other beam spectra
+  void clearOtherSpectra();
   /// Get the algorithm used to calculating the cross-sections
   ActAbsXSecAlgorithm* getXSecAlgorithm() {return _xSecAlgorithm;}
   /// Get the exposure and decay times
@@ -84,6 +94,7 @@ class ActAbsInput {
   ActTarget* _target;
   ActProdNuclideList* _prodNuclideList;
   ActBeamSpectrum* _spectrum;
+  std::vector<ActBeamSpectrum*> _otherSpectra;
   ActAbsXSecAlgorithm* _xSecAlgorithm;
   ActTime* _time;
   ActAbsDecayAlgorithm* _decayAlgorithm;
@@ -10,6 +10,11 @@
 #include <string>
 #include <vector>
 
+class ActCheckpoint;
+class ActShard;
+class ActSigmaMatrix;
+class ActEnsemble;
+
 /// \brief Abstract class for output data
 ///
 /// Classes inherting from this must implement various functions to specify
@@ -40,6 +45,15 @@ class ActAbsOutput {
   /// Method to print out a table of numbers
   virtual void outputTable(ActOutputTable& table) = 0;
 
+  // Methods for writing a table one row at a time (see ActOutputTable::streamTo).
+  // By default, the rows are collected and then written using outputTable.
+  /// Start writing the table, e.g. the column names
+  virtual void beginTable(ActOutputTable& table);
+  /// Write a row of the table; values has one entry per column
+  virtual void outputTableRow(ActOutputTable& table, const double* values);
+  /// Finish writing the table
+  virtual void endTable(ActOutputTable& table);
+
   /// Method to print out data from a graph with information about
   /// a target-product nuclide pair
   virtual void outputGraph(ActNucleiData& data,
@@ -71,6 +85,35 @@ class ActAbsOutput {
 
   ActAbsCalcStatus* getCalcStatus() {return _calcStatus;}
 
+  // Methods used by checkpoints (see ActCheckpoint). By default, checkpoints are not supported.
+  /// Write all output so far to the file and store the state needed to continue it.
+  /// Returns false if this is not possible.
+  virtual bool saveState(std::string& /*state*/) {return false;}
+  /// Re-open the output file at a state stored by saveState, discarding any later output.
+  /// Returns false if this is not possible.
+  virtual bool resumeFile(const std::string& /*state*/) {return false;}
+
+  /// Set the checkpoint pointer (0 if checkpoints are not used)
+  void setCheckpoint(ActCheckpoint* checkpoint) {_checkpoint = checkpoint;}
+  /// Get the checkpoint pointer
+  ActCheckpoint* getCheckpoint() {return _checkpoint;}
+
+  /// Set the shard pointer, if the calculation is split across processes (see ActShard)
+  void setShard(ActShard* shard) {_shard = shard;}
+  /// Get the shard pointer
+  ActShard* getShard() {return _shard;}
+
+  /// Set the store of the cross-sections vs energy, which are either restored from
+  /// an earlier run or stored for later runs (see ActSigmaMatrix)
+  void setSigmaMatrix(ActSigmaMatrix* sigmaMatrix) {_sigmaMatrix = sigmaMatrix;}
+  /// Get the sigma matrix pointer
+  ActSigmaMatrix* getSigmaMatrix() {return _sigmaMatrix;}
+
+  /// Set the Monte Carlo ensemble that the cross-sections are added to (see ActEnsemble)
+  void setEnsemble(ActEnsemble* ensemble) {_ensemble = ensemble;}
+  /// Get the ensemble pointer
+  ActEnsemble* getEnsemble() {return _ensemble;}
+
  protected:
 
   /// The filename of the output
@@ -81,9 +124,20 @@ class ActAbsOutput {
   std::string _typeName;
   /// Pointer to current calculation status for debugging purposes/GUI etc..
   ActAbsCalcStatus* _calcStatus;
+  /// Pointer to the checkpoint of the calculation
+  ActCheckpoint* _checkpoint;
+  /// Pointer to the shard of the calculation
+  ActShard* _shard;
+  /// Pointer to the store of the cross-sections vs energy
+  ActSigmaMatrix* _sigmaMatrix;
+  /// Pointer to the uncertainty ensemble
+  ActEnsemble* _ensemble;
 
  private:
 
+  /// Table used to collect streamed rows for the default beginTable/endTable
+  ActOutputTable* _streamTable;
+
 };
 
 #endif
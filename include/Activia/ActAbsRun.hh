@@ -1,10 +1,13 @@
 #ifndef ACT_ABS_RUN_HH
 #define ACT_ABS_RUN_HH
 
+#include <string>
+
 class ActAbsOutput;
 class ActAbsInput;
 class ActOutputSelection;
 class ActAbsCalcStatus;
+class ActEnsemble;
 
 /// \brief Run all of the isotope production code.
 ///
@@ -30,14 +33,106 @@ public:
   /// Method to perform the calculations and store the output
   void doCalculations();
 
+  /// Perform the calculations using input data that has already been read
+  /// (doCalculations without the call to ActAbsInput::getData). This allows
+  /// the input to be read on one thread and the calculation to run on another.
+  void calculate();
+
+  /// Save checkpoints of the cross-section calculation at least the given number
+  /// of seconds apart, so that an interrupted run can be resumed by running it
+  /// again with the same input (see ActCheckpoint). Negative values, the default,
+  /// switch checkpoints off.
+  void setCheckpointInterval(double seconds) {_checkpointInterval = seconds;}
+
+  /// Only calculate shard iShard (1 to nShards) of the products, writing partial results,
+  /// or merge the partial results of all shards if iShard = 0 (see ActShard).
+  /// The default, nShards = 0, calculates everything in one process.
+  void setShard(int iShard, int nShards) {_iShard = iShard; _nShards = nShards;}
+
+  /// Also calculate the production rates for other beam spectra in the same pass as
+  /// the input beam, given as a comma-separated list of "cosmic" or "gordon", each
+  /// optionally multiplied by a scale factor, e.g. "gordon,cosmic*2.5". The summary
+  /// and decay yields of each spectrum are written to the output files with the
+  /// spectrum name added, e.g. "xSec_GordonSpectrum.out". They are not used with
+  /// shards or checkpoints.
+  void setOtherSpectra(const std::string& spectra) {_otherSpectra = spectra;}
+
+  /// Store the cross-sections of every product at every energy in the file (by default
+  /// the cross-section file name with "_sigma.dat" instead of its extension), keeping
+  /// values of at least minSigma (mb). A later run with the same energies and models
+  /// reads the target-product pairs that are stored, and only calculates the others,
+  /// e.g. for new products or target isotopes, which are added to the file; changes of
+  /// the fractions or the beam spectrum need no calculation (see ActSigmaMatrix). The
+  /// precision is the number of bits of the stored values, 32 (compact) or 64 (the same
+  /// results as a full calculation). This is not used with shards or checkpoints.
+  void setSigmaMatrix(bool useMatrix, const std::string& fileName = "", double minSigma = 0.0,
+		      int precision = 32) {
+    _useSigmaMatrix = useMatrix; _sigmaMatrixFile = fileName; _minSigma = minSigma;
+    _sigmaMatrixPrecision = precision;
+  }
+
+  /// Also calculate an ensemble of nReplicas replicas with perturbed fractions, spectrum
+  /// and models, using the uncertainties given as a list of name:value pairs, the random
+  /// number seed and nThreads threads (0 to use all processors). The statistics of the
+  /// production rates and yields are written to the decay output file name with
+  /// "_Ensemble" added (see ActEnsemble). This is not used with shards, checkpoints
+  /// or the sigma matrix. The default, nReplicas = 0, switches the ensemble off.
+  void setEnsemble(int nReplicas, const std::string& uncertainties = "",
+		   unsigned long long seed = 1, int nThreads = 0) {
+    _nReplicas = nReplicas; _uncertainties = uncertainties; _seed = seed; _nThreads = nThreads;
+  }
+
+  /// Write the JSON report of the run statistics (ActRunStatistics) next to the
+  /// cross-section output file, with "_stats.json" instead of its extension.
+  /// It is not written by default.
+  void setWriteStatistics(bool writeStatistics) {_writeStatistics = writeStatistics;}
+
 protected:
 
   ActAbsInput* _input;
   ActOutputSelection* _outputSelection;
   ActAbsCalcStatus* _calcStatus;
+  double _checkpointInterval;
+  int _nShards, _iShard;
+  std::string _otherSpectra;
+  bool _useSigmaMatrix;
+  std::string _sigmaMatrixFile;
+  double _minSigma;
+  int _sigmaMatrixPrecision;
+  int _nReplicas, _nThreads;
+  std::string _uncertainties;
+  unsigned long long _seed;
+  bool _writeStatistics;
 
   ActAbsOutput* selectXSecOutput();
   ActAbsOutput* selectDecayOutput();
+  /// Create the output class of the given type (ActOutputSelection) for the file
+  ActAbsOutput* createOutput(const std::string& fileName, int type, int levelOfDetail);
+
+  /// Create the other beam spectra given by setOtherSpectra and add them to the input.
+  /// Returns false if a spectrum is not known.
+  bool createOtherSpectra();
+  /// Write the summary and decay yields for each of the other beam spectra
+  void outputOtherSpectra();
+  /// Finish the ensemble and write its statistics
+  void outputEnsemble(ActEnsemble* ensemble);
+  /// The file name with the tag added before its extension
+  std::string getTaggedFileName(const std::string& fileName, const std::string& tag);
+
+  /// Name of a report file (e.g. run statistics), given by the cross-section
+  /// file name with its extension replaced by the suffix
+  std::string getReportFileName(const std::string& suffix);
+  /// The cross-section output file name without its extension
+  std::string getBaseFileName();
+
+  /// Description of the cross-section calculation, used to check that a
+  /// checkpoint or the shard results belong to the current run. The shard
+  /// number is only included in the checkpoint description.
+  std::string getCheckpointKey(bool withShard);
+
+  /// Description of everything that changes the cross-sections vs energy, apart
+  /// from the isotope fractions and the beam spectrum shape, used for the sigma matrix
+  std::string getSigmaMatrixKey();
   
 private:
 
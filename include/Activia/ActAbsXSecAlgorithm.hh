@@ -1,6 +1,10 @@
 #ifndef ACT_ABS_XSEC_ALGORITHM_HH
 #define ACT_ABS_XSEC_ALGORITHM_HH
 
+#include <string>
+#include <vector>
+
+class ActAbsCalcStatus;
 class ActNucleiData;
 class ActTargetNuclide;
 class ActProdNuclideList;
@@ -11,13 +15,17 @@ class ActAbsXSecAlgorithm {
 
  public:
 
-  ActAbsXSecAlgorithm() {_nucleiData = 0;}
+  ActAbsXSecAlgorithm() {_nucleiData = 0; _calcStatus = 0; _recordFactors = false; _usedData = false;}
   virtual ~ActAbsXSecAlgorithm() {;}
 
   /// Set the target and product isotope data that can be used in cross-section
   /// algorithms.
   virtual void setNucleiData(ActNucleiData* data) {_nucleiData = data;}
 
+  /// Set the calculation status, which is checked in the energy loop of
+  /// calcCrossSections so that a stopped calculation ends promptly
+  void setCalcStatus(ActAbsCalcStatus* calcStatus) {_calcStatus = calcStatus;}
+
   // These methods must be implemented
 
   /// All derived classes must implement a way to calculate the cross-sections
@@ -33,12 +41,51 @@ class ActAbsXSecAlgorithm {
   /// Apply any energy selection criteria
   virtual bool passESelection(ActNucleiData* data) = 0;
 
+  /// Calculate the cross-sections for all of the given energies, using the
+  /// current nuclei data. The passed vector stores whether each energy passed
+  /// the energy selection (1) or not (0); the sigma is zero if it did not.
+  /// The loop ends early if the calculation status says to stop running.
+  /// The default implementation calls passESelection and calcCrossSection for
+  /// each energy. Derived classes can override this to provide a faster loop.
+  virtual void calcCrossSections(const std::vector<double>& energies,
+				 std::vector<double>& sigmas, std::vector<int>& passed);
+
+  /// Record, for each energy in calcCrossSections, the factor of the model updates
+  /// included in the cross-section and whether it came from a data table. These are
+  /// used to perturb the models in uncertainty ensembles (see ActEnsemble).
+  void setRecordFactors(bool record) {_recordFactors = record;}
+  /// The update factors (ActNucleiData::getUpdateFactor) of the last calcCrossSections,
+  /// if they are recorded; these are 1 if there are no updates
+  const std::vector<double>& getUpdateFactors() const {return _updateFactors;}
+  /// Whether each cross-section of the last calcCrossSections came from a data table (1)
+  /// or from the model formulae (0), if they are recorded
+  const std::vector<int>& getDataFlags() const {return _dataFlags;}
+  /// The name of the model used for the current nuclei data
+  virtual std::string getModelName() {return "";}
+
+  /// The list of data tables used for the cross-sections, if any
+  virtual std::string getListOfDataTables() {return "";}
+  /// The minimum data cross-section that is used, if there are data tables
+  virtual double getMinDataSigma() {return 0.0;}
+
   /// Retrieve nuclei data pointer
   ActNucleiData* getNucleiData() {return _nucleiData;}
 
  protected:
   
   ActNucleiData* _nucleiData;
+  ActAbsCalcStatus* _calcStatus;
+
+  /// Start recording the factors for the given number of energies
+  void startRecord(int nE);
+  /// Record the factors of the cross-section just calculated for energy bin iE
+  void record(int iE);
+
+  bool _recordFactors;
+  /// Set by calcCrossSection if the last cross-section came from a data table
+  bool _usedData;
+  std::vector<double> _updateFactors;
+  std::vector<int> _dataFlags;
 
  private:
 
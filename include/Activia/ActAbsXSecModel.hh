@@ -35,7 +35,7 @@ class ActAbsXSecModel {
   inline double getCrossSection() {return _sigma;}
 
   /// Reset the name of the model
-  void resetName(std::string name) {_name = name;}
+  void resetName(std::string name);
   /// Set the debugging flag
   void setDebugFlag(int debug) {_debug = debug;}
 
@@ -43,8 +43,14 @@ class ActAbsXSecModel {
   std::string getName() {return _name;}
 
  protected:
+
+  /// Return a factor that only depends on the energy and target (see ActEnergyFactorCache),
+  /// using the cache stored in the nuclei data object if it is available
+  double getEnergyFactor(int factor, ActNucleiData* data);
   
   std::string _name;
+  /// Copy of the name that stays valid for the trace output (see ActTrace)
+  const char* _traceName;
   double _sigma;
   ActFormulae _formulae;
   int _debug;
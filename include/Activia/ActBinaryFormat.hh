@@ -0,0 +1,118 @@
+#ifndef ACT_BINARY_FORMAT_HH
+#define ACT_BINARY_FORMAT_HH
+
+#include <string>
+#include <vector>
+
+/// \brief Definitions and column codecs for the columnar binary output files.
+///
+/// A binary output file starts with the 8 byte magic word "ACTBIN01". It is then
+/// followed by blocks of encoded column data, each one containing up to
+/// RowGroupSize values of one column of a table. The file ends with a footer that
+/// describes all tables: their names, column names and, for each row group, the type,
+/// codec, file offset and size of every column block. The footer is followed by its
+/// offset (8 bytes) and the magic word "ACTBINFT". Lines of text are stored in
+/// the footer as well. All numbers are written in little-endian byte order.
+///
+/// Columns whose values in a row group are all integers are stored as 32-bit
+/// integers, using delta, zig-zag and variable length encoding. Other columns are
+/// stored as doubles, where each value is XORed with the previous one, the bytes are
+/// shuffled so that the n-th bytes of all values are next to each other, and then
+/// run-length encoded (Float32 values are stored in the same way, using 4 bytes per
+/// value). A block is stored without compression if the encoding
+/// does not make it smaller. Decoding always gives the exact values that were written.
+
+class ActBinaryFormat {
+
+ public:
+
+  /// The type of the values in a column block. Float32 is never chosen by
+  /// findColumnType, since it rounds the values; it is used for compact stores.
+  enum ColumnType {Float64 = 0, Int32, Float32};
+
+  /// The encoding of a column block
+  enum Codec {Raw = 0, XorShuffleRLE, DeltaVarint};
+
+  /// The maximum number of rows of a table stored in one block per column
+  enum {RowGroupSize = 65536};
+
+  /// The location of one encoded column block in the file
+  struct ColumnBlock {
+    int type, codec;
+    unsigned long long offset, nBytes;
+  };
+
+  /// A group of rows of a table, with one block per column
+  struct RowGroup {
+    unsigned long long nRows;
+    std::vector<ColumnBlock> blocks;
+  };
+
+  /// The footer index entry for a table
+  struct TableIndex {
+    std::string name;
+    std::vector<std::string> columns;
+    unsigned long long nRows;
+    std::vector<RowGroup> groups;
+  };
+
+  /// The magic word at the start of the file
+  static const char* getHeaderMagic() {return "ACTBIN01";}
+  /// The magic word at the end of the file
+  static const char* getFooterMagic() {return "ACTBINFT";}
+
+  /// Find the best type for the values
+  static int findColumnType(const std::vector<double>& values);
+
+  /// Encode the values using the given type, choosing the codec. Returns the codec.
+  static int encode(const std::vector<double>& values, int type,
+		    std::vector<unsigned char>& bytes);
+
+  /// Decode nValues values from the bytes, which use the given type and codec.
+  /// Returns false if the bytes are not valid.
+  static bool decode(const std::vector<unsigned char>& bytes, int type, int codec,
+		     int nValues, std::vector<double>& values);
+
+  /// Encode the footer index for the tables and lines of text
+  static void encodeFooter(const std::vector<TableIndex>& tables,
+			   const std::vector<std::string>& textLines,
+			   std::vector<unsigned char>& bytes);
+
+  /// Decode the footer index. Returns false if the bytes are not valid.
+  static bool decodeFooter(const std::vector<unsigned char>& bytes,
+			   std::vector<TableIndex>& tables,
+			   std::vector<std::string>& textLines);
+
+  // Little-endian helpers for writing and reading the footer
+  /// Append an unsigned integer of nBytes bytes
+  static void putUInt(std::vector<unsigned char>& bytes, unsigned long long value, int nBytes);
+  /// Append a string, preceded by its length
+  static void putString(std::vector<unsigned char>& bytes, const std::string& value);
+  /// Read an unsigned integer of nBytes bytes at the given position, which is then advanced
+  static bool getUInt(const std::vector<unsigned char>& bytes, size_t& pos,
+		      unsigned long long& value, int nBytes);
+  /// Read a string at the given position, which is then advanced
+  static bool getString(const std::vector<unsigned char>& bytes, size_t& pos,
+			std::string& value);
+
+ protected:
+
+ private:
+
+  static void encodeRaw(const std::vector<double>& values, int type,
+			std::vector<unsigned char>& bytes);
+  static void encodeXorShuffleRLE(const std::vector<double>& values, int type,
+				  std::vector<unsigned char>& bytes);
+  static void encodeDeltaVarint(const std::vector<double>& values,
+				std::vector<unsigned char>& bytes);
+
+  static bool decodeRaw(const std::vector<unsigned char>& bytes, int type,
+			int nValues, std::vector<double>& values);
+  static bool decodeXorShuffleRLE(const std::vector<unsigned char>& bytes, int type,
+				  int nValues, std::vector<double>& values);
+  static bool decodeDeltaVarint(const std::vector<unsigned char>& bytes,
+				int nValues, std::vector<double>& values);
+
+};
+
+#endif
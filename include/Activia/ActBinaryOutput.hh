@@ -0,0 +1,102 @@
+#ifndef ACT_BINARY_OUTPUT_HH
+#define ACT_BINARY_OUTPUT_HH
+
+#include "Activia/ActAbsOutput.hh"
+#include "Activia/ActBinaryFormat.hh"
+#include "Activia/ActAbsGraph.hh"
+#include "Activia/ActNucleiData.hh"
+#include "Activia/ActString.hh"
+#include "Activia/ActOutputTable.hh"
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+/// \brief Store output from the calculations in a columnar binary file.
+///
+/// This does not need any external libraries. Each table is stored column by column,
+/// in row groups of ActBinaryFormat::RowGroupSize rows, and every column block is
+/// compressed separately (see ActBinaryFormat). Graphs are stored in a table with
+/// the graph name and one row per point, with the columns Zt, At, frac, Z, A, the
+/// x axis name and the y axes names, as in the ROOT output. Lines of text are also
+/// kept. The footer index lets ActBinaryReader load only the columns it needs.
+
+class ActBinaryOutput : public ActAbsOutput {
+
+ public:
+
+  /// Constructor, specifying the binary output file name and level of detail
+  ActBinaryOutput(const char* fileName, int levelOfDetail = 0);
+  /// Destructor
+  virtual ~ActBinaryOutput();
+
+  /// Open the output file
+  virtual void openFile();
+  /// Store a line of text in the output file
+  virtual void outputLineOfText(const char* line);
+  /// Store a line of text in the output file
+  virtual void outputLineOfText(std::string& line);
+  /// Store a line of text in the output file
+  virtual void outputLineOfText(ActString& line);
+  /// Store a line of text in the output file
+  virtual void outputLineOfText(std::vector<ActString>& strings);
+
+  /// Write out a table of results to the output file
+  virtual void outputTable(ActOutputTable& table);
+
+  /// Start a table that is streamed row by row
+  virtual void beginTable(ActOutputTable& table);
+  /// Add a row of the streamed table
+  virtual void outputTableRow(ActOutputTable& table, const double* values);
+  /// Finish the streamed table
+  virtual void endTable(ActOutputTable& table);
+
+  /// Write out a graph of results and related nuclei data to the table with the graph name
+  virtual void outputGraph(ActNucleiData& data,
+			   ActAbsGraph& graph);
+
+  /// Write the remaining data and the footer index, then close the output file
+  virtual void closeFile();
+
+  /// Write all complete row groups and store the file length, the index
+  /// and the rows that have not been written yet as the state
+  virtual bool saveState(std::string& state);
+  /// Re-open the file, truncated to the length stored by saveState, and restore the index
+  virtual bool resumeFile(const std::string& state);
+
+  /// Set any writing options
+  virtual void setOptions();
+
+ protected:
+
+  /// Find the table with the given name, or create it if it does not exist.
+  /// Returns -1 if the table exists with different columns.
+  int findTable(const std::string& name, const std::vector<std::string>& columns);
+
+  /// Add a row of values to the table, writing a row group when it is full
+  void addRow(int index, const double* values);
+
+  /// Encode and write the pending rows of the table as a new row group
+  void writeRowGroup(int index);
+
+  /// Write the footer index
+  void writeFooter();
+
+ private:
+
+  std::ofstream _stream;
+  unsigned long long _offset;
+
+  /// The footer index entries of the tables
+  std::vector<ActBinaryFormat::TableIndex> _tables;
+  /// The rows that have not been written yet, stored as _pending[table][column][row]
+  std::vector< std::vector< std::vector<double> > > _pending;
+  std::map<std::string, int> _tableIndex;
+  int _currentTable;
+
+  std::vector<std::string> _textLines;
+
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef ACT_BINARY_READER_HH
+#define ACT_BINARY_READER_HH
+
+#include "Activia/ActBinaryFormat.hh"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+/// \brief Read the tables stored in a columnar binary output file.
+///
+/// The footer index is read when the file is opened. Columns are then loaded
+/// on request, reading only the blocks that belong to them, e.g.
+/// \code
+/// ActBinaryReader reader("xSecOutput.bin");
+/// std::vector<double> sigma;
+/// if (reader.isOpen()) {reader.readColumn("xSecSummary", "TotSigma", sigma);}
+/// \endcode
+
+class ActBinaryReader {
+
+ public:
+
+  /// Open the binary file and read its index
+  ActBinaryReader(const char* fileName);
+  /// Destructor
+  virtual ~ActBinaryReader();
+
+  /// Check if the file is open and has a valid index
+  bool isOpen() const {return _ok;}
+
+  /// Get the names of the tables in the file
+  std::vector<std::string> getTableNames() const;
+
+  /// Get the column names of the table
+  std::vector<std::string> getColumnNames(const std::string& tableName) const;
+
+  /// Get the number of rows of the table
+  unsigned long long getNRows(const std::string& tableName) const;
+
+  /// Read all values of one column of the table. Returns false if the table
+  /// or column does not exist, or if the data can not be read.
+  bool readColumn(const std::string& tableName, const std::string& columnName,
+		  std::vector<double>& values);
+
+  /// Read several columns of the table, stored as values[column][row]
+  bool readColumns(const std::string& tableName, const std::vector<std::string>& columnNames,
+		   std::vector< std::vector<double> >& values);
+
+  /// Get the lines of text stored in the file
+  std::vector<std::string> getTextLines() const {return _textLines;}
+
+ protected:
+
+  /// Read the footer index
+  bool readIndex();
+
+  /// Find the table index, or -1 if it does not exist
+  int findTable(const std::string& tableName) const;
+
+ private:
+
+  std::string _fileName;
+  std::ifstream _stream;
+  bool _ok;
+
+  std::vector<ActBinaryFormat::TableIndex> _tables;
+  std::vector<std::string> _textLines;
+
+};
+
+#endif
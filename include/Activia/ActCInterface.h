@@ -0,0 +1,95 @@
+#ifndef ACT_C_INTERFACE_H
+#define ACT_C_INTERFACE_H
+
+/* C interface to the ACTIVIA cross-section calculations (in libActivia.so),
+   so that other programs can embed them without running bin/Activia.
+
+   A context reads the decay data (and the optional list of data tables) once.
+   Targets are then registered with the context, which returns an index for
+   each, and many cross-sections or production rates are calculated in one call:
+
+     ActContext* context = actCreateContext("decayData.dat", "", 0.0);
+     double A[2] = {63.0, 65.0}, fractions[2] = {0.6917, 0.3083};
+     int target = actAddTarget(context, 29, 2, A, fractions);
+     int Z[1] = {27}; double prodA[1] = {60.0}, E[1] = {100.0}, sigma[1];
+     actCalcSigmas(context, target, 1, Z, prodA, E, sigma);
+     actDestroyContext(context);
+
+   The cross-sections (mb) include the side branches of the product and are
+   summed over the target isotopes weighted by their fractions. The production
+   rates (per kg per day) are the same as in the cross-section summary of a
+   normal run with the same target and spectrum.
+
+   All functions of a context can be called by several threads at the same
+   time; the calls are then done one after the other. Different contexts can
+   be used in parallel. Nothing is written to the standard output or error:
+   failures are reported by the return values and actGetError. */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The version of this interface, which changes if the functions change */
+#define ACT_C_INTERFACE_VERSION 2
+
+/* The spectrum types for actCalcProdRates */
+#define ACT_SPECTRUM_COSMIC 0
+#define ACT_SPECTRUM_GORDON 1
+
+/* The calculation context, which is only used through these functions */
+typedef struct ActContext ActContext;
+
+/* Get the version of the interface in the library */
+int actGetInterfaceVersion(void);
+
+/* Create a context using the decay data file (e.g. "decayData.dat"), the file with
+   the list of data tables (0, "" or "0" for none) and the minimum data cross-section
+   (mb) above which the data tables are used. Returns 0 if the files can not be read. */
+ActContext* actCreateContext(const char* decayDataFile, const char* listOfDataTables,
+			     double minDataXSec);
+
+/* Delete the context and everything it has stored */
+void actDestroyContext(ActContext* context);
+
+/* Register a target element with atomic number Z (> 5) and nIsotopes isotopes,
+   given by their mass numbers and abundance fractions. Returns the index of the
+   target (0, 1, ...), which is the same if the target is registered again,
+   or -1 if it is not valid. */
+int actAddTarget(ActContext* context, int Z, int nIsotopes,
+		 const double* massNumbers, const double* fractions);
+
+/* Calculate the cross-section (mb) of n (product, energy) pairs for a proton beam,
+   where product i has atomic and mass numbers prodZ[i] and prodA[i] and the energy
+   is energies[i] (MeV). The results are stored in sigmas[i]. Products need Z >= 1
+   and a whole number A >= Z. Returns 0 if successful, or -1 if there was an error. */
+int actCalcSigmas(ActContext* context, int target, int n, const int* prodZ,
+		  const double* prodA, const double* energies, double* sigmas);
+
+/* Calculate the cross-section (mb) of one product, with atomic and mass numbers
+   prodZ and prodA, for a proton beam at n energies (MeV) in any order, e.g. those
+   sampled by a Monte Carlo transport code. The results are stored in sigmas[i].
+   This is faster than actCalcSigmas for many energies of the same product.
+   A target with one isotope (fraction 1) gives the isotope cross-sections.
+   Returns 0 if successful, or -1 if there was an error. */
+int actCalcSigmaVsEnergy(ActContext* context, int target, int prodZ, double prodA,
+			 int n, const double* energies, double* sigmas);
+
+/* Calculate the total cross-section (mb, summed over the energy bins) and the
+   production rate (per kg per day) of nProducts products for the spectrum type
+   ACT_SPECTRUM_COSMIC or ACT_SPECTRUM_GORDON with energies from EStart to EEnd
+   (MeV) in steps of dE. The half-lives (days) of the products are also stored
+   if halfLives is not 0. Returns 0 if successful, or -1 if there was an error. */
+int actCalcProdRates(ActContext* context, int target, int spectrumType,
+		     double EStart, double EEnd, double dE, int nProducts,
+		     const int* prodZ, const double* prodA,
+		     double* sigmas, double* prodRates, double* halfLives);
+
+/* Get the message of the last error of the context, or "" if there was none.
+   The text is kept until the next call that uses the context. */
+const char* actGetError(ActContext* context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef ACT_CHECKPOINT_HH
+#define ACT_CHECKPOINT_HH
+
+#include "Activia/ActProdXSecData.hh"
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+class ActAbsOutput;
+
+/// \brief Checkpoints of long cross-section calculations, so that an interrupted
+/// run can be restarted without repeating the completed work.
+///
+/// The checkpoint file stores the total cross-section and production rate of every
+/// product that has been calculated, the position of the calculation (target
+/// isotope and next product) and the state of the cross-section output, which is
+/// obtained from ActAbsOutput::saveState after all output so far has been written.
+/// A checkpoint is saved after each target isotope, and after each chunk of products
+/// when at least the minimum interval has passed since the previous one. When the
+/// cross-sections are complete, a final checkpoint lets a restart go straight to
+/// the decay calculation. The file is written to a temporary file that then
+/// replaces the previous checkpoint, so an interruption while saving is safe.
+///
+/// On restart, the output file is re-opened at the saved state (ActAbsOutput::resumeFile),
+/// discarding anything written after it, and the calculation continues from the
+/// saved position. The final output files are the same as those of an uninterrupted
+/// run. The file also stores a description of the run, and is ignored if this does
+/// not match the current run. It is removed when the run finishes.
+
+class ActCheckpoint {
+
+ public:
+
+  /// Constructor, using the checkpoint file name and the minimum time (seconds)
+  /// between the checkpoints of product chunks
+  ActCheckpoint(const std::string& fileName, double minInterval = 60.0);
+  /// Destructor
+  virtual ~ActCheckpoint();
+
+  /// Set the description of the run, used to check that a checkpoint file
+  /// belongs to the same calculation
+  void setRunKey(const std::string& runKey) {_runKey = runKey;}
+
+  /// Set the number of products in each chunk (default 100)
+  void setChunkSize(int chunkSize) {_chunkSize = chunkSize > 0 ? chunkSize : 1;}
+
+  /// Read the checkpoint file, if it exists. Returns true if the run can be resumed.
+  bool read();
+
+  /// Check if the calculation is resumed from a checkpoint
+  bool isResuming() const {return _resuming;}
+  /// Check if the cross-section calculation was completed before the restart
+  bool isXSecDone() const {return _xSecDone;}
+  /// Get the saved state of the cross-section output
+  const std::string& getOutputState() const {return _outputState;}
+
+  /// Forget the restored checkpoint and start the calculation from the beginning
+  void clear();
+
+  /// Set the target isotope that is being calculated
+  void setTargetIsotope(int iIsotope);
+
+  /// Restore the results of the current target isotope that were calculated before
+  /// the restart. Returns the first product that still needs to be calculated
+  /// (nProducts if the target isotope is complete).
+  int restoreResults(ActProdXSecData::ActProdXSecMap& xSecData,
+		     ActProdXSecData::ActProdIndexMap& products, int nProducts);
+
+  /// Store the total cross-section and production rate of an isotope, calculated
+  /// for product iProduct
+  void addResult(ActNuclide* isotope, double sigma, double prodRate, int iProduct);
+
+  /// The products before iProduct of the current target isotope are complete.
+  /// Saves a checkpoint at the end of a product chunk if enough time has passed.
+  void endProducts(int iProduct, ActAbsOutput* output);
+  /// The current target isotope is complete: save a checkpoint
+  void endTargetIsotope(ActAbsOutput* output);
+  /// All cross-sections and their output are complete: save a checkpoint
+  void endXSections();
+
+  /// The run has finished: remove the checkpoint file
+  void finish();
+
+  /// Get the checkpoint file name
+  std::string getFileName() const {return _fileName;}
+
+  /// The stored result of an isotope, and the number of the product that calculated it
+  struct Result {
+    double z, a, halfLife;
+    double sigma, prodRate;
+    int iProduct;
+  };
+
+  /// Write the results of each target isotope, using the exact (shortest) representation
+  static void writeResults(std::ostream& stream, const std::vector< std::vector<Result> >& results);
+  /// Read the results of each target isotope written by writeResults
+  static bool readResults(std::istream& stream, std::vector< std::vector<Result> >& results);
+  /// Add the results to the cross-section map, in the order of the calculation,
+  /// and their product numbers to the map of products
+  static void fillXSecData(const std::vector<Result>& results, ActProdXSecData::ActProdXSecMap& xSecData,
+			   ActProdXSecData::ActProdIndexMap& products);
+
+ protected:
+
+  /// Write the checkpoint file for the given position and output state
+  bool save(int iTarget, int iProduct, ActAbsOutput* output);
+
+ private:
+
+  std::string _fileName, _runKey;
+  double _minInterval, _lastSave;
+  int _chunkSize;
+  bool _enabled;
+
+  bool _resuming, _xSecDone;
+  int _savedTarget, _savedProduct;
+  std::string _outputState;
+
+  int _iTarget;
+  std::vector< std::vector<Result> > _results;
+
+};
+
+#endif
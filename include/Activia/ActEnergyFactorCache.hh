@@ -0,0 +1,100 @@
+#ifndef ACT_ENERGY_FACTOR_CACHE_HH
+#define ACT_ENERGY_FACTOR_CACHE_HH
+
+#include "Activia/ActFormulae.hh"
+
+#include <string>
+#include <vector>
+
+class ActNucleiData;
+
+/// \brief Table of cross-section factors that only depend on the energy and the target.
+///
+/// Many terms in the Silberberg-Tsao formulae, such as f_2(E), f_22(E, E_0) or E^(2/3),
+/// only depend on the energy and the target isotope, but are recalculated for every
+/// product nuclide. This class evaluates them once for every energy bin (plus E_0 and
+/// 1 GeV, which the models also use) for a given target isotope and energy grid.
+/// The models then retrieve them using the energy bin index stored in ActNucleiData.
+/// Energies that are not in the table are calculated directly. The powers and
+/// exponentials of the energy (E^-0.77, E^(2/3), the fission yield factors, ...) are
+/// filled for all bins with the SIMD array functions of ActFormulae, so they can differ
+/// from the scalar expressions in calcFactor by a few ulp (see ActSIMDMath::checkAccuracy);
+/// the other factors use the same expressions as the models. The number of table
+/// hits and misses is stored for each factor, so that we can see which are worth caching.
+
+class ActEnergyFactorCache {
+
+ public:
+
+  ActEnergyFactorCache();
+  virtual ~ActEnergyFactorCache();
+
+  /// The factors stored in the cache
+  enum Factor {DAC = 0, F1, F2, F2p, F3, F11, F22, F33, F44, Cp,
+	       EPowM077, EPowM026, EPowM025, EGeVPowM23, EPow23, Phi, LogE,
+	       FissAy, FissPow350, FissPow130, FissLogTerm, FissExpAbs, Gauss1230, NFactors};
+
+  /// Calculate all factors for the target stored in the nuclei data object, for
+  /// the given energies. This also sets the cache pointer of the nuclei data.
+  void build(ActNucleiData* data, const std::vector<double>& energies);
+
+  /// Set up the table for the target stored in the nuclei data object and the given
+  /// energies, which can be in any order but must then be used in the same order.
+  /// Each factor is only calculated when it is first used, since arbitrary energies
+  /// (e.g. from a transport code) may only need a few of them. This also sets the
+  /// cache pointer of the nuclei data.
+  void buildList(ActNucleiData* data, const std::vector<double>& energies);
+
+  /// Return the bin index for the given energy, or -1 if it is not in the table
+  int findBin(double energy);
+
+  /// Return the factor for the energy (bin) and target stored in the nuclei data object
+  double getFactor(int factor, ActNucleiData& data);
+
+  /// Calculate the factor directly for the given target and energy
+  static double calcFactor(ActFormulae& formulae, int factor, double at, double zt,
+			   double e, double ezero);
+
+  /// Return the name of the factor
+  static std::string getName(int factor);
+
+  /// Return the number of times the factor was found in the table
+  long getNHits(int factor) const;
+  /// Return the number of times the factor had to be calculated
+  long getNMisses(int factor) const;
+
+  /// Print the hit rates for all factors
+  void print();
+
+  /// Add the hits and misses of all factors to the run statistics (ActRunStatistics)
+  void addToStatistics();
+
+ protected:
+
+ private:
+
+  /// Whether the factor is a power or exponential of the energy that is
+  /// filled for all bins by fillArrayFactors
+  static bool isArrayFactor(int factor);
+  /// Fill the power and exponential factors using the SIMD array functions
+  void fillArrayFactors();
+
+  ActFormulae _formulae;
+
+  int _nE, _nBins;
+  double _EStart, _dE;
+  std::vector<double> _energies;
+
+  /// Factor values, stored as _table[factor*_nBins + bin]
+  std::vector<double> _table;
+  /// For listed energies, whether each table entry has been calculated,
+  /// and the last bin that was found
+  bool _inOrder;
+  std::vector<char> _filled;
+  int _lastBin;
+
+  std::vector<long> _hits, _misses;
+
+};
+
+#endif
@@ -0,0 +1,145 @@
+#ifndef ACT_ENSEMBLE_HH
+#define ACT_ENSEMBLE_HH
+
+#include <map>
+#include <string>
+#include <vector>
+
+class ActAbsOutput;
+class ActBeamSpectrum;
+class ActProdNuclideList;
+class ActTarget;
+class ActTime;
+
+/// \brief Monte Carlo ensemble of perturbed production rates and yields, giving their
+/// uncertainty bands.
+///
+/// Each replica of the ensemble has its own random values of the uncertain inputs:
+/// the isotope fractions (each multiplied by exp(s*x), then normalised to the
+/// original sum), the spectrum normalisation (exp(s*x)) and shape (multiplied by
+/// (E/E_mid)^(s*x), where E_mid is the geometric mean of the energy range), a scale
+/// factor exp(s*x) for each Silberberg-Tsao model and for the data tables, and the
+/// strength of the ActSTSigUpdates corrections, whose factor U becomes U^(1 + s*x).
+/// The x values are standard normal random numbers and s are the uncertainties, which
+/// are set by name ("fractions", "norm", "shape", "updates", "data" and "model" for
+/// all models, or a model name such as "spal" for one model).
+///
+/// All of these only change the weights of the sums over the energies, so the
+/// cross-sections are calculated once, in the normal run, and every row of them
+/// (a product or side branch of a target isotope) is added to all replicas using
+/// the recorded update factors and data table flags (ActAbsXSecAlgorithm::setRecordFactors).
+/// The rows are collected in batches, and each batch is summed for all replicas
+/// using several threads, each with its own range of replicas; the results do not
+/// depend on the number of threads. The random numbers only depend on the seed.
+///
+/// The output has the nominal value, mean, standard deviation and the 5, 16, 50, 84
+/// and 95% quantiles of the total production rate and of the yields at the start and
+/// end of cooling (using the same formulae as ActSimpleDecayAlgorithm) of each product.
+
+class ActEnsemble {
+
+ public:
+
+  /// Constructor, using the number of replicas, the random number seed and the
+  /// number of threads (0 to use the number of processors)
+  ActEnsemble(int nReplicas, unsigned long long seed = 1, int nThreads = 0);
+  /// Destructor
+  virtual ~ActEnsemble();
+
+  /// Set the uncertainties from a comma-separated list of name:value pairs, e.g.
+  /// "norm:0.1,model:0.3,spal:0.5". Returns false if the list is not valid.
+  bool setUncertainties(const std::string& list);
+  /// Set the uncertainty with the given name
+  void setUncertainty(const std::string& name, double value) {_uncertainties[name] = value;}
+  /// Get the uncertainty with the given name, or that of all models for a model name
+  double getUncertainty(const std::string& name) const;
+
+  /// Draw the random values of all replicas for the target isotopes and the energies
+  /// of the beam spectrum, for the number of products
+  void setup(ActTarget* target, ActBeamSpectrum* spectrum, int nProducts);
+
+  /// Set the target isotope whose cross-sections are added
+  void setTargetIsotope(int iIsotope) {_iTarget = iIsotope;}
+
+  /// Add the cross-sections of product iProduct, or one of its side branches, for
+  /// the current target isotope. The factor is the normalisation of the production rate
+  /// (without the fraction), and the update factors and data flags are those recorded
+  /// by the cross-section algorithm for the named model.
+  void addRow(int iProduct, double factor, const std::string& modelName,
+	      const std::vector<double>& sigmas, const std::vector<double>& updateFactors,
+	      const std::vector<int>& dataFlags);
+
+  /// Add any remaining rows to the replicas
+  void finish();
+
+  /// Write the statistics of the production rates and yields of all products
+  void output(ActAbsOutput* output, ActProdNuclideList* prodList, ActTime* times);
+
+  /// Get the number of replicas
+  int getNReplicas() const {return _nReplicas;}
+  /// Get the production rate of a product in a replica
+  double getProdRate(int iReplica, int iProduct) const {return _rates[iReplica][iProduct];}
+  /// Get the nominal production rate of a product
+  double getNominalRate(int iProduct) const {return _nominal[iProduct];}
+
+  /// The quantiles given in the output
+  enum {NQuantiles = 5};
+  /// Get the probability of a quantile
+  static double getQuantileLevel(int iQuantile);
+
+  /// The statistics of the values of a quantity over all replicas
+  struct Statistics {
+    double nominal, mean, sigma;
+    double quantiles[NQuantiles];
+  };
+
+  /// Calculate the statistics of the values, which are sorted
+  static void calcStatistics(std::vector<double>& values, double nominal, Statistics& statistics);
+
+ protected:
+
+  /// A row of cross-sections, stored from the first energy bin with a non-zero value
+  struct Row {
+    int iProduct, iIsotope, iModel;
+    double factor;
+    int first;
+    /// The cross-sections from the data tables and from the models
+    std::vector<double> dataSigmas, modelSigmas;
+    /// The logarithms of the update factors, or one value if it is the same for all energies
+    std::vector<double> logFactors;
+    bool hasData;
+  };
+
+  /// Add the rows of the batch to all replicas
+  void addBatch();
+  /// Add the rows of the batch to the replicas from iFirst to iLast-1
+  void addBatch(int iFirst, int iLast);
+
+  /// Get the index of the model, drawing its scale factors if it is new
+  int getModelIndex(const std::string& modelName);
+
+ private:
+
+  int _nReplicas, _nThreads;
+  unsigned long long _seed;
+  std::map<std::string, double> _uncertainties;
+
+  int _iTarget, _nE;
+  std::vector<double> _nominalFractions;
+
+  // The random values of each replica
+  std::vector< std::vector<double> > _fractions, _weights;
+  std::vector<double> _nominalWeights;
+  std::vector<double> _updateShifts, _dataScales;
+  std::vector<std::string> _modelNames;
+  std::vector< std::vector<double> > _modelScales;
+
+  std::vector<Row> _batch;
+
+  /// The production rate of each product for each replica
+  std::vector< std::vector<double> > _rates;
+  std::vector<double> _nominal;
+
+};
+
+#endif
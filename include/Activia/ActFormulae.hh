@@ -26,7 +26,7 @@ class ActFormulae {
 	     double atbar, double e, double ezero);
 
   /// Calculate Omega (see Table 2 in ST'73 I)
-  double calcOmega(double zp, double ap, std::string formula);
+  double calcOmega(double zp, double ap, const std::string& formula);
   /// Calculate xi (see Table 2 in ST '85)
   double calcXi(double at, double zp, double ap);
 
@@ -70,6 +70,9 @@ class ActFormulae {
   /// Calculate the gamma exponent (Eq 7 in ST'73 II)
   double gamma(double z, double a, double zt, 
 	       double at, double atbar, double e);
+  /// Calculate the gamma exponent given the energy term E^(2/3)
+  double gammaETerm(double z, double a, double zt,
+		    double at, double atbar, double eTerm);
 
   /// Calculate Z given A (see p320 in ST'73 I).
   double zofa(double a);
@@ -79,6 +82,14 @@ class ActFormulae {
   /// Calculate exp(x) safely
   double expfun(double x);
 
+  /// Calculate result[i] = x[i]^n[i] safely for an array of values, using SIMD
+  /// instructions if available (see ActSIMDMath)
+  void power_n(const double* x, const double* n, double* result, int nValues);
+  /// Calculate result[i] = x[i]^n safely for an array of values
+  void power_n(const double* x, double n, double* result, int nValues);
+  /// Calculate result[i] = exp(x[i]) safely for an array of values
+  void expfun_n(const double* x, double* result, int nValues);
+
  protected:
 
  private:
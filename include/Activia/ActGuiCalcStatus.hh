@@ -6,6 +6,7 @@
 #include "Activia/ActAbsCalcStatus.hh"
 #include "Activia/ActQtDebugStream.hh"
 
+#include "QtCore/qelapsedtimer.h"
 #include "QtGui/qwidget.h"
 #include "QtGui/qtextedit.h"
 #include "QtGui/qprogressbar.h"
@@ -14,6 +15,11 @@
 #include "QtGui/qboxlayout.h"
 
 /// \brief Keep track of what has been calculated (cross-sections, yields) - for GUI progress bar
+///
+/// The reports are made on the calculation (worker) thread. They are passed
+/// to the progress bar using queued signals, which are only sent when the
+/// progress has changed by at least 1% or after 100 ms, to avoid flooding
+/// the GUI event loop.
 
 class ActGuiCalcStatus : public QWidget, public ActAbsCalcStatus {
 
@@ -26,6 +32,16 @@ public:
 
   /// Destructor
   virtual ~ActGuiCalcStatus();
+
+signals:
+
+  /// Progress of the calculation, sent from the calculation thread
+  void progressChanged(int value, int maximum);
+
+public slots:
+
+  /// Update the progress bar (on the GUI thread)
+  void setProgress(int value, int maximum);
   
 protected:
   
@@ -43,6 +59,9 @@ protected:
   /// Reset
   virtual void reset();
 
+  /// Send the progress signal, unless it is too soon after the last one
+  void updateProgress(int value, int maximum, bool force = false);
+
 private:
 
   QWidget* _parent;
@@ -58,6 +77,9 @@ private:
   float _xSecFrac, _decayFrac;
   int _xSecTally;
 
+  int _lastValue;
+  QElapsedTimer _lastUpdate;
+
 };
 
 #endif
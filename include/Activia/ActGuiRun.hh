@@ -9,12 +9,17 @@
 #include "QtGui/qdialog.h"
 #include "QtGui/qmenubar.h"
 #include "QtGui/qprogressbar.h"
+#include "QtGui/qpushbutton.h"
+
+class ActGuiWorker;
 
 /// \brief Run all of the isotope production code using a GUI
 ///
 /// All relevent input and output classes as well as the 
 /// cross-section and isotope yield calculations will be called 
-/// here using the abstract ActAbsRun interface.
+/// here using the abstract ActAbsRun interface. The input is read from
+/// the GUI, then the calculations run on a worker thread (ActGuiWorker),
+/// so that the GUI remains responsive and can stop them.
 
 class ActGuiRun : public QDialog, public ActAbsRun {
 
@@ -40,6 +45,8 @@ public slots:
   void runCode();
   /// Stop the calculations
   void stopCode();
+  /// The calculations on the worker thread have finished
+  void codeFinished();
   /// Create pop-up window with brief description about the software
   void about();
   /// Create pop-up window showing the usage license for the code
@@ -58,6 +65,8 @@ private:
 
   QProgressBar* _progressBar;
   ActGuiWindow* _guiWindow;
+  ActGuiWorker* _worker;
+  QPushButton* _runButton;
 
   /// Create the top menu bar for the GUI
   QMenuBar* createMenu();
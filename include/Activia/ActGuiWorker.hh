@@ -0,0 +1,41 @@
+#ifdef ACT_USE_QT
+
+#ifndef ACT_GUI_WORKER_HH
+#define ACT_GUI_WORKER_HH
+
+#include "QtCore/qthread.h"
+
+class ActAbsRun;
+
+/// \brief Thread that runs the calculations for the GUI
+///
+/// The input must already have been read from the GUI (on the GUI thread),
+/// since the thread only calls ActAbsRun::calculate(). The GUI thread stays
+/// responsive and is told when the calculations end by the finished() signal.
+
+class ActGuiWorker : public QThread {
+
+  Q_OBJECT
+
+public:
+
+  /// Constructor, using the run object that performs the calculations
+  ActGuiWorker(ActAbsRun* run, QObject* parent = 0);
+
+  /// Destructor
+  virtual ~ActGuiWorker();
+
+protected:
+
+  /// Perform the calculations on the worker thread
+  virtual void run();
+
+private:
+
+  ActAbsRun* _run;
+
+};
+
+#endif
+
+#endif
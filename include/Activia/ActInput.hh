@@ -41,11 +41,16 @@ class ActInput : public ActAbsInput {
   /// Print out the available calculation options.
   virtual void printOptions(std::ofstream& stream);
 
+  /// Read the answers to the questions from the given stream instead of 
+  /// the standard input, e.g. a std::istringstream of a run file
+  void setInputStream(std::istream& stream) {_in = &stream;}
+
  protected:
 
  private:
 
   std::string _prodDataFile;
+  std::istream* _in;
   void printIntro();
 
 };
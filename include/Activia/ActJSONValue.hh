@@ -0,0 +1,83 @@
+#ifndef ACT_JSON_VALUE_HH
+#define ACT_JSON_VALUE_HH
+
+#include <map>
+#include <string>
+#include <vector>
+
+/// \brief A value read from JSON text: null, true/false, a number, a string,
+/// an array or an object.
+///
+/// This is a small reader for the requests given to the query server
+/// (see ActQueryServer). Numbers are stored as doubles. Strings can use the
+/// standard escape sequences; \\u escapes are converted to UTF-8.
+
+class ActJSONValue {
+
+ public:
+
+  /// The type of the value
+  enum Type {Null = 0, Bool, Number, String, Array, Object};
+
+  /// Constructor (null value)
+  ActJSONValue();
+  /// Destructor
+  virtual ~ActJSONValue();
+
+  /// Read the value from the text. Returns false, with an error message,
+  /// if the text is not valid JSON.
+  bool parse(const std::string& text, std::string& error);
+
+  /// Get the type of the value
+  int getType() const {return _type;}
+  /// Check the type of the value
+  bool isNull() const {return _type == ActJSONValue::Null;}
+  bool isNumber() const {return _type == ActJSONValue::Number;}
+  bool isString() const {return _type == ActJSONValue::String;}
+  bool isArray() const {return _type == ActJSONValue::Array;}
+  bool isObject() const {return _type == ActJSONValue::Object;}
+
+  /// Get the boolean value
+  bool getBool() const {return _bool;}
+  /// Get the number
+  double getNumber() const {return _number;}
+  /// Get the string
+  const std::string& getString() const {return _string;}
+
+  /// Get the number of array entries or object members
+  int size() const;
+  /// Get the array entry, or 0 if it does not exist
+  const ActJSONValue* at(int index) const;
+  /// Get the object member with the given name, or 0 if it does not exist
+  const ActJSONValue* get(const std::string& name) const;
+
+  /// Get the number of the object member, or the default value if it is not a number
+  double getNumber(const std::string& name, double defaultValue) const;
+  /// Get the string of the object member, or the default value if it is not a string
+  std::string getString(const std::string& name, const std::string& defaultValue) const;
+
+  /// Append a string to JSON text, with quotes and escaped characters
+  static void appendString(std::string& text, const std::string& value);
+
+ protected:
+
+  /// Read a value starting at pos, which is then advanced past it
+  bool parseValue(const std::string& text, size_t& pos, std::string& error, int depth);
+  /// Read a quoted string starting at pos
+  static bool parseString(const std::string& text, size_t& pos, std::string& value,
+			  std::string& error);
+  /// Skip white space
+  static void skipSpace(const std::string& text, size_t& pos);
+
+ private:
+
+  int _type;
+  bool _bool;
+  double _number;
+  std::string _string;
+  std::vector<ActJSONValue> _array;
+  std::map<std::string, ActJSONValue> _object;
+
+};
+
+#endif
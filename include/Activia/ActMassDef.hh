@@ -33,6 +33,12 @@ class ActMassDef {
   /// would be calculated as (n,n+3-He).
   double thr(double zt, double at, double mdtgt, double mdprod);
 
+  /// Calculate the threshold energy for zt,at + p -> z,a + p + whatever, given the
+  /// target and product mass excesses. This does not need the mass formula constants,
+  /// so it can be used with the precomputed values from ActNuclideTable.
+  static double calcThreshold(double z, double a, double zt, double at,
+			      double mdtgt, double mdprod);
+
  protected:
 
  private:
@@ -0,0 +1,53 @@
+#ifndef ACT_MODEL_VERSION_HH
+#define ACT_MODEL_VERSION_HH
+
+#include <cstddef>
+#include <string>
+
+class ActXSecEngine;
+
+/// \brief Versions and fingerprints of the cross-section models and input data,
+/// used to find stored results that are no longer valid.
+///
+/// The model version is a number that is incremented by hand whenever the formulae,
+/// their corrections or the spectra are changed. It is the primary check. The model hash is calculated from the cross-sections of a fixed set of
+/// target-product pairs and energies, chosen so that every group of Silberberg-Tsao
+/// formulae is used, together with the fluxes of the bundled spectra. Any change of
+/// the model code, the updates, the spectra or the data tables that changes these
+/// numbers therefore changes the hash; it is a secondary check, since changes that
+/// only affect other pairs or energies are not seen by it.
+/// The input files (decay data, data tables) are hashed using their contents.
+/// All hashes are 64-bit FNV-1a hashes.
+
+class ActModelVersion {
+
+ public:
+
+  /// The version of the cross-section models. Increment it with any change of the
+  /// formulae, their corrections or the spectra that changes the results.
+  enum {ModelVersion = 1};
+
+  /// The starting value of a hash
+  static const unsigned long long EmptyHash = 14695981039346656037ULL;
+
+  /// Calculate the hash of the models using the engine (with its decay data and data tables)
+  static unsigned long long calcModelHash(ActXSecEngine* engine);
+
+  /// Calculate the hash of the contents of the file, or 0 if it can not be read
+  static unsigned long long calcFileHash(const std::string& fileName);
+
+  /// Calculate the hash of the list of data tables and of all of the listed files.
+  /// This is the empty hash if there is no list ("" or "0").
+  static unsigned long long calcDataTablesHash(const std::string& listOfDataTables);
+
+  /// Add the bytes to the hash
+  static void addBytes(unsigned long long& hash, const void* data, size_t nBytes);
+  /// Add the value to the hash
+  static void addDouble(unsigned long long& hash, double value);
+
+  /// Return the hash as 16 hexadecimal digits
+  static std::string toString(unsigned long long hash);
+
+};
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef ACT_NATURAL_ABUNDANCE_HH
+#define ACT_NATURAL_ABUNDANCE_HH
+
+#include <map>
+#include <string>
+#include <vector>
+
+/// \brief Table of the natural isotopic abundances of the stable elements.
+///
+/// The table is read from a text file (by default "abundanceData.dat") where each
+/// line gives the Z and A values of an isotope and its abundance fraction (0 to 1).
+/// Lines starting with the hash (\#) symbol are comments.
+
+class ActNaturalAbundance {
+
+ public:
+
+  /// Constructor
+  ActNaturalAbundance();
+  /// Destructor
+  virtual ~ActNaturalAbundance();
+
+  /// Read the table from the file. Returns false if the file can not be read.
+  bool storeTable(const char* inFileName = "abundanceData.dat");
+
+  /// Get the atomic numbers of all elements in the table, in increasing order
+  std::vector<int> getElements() const;
+
+  /// Get the mass numbers and abundance fractions of the isotopes of element Z.
+  /// Returns false if the element is not in the table.
+  bool getIsotopes(int Z, std::vector<double>& massNumbers,
+		   std::vector<double>& fractions) const;
+
+  /// Get the number of isotopes in the table
+  int getNIsotopes() const;
+
+ protected:
+
+ private:
+
+  /// The (A, fraction) values of the isotopes of each element, in the order of the file
+  std::map<int, std::vector<std::pair<double, double> > > _elements;
+
+};
+
+#endif
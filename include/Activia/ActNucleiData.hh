@@ -8,6 +8,7 @@
 
 class ActNuclide;
 class ActTargetNuclide;
+class ActEnergyFactorCache;
 
 /// \brief Class to hold data values for target and product nuclei.
 ///
@@ -35,8 +36,22 @@ class ActNucleiData : public ActAbsData {
   /// Set the product isotope values
   void setProductData(ActNuclide* product);
 
-  /// Set the energy of the reaction
-  void setEnergy(double e) {_e = e;}
+  /// Set the energy of the reaction. If an energy factor cache is used,
+  /// this also finds the corresponding energy bin
+  void setEnergy(double e);
+
+  /// Set the cache of energy dependent factors for the current target
+  void setEnergyFactorCache(ActEnergyFactorCache* cache) {_eCache = cache; _eBin = -1;}
+  /// Get the cache of energy dependent factors (null if not used)
+  inline ActEnergyFactorCache* getEnergyFactorCache() {return _eCache;}
+  /// Get the energy bin index in the factor cache (-1 if the energy is not in the cache)
+  inline int getEnergyBin() {return _eBin;}
+
+  /// Set the factor of the Silberberg-Tsao updates (ActSTSigUpdates) that was
+  /// included in the last cross-section (1 if there were none)
+  void setUpdateFactor(double factor) {_updateFactor = factor;}
+  /// Get the factor of the updates included in the last cross-section
+  inline double getUpdateFactor() {return _updateFactor;}
 
   /// Set the target isotope fraction (between 0 and 1)
   void setFraction(double frac) {_fraction = frac;}
@@ -114,6 +129,8 @@ class ActNucleiData : public ActAbsData {
   inline double getx() {return _x;}
   /// Get the value of y: (Z_t - Z + 1)
   inline double gety() {return _y;}
+  /// Get the pairing classification (ActClassify::pairing enum) of the product isotope
+  inline int getioe() {return _ioe;}
   /// Get the integer value of x
   inline int getix() {return _ix;}
   /// Get the integer value of y
@@ -153,12 +170,16 @@ class ActNucleiData : public ActAbsData {
   int _izt, _iat, _iz, _ia;
 
   double _nt, _n, _dnpt, _dnp;
-  int _int, _in, _idnpt, _idnp;
+  int _int, _in, _idnpt, _idnp, _ioe;
 
   double _x, _y;
   int _ix, _iy, _ichg;
 
   double _mdtgt, _thrse;
+  double _updateFactor;
+
+  ActEnergyFactorCache* _eCache;
+  int _eBin;
 
 };
 
@@ -6,6 +6,7 @@
 class ActNuclide;
 
 #include <map>
+#include <mutex>
 
 /// \brief A factory class for creating nuclear isotope objects
 ///
@@ -13,6 +14,7 @@ class ActNuclide;
 /// method whereby if the required isotope already exists it returns the pre-existing pointer
 /// and does not create a new object. This significantly saves on memory use, and avoids 
 /// the need to continually create new isotope objects whenever they are used throughout the code.
+/// The factory can be used by several threads at the same time.
 
 class ActNuclideFactory {
 
@@ -37,6 +39,7 @@ class ActNuclideFactory {
  private:
 
   ActFactoryMap _map;
+  std::mutex _mutex;
 
 };
 
@@ -0,0 +1,72 @@
+#ifndef ACT_NUCLIDE_TABLE_HH
+#define ACT_NUCLIDE_TABLE_HH
+
+#include "Activia/ActClassify.hh"
+
+#include <vector>
+
+/// \brief Precomputed table of nuclide properties that only depend on Z and A.
+///
+/// The mass excess (ActMassDef), the Z,N pairing classification (ActClassify)
+/// and the critical energy E0 are needed for every target-product pair, but
+/// only depend on the integer Z and A values. They are calculated once per
+/// application for all nuclides up to MaxZ and MaxA, and are then retrieved
+/// using the nuclide id = Z*(MaxA+1) + A. Values outside the table range, or
+/// for non-integer Z,A, are calculated directly so that the results are the
+/// same as using ActMassDef and ActClassify.
+
+class ActNuclideTable {
+
+ public:
+
+  ActNuclideTable();
+  virtual ~ActNuclideTable();
+
+  /// Get a static instance of the table. Only one is created per application.
+  static ActNuclideTable* getInstance();
+
+  /// The maximum atomic and mass numbers stored in the table
+  enum TableRange {MaxZ = 120, MaxA = 300};
+
+  /// Return the nuclide id for the given Z and A, or -1 if it is outside the table
+  static inline int getId(int iz, int ia) {
+    if (iz < 0 || ia < 0 || iz > MaxZ || ia > MaxA || iz > ia) {return -1;}
+    return iz*(MaxA+1) + ia;
+  }
+
+  /// Return the pairing classification (ActClassify::pairing enum) for the given A and Z.
+  /// This only depends on whether A and Z are even or odd, and so is evaluated at compile time
+  /// whenever the arguments are constants.
+  static constexpr int getPairing(int ia, int iz) {
+    return _pairing[ia & 1][iz & 1];
+  }
+
+  /// Return the mass excess (ActMassDef::calcDelta) for the given Z and A
+  double getMassExcess(double z, double a);
+
+  /// Return the critical energy E0 (MeV) for the given target mass number,
+  /// above which cross-sections are approximately independent of energy
+  double getEZero(double at);
+
+  /// Calculate the critical energy E0 (MeV) for the given target mass number
+  static double calcEZero(double at);
+
+ protected:
+
+  /// Check if the Z or A value is a whole number, which can be used as a table index
+  inline bool isInteger(double x, int ix) {return (x == (double) ix);}
+
+ private:
+
+  void setUp();
+
+  /// Pairing classification indexed by [A is odd][Z is odd]
+  static constexpr int _pairing[2][2] = {{ActClassify::EvenEven, ActClassify::OddOdd},
+					 {ActClassify::EvenOdd, ActClassify::OddEven}};
+
+  std::vector<double> _massExcess;
+  std::vector<double> _eZero;
+
+};
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef ACT_NUMBER_FORMAT_HH
+#define ACT_NUMBER_FORMAT_HH
+
+#include <string>
+
+/// \brief Fast, locale independent conversion of numbers to text.
+///
+/// Numbers are converted using std::to_chars into a reusable buffer and appended
+/// to a string, optionally left-justified within a fixed width. The Stream mode
+/// gives exactly the same text as writing the number to an iostream with the
+/// default floating point format and the same precision (i.e. printf("%g")),
+/// which is what the text output has always used. Shortest uses the shortest
+/// text that reads back as the same double, while Fixed writes the given number
+/// of decimal places.
+
+class ActNumberFormat {
+
+ public:
+
+  /// The formatting modes for doubles
+  enum Mode {Stream = 0, Shortest, Fixed};
+
+  /// Construct a formatter using the given mode and precision
+  ActNumberFormat(int mode = ActNumberFormat::Stream, int precision = 6);
+  virtual ~ActNumberFormat();
+
+  /// Set the formatting mode
+  void setMode(int mode) {_mode = mode;}
+  /// Get the formatting mode
+  int getMode() const {return _mode;}
+
+  /// Set the precision: significant figures for Stream, decimal places for Fixed
+  void setPrecision(int precision) {_precision = precision;}
+  /// Get the precision
+  int getPrecision() const {return _precision;}
+
+  /// Append the double to the string, padded with spaces on the right up to width
+  void append(std::string& text, double value, int width = 0);
+  /// Append the integer to the string, padded with spaces on the right up to width
+  void append(std::string& text, int value, int width = 0);
+
+  /// Append the text, padded with spaces on the right up to width
+  static void append(std::string& text, const char* word, int width = 0);
+  /// Append the text, padded with spaces on the right up to width
+  static void append(std::string& text, const std::string& word, int width = 0);
+
+  /// Return the double as a string
+  std::string toString(double value);
+  /// Return the integer as a string
+  std::string toString(int value);
+
+ protected:
+
+  /// Pad the string with spaces if the appended length is less than width
+  static void pad(std::string& text, size_t length, int width);
+
+ private:
+
+  int _mode, _precision;
+
+  /// Reusable conversion buffer, large enough for any double in all modes
+  char _buffer[512];
+
+};
+
+#endif
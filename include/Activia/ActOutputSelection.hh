@@ -17,9 +17,10 @@ class ActOutputSelection {
   virtual ~ActOutputSelection();
 
   /// Allowed output types
-  enum OutputTypes {Stream = 0, ROOT};
-  /// Level of detail
-  enum LevelOfDetail {Summary = 0, All};
+  enum OutputTypes {Stream = 0, ROOT, Binary};
+  /// Level of detail. Sparse is the same as All, except that the energy graphs
+  /// only contain the energy range with non-zero values (see ActAbsGraph::setGrid)
+  enum LevelOfDetail {Summary = 0, All, Sparse};
 
   /// Methods to set the output filenames, types and level of detail
 
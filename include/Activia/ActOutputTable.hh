@@ -6,9 +6,16 @@
 #include <vector>
 #include <string>
 
+class ActAbsOutput;
+
 /// \brief A class for defining an output table
 ///
 /// This stores column names and rows of doubles in a table format.
+/// The rows are stored contiguously, with a fixed number of values (columns) per row.
+/// Alternatively, the table can stream its rows to an output object: after
+/// calling streamTo, addRow passes each row straight to the output, without storing
+/// it, and endStream finishes the table. This keeps the memory use bounded for
+/// large tables.
 
 class ActOutputTable {
 
@@ -29,10 +36,22 @@ class ActOutputTable {
   /// Add a row of numbers. The number of values in the row should match the number of columns.
   void addRow(std::vector<double>& values);
 
-  /// Get all available rows of data
-  std::vector< std::vector <double> > getRows() {return _rows;}
+  /// Start streaming the rows to the output object, which writes the column names.
+  /// Any rows already stored in the table are written first.
+  void streamTo(ActAbsOutput* output);
+  /// Finish streaming the rows to the output object
+  void endStream();
+  /// Check if the rows are streamed to an output object
+  bool isStreaming() const {return _sink != 0;}
+
+  /// Get all available rows of data (copies the table)
+  std::vector< std::vector <double> > getRows();
   /// Get the specific row of data
   std::vector<double> getRow(int index);
+  /// Get a pointer to the values of the given (stored) row, or 0 if the index is out of range
+  const double* getRowData(int index) const;
+  /// Get the number of stored rows
+  int getNRows() const {return _nRows;}
   /// Get all of the column names
   std::vector<ActString> getColumnNames() {return _columnNames;}
 
@@ -54,9 +73,12 @@ class ActOutputTable {
 
   std::string _name;
   std::vector<ActString> _columnNames;
-  std::vector<std::vector <double> > _rows;
+  /// Row values, stored as _values[row*_nColumns + column]
+  std::vector<double> _values;
+
+  int _nRows, _nColumns, _colWidth;
 
-  int _nColumns, _colWidth;
+  ActAbsOutput* _sink;
 
 };
 
@@ -45,6 +45,8 @@ class ActProdNuclideList {
   void cleanUp();
   /// Set the debug output flag
   void setDebugFlag(int flag) {_debug = flag;}
+  /// Set whether storeTable prints information messages (default true)
+  void setVerbose(bool verbose) {_verbose = verbose;}
 
   /// Get the number of product nuclides stored in the internal vector
   inline int getNProdNuclides() {return _nProdNuclides;}
@@ -60,6 +62,7 @@ class ActProdNuclideList {
 
   std::vector<ActProdNuclide*> _prodNuclides;
   int _nProdNuclides, _debug;
+  bool _verbose;
   std::string _inFileName;
 
 };
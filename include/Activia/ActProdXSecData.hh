@@ -9,6 +9,7 @@
 #include "Activia/ActNuclide.hh"
 
 #include <map>
+#include <vector>
 
 class ActBeamSpectrum;
 class ActProdNuclideList;
@@ -48,11 +49,16 @@ class ActProdXSecData {
 
   /// A typedef to define a map of product isotopes and cross-section graphs (sigma vs energy)
   typedef std::map<ActNuclide*, ActXSecGraph, ActPtrLess> ActProdXSecMap;
+  /// A typedef to define a map of isotopes and the number of the product that stored their graph
+  typedef std::map<ActNuclide*, int, ActPtrLess> ActProdIndexMap;
 
   // Accessors
   /// Get the full cross-section data: a map associating the cross-section graphs for
   /// all possible product isotopes, given the target isotope specified in the constructor.
   ActProdXSecMap getXSecData() {return _xSecData;}
+  /// Get the number of the product (in the product list) whose calculation stored
+  /// each cross-section graph, which is the product itself or one with it as a side branch
+  ActProdIndexMap getXSecProducts() {return _xSecProducts;}
 
   /// Get the target isotope
   ActTargetNuclide* getTargetNuclide() {return _targetIsotope;}
@@ -63,7 +69,21 @@ class ActProdXSecData {
   /// Get the cross-section algorithm
   ActAbsXSecAlgorithm* getXSecAlgorithm() {return _algorithm;}
 
+  /// Set other beam spectra (with the same energies as the input beam), whose
+  /// production rates are calculated in the same energy loop as those of the input beam
+  void setOtherSpectra(const std::vector<ActBeamSpectrum*>& spectra) {_otherSpectra = spectra;}
+  /// Get the number of spectra: the input beam and the other spectra
+  int getNSpectra() {return (int) _otherSpectra.size() + 1;}
+  /// Set the production rates of the stored graphs to those of the given spectrum,
+  /// where 0 is the input beam and 1 to getNSpectra()-1 are the other spectra
+  void useSpectrum(int iSpectrum);
+
  protected:
+
+  /// Add the points in the range with non-zero y values to the graph, and set its
+  /// grid description using the start energy and spacing of all points
+  void addNonZeroPoints(ActXSecGraph& graph, std::vector<ActGraphPoint>& points,
+			double EStart, double dE);
   
  private:
 
@@ -72,8 +92,13 @@ class ActProdXSecData {
   ActBeamSpectrum* _inputBeam;
   ActAbsXSecAlgorithm* _algorithm;
 
+  std::vector<ActBeamSpectrum*> _otherSpectra;
+
   // Store XSecGraphs for all product nuclei as well as side branches
   ActProdXSecMap _xSecData;
+  ActProdIndexMap _xSecProducts;
+  // The production rates for all spectra, if there are other spectra
+  std::map<ActNuclide*, std::vector<double>, ActPtrLess> _prodRates;
   ActAbsOutput* _output;
 
 };
@@ -0,0 +1,143 @@
+#ifndef ACT_PRODUCTION_LIBRARY_HH
+#define ACT_PRODUCTION_LIBRARY_HH
+
+#include "Activia/ActXSecEngine.hh"
+
+#include <iosfwd>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+class ActJSONValue;
+
+/// \brief Prebuilt library of total cross-sections and production rates for every
+/// stable isotope, so that material questions are answered without any calculation.
+///
+/// The library is built by running ActXSecEngine for every isotope in the table of
+/// natural abundances (ActNaturalAbundance, Z = 6 to 83), with every product of the
+/// decay data, for the cosmic ray (ActCosmicSpectrum) and Gordon (ActGordonSpectrum)
+/// spectra on a common energy grid. Each isotope is calculated with fraction 1 in a
+/// target made of the natural isotopes of its element (the formulae use their median A),
+/// and only the products with a non-zero cross-section are kept.
+///
+/// The library file starts with the magic word "ACTLIB01", followed by a header with
+/// the format version, the model version, the hashes of the models, decay data and data tables
+/// (ActModelVersion), the energy grid and the spectrum names. The header ends with an
+/// index giving the Z, A, natural abundance and the position of the entries of each
+/// isotope, which are then stored sorted by the product Z and A. All numbers are
+/// written in little-endian byte order (see ActBinaryFormat).
+///
+/// The cross-section of a target is the sum of the isotope cross-sections weighted by
+/// their fractions, as in the xSecSummary table of a complete run; the production rate
+/// is the same weighted sum, since it is linear in the fractions. The results agree
+/// with a direct calculation to rounding when the target has the natural isotopes (with
+/// any fractions); for other sets of isotopes they are an approximation. Materials given as mass fractions of
+/// natural elements use the same sums, weighted by the mass fractions. Questions are
+/// answered with the same JSON requests as ActQueryServer, where the target isotopes
+/// are optional (natural abundances are then used) and the spectrum only needs its type.
+
+class ActProductionLibrary {
+
+ public:
+
+  /// Constructor
+  ActProductionLibrary();
+  /// Destructor
+  virtual ~ActProductionLibrary();
+
+  /// The version of the file format
+  enum {FormatVersion = 2};
+
+  /// The spectra stored in the library
+  enum Spectrum {Cosmic = 0, Gordon, NSpectra};
+
+  /// The total cross-section (mb) of a product, and its production rate
+  /// (per kg per day) for each spectrum
+  struct Entry {
+    int z;
+    double a;
+    double halfLife;
+    double sigma;
+    double prodRates[NSpectra];
+  };
+
+  /// A target isotope, with its natural abundance and its products sorted by Z and A
+  struct Isotope {
+    int z;
+    double a;
+    double fraction;
+    std::vector<Entry> entries;
+  };
+
+  /// Calculate the library for all isotopes of the abundance table, for a proton
+  /// beam with energies from EStart to EEnd (MeV) in steps of dE, using nThreads
+  /// threads (0 to use the number of processors). Returns false if the input files
+  /// can not be read.
+  bool build(const char* decayDataFile, const char* listOfDataTables, double minDataXSec,
+	     const char* abundanceFile, double EStart, double EEnd, double dE,
+	     int nThreads = 0);
+
+  /// Write the library file. Returns false if it can not be written.
+  bool write(const std::string& fileName) const;
+  /// Read the library file. Returns false if it can not be read or is not valid.
+  bool read(const std::string& fileName);
+
+  /// Check that the library was made with the current models and the given input
+  /// data, otherwise its entries are stale. The reason is given if they are not.
+  bool isCurrent(const char* decayDataFile, const char* listOfDataTables,
+		 double minDataXSec, std::string& reason) const;
+
+  /// Get the sums for a target element Z with the given isotopes and fractions (the
+  /// natural ones if massNumbers is empty), weighted by the factor, for the spectrum.
+  /// The sums are added to the totals of each product, which are created for all
+  /// products if allProducts is true. Returns false (and the error) if an isotope
+  /// is not in the library.
+  bool addTarget(int Z, const std::vector<double>& massNumbers,
+		 const std::vector<double>& fractions, int spectrum, double weight,
+		 bool allProducts,
+		 std::map<std::pair<int, double>, ActXSecEngine::Product>& totals,
+		 std::string& error) const;
+
+  /// Answer one request (a line of JSON text) from the library
+  std::string answer(const std::string& request) const;
+
+  /// Answer the requests read from the input stream, one per line, writing the
+  /// answers to the output stream, until the end of the input
+  void serveStream(std::istream& input, std::ostream& output) const;
+
+  /// Get the number of target isotopes
+  int getNIsotopes() const {return (int) _isotopes.size();}
+  /// Get the total number of product entries
+  int getNEntries() const;
+  /// Get the isotope with the given Z and A, or 0 if it is not in the library
+  const Isotope* getIsotope(int Z, double A) const;
+
+  /// Get the name of the spectrum
+  static std::string getSpectrumName(int spectrum);
+
+ protected:
+
+  /// Calculate the entries of the isotope using the engine
+  void calcIsotope(ActXSecEngine* engine, Isotope& isotope);
+
+  /// Answer a production request
+  bool answerProduction(const ActJSONValue& request, std::string& answer,
+			std::string& error) const;
+
+ private:
+
+  unsigned long long _modelVersion;
+  unsigned long long _modelHash, _decayDataHash, _dataTablesHash;
+  double _minDataXSec, _EStart, _EEnd, _dE;
+
+  /// The isotopes, using their Z and A values as the key
+  std::map<std::pair<int, double>, Isotope> _isotopes;
+
+  /// For writing messages from several threads while building
+  std::mutex _messageMutex;
+
+};
+
+#endif
@@ -5,12 +5,16 @@
 
 #include <ostream>
 #include <fstream>
+#include <mutex>
 #include <streambuf>
 #include <string>
 
 #include "QtGui/qtextedit.h"
 
 /// \brief Redirect output such as cout to a QTextEdit object in Qt
+///
+/// The output can be written from any thread. Each line is appended to the
+/// QTextEdit in the thread that owns it, using a queued call when needed.
 
 class ActQtDebugStream : public std::basic_streambuf<char> {
 
@@ -30,11 +34,15 @@ protected:
   /// controlled by the stream buffer
   virtual std::streamsize xsputn(const char *p, std::streamsize n);
 
+  /// Append a line to the QTextEdit, in the thread that owns it
+  void appendLine(const std::string& line);
+
 private:
 
  std::ostream &m_stream;
  std::streambuf *m_old_buf;
  std::string m_string;
+ std::mutex m_mutex;
 
  QTextEdit* log_window;
 
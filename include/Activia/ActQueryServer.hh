@@ -0,0 +1,139 @@
+#ifndef ACT_QUERY_SERVER_HH
+#define ACT_QUERY_SERVER_HH
+
+#include "Activia/ActXSecEngine.hh"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+class ActJSONValue;
+class ActProdNuclideList;
+
+/// \brief Answer many small production questions in one long-running process.
+///
+/// The decay data and the list of data tables are read once, when the server is
+/// created. Each request is one line of JSON text and gets one line of JSON text as
+/// its answer, which has the same "id" as the request. For example
+///
+///   {"id": 1, "target": {"Z": 29, "isotopes": [[63, 0.6917], [65, 0.3083]]},
+///    "spectrum": {"type": "cosmic", "EStart": 10, "EEnd": 1e5, "dE": 10},
+///    "products": [[27, 60], [25, 54]]}
+///
+/// is answered by
+///
+///   {"id":1,"results":[{"Z":27,"A":60,"halfLife":1925.2,"sigma":...,"prodRate":...},...],
+///    "cached":0,"time":...}
+///
+/// where sigma (mb) and prodRate (per kg per day) are the values of the xSecSummary
+/// table of a complete run. The spectrum type can be "cosmic" (default) or "gordon".
+/// The requests {"command": "ping"} and {"command": "shutdown"} are also understood.
+/// Invalid requests are answered with an "error" message.
+///
+/// Requests are answered concurrently by a pool of threads, each with its own
+/// ActXSecEngine, so the answers can be written in a different order than the
+/// requests. The engines keep the models, data tables and targets between requests,
+/// and the answer for each target, spectrum and product is also kept, so repeated
+/// questions are not calculated again.
+
+class ActQueryServer {
+
+ public:
+
+  /// Constructor, using the decay data file, the file with the list of data tables
+  /// ("" or "0" for none), the minimum data cross-section (mb) and the number of
+  /// threads (0 to use the number of processors)
+  ActQueryServer(const char* decayDataFile = "decayData.dat", const char* listOfDataTables = "",
+		 double minDataXSec = 0.0, int nThreads = 0);
+  /// Destructor
+  virtual ~ActQueryServer();
+
+  /// Answer the requests read from the input stream, one per line, writing the
+  /// answers to the output stream, until the end of the input
+  void serveStream(std::istream& input, std::ostream& output);
+
+  /// Answer the requests sent to a Unix domain socket with the given path. Each
+  /// connection can send any number of requests. Returns when a shutdown request
+  /// has been received, or false if the socket could not be created.
+  bool serveSocket(const std::string& path);
+
+  /// Answer one request using the given engine
+  std::string answer(const std::string& request, ActXSecEngine* engine);
+
+  /// Stop serving requests
+  void stop();
+
+  /// Set the maximum number of answers kept for repeated questions (default 100000)
+  void setMaxCacheSize(size_t maxSize) {_maxCacheSize = maxSize;}
+
+  /// Get the number of threads answering requests
+  int getNThreads() const {return (int) _engines.size();}
+
+  /// Where the answers of the requests are written
+  struct Connection {
+    Connection(std::ostream* stream, int fd);
+    ~Connection();
+    /// Write a line of text
+    void writeLine(const std::string& line);
+    std::ostream* stream;
+    int fd;
+    std::mutex mutex;
+  };
+
+ protected:
+
+  /// A request and where its answer is written
+  struct Job {
+    std::string request;
+    std::shared_ptr<Connection> connection;
+  };
+
+  /// Start the threads that answer the requests
+  void startWorkers();
+  /// Wait for all requests to be answered and stop the threads
+  void stopWorkers();
+  /// Add a request to the queue
+  void addJob(const std::string& request, std::shared_ptr<Connection> connection);
+  /// Answer the requests in the queue using the given engine (worker thread)
+  void work(ActXSecEngine* engine);
+
+  /// Read the requests of a socket connection (reader thread)
+  void readConnection(int fd);
+
+  /// Answer a production request
+  bool answerProduction(const ActJSONValue& request, ActXSecEngine* engine,
+			std::string& answer, std::string& error);
+
+ private:
+
+  ActProdNuclideList* _prodList;
+  std::vector<ActXSecEngine*> _engines;
+
+  std::vector<std::thread> _workers;
+  std::mutex _queueMutex;
+  std::condition_variable _queueCondition;
+  std::deque<Job> _jobs;
+  bool _finished;
+
+  /// The answers for each target, spectrum and product
+  std::map<std::string, ActXSecEngine::Product> _cache;
+  std::mutex _cacheMutex;
+  size_t _maxCacheSize;
+
+  /// The listening socket and the open connections
+  int _listenFd;
+  std::set<int> _connections;
+  std::mutex _connectionMutex;
+  std::atomic<bool> _stopping;
+
+};
+
+#endif
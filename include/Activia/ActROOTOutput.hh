@@ -43,6 +43,13 @@ class ActROOTOutput : public ActAbsOutput {
   /// Write out a table of results to the output file
   virtual void outputTable(ActOutputTable& table);
 
+  /// Create the ntuple for a table that is streamed row by row
+  virtual void beginTable(ActOutputTable& table);
+  /// Fill the ntuple with a row of the streamed table
+  virtual void outputTableRow(ActOutputTable& table, const double* values);
+  /// Finish the ntuple of the streamed table
+  virtual void endTable(ActOutputTable& table);
+
   /// Write out a graph of results and related nuclei data to the appropriate ntuple
   virtual void outputGraph(ActNucleiData& data,
 			   ActAbsGraph& graph);
@@ -64,6 +71,10 @@ class ActROOTOutput : public ActAbsOutput {
   TTree* _currentTree;
   int _nTrees;
 
+  /// The ntuple and branch values of the table being written
+  TTree* _tableTree;
+  std::vector<double> _tableValues;
+
 };
 
 #endif
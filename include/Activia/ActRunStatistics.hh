@@ -0,0 +1,119 @@
+#ifndef ACT_RUN_STATISTICS_HH
+#define ACT_RUN_STATISTICS_HH
+
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/// \brief Record the wall and CPU time of the calculation phases, as well as
+/// the number of cross-section evaluations for each model and the hit rates
+/// of the cached energy factors.
+///
+/// This is a singleton that sits alongside ActAbsCalcStatus. Phases are timed
+/// using startPhase and stopPhase with the phase name, e.g. "tableLoad",
+/// "xSec:52:120" (target isotope Z = 52, A = 120), "decay" and "output".
+/// Phases can be nested; the output phase time is also included in the
+/// cross-section and decay phases that write the output. At the end of the
+/// run, finalise() writes a JSON report to the report file (if it is set).
+
+class ActRunStatistics {
+
+ public:
+
+  /// Get the run statistics object
+  static ActRunStatistics* getInstance();
+
+  virtual ~ActRunStatistics();
+
+  /// Start timing the named phase
+  void startPhase(const std::string& name);
+  /// Stop timing the named phase, adding the elapsed time to its total
+  void stopPhase(const std::string& name);
+
+  /// Add the number of cross-section evaluations done by the named model,
+  /// together with the wall time (seconds) that they took
+  void addSigmaEvaluations(const std::string& model, unsigned long nEvaluations,
+			   double wallTime);
+
+  /// Add the number of times the named cached value was found (nHits) or
+  /// had to be calculated (nMisses)
+  void addCacheLookups(const std::string& name, unsigned long nHits, unsigned long nMisses);
+
+  /// Get the total wall time (seconds) of the named phase
+  double getWallTime(const std::string& name);
+  /// Get the total CPU time (seconds) of the named phase
+  double getCPUTime(const std::string& name);
+  /// Get the number of cross-section evaluations of the named model
+  unsigned long getNSigmaEvaluations(const std::string& model);
+  /// Get the number of cache hits of the named value
+  unsigned long getNCacheHits(const std::string& name);
+
+  /// Set the name of the file used for the JSON report
+  void setReportFileName(const std::string& fileName) {_reportFileName = fileName;}
+  /// Get the name of the JSON report file
+  std::string getReportFileName() {return _reportFileName;}
+
+  /// Write the JSON report to the given stream
+  void writeReport(std::ostream& stream);
+
+  /// Stop any running phases and write the report file
+  void finalise();
+
+  /// Clear all phase times and counters
+  void reset();
+
+  /// Current wall clock time (seconds)
+  static double wallClock();
+  /// CPU time used by the process (seconds)
+  static double cpuClock();
+
+ protected:
+
+  /// Constructor, use getInstance()
+  ActRunStatistics();
+
+  /// Time information for one phase
+  struct Phase {
+    unsigned long nCalls;
+    double wallTime, cpuTime;
+    double wallStart, cpuStart;
+    int depth;
+  };
+
+  /// Evaluation counter for one cross-section model
+  struct Counter {
+    unsigned long nEvaluations;
+    double wallTime;
+  };
+
+  /// Hit and miss counter for one cached value
+  struct Lookups {
+    unsigned long nHits, nMisses;
+  };
+
+  /// Find the phase, creating it if required
+  Phase& findPhase(const std::string& name);
+
+  /// Write the text within quotes, escaping special characters
+  void writeString(std::ostream& stream, const std::string& text);
+
+ private:
+
+  std::map<std::string, Phase> _phases;
+  /// Phase names in the order that they were first started
+  std::vector<std::string> _phaseNames;
+
+  std::map<std::string, Counter> _counters;
+
+  /// Cache lookups of each value, in the order that they were first added
+  std::map<std::string, Lookups> _lookups;
+  std::vector<std::string> _lookupNames;
+
+  std::string _reportFileName;
+  std::mutex _mutex;
+
+};
+
+#endif
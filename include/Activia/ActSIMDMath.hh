@@ -0,0 +1,60 @@
+#ifndef ACT_SIMD_MATH_HH
+#define ACT_SIMD_MATH_HH
+
+#include <string>
+
+/// \brief Array versions of the ActFormulae power and expfun functions.
+///
+/// The kernels use AVX-512 or AVX2 instructions if the CPU supports them,
+/// otherwise a portable scalar loop is used. The instruction set is chosen
+/// at run time, so the library does not need to be compiled with any special
+/// architecture flags. The NaN guards of ActFormulae::power and expfun are kept:
+/// any value that would need them (x <= 0, |x| < 1e-30, non-finite input or
+/// output) is calculated using the scalar function. Otherwise, the vectorised exp
+/// agrees with the scalar version to 1 ulp, while x^n = exp(n log x) has a relative
+/// accuracy of about |n log x|*1e-16, i.e. better than 1e-14 for the ST formulae.
+
+class ActSIMDMath {
+
+ public:
+
+  /// The available instruction sets, in increasing order of preference
+  enum InstructionSet {Scalar = 0, AVX2, AVX512};
+
+  /// Return the instruction set that the kernels are currently using
+  static int getInstructionSet();
+
+  /// Return the best instruction set supported by the CPU
+  static int getSupportedInstructionSet();
+
+  /// Restrict the kernels to use the given instruction set (e.g. to compare results).
+  /// If the CPU does not support it, the best supported one is used instead.
+  static void setInstructionSet(int instructionSet);
+
+  /// Return the name of the instruction set
+  static std::string getName(int instructionSet);
+
+  /// Calculate result[i] = x[i]^n[i] for nValues entries, with the same checks as ActFormulae::power
+  static void power_n(const double* x, const double* n, double* result, int nValues);
+
+  /// Calculate result[i] = x[i]^n for nValues entries, with the same checks as ActFormulae::power
+  static void power_n(const double* x, double n, double* result, int nValues);
+
+  /// Calculate result[i] = exp(x[i]) for nValues entries, with the same checks as ActFormulae::expfun
+  static void expfun_n(const double* x, double* result, int nValues);
+
+  /// Check that the kernels agree with ActFormulae::power and expfun for every
+  /// instruction set supported by the CPU: exp to 2 ulp, and x^n to (2 + |n log x|) ulp.
+  /// NaN, infinite, denormal, zero and negative inputs, and |x| >= 70 for exp, must give
+  /// identical values. Returns false, with the reason in the message, if they do not.
+  static bool checkAccuracy(std::string& message);
+
+ protected:
+
+ private:
+
+  static int& currentSet();
+
+};
+
+#endif
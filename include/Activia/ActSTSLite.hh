@@ -50,6 +50,8 @@ class ActSTSLite : public ActAbsXSecModel {
   /// Calculate the cross-section in Table ID, ST'73 I
   void calcLite4Values(int ioe);
 
+  ActNucleiData* _data;
+
   double _zt, _at, _atbar, _z, _a, _e, _ezero;
   int _izt, _iz, _ia, _iat;
   double _logat, _loge;
@@ -11,6 +11,11 @@
 /// target and product nuclei. Some corrections need to be applied
 /// over several models, hence they are in this separate class that
 /// all can use.
+///
+/// Only the heavy target, large deltaZ correction depends on the energy.
+/// All other factors are found once for each (target, product) pair and
+/// are reused for all energies. They are still applied one at a time, in
+/// the original order, so that the updated cross-sections are unchanged.
 
 class ActSTSigUpdates {
 
@@ -20,14 +25,28 @@ class ActSTSigUpdates {
   ActSTSigUpdates();
 
   /// Update the cross-section with any relevant updates (from '85 and '98 papers).
+  /// The product of the factors applied is stored in the data (setUpdateFactor).
   void updateSigma(ActNucleiData& data, double& sigma);
 
   virtual ~ActSTSigUpdates();
 
  protected:
 
+  /// Find the energy independent factors for the target and product in the data object
+  void setPairFactors(ActNucleiData& data);
+
  private:
 
+  /// The (target, product) pair used for the stored factors
+  int _izt, _iat, _iz, _ia;
+
+  /// Factors applied before and after the energy dependent correction
+  std::vector<double> _preFactors, _postFactors;
+
+  /// Is the energy dependent correction needed, and its deltaZ part
+  bool _useEnergyTerm;
+  double _dzTerm;
+
 };
 
 #endif
@@ -28,7 +28,7 @@ class ActSTSpallation : public ActAbsXSecModel {
   double calcSpallSigma(ActNucleiData* data, double& dela);
 
   /// Calculate the magic number yield curve shift (p338, ST'73 II)
-  double calcMValue(std::string name, int izt, int iz);
+  double calcMValue(const std::string& name, int izt, int iz);
 
   /// Calculate the P value from Table 1D, ST'73 I.
   double calcPValue(ActNucleiData* data);
@@ -39,6 +39,13 @@ class ActSTSpallation : public ActAbsXSecModel {
 
   void setUp();
 
+  /// Forget the stored sigmas at E0 and 1 GeV
+  void clearFixedSigmas();
+  /// Forget the stored sigmas if the target or product isotopes have changed
+  void checkFixedSigmas(ActNucleiData* data);
+  /// Calculate the terms of the spallation formula that do not depend on energy
+  void calcPairTerms(ActNucleiData* data);
+
   std::vector< std::vector<double> > _eta;
 
   double _EMaxLimit, _E1GeV, _EMaxDiff;
@@ -47,6 +54,14 @@ class ActSTSpallation : public ActAbsXSecModel {
   bool _applyUpdates;
 
   double _etasel;
+
+  // The energy-independent sigmas (at E0 and 1 GeV) for the isotopes in _fixedKey
+  std::vector<double> _fixedKey;
+  bool _gotSigE0, _gotSig1;
+  double _sigE0, _delaE0, _sig1;
+  // The energy-independent terms of the formula for the isotopes in _fixedKey
+  bool _gotPairTerms;
+  double _atpow, _dacE0, _dac300, _rpow, _omega, _pHigh, _invpatHigh;
   
 
 };
@@ -0,0 +1,34 @@
+#ifndef ACT_SCALED_SPECTRUM_HH
+#define ACT_SCALED_SPECTRUM_HH
+
+#include "Activia/ActBeamSpectrum.hh"
+
+/// \brief A beam spectrum given by another spectrum multiplied by a constant factor,
+/// e.g. the cosmic ray spectrum scaled to a different altitude or latitude.
+
+class ActScaledSpectrum : public ActBeamSpectrum {
+
+ public:
+
+  /// Construct the spectrum from the given spectrum, which is then owned by this
+  /// class, and the scale factor. The beam particles are those of the given spectrum.
+  ActScaledSpectrum(const char* name, ActBeamSpectrum* spectrum, double scale);
+  virtual ~ActScaledSpectrum();
+
+  /// Calculate the flux (cm^-2 s^-1) per unit energy (MeV^-1) 
+  /// at the given energy (MeV)
+  virtual double fluxdE(double e);
+
+  /// Get the scale factor
+  double getScale() {return _scale;}
+
+ protected:
+
+ private:
+
+  ActBeamSpectrum* _spectrum;
+  double _scale;
+
+};
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef ACT_SHARD_HH
+#define ACT_SHARD_HH
+
+#include "Activia/ActCheckpoint.hh"
+#include "Activia/ActProdXSecData.hh"
+
+#include <string>
+#include <vector>
+
+/// \brief Split one cross-section calculation across several independent processes.
+///
+/// Shard i (1 to n) calculates the cross-sections for every n-th product of every
+/// target isotope, starting from product i-1. The cost of a product rises steeply with
+/// its mass, and the products are in the order of the decay data, so this gives all
+/// shards a similar mix of light and heavy products, unlike contiguous blocks.
+/// Each shard writes the total cross-section and production rate of each product,
+/// and the number of the product that calculated it, to a partial result file, named using the
+/// cross-section output file with its extension replaced by "_shard<i>of<n>.dat".
+/// Its own cross-section output file, named in the same way, has the energy
+/// graphs of its products but no summary table; the decay yields are not calculated.
+///
+/// A merge (shard number 0) reads the partial result files of all n shards and
+/// restores their results, in the order of the product numbers, instead of calculating
+/// the cross-sections. The normal cross-section summary and decay yield outputs
+/// are then written, and are the same as those of a single process run (the energy
+/// graphs are only in the shard output files).
+
+class ActShard {
+
+ public:
+
+  /// Constructor, using the cross-section output file name without its extension,
+  /// the number of shards and the shard number (1 to nShards, or 0 to merge all shards)
+  ActShard(const std::string& baseName, int nShards, int iShard = 0);
+  /// Destructor
+  virtual ~ActShard();
+
+  /// Set the description of the run, used to check that the partial results
+  /// of all shards belong to the same calculation
+  void setRunKey(const std::string& runKey) {_runKey = runKey;}
+
+  /// Check if the partial results of the shards are merged
+  bool isMerging() const {return _iShard == 0;}
+  /// Get the shard number (0 when merging)
+  int getShard() const {return _iShard;}
+  /// Get the number of shards
+  int getNShards() const {return _nShards;}
+
+  /// Get the tag added to the file names of the given shard, e.g. "_shard1of4"
+  static std::string getTag(int iShard, int nShards);
+  /// Get the name of the partial result file of the given shard
+  std::string getFileName(int iShard) const;
+
+  /// Set the target isotope that is being calculated
+  void setTargetIsotope(int iIsotope);
+
+  /// Get the first product calculated by this shard (nProducts when merging)
+  int getFirstProduct(int nProducts) const;
+  /// Check if the product is calculated by this shard
+  bool hasProduct(int iProduct) const;
+
+  /// Store the results of the current target isotope calculated by this shard,
+  /// with the number of the product that calculated each of them
+  void addResults(ActProdXSecData::ActProdXSecMap& xSecData,
+		  ActProdXSecData::ActProdIndexMap& products);
+  /// When merging, add the results of all shards for the current target isotope
+  void restoreResults(ActProdXSecData::ActProdXSecMap& xSecData,
+		      ActProdXSecData::ActProdIndexMap& products);
+
+  /// Write the partial result file of this shard
+  bool write();
+  /// Read and combine the partial result files of all shards. Returns false
+  /// if any of them is missing or does not belong to the same run.
+  bool read();
+
+ protected:
+
+ private:
+
+  std::string _baseName, _runKey;
+  int _nShards, _iShard;
+
+  int _iTarget;
+  std::vector< std::vector<ActCheckpoint::Result> > _results;
+
+};
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef ACT_SIGMA_MATRIX_HH
+#define ACT_SIGMA_MATRIX_HH
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// \brief Compact store of the cross-sections of every product at every energy, for
+/// each target isotope, so that later runs can re-weight them without evaluating
+/// the models.
+///
+/// The store is a cache of target-product pairs: each target isotope (Z, A) has one
+/// row per product or side branch (Z, A) that passed the selection, giving the
+/// cross-section (mb) at each energy of the beam spectrum. The values are stored
+/// as 32-bit floats by default, or as 64-bit doubles (see setPrecision), and only the
+/// range from the first to the last value that is not below the minimum sigma is kept;
+/// smaller values inside this range are set to zero.
+/// The rows of each target isotope are written as columns (Z, A, side branch flag,
+/// first energy bin, number of values and the values) using the codecs of
+/// ActBinaryFormat. The file starts with the magic word "ACTSIG02" and the
+/// description of the run.
+///
+/// The description has everything else that the cross-sections depend on: the beam,
+/// the energy grid, the model option, the model version, the hashes of the models
+/// and data tables (ActModelVersion) and the precision. If it changes, all stored
+/// rows are invalid and the file is replaced. Otherwise, a later run looks up each of
+/// its target-product pairs, and only calculates those that are not stored, e.g. for
+/// products appended to the decay data or a new target isotope; these are then added
+/// to the file, which also keeps the pairs that the run did not use. The production
+/// rates are linear in the isotope fractions and beam fluxes, so a change of these
+/// only needs the sums over the stored cross-sections. With floats, these agree with
+/// a full calculation to about 1e-7 relative, so printed values can differ in the
+/// last digit; with doubles, they are the same, but the file is about twice as large.
+
+class ActSigmaMatrix {
+
+ public:
+
+  /// The precision of the stored cross-sections (number of bits)
+  enum Precision {Float = 32, Double = 64};
+
+  /// Constructor, using the file name, the minimum sigma (mb) that is stored
+  /// and the precision
+  ActSigmaMatrix(const std::string& fileName, double minSigma = 0.0,
+		 int precision = ActSigmaMatrix::Float);
+  /// Destructor
+  virtual ~ActSigmaMatrix();
+
+  /// Set the description of the run, used to check that the stored
+  /// cross-sections belong to the same calculation
+  void setRunKey(const std::string& runKey) {_runKey = runKey;}
+
+  /// Read the file, if it exists. Returns true if the stored cross-sections are used.
+  bool read();
+  /// Write the file, with the stored and any new rows. Returns false if it can not be written.
+  bool write();
+
+  /// Check if rows have been added since the file was read
+  bool isModified() const {return _nAdded > 0;}
+
+  /// Set the target isotope that is being calculated
+  void setTargetIsotope(int zTarget, double aTarget);
+  /// Check if any rows are stored for the current target isotope
+  bool hasRows() const;
+
+  /// Get the stored cross-sections of the product Z and A for the current target
+  /// isotope, for nE energies. Returns false if there is no such row, in which case
+  /// the cross-sections must be calculated.
+  bool findRow(int z, double a, int nE, std::vector<double>& sigmas);
+
+  /// Store the cross-sections of a product (or side branch) of the current target isotope,
+  /// where the sigma is zero for the energies that did not pass the selection
+  void addRow(int z, double a, bool sideBranch, const std::vector<double>& sigmas);
+
+  /// Set the precision (Float or Double) of the rows that are added
+  void setPrecision(int precision) {_precision = precision;}
+  /// Get the precision of the rows that are added
+  int getPrecision() const {return _precision;}
+
+  /// Get the file name
+  std::string getFileName() const {return _fileName;}
+  /// Get the total number of rows
+  int getNRows() const;
+  /// Get the number of rows that were found, and that were added, in this run
+  int getNFound() const {return _nFound;}
+  int getNAdded() const {return _nAdded;}
+
+  /// A stored row: the values start at the energy bin first
+  struct Row {
+    int z;
+    double a;
+    bool sideBranch;
+    int first;
+    std::vector<double> values;
+  };
+
+  /// The rows of a target isotope, with the index of each product (Z, A)
+  struct Block {
+    int z;
+    double a;
+    std::vector<Row> rows;
+    std::map<std::pair<int, double>, int> index;
+  };
+
+ protected:
+
+  /// Encode the rows of a target isotope as columns
+  void encodeRows(const std::vector<Row>& rows, std::vector<unsigned char>& bytes) const;
+  /// Decode the rows of a target isotope. Returns false if the bytes are not valid.
+  bool decodeRows(const std::vector<unsigned char>& bytes, size_t& pos,
+		  std::vector<Row>& rows) const;
+
+  /// Make the index of the rows of the block
+  void makeIndex(Block& block) const;
+
+ private:
+
+  std::string _fileName, _runKey;
+  double _minSigma;
+  int _precision;
+
+  int _iBlock, _nFound, _nAdded;
+  std::vector<Block> _blocks;
+
+};
+
+#endif
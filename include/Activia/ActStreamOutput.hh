@@ -3,17 +3,32 @@
 
 #include "Activia/ActAbsOutput.hh"
 #include "Activia/ActAbsGraph.hh"
+#include "Activia/ActNumberFormat.hh"
 #include "Activia/ActNucleiData.hh"
 #include "Activia/ActString.hh"
 #include "Activia/ActOutputTable.hh"
 
+#include <condition_variable>
+#include <deque>
 #include <iostream>
 #include <fstream>
+#include <mutex>
 #include <string>
+#include <thread>
 
 class ActInput;
 
 /// \brief A class for writing data to an output ASCII text file.
+///
+/// Text is formatted into a memory buffer, with numbers converted by
+/// ActNumberFormat instead of the iostream operators, and lines end with a newline
+/// character only, so the file is not flushed after every line. When the buffer
+/// is larger than the buffer size (1 MB by default), at the end of a line, table
+/// or graph, it is handed to a background writer thread, or written directly if
+/// asynchronous writing is switched off. At most a few blocks (4 by default) are
+/// queued for the writer; the calculation waits for it if the queue is full, e.g. on
+/// a slow filesystem. Everything is written when the file is closed, and a failure
+/// to write the file is reported then (and by saveState).
 
 class ActStreamOutput : public ActAbsOutput {
 
@@ -38,6 +53,13 @@ class ActStreamOutput : public ActAbsOutput {
   /// Write out a table of results to the output file
   virtual void outputTable(ActOutputTable& table);
 
+  /// Write the column names of a table that is streamed row by row
+  virtual void beginTable(ActOutputTable& table);
+  /// Write a row of the streamed table
+  virtual void outputTableRow(ActOutputTable& table, const double* values);
+  /// Finish the streamed table
+  virtual void endTable(ActOutputTable& table);
+
   /// Write out a graph of results and related nuclei data to the output file
   virtual void outputGraph(ActNucleiData& data,
 			   ActAbsGraph& graph);
@@ -45,21 +67,69 @@ class ActStreamOutput : public ActAbsOutput {
   /// Close the output file
   virtual void closeFile();
 
+  /// Write all text so far and store the file length as the state
+  virtual bool saveState(std::string& state);
+  /// Re-open the file, truncated to the length stored by saveState, for appending
+  virtual bool resumeFile(const std::string& state);
+
   /// Set any writing options
   virtual void setOptions();
 
   /// Set the precision for writing out numbers.
-  void setPrecision(int number) {_precision = number; _stream.precision(number);}
+  void setPrecision(int number) {_precision = number; _format.setPrecision(number);}
+  /// Set the number format mode (ActNumberFormat::Stream by default, which
+  /// matches the standard iostream output, Shortest or Fixed)
+  void setNumberFormat(int mode) {_format.setMode(mode);}
   /// Set the minimum total string width for writing out numbers
   void setMinWidth(int number) {_minWidth = number;}
 
+  /// Use a background thread to write the buffered text (true by default).
+  /// This must be set before the file is opened.
+  void setAsyncWriting(bool flag) {_async = flag;}
+  /// Set the buffer size (bytes) above which the text is passed to the writer
+  void setBufferSize(size_t bufferSize) {_bufferSize = bufferSize;}
+  /// Set the maximum number of blocks of text that are queued for the writer
+  void setMaxQueuedBlocks(size_t maxBlocks) {_maxBlocks = maxBlocks > 0 ? maxBlocks : 1;}
+
  protected:
-  
+
+  /// Pass the buffered text to the writer if it is larger than the buffer size,
+  /// or if force is true. This waits if the queue of the writer is full.
+  void handOff(bool force = false);
+
+  /// Write a block of text to the file, recording any failure
+  void writeBlock(const std::string& block);
+
+  /// Write the queued blocks of text to the file (writer thread)
+  void writeBlocks();
+
+  /// Start the writer thread, if asynchronous writing is used
+  void startWriter();
+  /// Wait for the writer thread to write all queued text and stop it
+  void stopWriter();
+
  private:
 
   std::ofstream _stream;
+  std::string _buffer;
+  ActNumberFormat _format;
   int _precision, _minWidth;
 
+  /// Column widths of the table being written
+  std::vector<int> _colWidths;
+
+  bool _async;
+  size_t _bufferSize, _maxBlocks;
+
+  std::thread _writer;
+  std::mutex _mutex;
+  /// Signals new blocks (or the end) to the writer, and free space in the queue
+  std::condition_variable _condition, _spaceCondition;
+  std::deque<std::string> _blocks;
+  bool _finished;
+  /// Whether writing to the file has failed
+  bool _writeFailed;
+
 };
 
 #endif
@@ -45,6 +45,14 @@ class ActTarget {
 
   /// Set the output class for writing out information
   void setOutput(ActAbsOutput* output) {_output = output;}
+  /// Set other beam spectra (with the same energies as the input beam), whose
+  /// production rates are calculated by calcXSections in the same pass
+  void setOtherSpectra(const std::vector<ActBeamSpectrum*>& spectra) {_otherSpectra = spectra;}
+  /// Use the production rates of the given spectrum (0 = input beam, then the
+  /// other spectra) for the summary table and the decay yields
+  void useSpectrum(int iSpectrum);
+  /// Set whether addIsotope prints information messages (default true)
+  void setVerbose(bool verbose) {_verbose = verbose;}
 
   /// Get all of the production cross-section data. Each element in the vector
   /// is the full cross-section data for each target isotope over all available
@@ -105,6 +113,8 @@ class ActTarget {
 
   ActAbsOutput* _output;
   ActBeamSpectrum* _inputBeam;
+  std::vector<ActBeamSpectrum*> _otherSpectra, _spectra;
+  bool _verbose;
 
 };
 
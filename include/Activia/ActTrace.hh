@@ -0,0 +1,122 @@
+#ifndef ACT_TRACE_HH
+#define ACT_TRACE_HH
+
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+/// \brief Optional timing of scoped code regions, exported as a Chrome trace.
+///
+/// Tracing is only compiled in when ACT_USE_TRACE is defined, which is done by
+/// setting ACT_USE_TRACE = 1 in config.mk (or using "./configure --enable-trace").
+/// Otherwise the ACT_TRACE_SCOPE macro is empty and has no run-time cost.
+///
+/// Each thread records the start and duration of its regions in its own ring
+/// buffer, so only the most recent events are kept when the buffer is full.
+/// The events of all threads are written by writeChromeTrace in the JSON trace
+/// event format, which can be viewed using chrome://tracing or ui.perfetto.dev.
+/// The region names must remain valid until the trace is written: use string
+/// literals or names returned by ActTrace::intern().
+
+class ActTrace {
+
+ public:
+
+  /// Get the trace object
+  static ActTrace* getInstance();
+
+  virtual ~ActTrace();
+
+  /// Record a region for the current thread. The times are in nanoseconds
+  /// since the trace was created.
+  void addEvent(const char* name, const char* category, long long start, long long duration);
+
+  /// Current time (nanoseconds) since the trace was created
+  long long now() const;
+
+  /// Return a copy of the name that remains valid for the whole program
+  static const char* intern(const std::string& name);
+
+  /// Set the number of events kept for each thread. Only affects the buffers
+  /// of threads that have not yet recorded any events.
+  void setBufferSize(size_t nEvents) {_bufferSize = nEvents;}
+  /// Get the number of events kept for each thread
+  size_t getBufferSize() const {return _bufferSize;}
+
+  /// Write the events of all threads in the Chrome trace event JSON format.
+  /// This should be called when no other thread is recording events.
+  bool writeChromeTrace(const std::string& fileName);
+
+  /// Remove all recorded events
+  void clear();
+
+  /// Event recorded when a traced region ends
+  struct Event {
+    const char* name;
+    const char* category;
+    long long start, duration;
+  };
+
+  /// Ring buffer of the events of one thread
+  struct Buffer {
+    int threadId;
+    std::vector<Event> events;
+    size_t next;
+    bool wrapped;
+  };
+
+ protected:
+
+  /// Constructor, use getInstance()
+  ActTrace();
+
+  /// Get the buffer of the current thread, creating it if required
+  Buffer* getBuffer();
+
+ private:
+
+  long long _origin;
+  size_t _bufferSize;
+
+  std::vector<Buffer*> _buffers;
+  std::mutex _mutex;
+
+};
+
+/// \brief Record the time between the construction and destruction of this object
+/// as a traced region. Use the ACT_TRACE_SCOPE macro instead of this class.
+
+class ActTraceScope {
+
+ public:
+
+  ActTraceScope(const char* name, const char* category) : _name(name), _category(category) {
+    _start = ActTrace::getInstance()->now();
+  }
+
+  ~ActTraceScope() {
+    ActTrace* trace = ActTrace::getInstance();
+    trace->addEvent(_name, _category, _start, trace->now() - _start);
+  }
+
+ private:
+
+  const char* _name;
+  const char* _category;
+  long long _start;
+
+};
+
+#define ACT_TRACE_CONCAT_(a, b) a##b
+#define ACT_TRACE_CONCAT(a, b) ACT_TRACE_CONCAT_(a, b)
+
+#ifdef ACT_USE_TRACE
+/// Trace the rest of the enclosing scope using the given name and category
+#define ACT_TRACE_SCOPE(name, category) \
+  ActTraceScope ACT_TRACE_CONCAT(actTraceScope, __LINE__)(name, category)
+#else
+#define ACT_TRACE_SCOPE(name, category)
+#endif
+
+#endif
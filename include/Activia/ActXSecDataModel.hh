@@ -50,7 +50,8 @@ class ActXSecDataModel : public ActAbsXSecModel {
 
   /// Construct the data table model with the given name, inputList of data files and debug flag.
   /// The inputList must contain the file names of the all cross-section data tables.
-  ActXSecDataModel(std::string name, std::string inputList, int debug);
+  /// Information messages are only printed if verbose is true.
+  ActXSecDataModel(std::string name, std::string inputList, int debug, bool verbose = true);
   virtual ~ActXSecDataModel();
 
   /// Calculate the cross-section for a given set of target-product nuclei data.
@@ -68,7 +69,9 @@ class ActXSecDataModel : public ActAbsXSecModel {
 		       ActNuclide* targetNuclide,
 		       ActProdNuclideList* prodList);
 
-  ActXSecGraph getXSecGraph(ActNucleiData* data);
+  /// Get the graph for the target-product pair of the nuclei data (empty if there is none).
+  /// The graph is kept until the next call.
+  ActXSecGraph& getXSecGraph(ActNucleiData* data);
 
   typedef std::map<ActNuclide*, ActXSecGraph, ActDataPtrLess> ActDataModelMap;
   typedef std::map<ActNuclide*, ActDataModelMap> ActXSecDMAllMap;
@@ -85,6 +88,7 @@ class ActXSecDataModel : public ActAbsXSecModel {
 
   int _Zt, _Z;
   double _At, _A;
+  bool _verbose;
 
 };
 
@@ -0,0 +1,130 @@
+#ifndef ACT_XSEC_ENGINE_HH
+#define ACT_XSEC_ENGINE_HH
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+class ActBeamSpectrum;
+class ActNucleiData;
+class ActProdNuclide;
+class ActProdNuclideList;
+class ActSTXSecAlgorithm;
+class ActTarget;
+
+/// \brief Calculate the cross-sections and production rates of a few products
+/// without the input and output classes of a complete run.
+///
+/// The engine keeps the Silberberg-Tsao models, the data tables loaded for each
+/// target isotope and the targets it has been asked about, so that repeated
+/// questions do not read the data files again. The list of all products (from the
+/// decay data file) is given to the constructor and can be shared by several engines.
+/// The results are the same as those in the xSecSummary table of a complete run.
+///
+/// An engine must only be used by one thread at a time, but different engines
+/// can be used by different threads. Apart from error messages, nothing is
+/// printed if the engine is not verbose.
+
+class ActXSecEngine {
+
+ public:
+
+  /// Constructor, using the list of all product nuclides (which is not copied),
+  /// the file containing the list of data tables ("" or "0" for none) and the
+  /// minimum data cross-section (mb) above which the data tables are used.
+  /// Information messages are only printed if verbose is true.
+  ActXSecEngine(ActProdNuclideList* prodList, const char* listOfDataTables = "",
+		double minDataXSec = 0.0, bool verbose = true);
+  /// Destructor
+  virtual ~ActXSecEngine();
+
+  /// The total cross-section and production rate of a product isotope
+  struct Product {
+    int z;
+    double a;
+    /// Cross-section (mb), summed over the target isotopes weighted by their fractions
+    double sigma;
+    /// Production rate (per kg per day), summed over the target isotopes
+    double prodRate;
+    /// Half-life (days) from the decay data, or 0 if the product is not in the list
+    double halfLife;
+  };
+
+  /// Get the target with the given Z and isotopes (A and abundance fractions).
+  /// The target is created when it is first used and then kept by the engine.
+  /// Returns 0 if Z < 6, since the Silberberg-Tsao formulae need Z > 5.
+  ActTarget* getTarget(int Z, const std::vector<double>& massNumbers,
+		       const std::vector<double>& fractions);
+
+  /// Calculate the cross-section and production rate of each product (with the z
+  /// and a values set) for the target and beam spectrum. Returns false if the
+  /// target or spectrum is not valid.
+  bool calcProduction(ActTarget* target, ActBeamSpectrum* spectrum,
+		      std::vector<Product>& products);
+
+  /// Calculate the cross-sections and production rates for several beam spectra
+  /// with the same energies in one pass, since the cross-sections do not depend on
+  /// the spectrum. The products (z and a values) are given by products[0], and
+  /// products[i] has the results for spectra[i]. Returns false if the target is not
+  /// valid or the spectra have different energies.
+  bool calcProduction(ActTarget* target, const std::vector<ActBeamSpectrum*>& spectra,
+		      std::vector<std::vector<Product> >& products);
+
+  /// Calculate the cross-section (mb) for a proton beam at each of the energies (MeV),
+  /// for the product with the atomic and mass numbers z[i] and a[i] given for
+  /// the same entry. The cross-sections include the side branches and are summed
+  /// over the target isotopes weighted by their fractions. Returns false if
+  /// the array sizes are different.
+  bool calcCrossSections(ActTarget* target, const std::vector<int>& z,
+			 const std::vector<double>& a, const std::vector<double>& energies,
+			 std::vector<double>& sigmas);
+
+  /// Calculate the cross-section (mb) of one product, with atomic and mass numbers
+  /// z and a, for a proton beam at each of the energies (MeV), which can be in any
+  /// order (e.g. from a transport code). The cross-section is zero for energies
+  /// that are not positive. A target with a single isotope (fraction 1) gives the
+  /// isotope cross-sections. Returns false if the target is not valid.
+  bool calcSigmaVsEnergy(ActTarget* target, int z, double a,
+			 const std::vector<double>& energies, std::vector<double>& sigmas);
+
+  /// The number of energies calculated together
+  static const int BatchSize = 1024;
+
+  /// Get the cross-section algorithm
+  ActSTXSecAlgorithm* getAlgorithm() {return _algorithm;}
+  /// Get the list of all product nuclides
+  ActProdNuclideList* getProdNuclideList() {return _prodList;}
+
+ protected:
+
+  /// Get the product from the list of all products, or an isotope without
+  /// side branches if it is not in the list
+  ActProdNuclide* getProduct(int z, double a);
+
+  /// Calculate the cross-sections of a side branch (iSB below the number of side
+  /// branches) or the product itself for the target isotope in the nuclei data.
+  /// Returns false if the branch does not pass the selection.
+  bool calcBranchSigmas(ActNucleiData* data, ActProdNuclide* product, int iSB,
+			const std::vector<double>& energies,
+			std::vector<double>& sigmas, std::vector<int>& passed);
+
+  /// Calculate the cross-sections of the product at the energies, summed over the
+  /// target isotopes, in batches that share a table of the energy factors
+  void calcProductSigmas(ActTarget* target, ActProdNuclide* prodNuclide,
+			 const std::vector<double>& energies, std::vector<double>& sigmas);
+
+ private:
+
+  ActProdNuclideList* _prodList;
+  ActSTXSecAlgorithm* _algorithm;
+  bool _verbose;
+
+  /// The targets that have been used, with their description as the key
+  std::map<std::string, ActTarget*> _targets;
+  /// The products that are not in the list of all products
+  std::map<std::pair<int, double>, ActProdNuclide*> _products;
+
+};
+
+#endif
@@ -21,6 +21,24 @@ void ActAbsGraph::reset() {
   _minX = 1e10; _maxX = 0.0;
   _xAxis = ""; _xUnits = "";
   _yAxes.clear(); _yUnits.clear();
+  _gridStart = 0.0; _gridStep = 0.0;
+  _gridRuns.clear();
+}
+
+void ActAbsGraph::setGrid(double xStart, double dx, std::vector<int> runs) {
+  _gridStart = xStart; _gridStep = dx;
+  _gridRuns = runs;
+}
+
+int ActAbsGraph::getGridSize() {
+
+  int nBins(0);
+  int nRuns = (int) _gridRuns.size();
+  int i;
+  for (i = 0; i < nRuns; i++) {nBins += _gridRuns[i];}
+
+  return nBins;
+
 }
 
 void ActAbsGraph::addPoints(std::vector<ActGraphPoint> points) {
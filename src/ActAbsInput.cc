@@ -10,7 +10,7 @@
 #include "Activia/ActAbsDecayAlgorithm.hh"
 #include "Activia/ActOutputSelection.hh"
 
-ActAbsInput::ActAbsInput() : _target(0), _prodNuclideList(0), _spectrum(0),
+ActAbsInput::ActAbsInput() : _target(0), _prodNuclideList(0), _spectrum(0), _otherSpectra(),
 			     _xSecAlgorithm(0), _time(0), _decayAlgorithm(0),
 			     _outputSelection(0), _calcInt(-1), _option("")
 {
@@ -18,6 +18,7 @@ ActAbsInput::ActAbsInput() : _target(0), _prodNuclideList(0), _spectrum(0),
 }
 
 ActAbsInput::ActAbsInput(ActOutputSelection* outputSelection) : _target(0), _prodNuclideList(0), _spectrum(0),
+								_otherSpectra(),
 								_xSecAlgorithm(0), _time(0), _decayAlgorithm(0),
 								_outputSelection(outputSelection), _calcInt(-1), 
 								_option("")
@@ -33,6 +34,7 @@ ActAbsInput::~ActAbsInput()
     delete _prodNuclideList; _prodNuclideList = 0;
   }
   if (_spectrum != 0) {delete _spectrum; _spectrum = 0;}
+  this->clearOtherSpectra();
   if (_xSecAlgorithm != 0) {delete _xSecAlgorithm; _xSecAlgorithm = 0;}
 
   if (_time != 0) {delete _time; _time = 0;}
@@ -54,3 +56,17 @@ void ActAbsInput::getData() {
   this->specifyOutput();
 
 }
+
+void ActAbsInput::addOtherSpectrum(ActBeamSpectrum* spectrum) {
+
+  if (spectrum != 0) {_otherSpectra.push_back(spectrum);}
+
+}
+
+void ActAbsInput::clearOtherSpectra() {
+
+  int i;
+  for (i = 0; i < (int) _otherSpectra.size(); i++) {delete _otherSpectra[i];}
+  _otherSpectra.clear();
+
+}
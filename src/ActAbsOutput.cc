@@ -4,7 +4,9 @@
 
 ActAbsOutput::ActAbsOutput(const char* fileName, int levelOfDetail) : _fileName(fileName), 
 								      _type(0), _detail(levelOfDetail),
-								      _typeName(""), _calcStatus(0)
+								      _typeName(""), _calcStatus(0),
+								      _checkpoint(0), _shard(0), _sigmaMatrix(0),
+								      _ensemble(0), _streamTable(0)
 {
   // Constructor
 }
@@ -12,7 +14,8 @@ ActAbsOutput::ActAbsOutput(const char* fileName, int levelOfDetail) : _fileName(
 ActAbsOutput::ActAbsOutput(ActAbsCalcStatus* calcStatus, const char* fileName, int levelOfDetail)
   : _fileName(fileName), 
     _type(0), _detail(levelOfDetail),
-    _typeName(""), _calcStatus(calcStatus)
+    _typeName(""), _calcStatus(calcStatus),
+    _checkpoint(0), _shard(0), _sigmaMatrix(0), _ensemble(0), _streamTable(0)
 {
   // Constructor
 }
@@ -20,4 +23,33 @@ ActAbsOutput::ActAbsOutput(ActAbsCalcStatus* calcStatus, const char* fileName, i
 ActAbsOutput::~ActAbsOutput() 
 {
   // Destructor
+  delete _streamTable;
+}
+
+void ActAbsOutput::beginTable(ActOutputTable& table) {
+
+  // Collect the rows in a copy of the table, which is written by endTable
+  delete _streamTable;
+  std::string name = table.getName();
+  std::vector<ActString> columnNames = table.getColumnNames();
+  _streamTable = new ActOutputTable(name.c_str(), columnNames, table.getColumnSpacing());
+
+}
+
+void ActAbsOutput::outputTableRow(ActOutputTable& table, const double* values) {
+
+  if (_streamTable == 0 || values == 0) {return;}
+
+  std::vector<double> row(values, values + table.getNColumns());
+  _streamTable->addRow(row);
+
+}
+
+void ActAbsOutput::endTable(ActOutputTable&) {
+
+  if (_streamTable != 0) {
+    this->outputTable(*_streamTable);
+    delete _streamTable; _streamTable = 0;
+  }
+
 }
@@ -12,9 +12,27 @@
 
 #include "Activia/ActOutputSelection.hh"
 #include "Activia/ActStreamOutput.hh"
+#include "Activia/ActBinaryOutput.hh"
 #include "Activia/ActROOTOutput.hh"
 #include "Activia/ActAbsCalcStatus.hh"
-
+#include "Activia/ActRunStatistics.hh"
+#include "Activia/ActTrace.hh"
+#include "Activia/ActCheckpoint.hh"
+#include "Activia/ActShard.hh"
+#include "Activia/ActBeamSpectrum.hh"
+#include "Activia/ActCosmicSpectrum.hh"
+#include "Activia/ActGordonSpectrum.hh"
+#include "Activia/ActScaledSpectrum.hh"
+#include "Activia/ActTargetNuclide.hh"
+#include "Activia/ActNumberFormat.hh"
+#include "Activia/ActSigmaMatrix.hh"
+#include "Activia/ActEnsemble.hh"
+#include "Activia/ActModelVersion.hh"
+#include "Activia/ActXSecEngine.hh"
+#include "Activia/ActAbsXSecAlgorithm.hh"
+#include "Activia/ActProdNuclide.hh"
+
+#include <cstdlib>
 #include <string>
 #include <iostream>
 #include <fstream>
@@ -28,6 +46,13 @@ ActAbsRun::ActAbsRun() {
   _input = 0;
   _outputSelection = new ActOutputSelection();
   _calcStatus = 0;
+  _checkpointInterval = -1.0;
+  _nShards = 0; _iShard = 0;
+  _otherSpectra = "";
+  _useSigmaMatrix = false; _sigmaMatrixFile = ""; _minSigma = 0.0;
+  _sigmaMatrixPrecision = ActSigmaMatrix::Float;
+  _nReplicas = 0; _nThreads = 0; _uncertainties = ""; _seed = 1;
+  _writeStatistics = false;
 }
 
 ActAbsRun::~ActAbsRun() {
@@ -49,6 +74,13 @@ void ActAbsRun::doCalculations() {
   if (_input == 0) {return;}
 
   _input->getData();
+  this->calculate();
+
+}
+
+void ActAbsRun::calculate() {
+
+  if (_input == 0) {return;}
 
   // Calculate the cross-sections for target-nuclide pairs.
 
@@ -70,20 +102,141 @@ void ActAbsRun::doCalculations() {
     return;
   }
 
+  // Record the phase timings and evaluation counts of this run. The report
+  // is only written (next to the cross-section output file) if requested.
+  ActRunStatistics* statistics = ActRunStatistics::getInstance();
+  statistics->reset();
+  std::string reportFileName("");
+  if (_writeStatistics == true && _outputSelection != 0) {
+    reportFileName = this->getReportFileName("_stats.json");
+  }
+  statistics->setReportFileName(reportFileName);
+  statistics->startPhase("total");
+
   // Calculate the cross-section and production rate (based on the input beam spectrum)
   // for all target-product isotope pairs.
 
   ActAbsOutput* prodOutput = this->selectXSecOutput();
-  if (prodOutput != 0) {
-    prodOutput->openFile();
-    if (_calcStatus != 0) {prodOutput->setCalcStatus(_calcStatus);}
+
+  // The production rates of any other spectra are calculated in the same pass
+  _input->clearOtherSpectra();
+  if (_otherSpectra.size() > 0) {
+    if (_nShards > 0 || _checkpointInterval >= 0.0) {
+      cout<<"The other spectra "<<_otherSpectra<<" are not used with shards or checkpoints"<<endl;
+    } else if (this->createOtherSpectra() == false) {
+      delete prodOutput;
+      return;
+    }
   }
 
+  // Calculate one shard of the products, or merge the results of all shards
+  ActShard* shard(0);
+  if (prodOutput != 0 && _nShards > 0) {
+    shard = new ActShard(this->getBaseFileName(), _nShards, _iShard);
+    shard->setRunKey(this->getCheckpointKey(false));
+    if (shard->isMerging() == true && shard->read() == false) {
+      cout<<"Error in ActAbsRun::calculate. Could not merge the shard results. Exiting."<<endl;
+      delete shard; delete prodOutput;
+      return;
+    }
+    prodOutput->setShard(shard);
+  }
+
+  // Restart from a checkpoint of an earlier run that was interrupted
+  ActCheckpoint* checkpoint(0);
+  if (prodOutput != 0 && _checkpointInterval >= 0.0 && (shard == 0 || shard->isMerging() == false)) {
+    checkpoint = new ActCheckpoint(this->getReportFileName("_checkpoint.dat"), _checkpointInterval);
+    checkpoint->setRunKey(this->getCheckpointKey(true));
+    checkpoint->read();
+    prodOutput->setCheckpoint(checkpoint);
+  }
+
+  // Restore the cross-sections vs energy of an earlier run, and store new ones for later runs
+  ActSigmaMatrix* sigmaMatrix(0);
+  if (prodOutput != 0 && _useSigmaMatrix == true) {
+    if (_nShards > 0 || _checkpointInterval >= 0.0) {
+      cout<<"The sigma matrix is not used with shards or checkpoints"<<endl;
+    } else {
+      std::string fileName(_sigmaMatrixFile);
+      if (fileName.size() == 0) {fileName = this->getReportFileName("_sigma.dat");}
+      sigmaMatrix = new ActSigmaMatrix(fileName, _minSigma, _sigmaMatrixPrecision);
+      sigmaMatrix->setRunKey(this->getSigmaMatrixKey());
+      sigmaMatrix->read();
+      prodOutput->setSigmaMatrix(sigmaMatrix);
+    }
+  }
+
+  // The replicas of the uncertainty ensemble use the same cross-sections
+  ActEnsemble* ensemble(0);
+  ActAbsXSecAlgorithm* xSecAlgorithm = _input->getXSecAlgorithm();
+  if (prodOutput != 0 && _nReplicas > 0 && xSecAlgorithm != 0) {
+    if (_nShards > 0 || _checkpointInterval >= 0.0 || sigmaMatrix != 0) {
+      cout<<"The ensemble is not used with shards, checkpoints or the sigma matrix"<<endl;
+    } else {
+      ensemble = new ActEnsemble(_nReplicas, _seed, _nThreads);
+      if (ensemble->setUncertainties(_uncertainties) == false) {
+	delete ensemble; delete prodOutput;
+	return;
+      }
+      ensemble->setup(target, _input->getSpectrum(), prodNuclideList->getNProdNuclides());
+      xSecAlgorithm->setRecordFactors(true);
+      prodOutput->setEnsemble(ensemble);
+    }
+  }
+
+  bool xSecDone(false);
+  if (checkpoint != 0) {xSecDone = checkpoint->isXSecDone();}
+
+  if (prodOutput != 0 && xSecDone == false) {
+    if (checkpoint != 0 && checkpoint->isResuming() == true &&
+	prodOutput->resumeFile(checkpoint->getOutputState()) == false) {
+      cout<<"Could not resume the output file "<<prodOutput->getFileName()
+	  <<"; the calculation starts from the beginning"<<endl;
+      checkpoint->clear();
+    }
+    if (checkpoint == 0 || checkpoint->isResuming() == false) {prodOutput->openFile();}
+  }
+  if (prodOutput != 0 && _calcStatus != 0) {prodOutput->setCalcStatus(_calcStatus);}
+
   ActIsotopeProduction production(_input, prodOutput);
   production.calcCrossSections();
-  if (prodOutput != 0) {prodOutput->closeFile();}
+  if (prodOutput != 0 && xSecDone == false) {
+    statistics->startPhase("output");
+    prodOutput->closeFile();
+    statistics->stopPhase("output");
+  }
+
+  // Stop here if the calculation has been stopped, keeping the checkpoint
+  bool stopped(false);
+  if (_calcStatus != 0) {stopped = !_calcStatus->canRunCode();}
+  if (checkpoint != 0 && xSecDone == false && stopped == false) {checkpoint->endXSections();}
+
+  if (ensemble != 0) {
+    if (stopped == false) {this->outputEnsemble(ensemble);}
+    xSecAlgorithm->setRecordFactors(false);
+    prodOutput->setEnsemble(0);
+    delete ensemble;
+  }
+
+  if (sigmaMatrix != 0) {
+    cout<<"Used "<<sigmaMatrix->getNFound()<<" stored and calculated "
+	<<sigmaMatrix->getNAdded()<<" new target-product cross-sections"<<endl;
+    if (sigmaMatrix->isModified() == true && stopped == false && sigmaMatrix->write() == true) {
+      cout<<"Written the sigma matrix "<<sigmaMatrix->getFileName()<<endl;
+    }
+    prodOutput->setSigmaMatrix(0);
+    delete sigmaMatrix;
+  }
+
+  // Each shard writes its partial results; the decay yields are calculated by the merge
+  bool calcDecays(true);
+  if (shard != 0 && shard->isMerging() == false) {
+    if (stopped == false) {shard->write();}
+    calcDecays = false;
+  }
 
-  ActAbsOutput* decayOutput = this->selectDecayOutput();
+  ActAbsOutput* decayOutput(0);
+  if (calcDecays == true) {decayOutput = this->selectDecayOutput();}
   if (decayOutput != 0) {
     decayOutput->openFile();
     if (_calcStatus != 0) {decayOutput->setCalcStatus(_calcStatus);}
@@ -96,12 +249,48 @@ void ActAbsRun::doCalculations() {
     return;
   }
 
-  decayAlgorithm->calculateDecays(decayOutput);
-  if (decayOutput != 0) {decayOutput->closeFile();}
+  if (calcDecays == true) {
+    statistics->startPhase("decay");
+    decayAlgorithm->calculateDecays(decayOutput);
+    statistics->stopPhase("decay");
+  }
+
+  if (decayOutput != 0) {
+    statistics->startPhase("output");
+    decayOutput->closeFile();
+    statistics->stopPhase("output");
+  }
+
+  // The summary and decay yields of the other spectra
+  if (_calcStatus != 0) {stopped = !_calcStatus->canRunCode();}
+  if (calcDecays == true && stopped == false && _input->getOtherSpectra().size() > 0) {
+    this->outputOtherSpectra();
+  }
+
+  // The run is complete, so the checkpoint is no longer needed
+  if (checkpoint != 0) {
+    if (_calcStatus == 0 || _calcStatus->canRunCode() == true) {checkpoint->finish();}
+    prodOutput->setCheckpoint(0);
+    delete checkpoint;
+  }
+
+  if (shard != 0) {
+    prodOutput->setShard(0);
+    delete shard;
+  }
 
   // Finalise calculation status
   if (_calcStatus != 0) {_calcStatus->finalise();}
 
+  // Write the run statistics report
+  statistics->stopPhase("total");
+  statistics->finalise();
+
+#ifdef ACT_USE_TRACE
+  // Write the timing of the traced code regions
+  ActTrace::getInstance()->writeChromeTrace(this->getReportFileName("_trace.json"));
+#endif
+
   delete prodOutput;
   delete decayOutput;
 
@@ -114,20 +303,15 @@ ActAbsOutput* ActAbsRun::selectXSecOutput() {
   if (_outputSelection != 0) {
 
     std::string xSecFileName = _outputSelection->getXSecFileName();
-    int xSecType = _outputSelection->getXSecType();
-    int xSecDetail = _outputSelection->getXSecDetail();
 
-    if (xSecType == ActOutputSelection::ROOT) {
-#ifdef ACT_USE_ROOT
-      output = new ActROOTOutput(xSecFileName.c_str(), xSecDetail);
-#endif
-    } else {
-      output = new ActStreamOutput(xSecFileName.c_str(), xSecDetail);
+    // Each shard writes its own cross-section output file, e.g. for the energy graphs
+    if (_nShards > 0 && _iShard > 0) {
+      std::string extension = xSecFileName.substr(this->getBaseFileName().size());
+      xSecFileName = this->getReportFileName(extension);
     }
 
-    cout<<"Creating output class "<<output->getTypeName()
-	<<"; fileName = "<<xSecFileName<<", levelOfDetail flag = "
-	<<xSecDetail<<endl;
+    output = this->createOutput(xSecFileName, _outputSelection->getXSecType(),
+				_outputSelection->getXSecDetail());
 
   }
 
@@ -143,25 +327,323 @@ ActAbsOutput* ActAbsRun::selectDecayOutput() {
   ActAbsOutput* output(0);
 
   if (_outputSelection != 0) {
+    output = this->createOutput(_outputSelection->getDecayFileName(),
+				_outputSelection->getDecayType(),
+				_outputSelection->getDecayDetail());
+  }
+
+  return output;
+
+}
 
-    std::string decayFileName = _outputSelection->getDecayFileName();
-    int decayType = _outputSelection->getDecayType();
-    int decayDetail = _outputSelection->getDecayDetail();
+ActAbsOutput* ActAbsRun::createOutput(const std::string& fileName, int type, int levelOfDetail) {
 
-    if (decayType == ActOutputSelection::ROOT) {
+  ActAbsOutput* output(0);
+
+  if (type == ActOutputSelection::ROOT) {
 #ifdef ACT_USE_ROOT
-      output = new ActROOTOutput(decayFileName.c_str(), decayDetail);
+    output = new ActROOTOutput(fileName.c_str(), levelOfDetail);
 #endif
+  } else if (type == ActOutputSelection::Binary) {
+    output = new ActBinaryOutput(fileName.c_str(), levelOfDetail);
+  } else {
+    output = new ActStreamOutput(fileName.c_str(), levelOfDetail);
+  }
+
+  if (output != 0) {
+    cout<<"Creating output class "<<output->getTypeName()
+	<<"; fileName = "<<fileName<<", levelOfDetail flag = "
+	<<levelOfDetail<<endl;
+  }
+
+  return output;
+
+}
+
+bool ActAbsRun::createOtherSpectra() {
+
+  ActBeamSpectrum* inputBeam = _input->getSpectrum();
+  if (inputBeam == 0) {return false;}
+
+  // Each spectrum is "cosmic" or "gordon", with an optional "*scale"
+  std::string spectra = _otherSpectra + ",";
+  size_t start(0), comma(0);
+  while ((comma = spectra.find(',', start)) != std::string::npos) {
+
+    std::string item = spectra.substr(start, comma - start);
+    start = comma + 1;
+    if (item.size() == 0) {continue;}
+
+    std::string type(item);
+    double scale(1.0);
+    size_t star = item.find('*');
+    if (star != std::string::npos) {
+      type = item.substr(0, star);
+      char* end(0);
+      std::string scaleText = item.substr(star + 1);
+      scale = strtod(scaleText.c_str(), &end);
+      if (scaleText.size() == 0 || *end != '\0' || scale <= 0.0) {
+	cout<<"Error in ActAbsRun::createOtherSpectra. Invalid scale factor in "<<item<<endl;
+	_input->clearOtherSpectra();
+	return false;
+      }
+    }
+
+    int ZBeam = inputBeam->getZ();
+    double ABeam = inputBeam->getA();
+    ActBeamSpectrum* spectrum(0);
+    if (type.compare("cosmic") == 0) {
+      spectrum = new ActCosmicSpectrum("CosmicRays", ZBeam, ABeam);
+    } else if (type.compare("gordon") == 0) {
+      spectrum = new ActGordonSpectrum("GordonSpectrum", ZBeam, ABeam);
     } else {
-      output = new ActStreamOutput(decayFileName.c_str(), decayDetail);
+      cout<<"Error in ActAbsRun::createOtherSpectra. Unknown spectrum "<<type
+	  <<"; use cosmic or gordon"<<endl;
+      _input->clearOtherSpectra();
+      return false;
     }
 
-    cout<<"Creating output class "<<output->getTypeName()
-	<<"; fileName = "<<decayFileName<<", levelOfDetail flag = "
-	<<decayDetail<<endl;
+    if (star != std::string::npos) {
+      std::string name = spectrum->getName() + "*" + item.substr(star + 1);
+      spectrum = new ActScaledSpectrum(name.c_str(), spectrum, scale);
+    }
+
+    spectrum->setEnergies(inputBeam->getEStart(), inputBeam->getEEnd(), inputBeam->getdE());
+    _input->addOtherSpectrum(spectrum);
+    cout<<"Also calculating the production rates for the spectrum "<<spectrum->getName()<<endl;
 
   }
 
-  return output;
+  return true;
+
+}
+
+void ActAbsRun::outputOtherSpectra() {
+
+  ActTarget* target = _input->getTarget();
+  ActProdNuclideList* prodList = _input->getProdNuclideList();
+  ActAbsDecayAlgorithm* decayAlgorithm = _input->getDecayAlgorithm();
+  if (target == 0 || prodList == 0 || decayAlgorithm == 0 || _outputSelection == 0) {return;}
+
+  ActRunStatistics* statistics = ActRunStatistics::getInstance();
+  std::vector<ActBeamSpectrum*> spectra = _input->getOtherSpectra();
+
+  int iS;
+  for (iS = 0; iS < (int) spectra.size(); iS++) {
+
+    target->useSpectrum(iS + 1);
+
+    // The file names have the spectrum name, e.g. "_GordonSpectrum" or "_CosmicRays_x2.5"
+    std::string tag = spectra[iS]->getName();
+    size_t star = tag.find('*');
+    if (star != std::string::npos) {tag.replace(star, 1, "_x");}
+
+    statistics->startPhase("output");
+    ActAbsOutput* xSecOutput = 
+      this->createOutput(this->getTaggedFileName(_outputSelection->getXSecFileName(), tag),
+			 _outputSelection->getXSecType(), _outputSelection->getXSecDetail());
+    if (xSecOutput != 0) {
+      xSecOutput->openFile();
+      // Same first line as the main cross-section file (see ActTarget::calcXSections)
+      xSecOutput->outputLineOfText("Cross-sections for target-product nuclide pairs");
+      target->setOutput(xSecOutput);
+      target->outputXSecSummary(prodList);
+      target->setOutput(0);
+      xSecOutput->closeFile();
+      delete xSecOutput;
+    }
+    statistics->stopPhase("output");
+
+    ActAbsOutput* decayOutput =
+      this->createOutput(this->getTaggedFileName(_outputSelection->getDecayFileName(), tag),
+			 _outputSelection->getDecayType(), _outputSelection->getDecayDetail());
+    if (decayOutput != 0) {
+      decayOutput->openFile();
+      if (_calcStatus != 0) {decayOutput->setCalcStatus(_calcStatus);}
+      statistics->startPhase("decay");
+      decayAlgorithm->calculateDecays(decayOutput);
+      statistics->stopPhase("decay");
+      decayOutput->closeFile();
+      delete decayOutput;
+    }
+
+  }
+
+  target->useSpectrum(0);
+
+}
+
+void ActAbsRun::outputEnsemble(ActEnsemble* ensemble) {
+
+  if (ensemble == 0 || _outputSelection == 0) {return;}
+
+  ActRunStatistics* statistics = ActRunStatistics::getInstance();
+  statistics->startPhase("ensemble");
+  ensemble->finish();
+  statistics->stopPhase("ensemble");
+
+  statistics->startPhase("output");
+  ActAbsOutput* output =
+    this->createOutput(this->getTaggedFileName(_outputSelection->getDecayFileName(), "Ensemble"),
+		       _outputSelection->getDecayType(), _outputSelection->getDecayDetail());
+  if (output != 0) {
+    output->openFile();
+    ensemble->output(output, _input->getProdNuclideList(), _input->getTime());
+    output->closeFile();
+    cout<<"Written the ensemble statistics to "<<output->getFileName()<<endl;
+    delete output;
+  }
+  statistics->stopPhase("output");
+
+}
+
+std::string ActAbsRun::getTaggedFileName(const std::string& fileName, const std::string& tag) {
+
+  std::string taggedName(fileName);
+  size_t dot = fileName.find_last_of('.');
+  size_t slash = fileName.find_last_of('/');
+  if (dot != std::string::npos && (slash == std::string::npos || dot > slash)) {
+    taggedName.insert(dot, "_" + tag);
+  } else {
+    taggedName += "_" + tag;
+  }
+
+  return taggedName;
+
+}
+
+std::string ActAbsRun::getCheckpointKey(bool withShard) {
+
+  // Everything that changes the cross-section results or their output
+  std::string key("");
+  if (_input == 0) {return key;}
+
+  ActNumberFormat format(ActNumberFormat::Shortest);
+
+  ActTarget* target = _input->getTarget();
+  if (target != 0) {
+    key += "target "; format.append(key, target->getZ());
+    int nIsotopes = target->getNIsotopes();
+    int it;
+    for (it = 0; it < nIsotopes; it++) {
+      ActTargetNuclide* isotope = target->getIsotope(it);
+      if (isotope == 0) {continue;}
+      key += ' '; format.append(key, isotope->getA());
+      key += ':'; format.append(key, isotope->getFraction());
+    }
+    key += '\n';
+  }
+
+  ActBeamSpectrum* spectrum = _input->getSpectrum();
+  if (spectrum != 0) {
+    key += "spectrum "; key += spectrum->getName();
+    key += ' '; format.append(key, spectrum->getEStart());
+    key += ' '; format.append(key, spectrum->getdE());
+    key += ' '; format.append(key, spectrum->getnE());
+    key += '\n';
+  }
+
+  ActProdNuclideList* prodList = _input->getProdNuclideList();
+  if (prodList != 0) {
+    key += "products "; format.append(key, prodList->getNProdNuclides()); key += '\n';
+  }
+
+  key += "model "; key += _input->getOption();
+  key += ' '; format.append(key, _input->getCalcInt()); key += '\n';
+
+  if (_outputSelection != 0) {
+    key += "xSec "; key += _outputSelection->getXSecFileName();
+    key += ' '; format.append(key, _outputSelection->getXSecType());
+    key += ' '; format.append(key, _outputSelection->getXSecDetail());
+    key += "\ndecay "; key += _outputSelection->getDecayFileName();
+    key += ' '; format.append(key, _outputSelection->getDecayType());
+    key += ' '; format.append(key, _outputSelection->getDecayDetail());
+    key += '\n';
+  }
+
+  if (withShard == true && _nShards > 0) {
+    key += "shard "; format.append(key, _iShard);
+    key += ' '; format.append(key, _nShards); key += '\n';
+  }
+
+  return key;
+
+}
+
+std::string ActAbsRun::getSigmaMatrixKey() {
+
+  // Everything that changes the cross-sections of all target-product pairs; the
+  // target isotopes and products are the keys of the stored rows
+  std::string key("");
+  if (_input == 0) {return key;}
+
+  ActNumberFormat format(ActNumberFormat::Shortest);
+
+  ActBeamSpectrum* spectrum = _input->getSpectrum();
+  if (spectrum != 0) {
+    key += "beam ";
+    ActNuclide* beam = spectrum->getNuclide();
+    if (beam != 0) {
+      format.append(key, beam->getfZ()); key += ' '; format.append(key, beam->getA());
+    }
+    key += ' '; format.append(key, spectrum->getEStart());
+    key += ' '; format.append(key, spectrum->getdE());
+    key += ' '; format.append(key, spectrum->getnE());
+    key += '\n';
+  }
+
+  key += "model "; key += _input->getOption();
+  key += ' '; format.append(key, _input->getCalcInt());
+
+  // The model version and the hashes of the models and data tables. The model hash uses
+  // no decay data, since the side branches of its products would change it when nuclides
+  // are added.
+  ActAbsXSecAlgorithm* algorithm = _input->getXSecAlgorithm();
+  if (algorithm != 0) {
+    std::string dataTables = algorithm->getListOfDataTables();
+    ActProdNuclideList noProducts;
+    ActXSecEngine engine(&noProducts, dataTables.c_str(), algorithm->getMinDataSigma(), false);
+    key += ' '; format.append(key, (int) ActModelVersion::ModelVersion);
+    key += ' '; key += ActModelVersion::toString(ActModelVersion::calcModelHash(&engine));
+    key += ' '; key += ActModelVersion::toString(ActModelVersion::calcDataTablesHash(dataTables));
+    key += ' '; format.append(key, algorithm->getMinDataSigma());
+  }
+  key += '\n';
+
+  key += "minSigma "; format.append(key, _minSigma); key += '\n';
+  key += "precision "; format.append(key, _sigmaMatrixPrecision); key += '\n';
+
+  return key;
+
+}
+
+std::string ActAbsRun::getBaseFileName() {
+
+  // The cross-section output file name without its extension
+  std::string fileName("");
+  if (_outputSelection == 0) {return fileName;}
+
+  fileName = _outputSelection->getXSecFileName();
+  size_t dot = fileName.find_last_of('.');
+  size_t slash = fileName.find_last_of('/');
+  if (dot != std::string::npos && (slash == std::string::npos || dot > slash)) {
+    fileName.erase(dot);
+  }
+
+  return fileName;
+
+}
+
+std::string ActAbsRun::getReportFileName(const std::string& suffix) {
+
+  // Use the cross-section output file name, replacing its extension.
+  // The files of each shard also have the shard tag.
+  std::string fileName = this->getBaseFileName();
+  if (_outputSelection == 0) {return fileName;}
+
+  if (_nShards > 0 && _iShard > 0) {fileName += ActShard::getTag(_iShard, _nShards);}
+  fileName += suffix;
+
+  return fileName;
 
 }
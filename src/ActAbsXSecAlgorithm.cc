@@ -0,0 +1,48 @@
+// Abstract class for defining algorithms for cross-section calculations
+
+#include "Activia/ActAbsXSecAlgorithm.hh"
+#include "Activia/ActNucleiData.hh"
+#include "Activia/ActAbsCalcStatus.hh"
+
+void ActAbsXSecAlgorithm::calcCrossSections(const std::vector<double>& energies,
+					    std::vector<double>& sigmas, std::vector<int>& passed) {
+
+  int nE = (int) energies.size();
+  sigmas.assign(nE, 0.0);
+  passed.assign(nE, 0);
+
+  if (_nucleiData == 0) {return;}
+  if (_recordFactors == true) {this->startRecord(nE);}
+
+  int iE;
+  for (iE = 0; iE < nE; iE++) {
+
+    // Stop if the calculation has been aborted
+    if (_calcStatus != 0 && _calcStatus->canRunCode() == false) {break;}
+
+    _nucleiData->setEnergy(energies[iE]);
+
+    if (this->passESelection(_nucleiData) == true) {
+      passed[iE] = 1;
+      if (_recordFactors == true) {_nucleiData->setUpdateFactor(1.0); _usedData = false;}
+      sigmas[iE] = this->calcCrossSection();
+      if (_recordFactors == true) {this->record(iE);}
+    }
+
+  }
+
+}
+
+void ActAbsXSecAlgorithm::startRecord(int nE) {
+
+  _updateFactors.assign(nE, 1.0);
+  _dataFlags.assign(nE, 0);
+
+}
+
+void ActAbsXSecAlgorithm::record(int iE) {
+
+  _updateFactors[iE] = _nucleiData->getUpdateFactor();
+  _dataFlags[iE] = (_usedData == true) ? 1 : 0;
+
+}
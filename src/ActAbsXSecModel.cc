@@ -1,14 +1,33 @@
 // Abstract class for cross section empirical models/formulae
 
 #include "Activia/ActAbsXSecModel.hh"
+#include "Activia/ActEnergyFactorCache.hh"
+#include "Activia/ActNucleiData.hh"
+#include "Activia/ActTrace.hh"
 
 ActAbsXSecModel::ActAbsXSecModel(std::string name, int debug) : 
-  _name(name), _sigma(0.0), _formulae(), _debug(debug)
+  _name(name), _traceName(ActTrace::intern(name)), _sigma(0.0), _formulae(), _debug(debug)
 {
   // Constructor
 }
 
+void ActAbsXSecModel::resetName(std::string name) {
+  _name = name;
+  _traceName = ActTrace::intern(name);
+}
+
 ActAbsXSecModel::~ActAbsXSecModel() 
 {
   // Destructor
 }
+
+double ActAbsXSecModel::getEnergyFactor(int factor, ActNucleiData* data) {
+
+  // Use the precalculated value if the nuclei data has an energy factor cache
+  ActEnergyFactorCache* cache = data->getEnergyFactorCache();
+  if (cache != 0) {return cache->getFactor(factor, *data);}
+
+  return ActEnergyFactorCache::calcFactor(_formulae, factor, data->getat(), data->getzt(),
+					  data->gete(), data->getezero());
+
+}
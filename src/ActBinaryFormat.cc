@@ -0,0 +1,493 @@
+// Class defining the column codecs and byte order helpers
+// for the columnar binary output files
+
+#include "Activia/ActBinaryFormat.hh"
+
+#include <cmath>
+#include <cstring>
+
+int ActBinaryFormat::findColumnType(const std::vector<double>& values) {
+
+  // Use integers if all values are exactly representable as 32-bit integers.
+  // Negative zero is kept as a double, so that decoding gives the same bits.
+  int nValues = (int) values.size();
+  int i;
+  for (i = 0; i < nValues; i++) {
+
+    double value = values[i];
+    if (!(value >= -2147483648.0 && value <= 2147483647.0)) {return ActBinaryFormat::Float64;}
+    if (value != floor(value)) {return ActBinaryFormat::Float64;}
+    if (value == 0.0 && std::signbit(value)) {return ActBinaryFormat::Float64;}
+
+  }
+
+  return ActBinaryFormat::Int32;
+
+}
+
+int ActBinaryFormat::encode(const std::vector<double>& values, int type,
+			    std::vector<unsigned char>& bytes) {
+
+  // Encode the values, but keep the raw bytes if the encoding is not smaller
+  std::vector<unsigned char> raw;
+  ActBinaryFormat::encodeRaw(values, type, raw);
+
+  int codec(ActBinaryFormat::Raw);
+  if (type == ActBinaryFormat::Int32) {
+    ActBinaryFormat::encodeDeltaVarint(values, bytes);
+    codec = ActBinaryFormat::DeltaVarint;
+  } else {
+    ActBinaryFormat::encodeXorShuffleRLE(values, type, bytes);
+    codec = ActBinaryFormat::XorShuffleRLE;
+  }
+
+  if (bytes.size() >= raw.size()) {
+    bytes.swap(raw);
+    codec = ActBinaryFormat::Raw;
+  }
+
+  return codec;
+
+}
+
+bool ActBinaryFormat::decode(const std::vector<unsigned char>& bytes, int type, int codec,
+			     int nValues, std::vector<double>& values) {
+
+  values.clear();
+  if (nValues < 0) {return false;}
+
+  bool ok(false);
+  if (codec == ActBinaryFormat::Raw) {
+    ok = ActBinaryFormat::decodeRaw(bytes, type, nValues, values);
+  } else if (codec == ActBinaryFormat::XorShuffleRLE && type != ActBinaryFormat::Int32) {
+    ok = ActBinaryFormat::decodeXorShuffleRLE(bytes, type, nValues, values);
+  } else if (codec == ActBinaryFormat::DeltaVarint && type == ActBinaryFormat::Int32) {
+    ok = ActBinaryFormat::decodeDeltaVarint(bytes, nValues, values);
+  }
+
+  return ok;
+
+}
+
+void ActBinaryFormat::encodeRaw(const std::vector<double>& values, int type,
+				std::vector<unsigned char>& bytes) {
+
+  bytes.clear();
+  int nValues = (int) values.size();
+  int i;
+
+  for (i = 0; i < nValues; i++) {
+
+    if (type == ActBinaryFormat::Int32) {
+
+      long long intValue = (long long) values[i];
+      ActBinaryFormat::putUInt(bytes, (unsigned long long) (intValue & 0xffffffffLL), 4);
+
+    } else if (type == ActBinaryFormat::Float32) {
+
+      float floatValue = (float) values[i];
+      unsigned int bits(0);
+      memcpy(&bits, &floatValue, sizeof(float));
+      ActBinaryFormat::putUInt(bytes, bits, 4);
+
+    } else {
+
+      unsigned long long bits(0);
+      memcpy(&bits, &values[i], sizeof(double));
+      ActBinaryFormat::putUInt(bytes, bits, 8);
+
+    }
+
+  }
+
+}
+
+bool ActBinaryFormat::decodeRaw(const std::vector<unsigned char>& bytes, int type,
+				int nValues, std::vector<double>& values) {
+
+  int nBytes = (type == ActBinaryFormat::Float64) ? 8 : 4;
+  if (bytes.size() != (size_t) nValues*nBytes) {return false;}
+
+  values.resize(nValues);
+  size_t pos(0);
+  int i;
+
+  for (i = 0; i < nValues; i++) {
+
+    unsigned long long bits(0);
+    ActBinaryFormat::getUInt(bytes, pos, bits, nBytes);
+
+    if (type == ActBinaryFormat::Int32) {
+      int intValue = (int) (unsigned int) bits;
+      values[i] = intValue*1.0;
+    } else if (type == ActBinaryFormat::Float32) {
+      unsigned int floatBits = (unsigned int) bits;
+      float floatValue(0.0);
+      memcpy(&floatValue, &floatBits, sizeof(float));
+      values[i] = floatValue;
+    } else {
+      memcpy(&values[i], &bits, sizeof(double));
+    }
+
+  }
+
+  return true;
+
+}
+
+void ActBinaryFormat::encodeXorShuffleRLE(const std::vector<double>& values, int type,
+					  std::vector<unsigned char>& bytes) {
+
+  bytes.clear();
+
+  // XOR each value with the previous one, then group the n-th bytes
+  // of all values together. Slowly changing values give many zero bytes.
+  int width = (type == ActBinaryFormat::Float32) ? 4 : 8;
+  size_t nValues = values.size();
+  std::vector<unsigned char> shuffled(width*nValues);
+  unsigned long long previous(0);
+  size_t i;
+  int iB;
+
+  for (i = 0; i < nValues; i++) {
+
+    unsigned long long bits(0);
+    if (width == 4) {
+      float floatValue = (float) values[i];
+      unsigned int floatBits(0);
+      memcpy(&floatBits, &floatValue, sizeof(float));
+      bits = floatBits;
+    } else {
+      memcpy(&bits, &values[i], sizeof(double));
+    }
+    unsigned long long xorBits = bits ^ previous;
+    previous = bits;
+
+    for (iB = 0; iB < width; iB++) {
+      shuffled[iB*nValues + i] = (unsigned char) ((xorBits >> (8*iB)) & 0xff);
+    }
+
+  }
+
+  // Run-length encoding: a control byte c < 128 is followed by c+1 literal bytes,
+  // while c >= 128 is followed by one byte that is repeated c-126 times (2 to 129)
+  size_t nBytes = shuffled.size();
+  size_t pos(0);
+
+  while (pos < nBytes) {
+
+    size_t run(1);
+    while (pos + run < nBytes && run < 129 && shuffled[pos + run] == shuffled[pos]) {run++;}
+
+    if (run >= 3) {
+
+      bytes.push_back((unsigned char) (run + 126));
+      bytes.push_back(shuffled[pos]);
+      pos += run;
+
+    } else {
+
+      // Collect literal bytes until the next run of at least 3 bytes
+      size_t start(pos);
+      size_t nLiteral(0);
+      while (pos < nBytes && nLiteral < 128) {
+	if (pos + 2 < nBytes && shuffled[pos] == shuffled[pos + 1] &&
+	    shuffled[pos] == shuffled[pos + 2]) {break;}
+	pos++; nLiteral++;
+      }
+
+      bytes.push_back((unsigned char) (nLiteral - 1));
+      bytes.insert(bytes.end(), shuffled.begin() + start, shuffled.begin() + pos);
+
+    }
+
+  }
+
+}
+
+bool ActBinaryFormat::decodeXorShuffleRLE(const std::vector<unsigned char>& bytes, int type,
+					  int nValues, std::vector<double>& values) {
+
+  int width = (type == ActBinaryFormat::Float32) ? 4 : 8;
+  size_t nShuffled = width*((size_t) nValues);
+  std::vector<unsigned char> shuffled;
+  shuffled.reserve(nShuffled);
+
+  size_t nBytes = bytes.size();
+  size_t pos(0);
+
+  while (pos < nBytes) {
+
+    unsigned int control = bytes[pos++];
+
+    if (control < 128) {
+
+      size_t nLiteral = control + 1;
+      if (pos + nLiteral > nBytes) {return false;}
+      shuffled.insert(shuffled.end(), bytes.begin() + pos, bytes.begin() + pos + nLiteral);
+      pos += nLiteral;
+
+    } else {
+
+      if (pos >= nBytes) {return false;}
+      shuffled.insert(shuffled.end(), control - 126, bytes[pos++]);
+
+    }
+
+    if (shuffled.size() > nShuffled) {return false;}
+
+  }
+
+  if (shuffled.size() != nShuffled) {return false;}
+
+  values.resize(nValues);
+  unsigned long long previous(0);
+  int i, iB;
+
+  for (i = 0; i < nValues; i++) {
+
+    unsigned long long xorBits(0);
+    for (iB = 0; iB < width; iB++) {
+      xorBits |= ((unsigned long long) shuffled[iB*((size_t) nValues) + i]) << (8*iB);
+    }
+
+    unsigned long long bits = xorBits ^ previous;
+    previous = bits;
+    if (width == 4) {
+      unsigned int floatBits = (unsigned int) bits;
+      float floatValue(0.0);
+      memcpy(&floatValue, &floatBits, sizeof(float));
+      values[i] = floatValue;
+    } else {
+      memcpy(&values[i], &bits, sizeof(double));
+    }
+
+  }
+
+  return true;
+
+}
+
+void ActBinaryFormat::encodeDeltaVarint(const std::vector<double>& values,
+					std::vector<unsigned char>& bytes) {
+
+  bytes.clear();
+
+  // Store the difference to the previous value, using zig-zag encoding so that
+  // small negative differences are also small, in 7-bit groups
+  long long previous(0);
+  size_t nValues = values.size();
+  size_t i;
+
+  for (i = 0; i < nValues; i++) {
+
+    long long value = (long long) values[i];
+    long long delta = value - previous;
+    previous = value;
+
+    unsigned long long zigZag = (((unsigned long long) delta) << 1) ^
+      ((unsigned long long) (delta >> 63));
+
+    while (zigZag >= 0x80) {
+      bytes.push_back((unsigned char) ((zigZag & 0x7f) | 0x80));
+      zigZag >>= 7;
+    }
+    bytes.push_back((unsigned char) zigZag);
+
+  }
+
+}
+
+bool ActBinaryFormat::decodeDeltaVarint(const std::vector<unsigned char>& bytes,
+					int nValues, std::vector<double>& values) {
+
+  values.resize(nValues);
+
+  long long previous(0);
+  size_t nBytes = bytes.size();
+  size_t pos(0);
+  int i;
+
+  for (i = 0; i < nValues; i++) {
+
+    unsigned long long zigZag(0);
+    int shift(0);
+    bool more(true);
+
+    while (more == true) {
+      if (pos >= nBytes || shift > 63) {return false;}
+      unsigned char byte = bytes[pos++];
+      zigZag |= ((unsigned long long) (byte & 0x7f)) << shift;
+      shift += 7;
+      more = ((byte & 0x80) != 0);
+    }
+
+    long long delta = (long long) (zigZag >> 1) ^ -((long long) (zigZag & 1));
+    previous += delta;
+    values[i] = previous*1.0;
+
+  }
+
+  return (pos == nBytes);
+
+}
+
+void ActBinaryFormat::encodeFooter(const std::vector<TableIndex>& tables,
+				   const std::vector<std::string>& textLines,
+				   std::vector<unsigned char>& bytes) {
+
+  bytes.clear();
+
+  size_t nTables = tables.size();
+  ActBinaryFormat::putUInt(bytes, nTables, 4);
+
+  size_t iT, iC, iG;
+  for (iT = 0; iT < nTables; iT++) {
+
+    const TableIndex& table = tables[iT];
+    ActBinaryFormat::putString(bytes, table.name);
+
+    size_t nColumns = table.columns.size();
+    ActBinaryFormat::putUInt(bytes, nColumns, 4);
+    for (iC = 0; iC < nColumns; iC++) {
+      ActBinaryFormat::putString(bytes, table.columns[iC]);
+    }
+
+    ActBinaryFormat::putUInt(bytes, table.nRows, 8);
+
+    size_t nGroups = table.groups.size();
+    ActBinaryFormat::putUInt(bytes, nGroups, 4);
+
+    for (iG = 0; iG < nGroups; iG++) {
+
+      const RowGroup& group = table.groups[iG];
+      ActBinaryFormat::putUInt(bytes, group.nRows, 8);
+
+      for (iC = 0; iC < nColumns; iC++) {
+	const ColumnBlock& block = group.blocks[iC];
+	ActBinaryFormat::putUInt(bytes, block.type, 1);
+	ActBinaryFormat::putUInt(bytes, block.codec, 1);
+	ActBinaryFormat::putUInt(bytes, block.offset, 8);
+	ActBinaryFormat::putUInt(bytes, block.nBytes, 8);
+      }
+
+    }
+
+  }
+
+  size_t nLines = textLines.size();
+  ActBinaryFormat::putUInt(bytes, nLines, 4);
+
+  size_t iL;
+  for (iL = 0; iL < nLines; iL++) {
+    ActBinaryFormat::putString(bytes, textLines[iL]);
+  }
+
+}
+
+bool ActBinaryFormat::decodeFooter(const std::vector<unsigned char>& bytes,
+				   std::vector<TableIndex>& tables,
+				   std::vector<std::string>& textLines) {
+
+  tables.clear();
+  textLines.clear();
+
+  size_t pos(0);
+  unsigned long long nTables(0), nColumns(0), nGroups(0), nLines(0), value(0);
+
+  if (ActBinaryFormat::getUInt(bytes, pos, nTables, 4) == false) {return false;}
+
+  unsigned long long iT, iC, iG, iL;
+  for (iT = 0; iT < nTables; iT++) {
+
+    TableIndex table;
+    if (ActBinaryFormat::getString(bytes, pos, table.name) == false) {return false;}
+
+    if (ActBinaryFormat::getUInt(bytes, pos, nColumns, 4) == false) {return false;}
+    table.columns.resize(nColumns);
+    for (iC = 0; iC < nColumns; iC++) {
+      if (ActBinaryFormat::getString(bytes, pos, table.columns[iC]) == false) {return false;}
+    }
+
+    if (ActBinaryFormat::getUInt(bytes, pos, table.nRows, 8) == false) {return false;}
+    if (ActBinaryFormat::getUInt(bytes, pos, nGroups, 4) == false) {return false;}
+
+    table.groups.resize(nGroups);
+    for (iG = 0; iG < nGroups; iG++) {
+
+      RowGroup& group = table.groups[iG];
+      if (ActBinaryFormat::getUInt(bytes, pos, group.nRows, 8) == false) {return false;}
+
+      group.blocks.resize(nColumns);
+      for (iC = 0; iC < nColumns; iC++) {
+	ColumnBlock& block = group.blocks[iC];
+	if (ActBinaryFormat::getUInt(bytes, pos, value, 1) == false) {return false;}
+	block.type = (int) value;
+	if (ActBinaryFormat::getUInt(bytes, pos, value, 1) == false) {return false;}
+	block.codec = (int) value;
+	if (ActBinaryFormat::getUInt(bytes, pos, block.offset, 8) == false) {return false;}
+	if (ActBinaryFormat::getUInt(bytes, pos, block.nBytes, 8) == false) {return false;}
+      }
+
+    }
+
+    tables.push_back(table);
+
+  }
+
+  if (ActBinaryFormat::getUInt(bytes, pos, nLines, 4) == false) {return false;}
+  textLines.resize(nLines);
+  for (iL = 0; iL < nLines; iL++) {
+    if (ActBinaryFormat::getString(bytes, pos, textLines[iL]) == false) {return false;}
+  }
+
+  return true;
+
+}
+
+void ActBinaryFormat::putUInt(std::vector<unsigned char>& bytes, unsigned long long value,
+			      int nBytes) {
+
+  int i;
+  for (i = 0; i < nBytes; i++) {
+    bytes.push_back((unsigned char) ((value >> (8*i)) & 0xff));
+  }
+
+}
+
+void ActBinaryFormat::putString(std::vector<unsigned char>& bytes, const std::string& value) {
+
+  ActBinaryFormat::putUInt(bytes, value.size(), 4);
+  bytes.insert(bytes.end(), value.begin(), value.end());
+
+}
+
+bool ActBinaryFormat::getUInt(const std::vector<unsigned char>& bytes, size_t& pos,
+			      unsigned long long& value, int nBytes) {
+
+  value = 0;
+  if (pos + nBytes > bytes.size()) {return false;}
+
+  int i;
+  for (i = 0; i < nBytes; i++) {
+    value |= ((unsigned long long) bytes[pos + i]) << (8*i);
+  }
+
+  pos += nBytes;
+  return true;
+
+}
+
+bool ActBinaryFormat::getString(const std::vector<unsigned char>& bytes, size_t& pos,
+				std::string& value) {
+
+  value = "";
+  unsigned long long length(0);
+  if (ActBinaryFormat::getUInt(bytes, pos, length, 4) == false) {return false;}
+  if (pos + length > bytes.size()) {return false;}
+
+  value.assign(bytes.begin() + pos, bytes.begin() + pos + length);
+  pos += length;
+  return true;
+
+}
@@ -0,0 +1,469 @@
+// Class for output data to columnar binary files
+
+#include "Activia/ActBinaryOutput.hh"
+#include "Activia/ActTrace.hh"
+#include "Activia/ActGraphPoint.hh"
+#include "Activia/ActOutputSelection.hh"
+
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+using std::cout;
+using std::endl;
+
+ActBinaryOutput::ActBinaryOutput(const char* fileName, int levelOfDetail) : ActAbsOutput(fileName, levelOfDetail)
+{
+  // Constructor
+  _type = ActOutputSelection::Binary;
+  _typeName = "Binary";
+  _offset = 0;
+  _tables.clear(); _pending.clear();
+  _tableIndex.clear();
+  _currentTable = -1;
+  _textLines.clear();
+}
+
+ActBinaryOutput::~ActBinaryOutput()
+{
+  // Destructor
+  this->closeFile();
+}
+
+void ActBinaryOutput::openFile() {
+
+  _stream.open(_fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (_stream.is_open() == false) {
+    cout<<"Error in ActBinaryOutput::openFile. Could not open "<<_fileName<<endl;
+    return;
+  }
+
+  _tables.clear(); _pending.clear();
+  _tableIndex.clear();
+  _currentTable = -1;
+  _textLines.clear();
+
+  const char* magic = ActBinaryFormat::getHeaderMagic();
+  _stream.write(magic, strlen(magic));
+  _offset = strlen(magic);
+
+}
+
+void ActBinaryOutput::setOptions() {
+
+}
+
+void ActBinaryOutput::outputLineOfText(const char* line) {
+
+  _textLines.push_back(std::string(line));
+
+}
+
+void ActBinaryOutput::outputLineOfText(std::string& line) {
+
+  _textLines.push_back(line);
+
+}
+
+void ActBinaryOutput::outputLineOfText(ActString& line) {
+
+  _textLines.push_back(line.getString());
+
+}
+
+void ActBinaryOutput::outputLineOfText(std::vector<ActString>& strings) {
+
+  // Use the same spacing as the text output
+  std::ostringstream line;
+  line.flags(std::ios::left);
+
+  int nStrings = (int) strings.size();
+  int i;
+
+  for (i = 0; i < nStrings; i++) {
+    ActString s = strings[i];
+    int nS = s.size() + 1;
+    line.width(nS); line << s.getData();
+  }
+
+  _textLines.push_back(line.str());
+
+}
+
+int ActBinaryOutput::findTable(const std::string& name, const std::vector<std::string>& columns) {
+
+  std::map<std::string, int>::iterator iter = _tableIndex.find(name);
+
+  if (iter != _tableIndex.end()) {
+
+    int index = iter->second;
+    if (_tables[index].columns != columns) {
+      cout<<"Error in ActBinaryOutput::findTable. The table "<<name
+	  <<" already exists with different columns"<<endl;
+      return -1;
+    }
+    return index;
+
+  }
+
+  ActBinaryFormat::TableIndex table;
+  table.name = name;
+  table.columns = columns;
+  table.nRows = 0;
+  table.groups.clear();
+
+  int index = (int) _tables.size();
+  _tables.push_back(table);
+  _pending.push_back(std::vector< std::vector<double> >(columns.size()));
+  _tableIndex[name] = index;
+
+  return index;
+
+}
+
+void ActBinaryOutput::addRow(int index, const double* values) {
+
+  if (index < 0 || index >= (int) _tables.size() || values == 0) {return;}
+
+  std::vector< std::vector<double> >& pending = _pending[index];
+  int nColumns = (int) pending.size();
+  int iCol;
+  for (iCol = 0; iCol < nColumns; iCol++) {
+    pending[iCol].push_back(values[iCol]);
+  }
+
+  _tables[index].nRows += 1;
+
+  // Write the row group if it is full, so that the memory use stays bounded
+  if (nColumns > 0 && pending[0].size() >= ActBinaryFormat::RowGroupSize) {
+    this->writeRowGroup(index);
+  }
+
+}
+
+void ActBinaryOutput::writeRowGroup(int index) {
+
+  std::vector< std::vector<double> >& pending = _pending[index];
+  int nColumns = (int) pending.size();
+  if (nColumns == 0 || pending[0].size() == 0) {return;}
+
+  ActBinaryFormat::RowGroup group;
+  group.nRows = pending[0].size();
+  group.blocks.resize(nColumns);
+
+  std::vector<unsigned char> bytes;
+  int iCol;
+
+  for (iCol = 0; iCol < nColumns; iCol++) {
+
+    ActBinaryFormat::ColumnBlock& block = group.blocks[iCol];
+    block.type = ActBinaryFormat::findColumnType(pending[iCol]);
+    block.codec = ActBinaryFormat::encode(pending[iCol], block.type, bytes);
+    block.offset = _offset;
+    block.nBytes = bytes.size();
+
+    if (_stream.is_open() == true && bytes.size() > 0) {
+      _stream.write((const char*) &bytes[0], bytes.size());
+    }
+    _offset += bytes.size();
+
+    pending[iCol].clear();
+
+  }
+
+  _tables[index].groups.push_back(group);
+
+}
+
+void ActBinaryOutput::outputTable(ActOutputTable& table) {
+
+  ACT_TRACE_SCOPE("ActBinaryOutput::outputTable", "output");
+
+  this->beginTable(table);
+
+  int nRows = table.getNRows();
+  int iRow;
+  for (iRow = 0; iRow < nRows; iRow++) {
+    this->outputTableRow(table, table.getRowData(iRow));
+  }
+
+  this->endTable(table);
+
+}
+
+void ActBinaryOutput::beginTable(ActOutputTable& table) {
+
+  std::vector<ActString> columnNames = table.getColumnNames();
+  std::vector<std::string> columns;
+
+  int nColumns = (int) columnNames.size();
+  int iCol;
+  for (iCol = 0; iCol < nColumns; iCol++) {
+    columns.push_back(columnNames[iCol].getString());
+  }
+
+  _currentTable = this->findTable(table.getName(), columns);
+
+}
+
+void ActBinaryOutput::outputTableRow(ActOutputTable& table, const double* values) {
+
+  if (_currentTable < 0) {return;}
+
+  if (table.getNColumns() != (int) _tables[_currentTable].columns.size()) {
+    cout<<"Error in ActBinaryOutput::outputTableRow. Row has "<<table.getNColumns()
+	<<" columns which should be "<<_tables[_currentTable].columns.size()<<endl;
+    return;
+  }
+
+  this->addRow(_currentTable, values);
+
+}
+
+void ActBinaryOutput::endTable(ActOutputTable&) {
+
+  _currentTable = -1;
+
+}
+
+void ActBinaryOutput::outputGraph(ActNucleiData& data,
+				  ActAbsGraph& graph) {
+
+  ACT_TRACE_SCOPE("ActBinaryOutput::outputGraph", "output");
+
+  // Store the graph points in the table with the graph name, using
+  // one row per point, which also contains the target and product (Z,A)
+  int nYAxes = graph.getnYAxes();
+  std::vector<std::string> yAxesNames = graph.getYAxesNames();
+
+  std::vector<std::string> columns;
+  columns.push_back("Zt");
+  columns.push_back("At");
+  columns.push_back("frac");
+  columns.push_back("Z");
+  columns.push_back("A");
+  columns.push_back(graph.getXAxisName());
+
+  int iY;
+  for (iY = 0; iY < nYAxes; iY++) {columns.push_back(yAxesNames[iY]);}
+
+  int index = this->findTable(graph.getName(), columns);
+  if (index < 0) {return;}
+
+  std::vector<double> row(columns.size(), 0.0);
+  row[0] = data.getzt();
+  row[1] = data.getat();
+  row[2] = data.getFraction();
+  row[3] = data.getz();
+  row[4] = data.geta();
+
+  std::vector<ActGraphPoint> points = graph.getPoints();
+  int nPoints = (int) points.size();
+  int iPoint;
+
+  for (iPoint = 0; iPoint < nPoints; iPoint++) {
+
+    ActGraphPoint& point = points[iPoint];
+    if (point.getnYValues() != nYAxes) {
+      cout<<"Error in ActBinaryOutput::outputGraph. Number of y values for point "
+	  <<iPoint<<" = "<<point.getnYValues()<<" != number of y axes = "<<nYAxes<<endl;
+      continue;
+    }
+
+    row[5] = point.getX();
+    std::vector<double> yValues = point.getYValues();
+    for (iY = 0; iY < nYAxes; iY++) {row[6+iY] = yValues[iY];}
+
+    this->addRow(index, &row[0]);
+
+  }
+
+  // For sparse graphs, store the grid description in a separate table,
+  // with one row for each run of omitted (Stored = 0) or stored bins
+  if (graph.hasGrid() == true) {
+
+    std::vector<std::string> gridColumns;
+    gridColumns.push_back("Zt");
+    gridColumns.push_back("At");
+    gridColumns.push_back("Z");
+    gridColumns.push_back("A");
+    gridColumns.push_back("Start");
+    gridColumns.push_back("Step");
+    gridColumns.push_back("Stored");
+    gridColumns.push_back("NBins");
+
+    std::string gridName(graph.getName()); gridName += "Grid";
+    int gridIndex = this->findTable(gridName, gridColumns);
+    if (gridIndex < 0) {return;}
+
+    double gridRow[8];
+    gridRow[0] = data.getzt(); gridRow[1] = data.getat();
+    gridRow[2] = data.getz(); gridRow[3] = data.geta();
+    gridRow[4] = graph.getGridStart(); gridRow[5] = graph.getGridStep();
+
+    std::vector<int> runs = graph.getGridRuns();
+    int nRuns = (int) runs.size();
+    int iR;
+    for (iR = 0; iR < nRuns; iR++) {
+      gridRow[6] = (double) (iR%2);
+      gridRow[7] = (double) runs[iR];
+      this->addRow(gridIndex, gridRow);
+    }
+
+  }
+
+}
+
+void ActBinaryOutput::writeFooter() {
+
+  std::vector<unsigned char> bytes;
+  ActBinaryFormat::encodeFooter(_tables, _textLines, bytes);
+
+  unsigned long long footerOffset = _offset;
+  if (bytes.size() > 0) {_stream.write((const char*) &bytes[0], bytes.size());}
+  _offset += bytes.size();
+
+  // The footer offset and the end magic word
+  std::vector<unsigned char> trailer;
+  ActBinaryFormat::putUInt(trailer, footerOffset, 8);
+  const char* magic = ActBinaryFormat::getFooterMagic();
+  trailer.insert(trailer.end(), magic, magic + strlen(magic));
+
+  _stream.write((const char*) &trailer[0], trailer.size());
+  _offset += trailer.size();
+
+}
+
+bool ActBinaryOutput::saveState(std::string& state) {
+
+  if (_stream.is_open() == false) {return false;}
+
+  _stream.flush();
+  if (_stream.fail()) {return false;}
+
+  // The pending rows are kept in the state instead of being written as a
+  // row group, so that the file is the same as the one from an uninterrupted run
+  std::vector<unsigned char> bytes, footer;
+  ActBinaryFormat::putUInt(bytes, _offset, 8);
+
+  ActBinaryFormat::encodeFooter(_tables, _textLines, footer);
+  ActBinaryFormat::putUInt(bytes, footer.size(), 8);
+  bytes.insert(bytes.end(), footer.begin(), footer.end());
+
+  ActBinaryFormat::putUInt(bytes, (unsigned long long) (_currentTable + 1), 4);
+
+  int nTables = (int) _pending.size();
+  int iT;
+  for (iT = 0; iT < nTables; iT++) {
+
+    int nColumns = (int) _pending[iT].size();
+    int iCol;
+    for (iCol = 0; iCol < nColumns; iCol++) {
+
+      std::vector<double>& values = _pending[iT][iCol];
+      ActBinaryFormat::putUInt(bytes, values.size(), 4);
+
+      size_t iV;
+      for (iV = 0; iV < values.size(); iV++) {
+	unsigned long long bits(0);
+	memcpy(&bits, &values[iV], sizeof(double));
+	ActBinaryFormat::putUInt(bytes, bits, 8);
+      }
+
+    }
+
+  }
+
+  state.assign(bytes.begin(), bytes.end());
+  return true;
+
+}
+
+bool ActBinaryOutput::resumeFile(const std::string& state) {
+
+  std::vector<unsigned char> bytes(state.begin(), state.end());
+  size_t pos(0);
+  unsigned long long offset(0), footerSize(0), currentTable(0);
+
+  if (ActBinaryFormat::getUInt(bytes, pos, offset, 8) == false ||
+      ActBinaryFormat::getUInt(bytes, pos, footerSize, 8) == false ||
+      pos + footerSize > bytes.size()) {return false;}
+
+  std::vector<unsigned char> footer(bytes.begin() + pos, bytes.begin() + pos + footerSize);
+  pos += footerSize;
+
+  std::vector<ActBinaryFormat::TableIndex> tables;
+  std::vector<std::string> textLines;
+  if (ActBinaryFormat::decodeFooter(footer, tables, textLines) == false ||
+      ActBinaryFormat::getUInt(bytes, pos, currentTable, 4) == false) {return false;}
+
+  int nTables = (int) tables.size();
+  std::vector< std::vector< std::vector<double> > > pending(nTables);
+  int iT;
+  for (iT = 0; iT < nTables; iT++) {
+
+    int nColumns = (int) tables[iT].columns.size();
+    pending[iT].resize(nColumns);
+
+    int iCol;
+    for (iCol = 0; iCol < nColumns; iCol++) {
+
+      unsigned long long nValues(0);
+      if (ActBinaryFormat::getUInt(bytes, pos, nValues, 4) == false) {return false;}
+
+      unsigned long long iV;
+      for (iV = 0; iV < nValues; iV++) {
+	unsigned long long bits(0);
+	if (ActBinaryFormat::getUInt(bytes, pos, bits, 8) == false) {return false;}
+	double value(0.0);
+	memcpy(&value, &bits, sizeof(double));
+	pending[iT][iCol].push_back(value);
+      }
+
+    }
+
+  }
+
+  // Discard anything written after the saved state
+  std::error_code error;
+  if (std::filesystem::file_size(_fileName, error) < offset || error) {
+    cout<<"Error in ActBinaryOutput::resumeFile. "<<_fileName<<" is shorter than the checkpoint"<<endl;
+    return false;
+  }
+  std::filesystem::resize_file(_fileName, offset, error);
+  if (error) {return false;}
+
+  _stream.open(_fileName.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+  if (_stream.is_open() == false) {return false;}
+  _stream.seekp(0, std::ios::end);
+
+  _offset = offset;
+  _tables = tables;
+  _pending = pending;
+  _textLines = textLines;
+  _currentTable = (int) currentTable - 1;
+
+  _tableIndex.clear();
+  for (iT = 0; iT < nTables; iT++) {_tableIndex[_tables[iT].name] = iT;}
+
+  return true;
+
+}
+
+void ActBinaryOutput::closeFile() {
+
+  ACT_TRACE_SCOPE("ActBinaryOutput::closeFile", "output");
+
+  if (_stream.is_open() == false) {return;}
+
+  // Write the remaining rows of all tables, then the index
+  int nTables = (int) _tables.size();
+  int iT;
+  for (iT = 0; iT < nTables; iT++) {this->writeRowGroup(iT);}
+
+  this->writeFooter();
+
+  _stream.close();
+
+}
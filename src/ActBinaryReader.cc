@@ -0,0 +1,185 @@
+// Class for reading tables from columnar binary output files
+
+#include "Activia/ActBinaryReader.hh"
+
+#include <cstring>
+#include <iostream>
+
+using std::cout;
+using std::endl;
+
+ActBinaryReader::ActBinaryReader(const char* fileName) : _fileName(fileName)
+{
+  // Constructor
+  _ok = false;
+  _tables.clear();
+  _textLines.clear();
+
+  _stream.open(fileName, std::ios::in | std::ios::binary);
+  if (_stream.is_open() == false) {
+    cout<<"Error in ActBinaryReader. Could not open "<<fileName<<endl;
+    return;
+  }
+
+  _ok = this->readIndex();
+  if (_ok == false) {
+    cout<<"Error in ActBinaryReader. "<<fileName<<" is not a valid binary output file"<<endl;
+  }
+
+}
+
+ActBinaryReader::~ActBinaryReader()
+{
+  // Destructor
+  if (_stream.is_open() == true) {_stream.close();}
+}
+
+bool ActBinaryReader::readIndex() {
+
+  const char* headerMagic = ActBinaryFormat::getHeaderMagic();
+  const char* footerMagic = ActBinaryFormat::getFooterMagic();
+  size_t nMagic = strlen(headerMagic);
+
+  // Check the start of the file
+  std::vector<char> word(nMagic);
+  _stream.seekg(0, std::ios::beg);
+  if (!_stream.read(&word[0], nMagic)) {return false;}
+  if (memcmp(&word[0], headerMagic, nMagic) != 0) {return false;}
+
+  // Then the trailer: footer offset and end magic word
+  _stream.seekg(0, std::ios::end);
+  unsigned long long fileSize = (unsigned long long) _stream.tellg();
+  size_t nTrailer = 8 + strlen(footerMagic);
+  if (fileSize < nMagic + nTrailer) {return false;}
+
+  std::vector<unsigned char> trailer(nTrailer);
+  _stream.seekg(fileSize - nTrailer, std::ios::beg);
+  if (!_stream.read((char*) &trailer[0], nTrailer)) {return false;}
+  if (memcmp(&trailer[8], footerMagic, strlen(footerMagic)) != 0) {return false;}
+
+  size_t pos(0);
+  unsigned long long footerOffset(0);
+  ActBinaryFormat::getUInt(trailer, pos, footerOffset, 8);
+  if (footerOffset < nMagic || footerOffset > fileSize - nTrailer) {return false;}
+
+  // Read and decode the footer
+  std::vector<unsigned char> footer(fileSize - nTrailer - footerOffset);
+  _stream.seekg(footerOffset, std::ios::beg);
+  if (footer.size() > 0 && !_stream.read((char*) &footer[0], footer.size())) {return false;}
+
+  return ActBinaryFormat::decodeFooter(footer, _tables, _textLines);
+
+}
+
+int ActBinaryReader::findTable(const std::string& tableName) const {
+
+  int nTables = (int) _tables.size();
+  int iT;
+  for (iT = 0; iT < nTables; iT++) {
+    if (_tables[iT].name == tableName) {return iT;}
+  }
+
+  return -1;
+
+}
+
+std::vector<std::string> ActBinaryReader::getTableNames() const {
+
+  std::vector<std::string> names;
+  int nTables = (int) _tables.size();
+  int iT;
+  for (iT = 0; iT < nTables; iT++) {names.push_back(_tables[iT].name);}
+
+  return names;
+
+}
+
+std::vector<std::string> ActBinaryReader::getColumnNames(const std::string& tableName) const {
+
+  std::vector<std::string> columns;
+  int index = this->findTable(tableName);
+  if (index >= 0) {columns = _tables[index].columns;}
+
+  return columns;
+
+}
+
+unsigned long long ActBinaryReader::getNRows(const std::string& tableName) const {
+
+  unsigned long long nRows(0);
+  int index = this->findTable(tableName);
+  if (index >= 0) {nRows = _tables[index].nRows;}
+
+  return nRows;
+
+}
+
+bool ActBinaryReader::readColumn(const std::string& tableName, const std::string& columnName,
+				 std::vector<double>& values) {
+
+  values.clear();
+  if (_ok == false) {return false;}
+
+  int index = this->findTable(tableName);
+  if (index < 0) {return false;}
+
+  const ActBinaryFormat::TableIndex& table = _tables[index];
+
+  int iCol(-1);
+  int nColumns = (int) table.columns.size();
+  int i;
+  for (i = 0; i < nColumns; i++) {
+    if (table.columns[i] == columnName) {iCol = i; break;}
+  }
+  if (iCol < 0) {return false;}
+
+  values.reserve(table.nRows);
+
+  // Only read the blocks of this column
+  std::vector<unsigned char> bytes;
+  std::vector<double> groupValues;
+  int nGroups = (int) table.groups.size();
+  int iG;
+
+  for (iG = 0; iG < nGroups; iG++) {
+
+    const ActBinaryFormat::RowGroup& group = table.groups[iG];
+    const ActBinaryFormat::ColumnBlock& block = group.blocks[iCol];
+
+    bytes.resize(block.nBytes);
+    _stream.clear();
+    _stream.seekg(block.offset, std::ios::beg);
+    if (block.nBytes > 0 && !_stream.read((char*) &bytes[0], block.nBytes)) {return false;}
+
+    if (ActBinaryFormat::decode(bytes, block.type, block.codec, (int) group.nRows,
+				groupValues) == false) {
+      cout<<"Error in ActBinaryReader::readColumn. Could not decode column "
+	  <<columnName<<" of table "<<tableName<<endl;
+      values.clear();
+      return false;
+    }
+
+    values.insert(values.end(), groupValues.begin(), groupValues.end());
+
+  }
+
+  return true;
+
+}
+
+bool ActBinaryReader::readColumns(const std::string& tableName,
+				  const std::vector<std::string>& columnNames,
+				  std::vector< std::vector<double> >& values) {
+
+  int nColumns = (int) columnNames.size();
+  values.assign(nColumns, std::vector<double>());
+
+  bool ok(true);
+  int iCol;
+  for (iCol = 0; iCol < nColumns; iCol++) {
+    if (this->readColumn(tableName, columnNames[iCol], values[iCol]) == false) {ok = false;}
+  }
+
+  return ok;
+
+}
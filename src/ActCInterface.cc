@@ -0,0 +1,327 @@
+// C interface to the cross-section calculations, for embedding them in other programs
+
+#include "Activia/ActCInterface.h"
+#include "Activia/ActCosmicSpectrum.hh"
+#include "Activia/ActGordonSpectrum.hh"
+#include "Activia/ActNuclideFactory.hh"
+#include "Activia/ActProdNuclideList.hh"
+#include "Activia/ActRunStatistics.hh"
+#include "Activia/ActTrace.hh"
+#include "Activia/ActXSecEngine.hh"
+
+#include <fstream>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/// The calculation context: the list of all products, the engine and the
+/// registered targets, which are used by one thread at a time
+struct ActContext {
+  std::mutex mutex;
+  ActProdNuclideList prodList;
+  ActXSecEngine* engine;
+  std::vector<ActTarget*> targets;
+  std::string error;
+};
+
+static bool actCanRead(const std::string& fileName) {
+
+  std::ifstream file(fileName.c_str());
+  return file.is_open();
+
+}
+
+static ActTarget* actGetTarget(ActContext* context, int target) {
+
+  if (target < 0 || target >= (int) context->targets.size()) {
+    context->error = "invalid target index " + std::to_string(target);
+    return 0;
+  }
+  return context->targets[target];
+
+}
+
+static bool actCheckProduct(ActContext* context, int z, double a) {
+
+  // The mass number must be a whole number that is at least the atomic number
+  if (z < 1 || !(a >= z) || a != (double) ((long) a)) {
+    std::ostringstream message;
+    message<<"invalid product Z = "<<z<<", A = "<<a;
+    context->error = message.str();
+    return false;
+  }
+  return true;
+
+}
+
+extern "C" {
+
+int actGetInterfaceVersion(void) {
+
+  return ACT_C_INTERFACE_VERSION;
+
+}
+
+ActContext* actCreateContext(const char* decayDataFile, const char* listOfDataTables,
+			     double minDataXSec) {
+
+  // Check the files here, since the classes reading them print messages
+  // (and storeTable stops the program) if they do not exist
+  if (decayDataFile == 0 || actCanRead(decayDataFile) == false) {return 0;}
+
+  std::string dataTables("");
+  if (listOfDataTables != 0) {dataTables = listOfDataTables;}
+  if (dataTables.compare("0") == 0) {dataTables = "";}
+  if (dataTables.size() > 0 && actCanRead(dataTables) == false) {return 0;}
+
+  ActContext* context = new (std::nothrow) ActContext();
+  if (context == 0) {return 0;}
+
+  try {
+
+    // Create the singletons before any threads use them
+    ActRunStatistics::getInstance();
+    ActNuclideFactory::getInstance();
+    ActTrace::getInstance();
+
+    context->prodList.setVerbose(false);
+    context->prodList.storeTable(decayDataFile);
+    context->engine = new ActXSecEngine(&context->prodList, dataTables.c_str(),
+					minDataXSec, false);
+
+  } catch (...) {
+
+    delete context;
+    return 0;
+
+  }
+
+  return context;
+
+}
+
+void actDestroyContext(ActContext* context) {
+
+  if (context == 0) {return;}
+  // The targets belong to the engine
+  delete context->engine;
+  delete context;
+
+}
+
+int actAddTarget(ActContext* context, int Z, int nIsotopes,
+		 const double* massNumbers, const double* fractions) {
+
+  if (context == 0) {return -1;}
+  std::lock_guard<std::mutex> lock(context->mutex);
+  context->error = "";
+
+  if (nIsotopes < 1 || massNumbers == 0 || fractions == 0) {
+    context->error = "the target needs at least one isotope";
+    return -1;
+  }
+
+  try {
+
+    std::vector<double> A(massNumbers, massNumbers + nIsotopes);
+    std::vector<double> fraction(fractions, fractions + nIsotopes);
+
+    int i;
+    for (i = 0; i < nIsotopes; i++) {
+      if (A[i] < Z || fraction[i] < 0.0 || fraction[i] > 1.0) {
+	context->error = "invalid target isotope " + std::to_string(i);
+	return -1;
+      }
+    }
+
+    ActTarget* theTarget = context->engine->getTarget(Z, A, fraction);
+    if (theTarget == 0) {
+      context->error = "invalid target Z = " + std::to_string(Z) + " (it must be > 5)";
+      return -1;
+    }
+
+    // The engine returns the same target for the same isotopes
+    for (i = 0; i < (int) context->targets.size(); i++) {
+      if (context->targets[i] == theTarget) {return i;}
+    }
+    context->targets.push_back(theTarget);
+    return (int) context->targets.size() - 1;
+
+  } catch (...) {
+
+    context->error = "could not create the target";
+    return -1;
+
+  }
+
+}
+
+int actCalcSigmas(ActContext* context, int target, int n, const int* prodZ,
+		  const double* prodA, const double* energies, double* sigmas) {
+
+  if (context == 0) {return -1;}
+  std::lock_guard<std::mutex> lock(context->mutex);
+  context->error = "";
+
+  ActTarget* theTarget = actGetTarget(context, target);
+  if (theTarget == 0) {return -1;}
+
+  if (n < 0 || (n > 0 && (prodZ == 0 || prodA == 0 || energies == 0 || sigmas == 0))) {
+    context->error = "invalid arrays";
+    return -1;
+  }
+
+  int i;
+  for (i = 0; i < n; i++) {
+    if (actCheckProduct(context, prodZ[i], prodA[i]) == false) {return -1;}
+  }
+
+  try {
+
+    std::vector<int> z(prodZ, prodZ + n);
+    std::vector<double> a(prodA, prodA + n);
+    std::vector<double> e(energies, energies + n);
+    std::vector<double> results;
+
+    if (context->engine->calcCrossSections(theTarget, z, a, e, results) == false) {
+      context->error = "the cross-sections could not be calculated";
+      return -1;
+    }
+
+    for (i = 0; i < n; i++) {sigmas[i] = results[i];}
+
+  } catch (...) {
+
+    context->error = "the cross-sections could not be calculated";
+    return -1;
+
+  }
+
+  return 0;
+
+}
+
+int actCalcSigmaVsEnergy(ActContext* context, int target, int prodZ, double prodA,
+			 int n, const double* energies, double* sigmas) {
+
+  if (context == 0) {return -1;}
+  std::lock_guard<std::mutex> lock(context->mutex);
+  context->error = "";
+
+  ActTarget* theTarget = actGetTarget(context, target);
+  if (theTarget == 0) {return -1;}
+
+  if (n < 0 || (n > 0 && (energies == 0 || sigmas == 0))) {
+    context->error = "invalid arrays";
+    return -1;
+  }
+
+  if (actCheckProduct(context, prodZ, prodA) == false) {return -1;}
+
+  try {
+
+    std::vector<double> e(energies, energies + n);
+    std::vector<double> results;
+
+    if (context->engine->calcSigmaVsEnergy(theTarget, prodZ, prodA, e, results) == false) {
+      context->error = "the cross-sections could not be calculated";
+      return -1;
+    }
+
+    int i;
+    for (i = 0; i < n; i++) {sigmas[i] = results[i];}
+
+  } catch (...) {
+
+    context->error = "the cross-sections could not be calculated";
+    return -1;
+
+  }
+
+  return 0;
+
+}
+
+int actCalcProdRates(ActContext* context, int target, int spectrumType,
+		     double EStart, double EEnd, double dE, int nProducts,
+		     const int* prodZ, const double* prodA,
+		     double* sigmas, double* prodRates, double* halfLives) {
+
+  if (context == 0) {return -1;}
+  std::lock_guard<std::mutex> lock(context->mutex);
+  context->error = "";
+
+  ActTarget* theTarget = actGetTarget(context, target);
+  if (theTarget == 0) {return -1;}
+
+  if (spectrumType != ACT_SPECTRUM_COSMIC && spectrumType != ACT_SPECTRUM_GORDON) {
+    context->error = "unknown spectrum type " + std::to_string(spectrumType);
+    return -1;
+  }
+
+  if (EStart <= 0.0 || EEnd <= EStart || dE <= 0.0) {
+    context->error = "the spectrum needs 0 < EStart < EEnd and dE > 0";
+    return -1;
+  }
+
+  if (nProducts < 0 || (nProducts > 0 && (prodZ == 0 || prodA == 0 ||
+					  sigmas == 0 || prodRates == 0))) {
+    context->error = "invalid arrays";
+    return -1;
+  }
+
+  int i;
+  for (i = 0; i < nProducts; i++) {
+    if (actCheckProduct(context, prodZ[i], prodA[i]) == false) {return -1;}
+  }
+
+  try {
+
+    std::vector<ActXSecEngine::Product> products(nProducts);
+    for (i = 0; i < nProducts; i++) {
+      products[i].z = prodZ[i]; products[i].a = prodA[i];
+    }
+
+    ActBeamSpectrum* spectrum(0);
+    if (spectrumType == ACT_SPECTRUM_GORDON) {
+      spectrum = new ActGordonSpectrum("GordonSpectrum", 1, 1.0);
+    } else {
+      spectrum = new ActCosmicSpectrum("CosmicRays", 1, 1.0);
+    }
+    spectrum->setEnergies(EStart, EEnd, dE);
+
+    bool calculated = context->engine->calcProduction(theTarget, spectrum, products);
+    delete spectrum;
+
+    if (calculated == false) {
+      context->error = "the production rates could not be calculated";
+      return -1;
+    }
+
+    for (i = 0; i < nProducts; i++) {
+      sigmas[i] = products[i].sigma;
+      prodRates[i] = products[i].prodRate;
+      if (halfLives != 0) {halfLives[i] = products[i].halfLife;}
+    }
+
+  } catch (...) {
+
+    context->error = "the production rates could not be calculated";
+    return -1;
+
+  }
+
+  return 0;
+
+}
+
+const char* actGetError(ActContext* context) {
+
+  if (context == 0) {return "the context is null";}
+  return context->error.c_str();
+
+}
+
+}
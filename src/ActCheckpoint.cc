@@ -0,0 +1,328 @@
+// Class for saving and restoring checkpoints of long cross-section
+// calculations, so that interrupted runs can be resumed
+
+#include "Activia/ActCheckpoint.hh"
+#include "Activia/ActAbsOutput.hh"
+#include "Activia/ActNuclideFactory.hh"
+#include "Activia/ActNumberFormat.hh"
+#include "Activia/ActRunStatistics.hh"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+using std::cout;
+using std::endl;
+
+ActCheckpoint::ActCheckpoint(const std::string& fileName, double minInterval) :
+  _fileName(fileName), _runKey(""), _minInterval(minInterval), _chunkSize(100), _enabled(true)
+{
+  // Constructor
+  _lastSave = ActRunStatistics::wallClock();
+  _iTarget = -1;
+  this->clear();
+}
+
+ActCheckpoint::~ActCheckpoint()
+{
+  // Destructor
+}
+
+void ActCheckpoint::clear() {
+
+  _resuming = false; _xSecDone = false;
+  _savedTarget = 0; _savedProduct = 0;
+  _outputState.clear();
+  _results.clear();
+
+}
+
+bool ActCheckpoint::read() {
+
+  this->clear();
+
+  std::ifstream input(_fileName.c_str(), std::ios::in | std::ios::binary);
+  if (input.is_open() == false) {return false;}
+
+  std::string word, version;
+  input >> word >> version;
+  if (word.compare("ACTIVIA") != 0 || version.compare("checkpoint2") != 0) {
+    cout<<"Error in ActCheckpoint::read. "<<_fileName<<" is not a checkpoint file"<<endl;
+    return false;
+  }
+
+  // The run description, which must be the same as the current run
+  size_t nBytes(0);
+  input >> word >> nBytes;
+  input.get();
+  std::string runKey(nBytes, ' ');
+  if (nBytes > 0) {input.read(&runKey[0], nBytes);}
+
+  if (input.fail() || word.compare("key") != 0 || runKey != _runKey) {
+    cout<<"The checkpoint "<<_fileName<<" is for a different run; it is ignored"<<endl;
+    return false;
+  }
+
+  int xSecDone(0);
+  input >> word >> _savedTarget >> _savedProduct >> xSecDone;
+  if (input.fail() || word.compare("position") != 0) {
+    cout<<"Error in ActCheckpoint::read. Could not read the position in "<<_fileName<<endl;
+    return false;
+  }
+
+  if (ActCheckpoint::readResults(input, _results) == false) {
+    cout<<"Error in ActCheckpoint::read. Could not read the results in "<<_fileName<<endl;
+    return false;
+  }
+
+  // The state of the cross-section output
+  nBytes = 0;
+  input >> word >> nBytes;
+  input.get();
+  _outputState.assign(nBytes, ' ');
+  if (nBytes > 0) {input.read(&_outputState[0], nBytes);}
+  input >> word;
+
+  if (input.fail() || word.compare("end") != 0) {
+    cout<<"Error in ActCheckpoint::read. "<<_fileName<<" is incomplete"<<endl;
+    this->clear();
+    return false;
+  }
+
+  _xSecDone = (xSecDone == 1);
+  _resuming = true;
+
+  cout<<"Resuming the calculation from the checkpoint "<<_fileName<<endl;
+
+  return true;
+
+}
+
+void ActCheckpoint::setTargetIsotope(int iIsotope) {
+
+  _iTarget = iIsotope;
+  if (_iTarget >= (int) _results.size()) {_results.resize(_iTarget + 1);}
+
+}
+
+int ActCheckpoint::restoreResults(ActProdXSecData::ActProdXSecMap& xSecData,
+				  ActProdXSecData::ActProdIndexMap& products, int nProducts) {
+
+  if (_iTarget < 0) {return 0;}
+
+  int firstProduct(0);
+  if (_resuming == true) {
+    if (_xSecDone == true || _iTarget < _savedTarget) {
+      firstProduct = nProducts;
+    } else if (_iTarget == _savedTarget) {
+      firstProduct = _savedProduct;
+    }
+  }
+
+  std::vector<Result>& results = _results[_iTarget];
+
+  // Nothing was calculated for this target isotope before the restart
+  if (firstProduct == 0) {
+    results.clear();
+    return 0;
+  }
+
+  ActCheckpoint::fillXSecData(results, xSecData, products);
+
+  return firstProduct;
+
+}
+
+void ActCheckpoint::addResult(ActNuclide* isotope, double sigma, double prodRate, int iProduct) {
+
+  if (isotope == 0 || _iTarget < 0) {return;}
+
+  Result result;
+  result.z = isotope->getfZ();
+  result.a = isotope->getA();
+  result.halfLife = isotope->getHalfLife();
+  result.sigma = sigma;
+  result.prodRate = prodRate;
+  result.iProduct = iProduct;
+
+  _results[_iTarget].push_back(result);
+
+}
+
+void ActCheckpoint::endProducts(int iProduct, ActAbsOutput* output) {
+
+  if (_enabled == false || iProduct%_chunkSize != 0) {return;}
+  if (ActRunStatistics::wallClock() - _lastSave < _minInterval) {return;}
+
+  this->save(_iTarget, iProduct, output);
+
+}
+
+void ActCheckpoint::endTargetIsotope(ActAbsOutput* output) {
+
+  // Nothing new has been calculated if the cross-sections were already complete
+  if (_xSecDone == true) {return;}
+  this->save(_iTarget + 1, 0, output);
+
+}
+
+void ActCheckpoint::endXSections() {
+
+  // The cross-section output file is complete, so its state is not needed
+  _xSecDone = true;
+  this->save(_iTarget + 1, 0, 0);
+
+}
+
+bool ActCheckpoint::save(int iTarget, int iProduct, ActAbsOutput* output) {
+
+  if (_enabled == false) {return false;}
+
+  // Write all output so far and get the state needed to continue it
+  std::string outputState("");
+  if (output != 0 && output->saveState(outputState) == false) {
+    cout<<"The "<<output->getTypeName()<<" output does not support checkpoints. "
+	<<"Checkpoints are switched off for this run"<<endl;
+    _enabled = false;
+    return false;
+  }
+
+  std::string tmpFileName(_fileName); tmpFileName += ".tmp";
+  std::ofstream file(tmpFileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (file.is_open() == false) {
+    cout<<"Error in ActCheckpoint::save. Could not open "<<tmpFileName<<endl;
+    return false;
+  }
+
+  file << "ACTIVIA checkpoint2\n";
+  file << "key " << _runKey.size() << "\n" << _runKey << "\n";
+  file << "position " << iTarget << " " << iProduct << " " << (_xSecDone ? 1 : 0) << "\n";
+  ActCheckpoint::writeResults(file, _results);
+
+  file << "output " << outputState.size() << "\n";
+  file.write(outputState.data(), outputState.size());
+  file << "\nend\n";
+  file.close();
+
+  if (file.fail()) {
+    cout<<"Error in ActCheckpoint::save. Could not write "<<tmpFileName<<endl;
+    return false;
+  }
+
+  // Replace the previous checkpoint
+  if (std::rename(tmpFileName.c_str(), _fileName.c_str()) != 0) {
+    cout<<"Error in ActCheckpoint::save. Could not rename "<<tmpFileName<<endl;
+    return false;
+  }
+
+  _lastSave = ActRunStatistics::wallClock();
+  return true;
+
+}
+
+void ActCheckpoint::writeResults(std::ostream& stream, const std::vector< std::vector<Result> >& results) {
+
+  ActNumberFormat format(ActNumberFormat::Shortest);
+  std::string text("");
+
+  int nTargets = (int) results.size();
+  stream << "targets " << nTargets << "\n";
+
+  int it;
+  for (it = 0; it < nTargets; it++) {
+
+    const std::vector<Result>& targetResults = results[it];
+    int nResults = (int) targetResults.size();
+    stream << "target " << it << " " << nResults << "\n";
+
+    int ir;
+    for (ir = 0; ir < nResults; ir++) {
+      const Result& result = targetResults[ir];
+      text.clear();
+      format.append(text, result.z); text += ' ';
+      format.append(text, result.a); text += ' ';
+      format.append(text, result.halfLife); text += ' ';
+      format.append(text, result.sigma); text += ' ';
+      format.append(text, result.prodRate); text += ' ';
+      format.append(text, result.iProduct); text += '\n';
+      stream << text;
+    }
+
+  }
+
+}
+
+bool ActCheckpoint::readResults(std::istream& stream, std::vector< std::vector<Result> >& results) {
+
+  results.clear();
+
+  std::string word("");
+  int nTargets(0);
+  stream >> word >> nTargets;
+  if (stream.fail() || word.compare("targets") != 0 || nTargets < 0) {return false;}
+
+  results.resize(nTargets);
+  int it;
+  for (it = 0; it < nTargets; it++) {
+
+    int iTarget(0), nResults(0);
+    stream >> word >> iTarget >> nResults;
+    if (stream.fail() || iTarget != it || nResults < 0) {
+      results.clear();
+      return false;
+    }
+
+    results[it].resize(nResults);
+    int ir;
+    for (ir = 0; ir < nResults; ir++) {
+      // Read the exact values written using the shortest representation
+      Result& result = results[it][ir];
+      std::string values[5];
+      stream >> values[0] >> values[1] >> values[2] >> values[3] >> values[4] >> result.iProduct;
+      result.z = strtod(values[0].c_str(), 0);
+      result.a = strtod(values[1].c_str(), 0);
+      result.halfLife = strtod(values[2].c_str(), 0);
+      result.sigma = strtod(values[3].c_str(), 0);
+      result.prodRate = strtod(values[4].c_str(), 0);
+    }
+
+  }
+
+  if (stream.fail()) {
+    results.clear();
+    return false;
+  }
+
+  return true;
+
+}
+
+void ActCheckpoint::fillXSecData(const std::vector<Result>& results,
+				 ActProdXSecData::ActProdXSecMap& xSecData,
+				 ActProdXSecData::ActProdIndexMap& products) {
+
+  // Use the same insertion order as the original calculation, since a
+  // nuclide can be stored more than once and the last graph is kept
+  ActNuclideFactory* factory = ActNuclideFactory::getInstance();
+  int nResults = (int) results.size();
+  int ir;
+  for (ir = 0; ir < nResults; ir++) {
+
+    const Result& result = results[ir];
+    ActNuclide* isotope = factory->getNuclide((int) result.z, result.a, result.halfLife);
+
+    ActXSecGraph xSecGraph("xSecGraph");
+    xSecGraph.addPoint(0.0, result.sigma, result.prodRate);
+    xSecData[isotope] = xSecGraph;
+    products[isotope] = result.iProduct;
+
+  }
+
+}
+
+void ActCheckpoint::finish() {
+
+  std::remove(_fileName.c_str());
+
+}
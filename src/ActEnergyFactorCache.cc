@@ -0,0 +1,343 @@
+// Class for storing the cross-section factors that only depend on
+// the energy and target isotope, for a given energy grid
+
+#include "Activia/ActEnergyFactorCache.hh"
+#include "Activia/ActNucleiData.hh"
+#include "Activia/ActRunStatistics.hh"
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+using std::cout;
+using std::endl;
+
+ActEnergyFactorCache::ActEnergyFactorCache()
+{
+  // Constructor
+  _nE = 0; _nBins = 0;
+  _EStart = 0.0; _dE = 0.0;
+  _energies.clear();
+  _table.clear();
+  _inOrder = false; _filled.clear(); _lastBin = -1;
+  _hits.assign(ActEnergyFactorCache::NFactors, 0);
+  _misses.assign(ActEnergyFactorCache::NFactors, 0);
+}
+
+ActEnergyFactorCache::~ActEnergyFactorCache()
+{
+  // Destructor
+}
+
+void ActEnergyFactorCache::build(ActNucleiData* data, const std::vector<double>& energies) {
+
+  if (data == 0) {
+    cout<<"Error in ActEnergyFactorCache::build. Data object is null"<<endl;
+    return;
+  }
+
+  // The grid energies, followed by E0 and 1 GeV, which are used by
+  // the spallation, breakup and fission formulae for every energy
+  _energies = energies;
+  _nE = (int) energies.size();
+  _EStart = 0.0; _dE = 0.0;
+  if (_nE > 0) {_EStart = energies[0];}
+  if (_nE > 1) {_dE = energies[1] - energies[0];}
+
+  double at = data->getat();
+  double zt = data->getzt();
+  double ezero = data->getezero();
+
+  _energies.push_back(ezero);
+  _energies.push_back(1000.0);
+  _nBins = (int) _energies.size();
+
+  _table.assign(ActEnergyFactorCache::NFactors*_nBins, 0.0);
+  _hits.assign(ActEnergyFactorCache::NFactors, 0);
+  _misses.assign(ActEnergyFactorCache::NFactors, 0);
+  _inOrder = false; _filled.clear(); _lastBin = -1;
+
+  // The powers and exponentials of the energy are calculated for all bins
+  // in one pass, using the array versions of ActFormulae::power and expfun
+  this->fillArrayFactors();
+
+  int iF, iBin;
+  for (iF = 0; iF < ActEnergyFactorCache::NFactors; iF++) {
+    if (ActEnergyFactorCache::isArrayFactor(iF) == true) {continue;}
+    for (iBin = 0; iBin < _nBins; iBin++) {
+      _table[iF*_nBins + iBin] = ActEnergyFactorCache::calcFactor(_formulae, iF, at, zt,
+								   _energies[iBin], ezero);
+    }
+  }
+
+  data->setEnergyFactorCache(this);
+
+}
+
+bool ActEnergyFactorCache::isArrayFactor(int factor) {
+
+  bool arrayFactor(false);
+  if (factor == ActEnergyFactorCache::EPowM077 || factor == ActEnergyFactorCache::EPowM026 ||
+      factor == ActEnergyFactorCache::EPowM025 || factor == ActEnergyFactorCache::EGeVPowM23 ||
+      factor == ActEnergyFactorCache::EPow23 || factor == ActEnergyFactorCache::FissAy ||
+      factor == ActEnergyFactorCache::FissPow350 || factor == ActEnergyFactorCache::FissPow130 ||
+      factor == ActEnergyFactorCache::FissLogTerm || factor == ActEnergyFactorCache::FissExpAbs) {
+    arrayFactor = true;
+  }
+  return arrayFactor;
+
+}
+
+void ActEnergyFactorCache::fillArrayFactors() {
+
+  // Same expressions as calcFactor, with x^n and exp(x) evaluated by the SIMD kernels
+  std::vector<double> x(_nBins, 0.0), inve(_nBins, 0.0);
+  int iBin;
+  for (iBin = 0; iBin < _nBins; iBin++) {
+    if (std::fabs(_energies[iBin]) > 1e-30) {inve[iBin] = 1.0/_energies[iBin];}
+  }
+
+  const double* e = &_energies[0];
+  _formulae.power_n(e, -0.77, &_table[ActEnergyFactorCache::EPowM077*_nBins], _nBins);
+  _formulae.power_n(e, -0.26, &_table[ActEnergyFactorCache::EPowM026*_nBins], _nBins);
+  _formulae.power_n(e, -0.25, &_table[ActEnergyFactorCache::EPowM025*_nBins], _nBins);
+  _formulae.power_n(e, (2.0/3.0), &_table[ActEnergyFactorCache::EPow23*_nBins], _nBins);
+
+  for (iBin = 0; iBin < _nBins; iBin++) {x[iBin] = _energies[iBin]*1.0e-3;}
+  _formulae.power_n(&x[0], -(2.0/3.0), &_table[ActEnergyFactorCache::EGeVPowM23*_nBins], _nBins);
+
+  double* ay = &_table[ActEnergyFactorCache::FissAy*_nBins];
+  for (iBin = 0; iBin < _nBins; iBin++) {x[iBin] = 450.0*inve[iBin];}
+  _formulae.power_n(&x[0], 0.6, ay, _nBins);
+  for (iBin = 0; iBin < _nBins; iBin++) {ay[iBin] *= 19.0;}
+
+  for (iBin = 0; iBin < _nBins; iBin++) {x[iBin] = 350.0*inve[iBin];}
+  _formulae.power_n(&x[0], 4.0, &_table[ActEnergyFactorCache::FissPow350*_nBins], _nBins);
+  for (iBin = 0; iBin < _nBins; iBin++) {x[iBin] = 130.0*inve[iBin];}
+  _formulae.power_n(&x[0], 4.0, &_table[ActEnergyFactorCache::FissPow130*_nBins], _nBins);
+
+  double* logTerm = &_table[ActEnergyFactorCache::FissLogTerm*_nBins];
+  _formulae.power_n(&inve[0], 0.07, logTerm, _nBins);
+  for (iBin = 0; iBin < _nBins; iBin++) {logTerm[iBin] = log(5.5*logTerm[iBin]);}
+
+  for (iBin = 0; iBin < _nBins; iBin++) {x[iBin] = -std::fabs(_energies[iBin] - 700.0)/700.0;}
+  _formulae.expfun_n(&x[0], &_table[ActEnergyFactorCache::FissExpAbs*_nBins], _nBins);
+
+}
+
+void ActEnergyFactorCache::buildList(ActNucleiData* data, const std::vector<double>& energies) {
+
+  if (data == 0) {
+    cout<<"Error in ActEnergyFactorCache::buildList. Data object is null"<<endl;
+    return;
+  }
+
+  _energies = energies;
+  _nE = (int) energies.size();
+  _EStart = 0.0; _dE = 0.0;
+
+  _energies.push_back(data->getezero());
+  _energies.push_back(1000.0);
+  _nBins = (int) _energies.size();
+
+  // Only the filled flags need to be reset, since the values are set when first used
+  _table.resize(ActEnergyFactorCache::NFactors*_nBins);
+  _filled.assign(ActEnergyFactorCache::NFactors*_nBins, 0);
+  _hits.assign(ActEnergyFactorCache::NFactors, 0);
+  _misses.assign(ActEnergyFactorCache::NFactors, 0);
+  _inOrder = true; _lastBin = -1;
+
+  data->setEnergyFactorCache(this);
+
+}
+
+int ActEnergyFactorCache::findBin(double energy) {
+
+  // The listed energies are used in the same order, so check the next bin, the
+  // last one (the energy is set again after E_0) and the first (for the next loop)
+  if (_inOrder == true && _nE > 0) {
+
+    int iE = _lastBin + 1;
+    if (iE < _nE && _energies[iE] == energy) {
+      _lastBin = iE;
+      return iE;
+    }
+    if (_lastBin >= 0 && _lastBin < _nE && _energies[_lastBin] == energy) {return _lastBin;}
+    if (_energies[0] == energy) {
+      _lastBin = 0;
+      return 0;
+    }
+
+  } else if (_nE > 0) {
+
+    // The uniform energy grid
+    int iE(0);
+    if (std::fabs(_dE) > 1e-30) {iE = (int) floor((energy - _EStart)/_dE + 0.5);}
+    if (iE >= 0 && iE < _nE && _energies[iE] == energy) {return iE;}
+
+  }
+
+  // Then the extra energies
+  int iBin;
+  for (iBin = _nE; iBin < _nBins; iBin++) {
+    if (_energies[iBin] == energy) {return iBin;}
+  }
+
+  return -1;
+
+}
+
+double ActEnergyFactorCache::getFactor(int factor, ActNucleiData& data) {
+
+  int iBin = data.getEnergyBin();
+
+  if (iBin >= 0 && iBin < _nBins) {
+
+    int index = factor*_nBins + iBin;
+    if (_inOrder == true && _filled[index] == 0) {
+      // Calculate the factor when it is first used
+      _misses[factor] += 1;
+      _table[index] = ActEnergyFactorCache::calcFactor(_formulae, factor, data.getat(),
+						       data.getzt(), _energies[iBin],
+						       data.getezero());
+      _filled[index] = 1;
+      return _table[index];
+    }
+
+    _hits[factor] += 1;
+    return _table[index];
+
+  }
+
+  _misses[factor] += 1;
+  return ActEnergyFactorCache::calcFactor(_formulae, factor, data.getat(), data.getzt(),
+					  data.gete(), data.getezero());
+
+}
+
+double ActEnergyFactorCache::calcFactor(ActFormulae& formulae, int factor, double at,
+					double zt, double e, double ezero) {
+
+  // These must be exactly the same expressions as those used by the models
+  double value(0.0);
+  double inve(0.0);
+  if (std::fabs(e) > 1e-30) {inve = 1.0/e;}
+
+  if (factor == ActEnergyFactorCache::DAC) {
+    value = formulae.dac(at, e, ezero);
+  } else if (factor == ActEnergyFactorCache::F1) {
+    value = formulae.f1(at, e, ezero);
+  } else if (factor == ActEnergyFactorCache::F2) {
+    value = formulae.f2(e);
+  } else if (factor == ActEnergyFactorCache::F2p) {
+    value = formulae.f2p(e);
+  } else if (factor == ActEnergyFactorCache::F3) {
+    value = formulae.f3(zt, e);
+  } else if (factor == ActEnergyFactorCache::F11) {
+    value = formulae.f11(e, ezero);
+  } else if (factor == ActEnergyFactorCache::F22) {
+    value = formulae.f22(e, ezero);
+  } else if (factor == ActEnergyFactorCache::F33) {
+    value = formulae.f33(e, ezero);
+  } else if (factor == ActEnergyFactorCache::F44) {
+    value = formulae.f44(e, ezero);
+  } else if (factor == ActEnergyFactorCache::Cp) {
+    value = formulae.cp(at, zt, e, ezero);
+  } else if (factor == ActEnergyFactorCache::EPowM077) {
+    value = formulae.power(e, -0.77);
+  } else if (factor == ActEnergyFactorCache::EPowM026) {
+    value = formulae.power(e, -0.26);
+  } else if (factor == ActEnergyFactorCache::EPowM025) {
+    value = formulae.power(e, -0.25);
+  } else if (factor == ActEnergyFactorCache::EGeVPowM23) {
+    value = formulae.power(e*1.0e-3, -(2.0/3.0));
+  } else if (factor == ActEnergyFactorCache::EPow23) {
+    value = formulae.power(e, (2.0/3.0));
+  } else if (factor == ActEnergyFactorCache::Phi) {
+    value = formulae.phi(at, e);
+  } else if (factor == ActEnergyFactorCache::LogE) {
+    if (e > 0.0) {value = log(e);}
+  } else if (factor == ActEnergyFactorCache::FissAy) {
+    value = 19.0*formulae.power((450.0*inve), 0.6);
+  } else if (factor == ActEnergyFactorCache::FissPow350) {
+    value = formulae.power((350.0*inve), 4.0);
+  } else if (factor == ActEnergyFactorCache::FissPow130) {
+    value = formulae.power((130.0*inve), 4.0);
+  } else if (factor == ActEnergyFactorCache::FissLogTerm) {
+    value = log(5.5*formulae.power(inve, 0.07));
+  } else if (factor == ActEnergyFactorCache::FissExpAbs) {
+    double absPow = std::fabs(e - 700.0)/700.0;
+    value = formulae.expfun(-absPow);
+  } else if (factor == ActEnergyFactorCache::Gauss1230) {
+    // Energy part of the ST heavy target, large deltaZ correction
+    double exp1 = std::fabs(e - 1230.0)/150.0;
+    value = exp(-exp1*exp1);
+  }
+
+  return value;
+
+}
+
+std::string ActEnergyFactorCache::getName(int factor) {
+
+  static const char* names[ActEnergyFactorCache::NFactors] = {
+    "dac", "f1", "f2", "f2p", "f3", "f11", "f22", "f33", "f44", "cp",
+    "E^-0.77", "E^-0.26", "E^-0.25", "(E/GeV)^-2/3", "E^2/3", "phi", "log(E)",
+    "fissAy", "fiss(350/E)^4", "fiss(130/E)^4", "fissLogTerm", "fissExpAbs", "gauss1230"};
+
+  std::string name("");
+  if (factor >= 0 && factor < ActEnergyFactorCache::NFactors) {name = names[factor];}
+  return name;
+
+}
+
+long ActEnergyFactorCache::getNHits(int factor) const {
+
+  long nHits(0);
+  if (factor >= 0 && factor < ActEnergyFactorCache::NFactors) {nHits = _hits[factor];}
+  return nHits;
+
+}
+
+long ActEnergyFactorCache::getNMisses(int factor) const {
+
+  long nMisses(0);
+  if (factor >= 0 && factor < ActEnergyFactorCache::NFactors) {nMisses = _misses[factor];}
+  return nMisses;
+
+}
+
+void ActEnergyFactorCache::print() {
+
+  cout<<"Energy factor cache hit rates ("<<_nBins<<" energy bins):"<<endl;
+
+  int iF;
+  for (iF = 0; iF < ActEnergyFactorCache::NFactors; iF++) {
+
+    long nHits = _hits[iF];
+    long nCalls = nHits + _misses[iF];
+    if (nCalls == 0) {continue;}
+
+    double rate = (100.0*nHits)/(1.0*nCalls);
+    cout<<"  "<<std::setw(14)<<std::left<<ActEnergyFactorCache::getName(iF)<<std::right
+	<<" lookups = "<<std::setw(10)<<nCalls<<", hit rate = "
+	<<std::fixed<<std::setprecision(1)<<rate<<"%"<<endl;
+    cout.unsetf(std::ios::fixed);
+    cout<<std::setprecision(6);
+
+  }
+
+}
+
+void ActEnergyFactorCache::addToStatistics() {
+
+  ActRunStatistics* statistics = ActRunStatistics::getInstance();
+
+  int iF;
+  for (iF = 0; iF < ActEnergyFactorCache::NFactors; iF++) {
+    if (_hits[iF] + _misses[iF] == 0) {continue;}
+    std::string name("energyFactor:"); name += ActEnergyFactorCache::getName(iF);
+    statistics->addCacheLookups(name, _hits[iF], _misses[iF]);
+  }
+
+}
@@ -0,0 +1,503 @@
+// Class for the Monte Carlo ensembles of perturbed production rates
+// and yields, which give their uncertainties
+
+#include "Activia/ActEnsemble.hh"
+#include "Activia/ActAbsOutput.hh"
+#include "Activia/ActBeamSpectrum.hh"
+#include "Activia/ActConstants.hh"
+#include "Activia/ActModelVersion.hh"
+#include "Activia/ActNumberFormat.hh"
+#include "Activia/ActOutputTable.hh"
+#include "Activia/ActProdNuclide.hh"
+#include "Activia/ActProdNuclideList.hh"
+#include "Activia/ActString.hh"
+#include "Activia/ActTarget.hh"
+#include "Activia/ActTargetNuclide.hh"
+#include "Activia/ActTime.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+
+using std::cout;
+using std::endl;
+
+ActEnsemble::ActEnsemble(int nReplicas, unsigned long long seed, int nThreads) :
+  _nReplicas(nReplicas), _nThreads(nThreads), _seed(seed)
+{
+  // Constructor
+  if (_nReplicas < 1) {_nReplicas = 1;}
+  if (_nThreads < 1) {_nThreads = (int) std::thread::hardware_concurrency();}
+  if (_nThreads < 1) {_nThreads = 1;}
+
+  // The default uncertainties
+  _uncertainties["fractions"] = 0.01;
+  _uncertainties["norm"] = 0.1;
+  _uncertainties["shape"] = 0.05;
+  _uncertainties["updates"] = 0.5;
+  _uncertainties["data"] = 0.1;
+  _uncertainties["model"] = 0.35;
+
+  _iTarget = 0; _nE = 0;
+}
+
+ActEnsemble::~ActEnsemble()
+{
+  // Destructor
+}
+
+bool ActEnsemble::setUncertainties(const std::string& list) {
+
+  size_t start(0);
+  while (start < list.size()) {
+
+    size_t comma = list.find(',', start);
+    if (comma == std::string::npos) {comma = list.size();}
+    std::string item = list.substr(start, comma - start);
+    start = comma + 1;
+
+    size_t colon = item.find(':');
+    if (colon == std::string::npos || colon == 0) {
+      cout<<"Error in ActEnsemble::setUncertainties. Use name:value instead of "<<item<<endl;
+      return false;
+    }
+
+    std::string value = item.substr(colon + 1);
+    char* end(0);
+    double uncertainty = strtod(value.c_str(), &end);
+    if (value.size() == 0 || *end != '\0' || uncertainty < 0.0) {
+      cout<<"Error in ActEnsemble::setUncertainties. Invalid uncertainty "<<item<<endl;
+      return false;
+    }
+
+    this->setUncertainty(item.substr(0, colon), uncertainty);
+
+  }
+
+  return true;
+
+}
+
+double ActEnsemble::getUncertainty(const std::string& name) const {
+
+  std::map<std::string, double>::const_iterator iter = _uncertainties.find(name);
+  if (iter == _uncertainties.end()) {iter = _uncertainties.find("model");}
+  if (iter == _uncertainties.end()) {return 0.0;}
+  return iter->second;
+
+}
+
+void ActEnsemble::setup(ActTarget* target, ActBeamSpectrum* spectrum, int nProducts) {
+
+  if (target == 0 || spectrum == 0) {return;}
+
+  _iTarget = 0; _batch.clear();
+  _modelNames.clear(); _modelScales.clear();
+
+  // The nominal weights of each energy bin, as used in ActProdXSecData
+  double EStart = spectrum->getEStart();
+  double dE = spectrum->getdE();
+  _nE = spectrum->getnE();
+  _nominalWeights.assign(_nE, 0.0);
+  int iE;
+  for (iE = 0; iE < _nE; iE++) {
+    double pfac(1.0);
+    if (iE == 0 || iE == _nE - 1) {pfac = 0.5;}
+    _nominalWeights[iE] = pfac*spectrum->fluxdE(iE*dE + EStart)*dE;
+  }
+
+  double EEnd = EStart + (_nE - 1)*dE;
+  double EMid(0.0);
+  if (EStart > 0.0 && EEnd > 0.0) {EMid = sqrt(EStart*EEnd);}
+
+  int nIsotopes = target->getNIsotopes();
+  _nominalFractions.assign(nIsotopes, 0.0);
+  double fractionSum(0.0);
+  int it;
+  for (it = 0; it < nIsotopes; it++) {
+    ActTargetNuclide* isotope = target->getIsotope(it);
+    if (isotope != 0) {_nominalFractions[it] = isotope->getFraction();}
+    fractionSum += _nominalFractions[it];
+  }
+
+  double sFractions = this->getUncertainty("fractions");
+  double sNorm = this->getUncertainty("norm");
+  double sShape = this->getUncertainty("shape");
+  double sUpdates = this->getUncertainty("updates");
+  double sData = this->getUncertainty("data");
+
+  std::mt19937_64 generator(_seed);
+  std::normal_distribution<double> normal(0.0, 1.0);
+
+  _fractions.assign(_nReplicas, std::vector<double>(nIsotopes, 0.0));
+  _weights.assign(_nReplicas, std::vector<double>(_nE, 0.0));
+  _updateShifts.assign(_nReplicas, 0.0);
+  _dataScales.assign(_nReplicas, 1.0);
+
+  int iR;
+  for (iR = 0; iR < _nReplicas; iR++) {
+
+    double norm = exp(sNorm*normal(generator));
+    double slope = sShape*normal(generator);
+    _updateShifts[iR] = sUpdates*normal(generator);
+    _dataScales[iR] = exp(sData*normal(generator));
+
+    std::vector<double>& weights = _weights[iR];
+    for (iE = 0; iE < _nE; iE++) {
+      double energy = iE*dE + EStart;
+      double shape(1.0);
+      if (EMid > 0.0 && energy > 0.0 && slope != 0.0) {shape = pow(energy/EMid, slope);}
+      weights[iE] = norm*shape*_nominalWeights[iE];
+    }
+
+    // The perturbed fractions keep the same sum
+    std::vector<double>& fractions = _fractions[iR];
+    double sum(0.0);
+    for (it = 0; it < nIsotopes; it++) {
+      fractions[it] = _nominalFractions[it]*exp(sFractions*normal(generator));
+      sum += fractions[it];
+    }
+    for (it = 0; it < nIsotopes; it++) {
+      if (sum > 0.0) {fractions[it] *= fractionSum/sum;}
+    }
+
+  }
+
+  _rates.assign(_nReplicas, std::vector<double>(nProducts, 0.0));
+  _nominal.assign(nProducts, 0.0);
+
+}
+
+int ActEnsemble::getModelIndex(const std::string& modelName) {
+
+  int iModel;
+  for (iModel = 0; iModel < (int) _modelNames.size(); iModel++) {
+    if (_modelNames[iModel] == modelName) {return iModel;}
+  }
+
+  // The scale factors of each model use their own random numbers, so that
+  // they do not depend on the order in which the models are used
+  unsigned long long modelSeed(_seed);
+  ActModelVersion::addBytes(modelSeed, modelName.c_str(), modelName.size());
+  std::mt19937_64 generator(modelSeed);
+  std::normal_distribution<double> normal(0.0, 1.0);
+
+  double sModel = this->getUncertainty(modelName);
+  std::vector<double> scales(_nReplicas, 1.0);
+  int iR;
+  for (iR = 0; iR < _nReplicas; iR++) {scales[iR] = exp(sModel*normal(generator));}
+
+  _modelNames.push_back(modelName);
+  _modelScales.push_back(scales);
+
+  return (int) _modelNames.size() - 1;
+
+}
+
+void ActEnsemble::addRow(int iProduct, double factor, const std::string& modelName,
+			 const std::vector<double>& sigmas, const std::vector<double>& updateFactors,
+			 const std::vector<int>& dataFlags) {
+
+  if (iProduct < 0 || iProduct >= (int) _nominal.size()) {return;}
+  if (_iTarget < 0 || _iTarget >= (int) _nominalFractions.size()) {return;}
+
+  int nE = (int) sigmas.size();
+  if (nE > _nE) {nE = _nE;}
+
+  // Only store the range of non-zero cross-sections
+  int iFirst(-1), iLast(-1);
+  int iE;
+  for (iE = 0; iE < nE; iE++) {
+    if (sigmas[iE] != 0.0) {
+      if (iFirst < 0) {iFirst = iE;}
+      iLast = iE;
+    }
+  }
+  if (iFirst < 0) {return;}
+
+  bool recorded = ((int) updateFactors.size() >= nE && (int) dataFlags.size() >= nE);
+
+  Row row;
+  row.iProduct = iProduct; row.iIsotope = _iTarget;
+  row.iModel = this->getModelIndex(modelName);
+  row.factor = factor; row.first = iFirst;
+  row.hasData = false;
+
+  int nValues = iLast - iFirst + 1;
+  row.dataSigmas.assign(nValues, 0.0);
+  row.modelSigmas.assign(nValues, 0.0);
+  row.logFactors.assign(nValues, 0.0);
+
+  double nominalSum(0.0);
+  bool sameFactor(true);
+  double firstFactor(-1.0);
+
+  for (iE = iFirst; iE <= iLast; iE++) {
+
+    double sigma = sigmas[iE];
+    nominalSum += sigma*_nominalWeights[iE];
+    if (sigma == 0.0) {continue;}
+
+    int k = iE - iFirst;
+    if (recorded == true && dataFlags[iE] == 1) {
+      row.dataSigmas[k] = sigma;
+      row.hasData = true;
+    } else {
+      row.modelSigmas[k] = sigma;
+      double updateFactor(1.0);
+      if (recorded == true && updateFactors[iE] > 0.0) {updateFactor = updateFactors[iE];}
+      row.logFactors[k] = log(updateFactor);
+      if (firstFactor < 0.0) {firstFactor = updateFactor;}
+      if (updateFactor != firstFactor) {sameFactor = false;}
+    }
+
+  }
+
+  // Most updates do not depend on the energy
+  if (sameFactor == true) {
+    double logFactor(0.0);
+    if (firstFactor > 0.0) {logFactor = log(firstFactor);}
+    row.logFactors.assign(1, logFactor);
+  }
+  if (row.hasData == false) {row.dataSigmas.clear();}
+
+  _nominal[iProduct] += _nominalFractions[_iTarget]*factor*nominalSum;
+
+  _batch.push_back(row);
+  if ((int) _batch.size() >= 256) {this->addBatch();}
+
+}
+
+void ActEnsemble::finish() {
+
+  this->addBatch();
+
+}
+
+void ActEnsemble::addBatch() {
+
+  if (_batch.size() == 0) {return;}
+
+  int nThreads = _nThreads;
+  if (nThreads > _nReplicas) {nThreads = _nReplicas;}
+
+  if (nThreads == 1) {
+
+    this->addBatch(0, _nReplicas);
+
+  } else {
+
+    // Each thread adds the batch to its own range of replicas
+    std::vector<std::thread> workers;
+    int iT;
+    for (iT = 0; iT < nThreads; iT++) {
+      int iFirst = (iT*_nReplicas)/nThreads;
+      int iLast = ((iT + 1)*_nReplicas)/nThreads;
+      workers.push_back(std::thread([this, iFirst, iLast] {this->addBatch(iFirst, iLast);}));
+    }
+    for (iT = 0; iT < nThreads; iT++) {workers[iT].join();}
+
+  }
+
+  _batch.clear();
+
+}
+
+void ActEnsemble::addBatch(int iFirst, int iLast) {
+
+  int nRows = (int) _batch.size();
+  int iR, ir, k;
+
+  for (iR = iFirst; iR < iLast; iR++) {
+
+    const std::vector<double>& fractions = _fractions[iR];
+    double shift = _updateShifts[iR];
+    std::vector<double>& rates = _rates[iR];
+
+    for (ir = 0; ir < nRows; ir++) {
+
+      const Row& row = _batch[ir];
+      const double* weights = &_weights[iR][row.first];
+      int nValues = (int) row.modelSigmas.size();
+
+      double dataSum(0.0);
+      if (row.hasData == true) {
+	const double* dataSigmas = &row.dataSigmas[0];
+	for (k = 0; k < nValues; k++) {dataSum += dataSigmas[k]*weights[k];}
+      }
+
+      // The update factors U become U^(1 + shift)
+      double modelSum(0.0);
+      const double* modelSigmas = &row.modelSigmas[0];
+      if (row.logFactors.size() == 1 || shift == 0.0) {
+	for (k = 0; k < nValues; k++) {modelSum += modelSigmas[k]*weights[k];}
+	if (row.logFactors.size() == 1 && row.logFactors[0] != 0.0) {
+	  modelSum *= exp(shift*row.logFactors[0]);
+	}
+      } else {
+	const double* logFactors = &row.logFactors[0];
+	for (k = 0; k < nValues; k++) {
+	  modelSum += modelSigmas[k]*weights[k]*exp(shift*logFactors[k]);
+	}
+      }
+
+      double sum = _dataScales[iR]*dataSum + _modelScales[row.iModel][iR]*modelSum;
+      rates[row.iProduct] += fractions[row.iIsotope]*row.factor*sum;
+
+    }
+
+  }
+
+}
+
+double ActEnsemble::getQuantileLevel(int iQuantile) {
+
+  static const double levels[ActEnsemble::NQuantiles] = {0.05, 0.16, 0.5, 0.84, 0.95};
+  if (iQuantile < 0 || iQuantile >= ActEnsemble::NQuantiles) {return 0.0;}
+  return levels[iQuantile];
+
+}
+
+void ActEnsemble::calcStatistics(std::vector<double>& values, double nominal,
+				 Statistics& statistics) {
+
+  statistics.nominal = nominal;
+  statistics.mean = 0.0; statistics.sigma = 0.0;
+  int iQ;
+  for (iQ = 0; iQ < ActEnsemble::NQuantiles; iQ++) {statistics.quantiles[iQ] = 0.0;}
+
+  int n = (int) values.size();
+  if (n == 0) {return;}
+
+  std::sort(values.begin(), values.end());
+
+  double sum(0.0);
+  int i;
+  for (i = 0; i < n; i++) {sum += values[i];}
+  statistics.mean = sum/(n*1.0);
+
+  double sumSq(0.0);
+  for (i = 0; i < n; i++) {
+    double diff = values[i] - statistics.mean;
+    sumSq += diff*diff;
+  }
+  if (n > 1) {statistics.sigma = sqrt(sumSq/(n - 1.0));}
+
+  // Linear interpolation between the sorted values
+  for (iQ = 0; iQ < ActEnsemble::NQuantiles; iQ++) {
+    double h = (n - 1)*ActEnsemble::getQuantileLevel(iQ);
+    int lo = (int) h;
+    if (lo >= n - 1) {
+      statistics.quantiles[iQ] = values[n - 1];
+    } else {
+      statistics.quantiles[iQ] = values[lo] + (h - lo)*(values[lo + 1] - values[lo]);
+    }
+  }
+
+}
+
+void ActEnsemble::output(ActAbsOutput* output, ActProdNuclideList* prodList, ActTime* times) {
+
+  if (output == 0 || prodList == 0 || times == 0) {return;}
+
+  ActNumberFormat format(ActNumberFormat::Shortest);
+  std::string line("Ensemble of "); format.append(line, _nReplicas);
+  line += " replicas with seed "; line += std::to_string(_seed);
+  output->outputLineOfText(line);
+
+  line = "Uncertainties:";
+  std::map<std::string, double>::const_iterator iter;
+  for (iter = _uncertainties.begin(); iter != _uncertainties.end(); ++iter) {
+    line += ' '; line += iter->first; line += ':'; format.append(line, iter->second);
+  }
+  output->outputLineOfText(line);
+  output->outputLineOfText("R_tot = total production rate, dndti = yield at start of cooling, "
+			   "dndtf = yield at end of cooling (per kg per day)");
+  output->outputLineOfText("nominal = unperturbed value, sigma = standard deviation, "
+			   "qN = N% quantile over the replicas");
+  output->outputLineOfText("");
+
+  const char* tableNames[3] = {"ensembleProdRates", "ensembleInitialYields", "ensembleFinalYields"};
+  const char* valueNames[3] = {"R_tot", "dndti", "dndtf"};
+
+  double texp = times->getExposureTime();
+  double tdec = times->getDecayTime();
+  double tCutOff(23.0);
+
+  int nProducts = prodList->getNProdNuclides();
+  if (nProducts > (int) _nominal.size()) {nProducts = (int) _nominal.size();}
+
+  int iTable, ip, iR, iQ;
+  for (iTable = 0; iTable < 3; iTable++) {
+
+    line = std::string("Statistics of ") + valueNames[iTable];
+    output->outputLineOfText(line);
+
+    std::vector<ActString> columns;
+    columns.push_back(ActString("ip"));
+    columns.push_back(ActString("Z"));
+    columns.push_back(ActString("A"));
+    columns.push_back(ActString("tHalf"));
+    columns.push_back(ActString("nominal"));
+    columns.push_back(ActString("mean"));
+    columns.push_back(ActString("sigma"));
+    for (iQ = 0; iQ < ActEnsemble::NQuantiles; iQ++) {
+      ActString name("q");
+      name += (int) (100.0*ActEnsemble::getQuantileLevel(iQ) + 0.5);
+      columns.push_back(name);
+    }
+    ActOutputTable table(tableNames[iTable], columns);
+
+    std::vector<double> values(_nReplicas, 0.0);
+    for (ip = 0; ip < nProducts; ip++) {
+
+      ActProdNuclide* prodNuclide = prodList->getProdNuclide(ip);
+      if (prodNuclide == 0) {continue;}
+      ActNuclide* product = prodNuclide->getProduct();
+      if (product == 0) {continue;}
+
+      // The same decay factors as ActSimpleDecayAlgorithm
+      double halfLife = prodNuclide->getHalfLife();
+      double texpPow(0.0), tdecPow(0.0);
+      if (halfLife > 0.0) {
+	texpPow = texp*ActConstants::ln2/halfLife;
+	tdecPow = tdec*ActConstants::ln2/halfLife;
+      }
+      double initFactor = (texpPow > tCutOff) ? 1.0 : 1.0 - exp(-texpPow);
+      double finalFactor = (tdecPow > tCutOff) ? 0.0 : initFactor*exp(-tdecPow);
+
+      double scale(1.0);
+      if (iTable == 1) {scale = initFactor;} else if (iTable == 2) {scale = finalFactor;}
+
+      bool nonZero = (_nominal[ip] != 0.0);
+      for (iR = 0; iR < _nReplicas; iR++) {
+	values[iR] = scale*_rates[iR][ip];
+	if (_rates[iR][ip] != 0.0) {nonZero = true;}
+      }
+      if (nonZero == false) {continue;}
+
+      Statistics statistics;
+      ActEnsemble::calcStatistics(values, scale*_nominal[ip], statistics);
+
+      std::vector<double> row;
+      row.push_back(ip);
+      row.push_back(product->getZ());
+      row.push_back(product->getA());
+      row.push_back(halfLife);
+      row.push_back(statistics.nominal);
+      row.push_back(statistics.mean);
+      row.push_back(statistics.sigma);
+      for (iQ = 0; iQ < ActEnsemble::NQuantiles; iQ++) {row.push_back(statistics.quantiles[iQ]);}
+      table.addRow(row);
+
+    }
+
+    output->outputTable(table);
+    output->outputLineOfText("");
+
+  }
+
+}
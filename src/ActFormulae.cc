@@ -1,6 +1,7 @@
 // Class to calculate common formulae
 
 #include "Activia/ActFormulae.hh"
+#include "Activia/ActSIMDMath.hh"
 
 #include <cmath>
 
@@ -123,7 +124,7 @@ double ActFormulae::fbe(double z, double a, double zt, double at,
 
 }
 
-double ActFormulae::calcOmega(double zp, double ap, std::string formula) {
+double ActFormulae::calcOmega(double zp, double ap, const std::string& formula) {
 
   // Nuclear structure factors, table 2 p 321+table 1, p874 in ST'85, p369 ST'90
 
@@ -462,6 +463,14 @@ double ActFormulae::fofa4(double zt, double at, double z,
 double ActFormulae::gamma(double z, double a, double zt, 
 			  double at, double atbar, double e) {
 
+  double eTerm = this->power(e, (2.0/3.0));
+  return this->gammaETerm(z, a, zt, at, atbar, eTerm);
+
+}
+
+double ActFormulae::gammaETerm(double z, double a, double zt, 
+			       double at, double atbar, double eTerm) {
+
   // Gamma given below from eqn 7, p 350.
   // Update from ST'85, eq 19
   double z0 = 53.0;
@@ -474,7 +483,6 @@ double ActFormulae::gamma(double z, double a, double zt,
 
   double gam = 0.007*(z - z0) + 0.03;
   double nzstarVal = this->nzstar(z, a, zt, at, atbar);
-  double eTerm = this->power(e, (2.0/3.0));
   gam *= (1.56 - nzstarVal)*eTerm;
 
   return gam;
@@ -525,3 +533,23 @@ double ActFormulae::expfun(double x) {
   return expVal;
 
 }
+
+void ActFormulae::power_n(const double* x, const double* n, double* result, int nValues) {
+
+  // Array version of power(x, n), where the nan checks are done for each value
+  ActSIMDMath::power_n(x, n, result, nValues);
+
+}
+
+void ActFormulae::power_n(const double* x, double n, double* result, int nValues) {
+
+  ActSIMDMath::power_n(x, n, result, nValues);
+
+}
+
+void ActFormulae::expfun_n(const double* x, double* result, int nValues) {
+
+  // Array version of expfun(x)
+  ActSIMDMath::expfun_n(x, result, nValues);
+
+}
@@ -4,8 +4,7 @@
 // Use this to update GUI progress bars/cout statements etc..
 #include "Activia/ActGuiCalcStatus.hh"
 
-#include "QtCore/qcoreapplication.h"
-
+#include <cstdlib>
 #include <iostream>
 
 ActGuiCalcStatus::ActGuiCalcStatus(QWidget* parent) : QWidget(parent), ActAbsCalcStatus()
@@ -16,6 +15,7 @@ ActGuiCalcStatus::ActGuiCalcStatus(QWidget* parent) : QWidget(parent), ActAbsCal
   _progressBar = new QProgressBar();
   _xSecFrac = 0.85; _decayFrac = 1.0 - _xSecFrac;
   _xSecTally = 0;
+  _lastValue = -1;
 
   _logBox = new QGroupBox(parent);
   _clearButton = new QPushButton(QObject::tr("Clea&r Log Text"));
@@ -24,6 +24,11 @@ ActGuiCalcStatus::ActGuiCalcStatus(QWidget* parent) : QWidget(parent), ActAbsCal
   _logLayout = new QVBoxLayout();
 
   _qOut = new ActQtDebugStream(std::cout, _textEdit);
+
+  // The progress is reported on the calculation thread, so always queue
+  // the updates for the GUI thread
+  connect(this, SIGNAL(progressChanged(int, int)), this, SLOT(setProgress(int, int)),
+	  Qt::QueuedConnection);
 }
 
 
@@ -48,6 +53,8 @@ void ActGuiCalcStatus::setUp() {
   _nTIsotopes = 0; _nPIsotopes = 0;
   _iTIsotope = 0; _iPIsotope = 0;
   _xSecTally = 0;
+  _lastValue = -1;
+  _lastUpdate.invalidate();
 
   _textEdit->setLineWrapMode(QTextEdit::NoWrap);
   _textEdit->setReadOnly(true);
@@ -57,9 +64,8 @@ void ActGuiCalcStatus::setUp() {
   connect(_clearButton, SIGNAL(clicked()), _textEdit, SLOT(clear()));
   connect(_closeButton, SIGNAL(clicked()), _logBox, SLOT(close()));
 
-  // Redirect the output from cout to the text editor widget
-  // Log text will only show at the end of the run. Have not
-  // found a way to print out the text as the program runs.
+  // The output from cout is redirected to the text editor widget, and is
+  // shown as the calculation runs on its own thread
   
   // Set the log window layout
   _logLayout->addWidget(_progressBar);
@@ -86,12 +92,7 @@ void ActGuiCalcStatus::xSecReport() {
   n = (int) (n*_xSecFrac);
   _xSecTally = n;
 
-  _progressBar->setMaximum(prodTotal);
-  _progressBar->setValue(n);
-
-  // This should automatically update the output directed to the _textEdit box 
-  // using the ActQtDebugStream class.
-  QCoreApplication::instance()->processEvents();
+  this->updateProgress(n, prodTotal);
 
 }
 
@@ -104,10 +105,7 @@ void ActGuiCalcStatus::decayReport() {
   n = (int) (n*_decayFrac);
   n += _xSecTally;
   
-  _progressBar->setMaximum(prodTotal);
-  _progressBar->setValue(n);
-  
-  QCoreApplication::instance()->processEvents();
+  this->updateProgress(n, prodTotal);
 
 }
 
@@ -118,8 +116,7 @@ void ActGuiCalcStatus::finalise() {
 
   if (prodTotal < 0) {prodTotal = 1;}
 
-  _progressBar->setMaximum(prodTotal);
-  _progressBar->setValue(prodTotal);
+  this->updateProgress(prodTotal, prodTotal, true);
 
   if (_runCode == false) {
     std::cout<<"\n\nCalculations were aborted. Output is not useable."<<std::endl;
@@ -134,10 +131,38 @@ void ActGuiCalcStatus::reset() {
   _nTIsotopes = 0; _nPIsotopes = 0;
   _iTIsotope = 0; _iPIsotope = 0;
   _xSecTally = 0;
+  _lastValue = -1;
+  _lastUpdate.invalidate();
 
   // Also clear up the text log output
   _textEdit->clear();
 
 }
 
+void ActGuiCalcStatus::updateProgress(int value, int maximum, bool force) {
+
+  // Only send the progress when it has changed by at least 1%, or at
+  // least 100 ms after the previous update
+  int step = maximum/100;
+  if (step < 1) {step = 1;}
+
+  bool changed = (_lastValue < 0 || std::abs(value - _lastValue) >= step);
+  bool waited = (_lastUpdate.isValid() == false || _lastUpdate.elapsed() >= 100);
+
+  if (force == false && (value == _lastValue || (changed == false && waited == false))) {return;}
+
+  _lastValue = value;
+  _lastUpdate.start();
+
+  emit progressChanged(value, maximum);
+
+}
+
+void ActGuiCalcStatus::setProgress(int value, int maximum) {
+
+  _progressBar->setMaximum(maximum);
+  _progressBar->setValue(value);
+
+}
+
 #endif
@@ -8,6 +8,8 @@
 #include "Activia/ActTarget.hh"
 #include "Activia/ActProdNuclideList.hh"
 #include "Activia/ActGuiCalcStatus.hh"
+#include "Activia/ActGuiWorker.hh"
+#include "Activia/ActAbsInput.hh"
 
 #include "QtGui/qaction.h"
 #include "QtGui/qdialogbuttonbox.h"
@@ -28,11 +30,17 @@ ActGuiRun::ActGuiRun() : QDialog(), ActAbsRun() {
   _calcStatus = new ActGuiCalcStatus(this);
   _progressBar = new QProgressBar();
   _guiWindow = 0;
+  _runButton = 0;
+
+  _worker = new ActGuiWorker(this);
+  connect(_worker, SIGNAL(finished()), this, SLOT(codeFinished()));
 
 }
 
 ActGuiRun::~ActGuiRun() {
-  // Destructor
+  // Destructor. Stop any running calculation before deleting anything it uses.
+  _calcStatus->setRunCode(false);
+  delete _worker;
   if (_guiWindow != 0) {delete _guiWindow;}
   if (_progressBar != 0) {delete _progressBar;}
 }
@@ -64,16 +72,16 @@ void ActGuiRun::makeGui() {
   mainLayout->addWidget(timeBox);
   mainLayout->addWidget(outputBox);
 
-  QPushButton* runButton = new QPushButton(QObject::tr("&Run"));
+  _runButton = new QPushButton(QObject::tr("&Run"));
   QPushButton* stopButton = new QPushButton(QObject::tr("&Stop"));
   QPushButton* closeButton = new QPushButton(QObject::tr("&Close"));
 
   QDialogButtonBox* buttonBox = new QDialogButtonBox();
-  buttonBox->addButton(runButton, QDialogButtonBox::ActionRole);
+  buttonBox->addButton(_runButton, QDialogButtonBox::ActionRole);
   buttonBox->addButton(stopButton, QDialogButtonBox::ActionRole);
   buttonBox->addButton(closeButton, QDialogButtonBox::RejectRole);
 
-  connect(runButton, SIGNAL(clicked()), this, SLOT(runCode()));
+  connect(_runButton, SIGNAL(clicked()), this, SLOT(runCode()));
   connect(stopButton, SIGNAL(clicked()), this, SLOT(stopCode()));
   connect(closeButton, SIGNAL(clicked()), this, SLOT(reject()));
  
@@ -131,24 +139,39 @@ QMenuBar* ActGuiRun::createMenu() {
 void ActGuiRun::runCode() {
 
   // Slot for catching the "run the code" signal.
-  // This just calls the ActAbsRun::run() command, which sets up 
-  // the input and performs the calculations.
+  // The input is read from the GUI widgets on this (GUI) thread, then
+  // the calculations are performed on the worker thread.
+  if (_worker->isRunning()) {return;}
 
   // Set the calculation status window
   _calcStatus->setUp();
 
   _calcStatus->setRunCode(true);
 
-  // Run the ACTIVIA code
-  this->run();
+  // Define the input using the current GUI entries
+  delete _input; _input = 0;
+  this->defineInput();
+  if (_input == 0) {return;}
+  _input->getData();
+
+  // Run the ACTIVIA calculations on the worker thread
+  if (_runButton != 0) {_runButton->setEnabled(false);}
+  _worker->start();
+
+}
+
+void ActGuiRun::codeFinished() {
+
+  // The calculations have finished or were stopped. Allow them to be run again.
+  if (_runButton != 0) {_runButton->setEnabled(true);}
 
 }
 
 void ActGuiRun::stopCode() {
 
   // Stop running the calculation code, but keep the GUI open. 
-  // The ActProdXSecData and ActDecayAlgorithm classes
-  // know when to stop the code when this is set to false.
+  // The cross-section energy loop, the ActProdXSecData and ActDecayAlgorithm
+  // classes know when to stop the code when this is set to false.
   // When the code is restarted, all internal data should be
   // reinitialised from the provided input.
   _calcStatus->setRunCode(false);
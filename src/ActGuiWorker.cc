@@ -0,0 +1,24 @@
+#ifdef ACT_USE_QT
+
+// Class for running the calculations on a separate thread from the GUI
+#include "Activia/ActGuiWorker.hh"
+#include "Activia/ActAbsRun.hh"
+
+ActGuiWorker::ActGuiWorker(ActAbsRun* run, QObject* parent) : QThread(parent), _run(run)
+{
+  // Constructor
+}
+
+ActGuiWorker::~ActGuiWorker()
+{
+  // Destructor. Wait for any calculation to finish.
+  this->wait();
+}
+
+void ActGuiWorker::run() {
+
+  if (_run != 0) {_run->calculate();}
+
+}
+
+#endif
@@ -16,15 +16,14 @@
 
 using std::cout;
 using std::endl;
-using std::cin;
 
-ActInput::ActInput() : ActAbsInput()
+ActInput::ActInput() : ActAbsInput(), _in(&std::cin)
 {
   _prodDataFile = "";
   this->setUp();
 }
 
-ActInput::ActInput(ActOutputSelection* outputSelection) : ActAbsInput(outputSelection)
+ActInput::ActInput(ActOutputSelection* outputSelection) : ActAbsInput(outputSelection), _in(&std::cin)
 {
   _prodDataFile = "";
   this->setUp();
@@ -57,10 +56,10 @@ void ActInput::defineTarget() {
 
   int zt, nisott;
   cout<<"Enter target Z"<<endl;
-  cin >> zt;
+  *_in >> zt;
 
   cout<<"Enter number of target isotopes"<<endl;
-  cin >> nisott;
+  *_in >> nisott;
 
   // Set the target pointer
   if (_target != 0) {delete _target;}
@@ -76,7 +75,7 @@ void ActInput::defineTarget() {
     
     cout<<"Enter mass number and fractional abundance (0 to 1) for the target isotope "<<i+1<<endl;
     cout<<"For example: 180 0.763"<<endl;
-    cin >> massNo >> ratio;
+    *_in >> massNo >> ratio;
     _target->addIsotope(massNo, ratio, halfLife);
 
   }
@@ -94,7 +93,7 @@ void ActInput::defineCalcMode() {
     cout<<"Enter z for calculating the cross-section and yield for one isotope product only "
 	<<"or a for finding the cross-sections and yields for all available active products"<<endl;
     cout<<"z or a: ";
-    cin >> tmpChar;
+    *_in >> tmpChar;
 
     if (tmpChar == "z" || tmpChar == "Z") {
       _calcInt = ActAbsInput::SingleProd; gotMode = true;
@@ -121,7 +120,7 @@ void ActInput::defineNuclides() {
   cout<<endl;
   cout<<"Enter the filename defining all possible product isotopes and their side-branches"
       <<" or type 0 to accept the default file "<<_prodDataFile<<":"<<endl;
-  cin >> tmpChar;
+  *_in >> tmpChar;
 
   if (tmpChar == "0") {
 
@@ -143,7 +142,7 @@ void ActInput::defineNuclides() {
 	break;
       } else {
 	cout<<"Error. The file "<<_prodDataFile<<" does not exist. Please enter another file\n"<<endl;
-	cin >> tmpChar;
+	*_in >> tmpChar;
       }
     }
 
@@ -168,7 +167,7 @@ void ActInput::defineNuclides() {
 
     int prodz;
     double proda;
-    cin >> prodz >> proda;
+    *_in >> prodz >> proda;
 
     // Load in the full isotope table. Then extract the appropriate
     // isotope and store in the _storeIsotopes object.
@@ -220,7 +219,7 @@ void ActInput::defineSpectrum() {
   cout<<"Enter energies: E(start)  E(end)  bin_width (dE) for beam (all in MeV)"<<endl;
   cout<<"For example: 0.0 1.0e4 100.0"<<endl;
   double EStart, EEnd, dE;
-  cin >> EStart >> EEnd >> dE;
+  *_in >> EStart >> EEnd >> dE;
 
   _spectrum->setEnergies(EStart, EEnd, dE);
 
@@ -240,7 +239,7 @@ void ActInput::specifyXSecAlgorithm() {
   cout<<"For example: listOfDataFiles.txt 0.001"<<endl;
 
   std::string dataFileName;
-  cin >> dataFileName;
+  *_in >> dataFileName;
 
   if (dataFileName.compare("0") == 0) {
 
@@ -250,7 +249,7 @@ void ActInput::specifyXSecAlgorithm() {
   } else {
 
     double minDataXSec(0.0);
-    cin >> minDataXSec;
+    *_in >> minDataXSec;
     cout<<"Using the input file "<<dataFileName<<" for any data tables"<<endl;
     cout<<"Data cross-sections are only used if they are greather than "<<minDataXSec<<" mb, "
 	<<"otherwise formulae are used instead.\n"<<endl;
@@ -268,7 +267,7 @@ void ActInput::defineTime() {
   cout<<"For example: 90.0 180.0"<<endl;
 
   double texp(0.0), tdec(0.0);
-  cin >> texp >> tdec;
+  *_in >> texp >> tdec;
   if (_time != 0) {delete _time;}
   _time = new ActTime(texp, tdec);
 
@@ -352,11 +351,11 @@ void ActInput::specifyOutput() {
       <<"separated by spaces:"<<endl;
 
   std::string tmpString;
-  cin >> tmpString;
+  *_in >> tmpString;
 
   if (tmpString != "0") {
 
-    cin >> xSecType >> xSecDetail;
+    *_in >> xSecType >> xSecDetail;
 
     xSecFileName = tmpString;
 
@@ -382,11 +381,11 @@ void ActInput::specifyOutput() {
   cout<<"Enter 0 to accept these, or type in all of the new values as in the previous line, "
       <<"separated by spaces:"<<endl;
 
-  cin >> tmpString;
+  *_in >> tmpString;
 
   if (tmpString != "0") {
 
-    cin >> decayType >> decayDetail;
+    *_in >> decayType >> decayDetail;
 
     decayFileName = tmpString;
 
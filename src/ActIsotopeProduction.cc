@@ -64,6 +64,7 @@ void ActIsotopeProduction::calcCrossSections() {
 
   // Calculate the cross-sections
   target->setOutput(_outputData);
+  target->setOtherSpectra(_inputData->getOtherSpectra());
   target->calcXSections(prodNuclideList, spectrum, algorithm);
 
 }
@@ -0,0 +1,281 @@
+// Class for reading values from JSON text
+
+#include "Activia/ActJSONValue.hh"
+
+#include <cstdio>
+#include <cstdlib>
+
+ActJSONValue::ActJSONValue() : _type(ActJSONValue::Null), _bool(false), _number(0.0), _string("")
+{
+  // Constructor
+}
+
+ActJSONValue::~ActJSONValue()
+{
+  // Destructor
+}
+
+bool ActJSONValue::parse(const std::string& text, std::string& error) {
+
+  error = "";
+  size_t pos(0);
+
+  if (this->parseValue(text, pos, error, 0) == false) {return false;}
+
+  ActJSONValue::skipSpace(text, pos);
+  if (pos != text.size()) {
+    error = "unexpected text after the value at position " + std::to_string(pos);
+    return false;
+  }
+
+  return true;
+
+}
+
+void ActJSONValue::skipSpace(const std::string& text, size_t& pos) {
+
+  while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' ||
+			       text[pos] == '\n' || text[pos] == '\r')) {pos++;}
+
+}
+
+bool ActJSONValue::parseValue(const std::string& text, size_t& pos, std::string& error, int depth) {
+
+  // Limit the nesting, so that bad input can not exhaust the stack
+  if (depth > 64) {
+    error = "values are nested too deeply";
+    return false;
+  }
+
+  _type = ActJSONValue::Null;
+  _array.clear(); _object.clear();
+
+  ActJSONValue::skipSpace(text, pos);
+  if (pos >= text.size()) {
+    error = "unexpected end of text";
+    return false;
+  }
+
+  char c = text[pos];
+
+  if (c == '{') {
+
+    _type = ActJSONValue::Object;
+    pos++;
+    ActJSONValue::skipSpace(text, pos);
+    if (pos < text.size() && text[pos] == '}') {pos++; return true;}
+
+    for (;;) {
+
+      ActJSONValue::skipSpace(text, pos);
+      std::string name("");
+      if (ActJSONValue::parseString(text, pos, name, error) == false) {return false;}
+
+      ActJSONValue::skipSpace(text, pos);
+      if (pos >= text.size() || text[pos] != ':') {
+	error = "expected ':' at position " + std::to_string(pos);
+	return false;
+      }
+      pos++;
+
+      ActJSONValue member;
+      if (member.parseValue(text, pos, error, depth + 1) == false) {return false;}
+      _object[name] = member;
+
+      ActJSONValue::skipSpace(text, pos);
+      if (pos < text.size() && text[pos] == ',') {pos++; continue;}
+      if (pos < text.size() && text[pos] == '}') {pos++; return true;}
+
+      error = "expected ',' or '}' at position " + std::to_string(pos);
+      return false;
+
+    }
+
+  } else if (c == '[') {
+
+    _type = ActJSONValue::Array;
+    pos++;
+    ActJSONValue::skipSpace(text, pos);
+    if (pos < text.size() && text[pos] == ']') {pos++; return true;}
+
+    for (;;) {
+
+      ActJSONValue entry;
+      if (entry.parseValue(text, pos, error, depth + 1) == false) {return false;}
+      _array.push_back(entry);
+
+      ActJSONValue::skipSpace(text, pos);
+      if (pos < text.size() && text[pos] == ',') {pos++; continue;}
+      if (pos < text.size() && text[pos] == ']') {pos++; return true;}
+
+      error = "expected ',' or ']' at position " + std::to_string(pos);
+      return false;
+
+    }
+
+  } else if (c == '"') {
+
+    _type = ActJSONValue::String;
+    return ActJSONValue::parseString(text, pos, _string, error);
+
+  } else if (text.compare(pos, 4, "true") == 0) {
+
+    _type = ActJSONValue::Bool; _bool = true;
+    pos += 4;
+
+  } else if (text.compare(pos, 5, "false") == 0) {
+
+    _type = ActJSONValue::Bool; _bool = false;
+    pos += 5;
+
+  } else if (text.compare(pos, 4, "null") == 0) {
+
+    pos += 4;
+
+  } else if (c == '-' || (c >= '0' && c <= '9')) {
+
+    const char* start = text.c_str() + pos;
+    char* end(0);
+    _number = strtod(start, &end);
+    if (end == start) {
+      error = "invalid number at position " + std::to_string(pos);
+      return false;
+    }
+    _type = ActJSONValue::Number;
+    pos += end - start;
+
+  } else {
+
+    error = "unexpected character at position " + std::to_string(pos);
+    return false;
+
+  }
+
+  return true;
+
+}
+
+bool ActJSONValue::parseString(const std::string& text, size_t& pos, std::string& value,
+			       std::string& error) {
+
+  value = "";
+  if (pos >= text.size() || text[pos] != '"') {
+    error = "expected a string at position " + std::to_string(pos);
+    return false;
+  }
+  pos++;
+
+  while (pos < text.size()) {
+
+    char c = text[pos++];
+    if (c == '"') {return true;}
+
+    if (c != '\\') {
+      value += c;
+      continue;
+    }
+
+    if (pos >= text.size()) {break;}
+    char escape = text[pos++];
+
+    if (escape == 'n') {value += '\n';}
+    else if (escape == 't') {value += '\t';}
+    else if (escape == 'r') {value += '\r';}
+    else if (escape == 'b') {value += '\b';}
+    else if (escape == 'f') {value += '\f';}
+    else if (escape == 'u') {
+
+      if (pos + 4 > text.size()) {break;}
+      unsigned int code = (unsigned int) strtoul(text.substr(pos, 4).c_str(), 0, 16);
+      pos += 4;
+
+      // Convert the code point to UTF-8 (surrogate pairs are not combined)
+      if (code < 0x80) {
+	value += (char) code;
+      } else if (code < 0x800) {
+	value += (char) (0xC0 | (code >> 6));
+	value += (char) (0x80 | (code & 0x3F));
+      } else {
+	value += (char) (0xE0 | (code >> 12));
+	value += (char) (0x80 | ((code >> 6) & 0x3F));
+	value += (char) (0x80 | (code & 0x3F));
+      }
+
+    } else {
+      // Quotes, back and forward slashes
+      value += escape;
+    }
+
+  }
+
+  error = "unterminated string";
+  return false;
+
+}
+
+int ActJSONValue::size() const {
+
+  if (_type == ActJSONValue::Array) {return (int) _array.size();}
+  if (_type == ActJSONValue::Object) {return (int) _object.size();}
+  return 0;
+
+}
+
+const ActJSONValue* ActJSONValue::at(int index) const {
+
+  if (_type != ActJSONValue::Array || index < 0 || index >= (int) _array.size()) {return 0;}
+  return &_array[index];
+
+}
+
+const ActJSONValue* ActJSONValue::get(const std::string& name) const {
+
+  if (_type != ActJSONValue::Object) {return 0;}
+  std::map<std::string, ActJSONValue>::const_iterator iter = _object.find(name);
+  if (iter == _object.end()) {return 0;}
+  return &iter->second;
+
+}
+
+double ActJSONValue::getNumber(const std::string& name, double defaultValue) const {
+
+  const ActJSONValue* value = this->get(name);
+  if (value == 0 || value->isNumber() == false) {return defaultValue;}
+  return value->getNumber();
+
+}
+
+std::string ActJSONValue::getString(const std::string& name, const std::string& defaultValue) const {
+
+  const ActJSONValue* value = this->get(name);
+  if (value == 0 || value->isString() == false) {return defaultValue;}
+  return value->getString();
+
+}
+
+void ActJSONValue::appendString(std::string& text, const std::string& value) {
+
+  text += '"';
+
+  size_t i;
+  for (i = 0; i < value.size(); i++) {
+
+    char c = value[i];
+    if (c == '"') {text += "\\\"";}
+    else if (c == '\\') {text += "\\\\";}
+    else if (c == '\n') {text += "\\n";}
+    else if (c == '\t') {text += "\\t";}
+    else if (c == '\r') {text += "\\r";}
+    else if ((unsigned char) c < 0x20) {
+      char code[8];
+      snprintf(code, sizeof(code), "\\u%04x", (unsigned int) (unsigned char) c);
+      text += code;
+    } else {
+      text += c;
+    }
+
+  }
+
+  text += '"';
+
+}
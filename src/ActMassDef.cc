@@ -7,6 +7,7 @@
 #include "Activia/ActMassDef.hh"
 #include "Activia/ActConstants.hh"
 #include "Activia/ActClassify.hh"
+#include "Activia/ActNuclideTable.hh"
 
 #include <cmath>
 #include <algorithm>
@@ -133,8 +134,7 @@ double ActMassDef::calcMass() {
 
   int ia = (int) _a;
   int iz = (int) _z;
-  ActClassify classify(ia, iz);
-  int ioe = classify.classif();
+  int ioe = ActNuclideTable::getPairing(ia, iz);
 
   if (ioe == ActClassify::EvenEven) {
     xmass -= del(_a);
@@ -156,6 +156,13 @@ double ActMassDef::del(double a) {
 
 double ActMassDef::thr(double zt, double at, double mdtgt, double mdprod) {
 
+  return ActMassDef::calcThreshold(_z, _a, zt, at, mdtgt, mdprod);
+
+}
+
+double ActMassDef::calcThreshold(double z, double a, double zt, double at,
+				 double mdtgt, double mdprod) {
+
   // Calculate threshold energy for zt,at + p -> z,a + p + whatever, where
   // whatever = max permitted alphas, at most one 3-H and at most one 3-He,
   // plus required additional p,n.      
@@ -172,8 +179,8 @@ double ActMassDef::thr(double zt, double at, double mdtgt, double mdprod) {
 
   // Calculate changes of z and a in this reaction
 
-  int dela = (int) (at - _a);
-  int delz = (int) (zt - _z);
+  int dela = (int) (at - a);
+  int delz = (int) (zt - z);
   int deln = dela - delz;
 
   if (delz >= 2 && deln >= 2) {nalpha = std::min(delz/2,deln/2);}
@@ -0,0 +1,134 @@
+// Class for calculating fingerprints of the cross-section models and input data
+
+#include "Activia/ActModelVersion.hh"
+#include "Activia/ActConstants.hh"
+#include "Activia/ActCosmicSpectrum.hh"
+#include "Activia/ActGordonSpectrum.hh"
+#include "Activia/ActXSecEngine.hh"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+unsigned long long ActModelVersion::calcModelHash(ActXSecEngine* engine) {
+
+  unsigned long long hash(ActModelVersion::EmptyHash);
+  if (engine == 0) {return hash;}
+
+  // Light, medium and heavy targets (single isotopes) and products covering the
+  // tritium, light nuclei, evaporation, peripheral, spallation and fission formulae
+  const int nTargets(8);
+  int zTargets[nTargets] = {6, 8, 13, 26, 29, 52, 79, 82};
+  double aTargets[nTargets] = {12.0, 16.0, 27.0, 56.0, 63.0, 130.0, 197.0, 208.0};
+
+  const int nProducts(9);
+  int zProducts[nProducts] = {1, 4, 6, 11, 25, 27, 29, 38, 71};
+  double aProducts[nProducts] = {3.0, 7.0, 11.0, 22.0, 54.0, 60.0, 61.0, 90.0, 173.0};
+
+  std::vector<double> energies;
+  energies.push_back(15.0); energies.push_back(40.0); energies.push_back(100.0);
+  energies.push_back(250.0); energies.push_back(700.0); energies.push_back(1500.0);
+  energies.push_back(2500.0); energies.push_back(5000.0); energies.push_back(1.0e5);
+
+  std::vector<double> sigmas;
+  int iT, iP, iE;
+  for (iT = 0; iT < nTargets; iT++) {
+
+    ActTarget* target = engine->getTarget(zTargets[iT], std::vector<double>(1, aTargets[iT]),
+					  std::vector<double>(1, 1.0));
+
+    // Also use the target isotopes as products, for the peripheral reactions
+    for (iP = 0; iP < nProducts+1; iP++) {
+
+      int z = zTargets[iT] - 1;
+      double a = aTargets[iT] - 1.0;
+      if (iP < nProducts) {z = zProducts[iP]; a = aProducts[iP];}
+      if (z > zTargets[iT] || a >= aTargets[iT]) {continue;}
+
+      engine->calcSigmaVsEnergy(target, z, a, energies, sigmas);
+      for (iE = 0; iE < (int) sigmas.size(); iE++) {ActModelVersion::addDouble(hash, sigmas[iE]);}
+
+    }
+
+  }
+
+  // The spectra and the constant used for the production rates
+  ActCosmicSpectrum cosmic;
+  ActGordonSpectrum gordon;
+  for (iE = 0; iE < (int) energies.size(); iE++) {
+    ActModelVersion::addDouble(hash, cosmic.fluxdE(energies[iE]));
+    ActModelVersion::addDouble(hash, gordon.fluxdE(energies[iE]));
+  }
+  ActModelVersion::addDouble(hash, ActConstants::pps);
+
+  return hash;
+
+}
+
+unsigned long long ActModelVersion::calcFileHash(const std::string& fileName) {
+
+  std::ifstream file(fileName.c_str(), std::ios::binary);
+  if (!file.is_open()) {return 0;}
+
+  unsigned long long hash(ActModelVersion::EmptyHash);
+  char buffer[65536];
+  while (file.good()) {
+    file.read(buffer, sizeof(buffer));
+    ActModelVersion::addBytes(hash, buffer, (size_t) file.gcount());
+  }
+
+  return hash;
+
+}
+
+unsigned long long ActModelVersion::calcDataTablesHash(const std::string& listOfDataTables) {
+
+  unsigned long long hash(ActModelVersion::EmptyHash);
+  if (listOfDataTables.size() == 0 || listOfDataTables.compare("0") == 0) {return hash;}
+
+  // The list is read in the same way as ActXSecDataModel::initialise
+  std::ifstream getData(listOfDataTables.c_str());
+  while (getData.good()) {
+
+    std::string fileName("");
+    getData >> fileName;
+    if (getData.eof()) {break;}
+
+    ActModelVersion::addBytes(hash, fileName.c_str(), fileName.size());
+    unsigned long long fileHash = ActModelVersion::calcFileHash(fileName);
+    ActModelVersion::addBytes(hash, &fileHash, sizeof(fileHash));
+
+  }
+
+  return hash;
+
+}
+
+void ActModelVersion::addBytes(unsigned long long& hash, const void* data, size_t nBytes) {
+
+  const unsigned char* bytes = (const unsigned char*) data;
+  size_t i;
+  for (i = 0; i < nBytes; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+
+}
+
+void ActModelVersion::addDouble(unsigned long long& hash, double value) {
+
+  // Use the exact bits of the value
+  unsigned long long bits(0);
+  memcpy(&bits, &value, sizeof(bits));
+  ActModelVersion::addBytes(hash, &bits, sizeof(bits));
+
+}
+
+std::string ActModelVersion::toString(unsigned long long hash) {
+
+  char text[17];
+  snprintf(text, sizeof(text), "%016llx", hash);
+  return std::string(text);
+
+}
@@ -0,0 +1,95 @@
+// Class storing the natural isotopic abundances of the stable elements
+
+#include "Activia/ActNaturalAbundance.hh"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using std::cout;
+using std::endl;
+
+ActNaturalAbundance::ActNaturalAbundance() : _elements()
+{
+  // Constructor
+}
+
+ActNaturalAbundance::~ActNaturalAbundance()
+{
+  // Destructor
+}
+
+bool ActNaturalAbundance::storeTable(const char* inFileName) {
+
+  _elements.clear();
+
+  std::ifstream getData(inFileName);
+  if (!getData.is_open()) {
+    cout<<"Error in ActNaturalAbundance::storeTable. The file "<<inFileName
+	<<" does not exist"<<endl;
+    return false;
+  }
+
+  std::string line("");
+  while (std::getline(getData, line)) {
+
+    if (line.size() == 0 || line[0] == '#') {continue;}
+
+    std::istringstream lineStream(line);
+    int Z(0);
+    double A(0.0), fraction(-1.0);
+    lineStream >> Z >> A >> fraction;
+
+    if (lineStream.fail() || Z < 1 || A < Z || fraction < 0.0 || fraction > 1.0) {
+      cout<<"Error in ActNaturalAbundance::storeTable. Invalid line \""<<line
+	  <<"\" in "<<inFileName<<endl;
+      _elements.clear();
+      return false;
+    }
+
+    _elements[Z].push_back(std::make_pair(A, fraction));
+
+  }
+
+  return true;
+
+}
+
+std::vector<int> ActNaturalAbundance::getElements() const {
+
+  std::vector<int> elements;
+  std::map<int, std::vector<std::pair<double, double> > >::const_iterator iter;
+  for (iter = _elements.begin(); iter != _elements.end(); ++iter) {
+    elements.push_back(iter->first);
+  }
+  return elements;
+
+}
+
+bool ActNaturalAbundance::getIsotopes(int Z, std::vector<double>& massNumbers,
+				      std::vector<double>& fractions) const {
+
+  massNumbers.clear(); fractions.clear();
+
+  std::map<int, std::vector<std::pair<double, double> > >::const_iterator iter = _elements.find(Z);
+  if (iter == _elements.end()) {return false;}
+
+  int i;
+  for (i = 0; i < (int) iter->second.size(); i++) {
+    massNumbers.push_back(iter->second[i].first);
+    fractions.push_back(iter->second[i].second);
+  }
+  return true;
+
+}
+
+int ActNaturalAbundance::getNIsotopes() const {
+
+  int nIsotopes(0);
+  std::map<int, std::vector<std::pair<double, double> > >::const_iterator iter;
+  for (iter = _elements.begin(); iter != _elements.end(); ++iter) {
+    nIsotopes += (int) iter->second.size();
+  }
+  return nIsotopes;
+
+}
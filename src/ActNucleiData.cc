@@ -3,7 +3,9 @@
 
 #include "Activia/ActNucleiData.hh"
 #include "Activia/ActMassDef.hh"
+#include "Activia/ActNuclideTable.hh"
 #include "Activia/ActTargetNuclide.hh"
+#include "Activia/ActEnergyFactorCache.hh"
 
 #include <cmath>
 #include <iostream>
@@ -15,6 +17,8 @@ ActNucleiData::ActNucleiData(ActNuclide* beamNuclide, ActTargetNuclide* targetIs
 			     ActNuclide* product, double energy) : ActAbsData()
 {
   // Constructor that calculates everything in one go
+  _eCache = 0; _eBin = -1;
+  _updateFactor = 1.0;
   this->setBeamData(beamNuclide);
   this->setTargetData(targetIsotope);
   this->setProductData(product);
@@ -49,15 +53,19 @@ void ActNucleiData::initialise() {
   _izt = 0; _iat = 0; _iz = 0; _ia = 0;
   _nt = 0.0; _int = 0; _n = 0.0; _in = 0;
   _dnpt = 0.0; _idnpt = 0; _dnp = 0.0; _idnp = 0;
-  _x = 0.0; _y = 0.0; _ix = 0; _iy = 0; _ichg = 0;
+  _x = 0.0; _y = 0.0; _ix = 0; _iy = 0; _ichg = 0; _ioe = 0;
   _mdtgt = 0.0; _thrse = 0.0;
   _fraction = 0.0;
+  _eCache = 0; _eBin = -1;
+  _updateFactor = 1.0;
 
 }
 
 void ActNucleiData::setTargetData(ActTargetNuclide* targetIsotope) {
 
   _targetIsotope = targetIsotope;
+  // Any cached energy factors were for the previous target
+  _eCache = 0; _eBin = -1;
 
   double targetZ(0.0), targetA(0.0), targetMedianA(0.0);
   double fraction(0.0);
@@ -79,8 +87,10 @@ void ActNucleiData::setTargetData(ActTargetNuclide* targetIsotope) {
   // N_n - N_p
   _dnpt = _nt - _zt; _idnpt = _int - _izt;
 
-  ActMassDef massDef(targetZ, targetA);
-  _mdtgt = massDef.calcDelta();
+  // Use the precomputed mass excess
+  _mdtgt = ActNuclideTable::getInstance()->getMassExcess(targetZ, targetA);
+  // E0 only depends on the target, so it is known before any product is set
+  this->setEZero();
 
 }
 
@@ -97,6 +107,9 @@ void ActNucleiData::setProductData(ActNuclide* product) {
     _n = _a - _z; _in = _ia - _iz;
     // N_n - N_p
     _dnp = _n - _z; _idnp = _in - _iz;  
+
+    // Pairing classification (even-even etc) for the product
+    _ioe = ActNuclideTable::getPairing(_ia, _iz);
   }
 
 }
@@ -117,6 +130,14 @@ void ActNucleiData::setBeamData(ActNuclide* beamNuclide) {
 
 }
 
+void ActNucleiData::setEnergy(double e) {
+
+  _e = e;
+  _eBin = -1;
+  if (_eCache != 0) {_eBin = _eCache->findBin(e);}
+
+}
+
 void ActNucleiData::setThresholdEnergy() {
 
   double zcall(_z), acall(_a);
@@ -124,22 +145,18 @@ void ActNucleiData::setThresholdEnergy() {
     zcall = _zt - _z; acall = _at - _a;
   }
 
-  ActMassDef sbMass(zcall, acall);
-  double mdprod = sbMass.calcDelta();
+  double mdprod = ActNuclideTable::getInstance()->getMassExcess(zcall, acall);
 
-  _thrse = sbMass.thr(_zt, _at, _mdtgt, mdprod);
+  _thrse = ActMassDef::calcThreshold(zcall, acall, _zt, _at, _mdtgt, mdprod);
 
 }
 
 void ActNucleiData::setEZero() {
 
   // Set the critical energy E0 above which no significant
-  // change in cross-sections is expected.
-  // This uses ST'73 I, Eq 3
-  //_ezero = 69.0*pow(_at, 0.867);
-  // Update from ST'90, pg 368
-  _ezero = 20.3*pow(_at, 1.169);
-  if (_ezero > 4000.0) {_ezero = 4000.0;}
+  // change in cross-sections is expected (ST'90, pg 368).
+  // This only depends on the target mass number, so use the precomputed value.
+  _ezero = ActNuclideTable::getInstance()->getEZero(_at);
 
 }
 
@@ -23,10 +23,9 @@ ActNuclideFactory::~ActNuclideFactory()
 
 ActNuclideFactory* ActNuclideFactory::getInstance() {
 
-  static ActNuclideFactory* theFactory = 0;
-  if (theFactory == 0) {
-    theFactory = new ActNuclideFactory();
-  }
+  // The local static is only initialised once, even if several
+  // threads ask for the factory at the same time
+  static ActNuclideFactory* theFactory = new ActNuclideFactory();
   return theFactory;
 
 }
@@ -38,6 +37,8 @@ ActNuclide* ActNuclideFactory::getNuclide(int Z, double A, double halfLife) {
   ActNuclideKey key(Z, A, halfLife);
   ActFactoryMap::iterator iter;
 
+  std::lock_guard<std::mutex> lock(_mutex);
+
   ActNuclide* theNuclide(0);
 
   if ((iter = _map.find(key)) != _map.end()) {
@@ -0,0 +1,94 @@
+// Class for storing precomputed nuclide properties (mass excess, pairing
+// classification and E0) indexed by the nuclide id
+
+#include "Activia/ActNuclideTable.hh"
+#include "Activia/ActMassDef.hh"
+
+#include <cmath>
+
+ActNuclideTable::ActNuclideTable()
+{
+  // Constructor
+  this->setUp();
+}
+
+ActNuclideTable::~ActNuclideTable()
+{
+  // Destructor
+  _massExcess.clear();
+  _eZero.clear();
+}
+
+ActNuclideTable* ActNuclideTable::getInstance() {
+
+  // The local static is only initialised once, even if several
+  // threads ask for the table at the same time
+  static ActNuclideTable theTable;
+  return &theTable;
+
+}
+
+void ActNuclideTable::setUp() {
+
+  int nZ = MaxZ + 1;
+  int nA = MaxA + 1;
+
+  _massExcess.assign(nZ*nA, 0.0);
+  _eZero.assign(nA, 0.0);
+
+  int iz, ia;
+  for (ia = 0; ia < nA; ia++) {
+
+    _eZero[ia] = ActNuclideTable::calcEZero((double) ia);
+
+    for (iz = 0; iz <= ia && iz < nZ; iz++) {
+
+      int id = ActNuclideTable::getId(iz, ia);
+      ActMassDef massDef((double) iz, (double) ia);
+      _massExcess[id] = massDef.calcDelta();
+
+    }
+
+  }
+
+}
+
+double ActNuclideTable::getMassExcess(double z, double a) {
+
+  int iz = (int) z;
+  int ia = (int) a;
+  int id = ActNuclideTable::getId(iz, ia);
+
+  if (id >= 0 && this->isInteger(z, iz) && this->isInteger(a, ia)) {
+    return _massExcess[id];
+  }
+
+  // Not in the table; calculate it directly
+  ActMassDef massDef(z, a);
+  return massDef.calcDelta();
+
+}
+
+double ActNuclideTable::getEZero(double at) {
+
+  int iat = (int) at;
+  if (iat >= 0 && iat <= MaxA && this->isInteger(at, iat)) {
+    return _eZero[iat];
+  }
+
+  return ActNuclideTable::calcEZero(at);
+
+}
+
+double ActNuclideTable::calcEZero(double at) {
+
+  // Set the critical energy E0 above which no significant
+  // change in cross-sections is expected.
+  // This uses ST'73 I, Eq 3
+  //ezero = 69.0*pow(at, 0.867);
+  // Update from ST'90, pg 368
+  double ezero = 20.3*pow(at, 1.169);
+  if (ezero > 4000.0) {ezero = 4000.0;}
+  return ezero;
+
+}
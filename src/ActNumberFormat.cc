@@ -0,0 +1,89 @@
+// Class for converting numbers to text using std::to_chars
+
+#include "Activia/ActNumberFormat.hh"
+
+#include <charconv>
+#include <cstring>
+
+ActNumberFormat::ActNumberFormat(int mode, int precision) : _mode(mode), _precision(precision)
+{
+  // Constructor
+  _buffer[0] = '\0';
+}
+
+ActNumberFormat::~ActNumberFormat()
+{
+  // Destructor
+}
+
+void ActNumberFormat::append(std::string& text, double value, int width) {
+
+  char* end = _buffer + sizeof(_buffer);
+  std::to_chars_result result;
+
+  if (_mode == ActNumberFormat::Shortest) {
+    result = std::to_chars(_buffer, end, value);
+  } else if (_mode == ActNumberFormat::Fixed) {
+    result = std::to_chars(_buffer, end, value, std::chars_format::fixed, _precision);
+  } else {
+    // Same as printf("%.*g"), which iostreams use for the default format
+    result = std::to_chars(_buffer, end, value, std::chars_format::general, _precision);
+  }
+
+  // Fixed format of very large numbers can be too long for the buffer
+  if (result.ec != std::errc()) {
+    result = std::to_chars(_buffer, end, value);
+  }
+
+  size_t length = result.ptr - _buffer;
+  text.append(_buffer, length);
+  ActNumberFormat::pad(text, length, width);
+
+}
+
+void ActNumberFormat::append(std::string& text, int value, int width) {
+
+  std::to_chars_result result = std::to_chars(_buffer, _buffer + sizeof(_buffer), value);
+
+  size_t length = result.ptr - _buffer;
+  text.append(_buffer, length);
+  ActNumberFormat::pad(text, length, width);
+
+}
+
+void ActNumberFormat::append(std::string& text, const char* word, int width) {
+
+  size_t length = strlen(word);
+  text.append(word, length);
+  ActNumberFormat::pad(text, length, width);
+
+}
+
+void ActNumberFormat::append(std::string& text, const std::string& word, int width) {
+
+  text.append(word);
+  ActNumberFormat::pad(text, word.size(), width);
+
+}
+
+void ActNumberFormat::pad(std::string& text, size_t length, int width) {
+
+  if (width > 0 && length < (size_t) width) {text.append(width - length, ' ');}
+
+}
+
+std::string ActNumberFormat::toString(double value) {
+
+  std::string text("");
+  this->append(text, value);
+  return text;
+
+}
+
+std::string ActNumberFormat::toString(int value) {
+
+  std::string text("");
+  this->append(text, value);
+  return text;
+
+}
@@ -119,6 +119,9 @@ void ActOutputSelection::allowedTypes() {
   _xSecExtension = this->setExtension(ActOutputSelection::Stream);
   _decayExtension = this->setExtension(ActOutputSelection::Stream);
 
+  // Columnar binary output is always available, but is not the default
+  _allowedTypes[ActOutputSelection::Binary] = "Binary (columnar)";
+
   // ROOT output if appropriate environment is present
 #ifdef ACT_USE_ROOT
   typeName = "ROOT";
@@ -137,6 +140,7 @@ void ActOutputSelection::allowedDetails() {
 
   _allowedDetails[ActOutputSelection::Summary] = "Summary";
   _allowedDetails[ActOutputSelection::All] = "All";
+  _allowedDetails[ActOutputSelection::Sparse] = "Sparse (non-zero energy range)";
 
   _defaultDetail = ActOutputSelection::Summary;
   _defaultDetailName = "Summary";
@@ -153,6 +157,8 @@ std::string ActOutputSelection::setExtension(int type) {
   std::string extension(".out");
   if (type == ActOutputSelection::ROOT) {
     extension = ".root";
+  } else if (type == ActOutputSelection::Binary) {
+    extension = ".bin";
   }
 
   return extension;
@@ -1,6 +1,7 @@
 // Class for defining a table of output
 
 #include "Activia/ActOutputTable.hh"
+#include "Activia/ActAbsOutput.hh"
 
 #include <iostream>
 using std::cout;
@@ -10,6 +11,7 @@ ActOutputTable::ActOutputTable(const char* name)
 {
   // Constructor
   _name = std::string(name);
+  _sink = 0;
   this->reset();
 }
 
@@ -17,6 +19,7 @@ ActOutputTable::ActOutputTable(const char* name, std::vector<ActString>& columnN
 {
   // Constructor
   _name = std::string(name);
+  _sink = 0;
   this->reset();
   this->setColumnNames(columnNames);
 
@@ -26,6 +29,7 @@ ActOutputTable::ActOutputTable(const char* name, std::vector<ActString>& columnN
 {
   // Constructor
   _name = std::string(name);
+  _sink = 0;
   this->reset();
   this->setColumnNames(columnNames);
   _colWidth = columnSpacing;
@@ -35,18 +39,15 @@ ActOutputTable::ActOutputTable(const char* name, std::vector<ActString>& columnN
 ActOutputTable::~ActOutputTable() 
 {
   // Destructor
+  this->endStream();
   this->reset();
 }
 
 void ActOutputTable::reset() { 
 
   _columnNames.clear();
-  int i;
-  int nRows = _rows.size();
-  for (i = 0; i < nRows; i++) {
-    _rows[i].clear();
-  }
-  _rows.clear();
+  _values.clear();
+  _nRows = 0;
   _nColumns = 0;
   _colWidth = 14;
 }
@@ -71,15 +72,78 @@ void ActOutputTable::addRow(std::vector<double>& values) {
     return;
   }
 
-  _rows.push_back(values);
+  if (_sink != 0) {
+
+    // Pass the row straight to the output
+    _sink->outputTableRow(*this, values.data());
+
+  } else {
+
+    _values.insert(_values.end(), values.begin(), values.end());
+    _nRows += 1;
+
+  }
+
+}
+
+void ActOutputTable::streamTo(ActAbsOutput* output) {
+
+  this->endStream();
+  if (output == 0) {return;}
+
+  _sink = output;
+  _sink->beginTable(*this);
+
+  // Write and then remove any rows that have already been stored
+  int iRow;
+  for (iRow = 0; iRow < _nRows; iRow++) {
+    _sink->outputTableRow(*this, this->getRowData(iRow));
+  }
+
+  _values.clear();
+  _nRows = 0;
+
+}
+
+void ActOutputTable::endStream() {
+
+  if (_sink != 0) {
+
+    ActAbsOutput* output = _sink;
+    _sink = 0;
+    output->endTable(*this);
+
+  }
+
+}
+
+std::vector< std::vector <double> > ActOutputTable::getRows() {
+
+  std::vector< std::vector <double> > rows(_nRows);
+  int iRow;
+  for (iRow = 0; iRow < _nRows; iRow++) {
+    rows[iRow] = this->getRow(iRow);
+  }
+
+  return rows;
 
 }
 
 std::vector<double> ActOutputTable::getRow(int index) {
 
   std::vector<double> row;
-  if (index >= 0 && index < _nColumns-1) {row = _rows[index];}
+  const double* rowData = this->getRowData(index);
+  if (rowData != 0) {row.assign(rowData, rowData + _nColumns);}
 
   return row;
 
 }
+
+const double* ActOutputTable::getRowData(int index) const {
+
+  const double* rowData(0);
+  if (index >= 0 && index < _nRows && _nColumns > 0) {rowData = &_values[index*_nColumns];}
+
+  return rowData;
+
+}
@@ -16,6 +16,7 @@ ActProdNuclideList::ActProdNuclideList()
 {
   // Constructor
   _prodNuclides.clear(); _nProdNuclides = 0; _debug = 0;
+  _verbose = true;
   _inFileName = "";
 }
 
@@ -37,7 +38,7 @@ void ActProdNuclideList::cleanUp() {
 
 void ActProdNuclideList::storeTable(const char* inFileName) {
 
-  cout<<"Storing radionuclide data using input file "<<inFileName<<endl;
+  if (_verbose) {cout<<"Storing radionuclide data using input file "<<inFileName<<endl;}
 
   _inFileName = std::string(inFileName);
   std::ifstream getData(inFileName);
@@ -88,7 +89,7 @@ void ActProdNuclideList::storeTable(const char* inFileName) {
 
   _nProdNuclides = (int) _prodNuclides.size();
 
-  cout<<"Finished storing "<<_nProdNuclides<<" product radio-nuclides"<<endl;
+  if (_verbose) {cout<<"Finished storing "<<_nProdNuclides<<" product radio-nuclides"<<endl;}
 
 }
 
@@ -7,6 +7,7 @@
 #include "Activia/ActProdNuclideList.hh"
 #include "Activia/ActProdNuclide.hh"
 #include "Activia/ActNucleiData.hh"
+#include "Activia/ActEnergyFactorCache.hh"
 #include "Activia/ActAbsXSecAlgorithm.hh"
 #include "Activia/ActConstants.hh"
 #include "Activia/ActNuclideFactory.hh"
@@ -15,6 +16,11 @@
 #include "Activia/ActOutputSelection.hh"
 #include "Activia/ActTargetNuclide.hh"
 #include "Activia/ActAbsCalcStatus.hh"
+#include "Activia/ActRunStatistics.hh"
+#include "Activia/ActCheckpoint.hh"
+#include "Activia/ActShard.hh"
+#include "Activia/ActSigmaMatrix.hh"
+#include "Activia/ActEnsemble.hh"
 
 #include <vector>
 
@@ -33,14 +39,15 @@ ActProdXSecData::ActProdXSecData(ActTargetNuclide* targetIsotope,
   _prodList = prodList;
   _inputBeam = inputBeam;
   _algorithm = algorithm;
-  _xSecData.clear();
+  _otherSpectra.clear();
+  _xSecData.clear(); _xSecProducts.clear(); _prodRates.clear();
   _output = output;
 }
 
 ActProdXSecData::~ActProdXSecData() 
 {
   // Destructor
-  _xSecData.clear();
+  _xSecData.clear(); _xSecProducts.clear(); _prodRates.clear();
 }
 
 void ActProdXSecData::calculate() {
@@ -52,7 +59,28 @@ void ActProdXSecData::calculate() {
   if (_prodList == 0 || _targetIsotope == 0) {return;}
   if (_inputBeam == 0 || _algorithm == 0) {return;}
 
-  _xSecData.clear();
+  _xSecData.clear(); _xSecProducts.clear(); _prodRates.clear();
+
+  int nProducts = _prodList->getNProdNuclides();
+  int ip;
+
+  // Restore any results that were calculated before the run was restarted
+  ActCheckpoint* checkpoint(0);
+  if (_output != 0) {checkpoint = _output->getCheckpoint();}
+  int firstProduct(0), lastProduct(nProducts);
+  if (checkpoint != 0) {firstProduct = checkpoint->restoreResults(_xSecData, _xSecProducts, nProducts);}
+
+  // Only calculate the products of this shard, or restore the
+  // results of all shards when they are merged
+  ActShard* shard(0);
+  if (_output != 0) {shard = _output->getShard();}
+  if (shard != 0) {
+    shard->restoreResults(_xSecData, _xSecProducts);
+    int shardFirst = shard->getFirstProduct(nProducts);
+    if (shardFirst > firstProduct) {firstProduct = shardFirst;}
+  }
+
+  if (firstProduct >= lastProduct) {return;}
 
   double EStart = _inputBeam->getEStart();
   double dE = _inputBeam->getdE();
@@ -60,9 +88,6 @@ void ActProdXSecData::calculate() {
   cout<<"E0 = "<<EStart<<", dE = "<<dE<<", nE = "<<nE<<endl;
   int nE1 = nE - 1;
 
-  int nProducts = _prodList->getNProdNuclides();
-  int ip;
-
   // Create a nuclei data pointer that will store the beam, target and
   // product information, all in one object, that can be passed around 
   // the various cross-section algorithm/models.
@@ -79,33 +104,73 @@ void ActProdXSecData::calculate() {
   // This will be used to scale the production rate for all product isotopes.
   double fraction = data->getFraction();
 
-  // Load in any data tables for this target isotope
-  // Use the list of product isotopes to store maps of
-  // target-product tables.
-  _algorithm->loadDataTables(_targetIsotope, _prodList);
-
-  // Store energies in vector (same for all products)
+  // Time the calculation for this target isotope
+  ActRunStatistics* statistics = ActRunStatistics::getInstance();
+  ActString phaseName("xSec:");
+  phaseName += (int) (data->getzt() + 0.5); phaseName += ":"; phaseName += (int) (atgt + 0.5);
+  statistics->startPhase(phaseName.getString());
+
+  // Use the stored cross-sections of an earlier run for the pairs that have them
+  ActSigmaMatrix* sigmaMatrix(0);
+  if (_output != 0) {sigmaMatrix = _output->getSigmaMatrix();}
+  bool restoring(false);
+  if (sigmaMatrix != 0) {restoring = sigmaMatrix->hasRows();}
+
+  // Any uncertainty ensemble that the cross-sections are added to
+  ActEnsemble* ensemble(0);
+  if (_output != 0) {ensemble = _output->getEnsemble();}
+
+  // Store energies in vector (same for all products), and the fluxes of the
+  // input beam and any other spectra at these energies
+  int nSpectra = this->getNSpectra();
   std::vector<double> energies;
-  int iE;
+  std::vector<std::vector<double> > fluxes(nSpectra, std::vector<double>(nE, 0.0));
+  int iE, iS;
   for (iE = 0; iE < nE; iE++) {
     double energy = iE*dE + EStart;
     energies.push_back(energy);
+    fluxes[0][iE] = _inputBeam->fluxdE(energy);
+    for (iS = 1; iS < nSpectra; iS++) {fluxes[iS][iE] = _otherSpectra[iS-1]->fluxdE(energy);}
+  }
+
+  // Load in any data tables for this target isotope, and calculate the factors
+  // that only depend on the energy and target isotope, which the cross-section
+  // models then retrieve for each product. If cross-sections are stored, these
+  // are only prepared when the first product that is not stored is calculated.
+  ActEnergyFactorCache eFactorCache;
+  bool modelsReady(false);
+  if (restoring == false) {
+    // Use the list of product isotopes to store maps of
+    // target-product tables.
+    statistics->startPhase("tableLoad");
+    _algorithm->loadDataTables(_targetIsotope, _prodList);
+    statistics->stopPhase("tableLoad");
+    eFactorCache.build(data, energies);
+    modelsReady = true;
   }
 
+  // Cross-sections for each energy, and whether the energy passed the selection
+  std::vector<double> sigmas(nE, 0.0);
+  std::vector<int> passedE(nE, 0);
+
   int levelOfDetail(0);
   bool outputEGraphs = false;
+  bool sparseEGraphs = false;
   if (_output != 0) {
     levelOfDetail = _output->getLevelOfDetail();
     if (levelOfDetail > ActOutputSelection::Summary) {outputEGraphs = true;}
+    if (levelOfDetail == ActOutputSelection::Sparse) {sparseEGraphs = true;}
   }
 
   // Calculation status
-  ActAbsCalcStatus* calcStatus = _output->getCalcStatus();
+  ActAbsCalcStatus* calcStatus(0);
+  if (_output != 0) {calcStatus = _output->getCalcStatus();}
   if (calcStatus != 0) {calcStatus->setNProductIsotopes(nProducts);}
+  _algorithm->setCalcStatus(calcStatus);
   bool runCode(true); // calculation status can say "stop calculating"
 
   // Loop over products
-  for (ip = 0; ip < nProducts; ip++) {
+  for (ip = firstProduct; ip < lastProduct; ip++) {
 
     cout<<"ActProdXSecData ip = "<<ip<<endl;
 
@@ -118,6 +183,12 @@ void ActProdXSecData::calculate() {
     // Stop calculation if requested by the status
     if (runCode == false) {break;}
 
+    // Save a checkpoint at the end of each chunk of products, if enough time has passed
+    if (checkpoint != 0 && ip > firstProduct) {checkpoint->endProducts(ip, _output);}
+
+    // Skip the products of the other shards
+    if (shard != 0 && shard->hasProduct(ip) == false) {continue;}
+
     ActProdNuclide* prodNuclide = _prodList->getProdNuclide(ip);
     
     double zNucl(0.0), aNucl(0.0), halfLife(0.0);
@@ -144,8 +215,10 @@ void ActProdXSecData::calculate() {
       prodGraphPoints[iE] = ActGraphPoint(energies[iE], 0.0, 0.0);
     }
 
-    // Total sigma and production rate for the product (including side branches)
+    // Total sigma and production rate for the product (including side branches),
+    // and the production rates for all spectra
     double totalProdSigma(0.0), totalProdRate(0.0);
+    std::vector<double> prodRates(nSpectra, 0.0);
 
     // Loop over side branches, as well as the product isotope
     int iSB;
@@ -153,6 +226,7 @@ void ActProdXSecData::calculate() {
 
       // Total sigma and production rate for the individual side branches
       double totalSBSigma(0.0), totalSBProdRate(0.0);
+      std::vector<double> sbProdRates(nSpectra, 0.0);
 
       bool doCalc(true);
 
@@ -195,36 +269,66 @@ void ActProdXSecData::calculate() {
       // have the target and product parameters
       data->setOtherQuantities();
 
-      // Set the nuclei data that the algorithm will use
-      // Since the data is a pointer, this can be updated and the algorithm
-      // will automatically know about the changes.
-      _algorithm->setNucleiData(data);
+      // Restore the cross-sections for all energies, if they are stored
+      bool restored(false);
+      if (restoring == true) {
+	restored = sigmaMatrix->findRow((int) z, a, nE, sigmas);
+	if (restored == true) {passedE.assign(nE, 1);}
+      }
 
-      // Loop over the energy range, calculating the cross section value
-      // and storing them in the graph.
+      if (restored == false) {
+
+	if (modelsReady == false) {
+	  statistics->startPhase("tableLoad");
+	  _algorithm->loadDataTables(_targetIsotope, _prodList);
+	  statistics->stopPhase("tableLoad");
+	  eFactorCache.build(data, energies);
+	  modelsReady = true;
+	}
+
+	// Set the nuclei data that the algorithm will use
+	// Since the data is a pointer, this can be updated and the algorithm
+	// will automatically know about the changes.
+	_algorithm->setNucleiData(data);
+
+	// Calculate the cross-sections for all energies. The algorithm uses
+	// the previously given nuclei data pointer.
+	_algorithm->calcCrossSections(energies, sigmas, passedE);
+
+	if (sigmaMatrix != 0) {sigmaMatrix->addRow((int) z, a, sideBranch, sigmas);}
+
+	// The same cross-sections are used by all replicas of the ensemble
+	if (ensemble != 0) {
+	  ensemble->addRow(ip, factor, _algorithm->getModelName(), sigmas,
+			   _algorithm->getUpdateFactors(), _algorithm->getDataFlags());
+	}
+
+      }
+
+      // Loop over the energy range, storing the cross section and 
+      // production rate values in the graph.
 
       for (iE = 0; iE < nE; iE++) {
 
 	double pfac(1.0);
 	if (iE == 0 || iE == nE1) {pfac = 0.5;}
 
-	double energy = energies[iE];
-	data->setEnergy(energy);
-
-	bool passESelection = _algorithm->passESelection(data);
-
-	if (passESelection == true) {
+	if (passedE[iE] == 1) {
 
-	  // Calculate the cross-section based on the previously 
-	  // given nuclei data pointer
-	  double sigma = _algorithm->calcCrossSection();
+	  double sigma = sigmas[iE];
 
-	  double dNdE = _inputBeam->fluxdE(energy);
+	  double dNdE = fluxes[0][iE];
 	  double prodRate = pfac*sigma*factor*fraction*dNdE*dE;
 
 	  totalSBSigma += sigma; totalSBProdRate += prodRate;
 	  totalProdSigma += sigma; totalProdRate += prodRate;
 
+	  // The same production rate for the other spectra
+	  for (iS = 1; iS < nSpectra; iS++) {
+	    double otherRate = pfac*sigma*factor*fraction*fluxes[iS][iE]*dE;
+	    sbProdRates[iS] += otherRate; prodRates[iS] += otherRate;
+	  }
+
 	  // Also store the sigma and production rate vs energy 
 	  // graph for the side branch/product isotope
 	  prodGraphPoints[iE].addYValues(sigma, prodRate);
@@ -251,10 +355,17 @@ void ActProdXSecData::calculate() {
 
 	// Print out sigma/production rate as function of energy to output class
 	ActXSecGraph xSecEGraph("xSecEData");
-	xSecEGraph.addPoints(prodGraphPoints);
+	if (sparseEGraphs == true) {
+	  this->addNonZeroPoints(xSecEGraph, prodGraphPoints, EStart, dE);
+	} else {
+	  xSecEGraph.addPoints(prodGraphPoints);
+	}
 
-	if (outputEGraphs == true) {
+	// Sparse graphs are empty if all values are zero, e.g. below threshold
+	if (outputEGraphs == true && xSecEGraph.numberOfPoints() > 0) {
+	  statistics->startPhase("output");
 	  _output->outputGraph(*data, xSecEGraph);
+	  statistics->stopPhase("output");
 	}
 
       }
@@ -262,14 +373,104 @@ void ActProdXSecData::calculate() {
       // Insert the graphs into the internal map for the given product nuclide
       //cout<<"Inserting cross-section and production rate vs energy graph into map"<<endl;
       _xSecData[isotope] = xSecGraph;
+      _xSecProducts[isotope] = ip;
+      if (nSpectra > 1) {
+	if (sideBranch == true) {
+	  sbProdRates[0] = totalSBProdRate;
+	  _prodRates[isotope] = sbProdRates;
+	} else {
+	  prodRates[0] = totalProdRate;
+	  _prodRates[isotope] = prodRates;
+	}
+      }
+      if (checkpoint != 0) {
+	if (sideBranch == true) {
+	  checkpoint->addResult(isotope, totalSBSigma, totalSBProdRate, ip);
+	} else {
+	  checkpoint->addResult(isotope, totalProdSigma, totalProdRate, ip);
+	}
+      }
 
     } // side branch plus product loop
 
   } // product loop
 
+  // The hit rates of the energy factors are given in the run statistics report
+  if (modelsReady == true) {eFactorCache.addToStatistics();}
   cout<<"Finished in ActProdXSecData"<<endl;
 
+  statistics->stopPhase(phaseName.getString());
+
   delete data;
 
 }
 
+void ActProdXSecData::useSpectrum(int iSpectrum) {
+
+  if (iSpectrum < 0 || iSpectrum >= this->getNSpectra()) {
+    cout<<"Error in ActProdXSecData::useSpectrum. Spectrum "<<iSpectrum
+	<<" is out of range [0,"<<this->getNSpectra()-1<<"]"<<endl;
+    return;
+  }
+
+  // The stored graphs only have the total sigma and production rate
+  std::map<ActNuclide*, std::vector<double>, ActPtrLess>::iterator iter;
+  for (iter = _prodRates.begin(); iter != _prodRates.end(); ++iter) {
+
+    ActProdXSecMap::iterator graphIter = _xSecData.find(iter->first);
+    if (graphIter == _xSecData.end()) {continue;}
+
+    double sigma = graphIter->second.getTotalSigma();
+    ActXSecGraph xSecGraph("xSecGraph");
+    xSecGraph.addPoint(0.0, sigma, iter->second[iSpectrum]);
+    graphIter->second = xSecGraph;
+
+  }
+
+}
+
+void ActProdXSecData::addNonZeroPoints(ActXSecGraph& graph, std::vector<ActGraphPoint>& points,
+				       double EStart, double dE) {
+
+  // Only add the points from the first to the last one that has a non-zero
+  // y value (sigma or production rate), and describe the full energy grid
+  // using the run lengths of the omitted and stored bins
+  int nPoints = (int) points.size();
+  int iFirst(-1), iLast(-1);
+  int iP;
+
+  for (iP = 0; iP < nPoints; iP++) {
+
+    std::vector<double> yValues = points[iP].getYValues();
+    int nY = (int) yValues.size();
+    int iY;
+    for (iY = 0; iY < nY; iY++) {
+      if (yValues[iY] != 0.0) {
+	if (iFirst < 0) {iFirst = iP;}
+	iLast = iP;
+	break;
+      }
+    }
+
+  }
+
+  std::vector<int> runs;
+  if (iFirst < 0) {
+
+    // All values are zero: no points are stored
+    runs.push_back(nPoints);
+
+  } else {
+
+    std::vector<ActGraphPoint> nonZeroPoints(points.begin() + iFirst, points.begin() + iLast + 1);
+    graph.addPoints(nonZeroPoints);
+
+    runs.push_back(iFirst);
+    runs.push_back(iLast - iFirst + 1);
+    runs.push_back(nPoints - iLast - 1);
+
+  }
+
+  graph.setGrid(EStart, dE, runs);
+
+}
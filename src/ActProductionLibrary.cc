@@ -0,0 +1,787 @@
+// Class for building and reading the library of total cross-sections and
+// production rates of all stable isotopes, and answering questions from it
+
+#include "Activia/ActProductionLibrary.hh"
+#include "Activia/ActBinaryFormat.hh"
+#include "Activia/ActCosmicSpectrum.hh"
+#include "Activia/ActGordonSpectrum.hh"
+#include "Activia/ActJSONValue.hh"
+#include "Activia/ActModelVersion.hh"
+#include "Activia/ActNaturalAbundance.hh"
+#include "Activia/ActNuclideFactory.hh"
+#include "Activia/ActNumberFormat.hh"
+#include "Activia/ActProdNuclide.hh"
+#include "Activia/ActProdNuclideList.hh"
+#include "Activia/ActRunStatistics.hh"
+#include "Activia/ActTrace.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+using std::cout;
+using std::endl;
+
+static void actPutDouble(std::vector<unsigned char>& bytes, double value) {
+
+  unsigned long long bits(0);
+  memcpy(&bits, &value, sizeof(bits));
+  ActBinaryFormat::putUInt(bytes, bits, 8);
+
+}
+
+static bool actGetDouble(const std::vector<unsigned char>& bytes, size_t& pos, double& value) {
+
+  unsigned long long bits(0);
+  if (ActBinaryFormat::getUInt(bytes, pos, bits, 8) == false) {return false;}
+  memcpy(&value, &bits, sizeof(value));
+  return true;
+
+}
+
+static bool actLessEntry(const ActProductionLibrary::Entry& entry1,
+			 const ActProductionLibrary::Entry& entry2) {
+
+  if (entry1.z != entry2.z) {return entry1.z < entry2.z;}
+  return entry1.a < entry2.a;
+
+}
+
+ActProductionLibrary::ActProductionLibrary() :
+  _modelVersion(0), _modelHash(0), _decayDataHash(0), _dataTablesHash(0),
+  _minDataXSec(0.0), _EStart(0.0), _EEnd(0.0), _dE(0.0),
+  _isotopes(),
+  _messageMutex()
+{
+  // Constructor
+}
+
+ActProductionLibrary::~ActProductionLibrary()
+{
+  // Destructor
+}
+
+std::string ActProductionLibrary::getSpectrumName(int spectrum) {
+
+  if (spectrum == ActProductionLibrary::Cosmic) {return "cosmic";}
+  if (spectrum == ActProductionLibrary::Gordon) {return "gordon";}
+  return "unknown";
+
+}
+
+bool ActProductionLibrary::build(const char* decayDataFile, const char* listOfDataTables,
+				 double minDataXSec, const char* abundanceFile,
+				 double EStart, double EEnd, double dE, int nThreads) {
+
+  _isotopes.clear();
+
+  if (EStart <= 0.0 || EEnd <= EStart || dE <= 0.0) {
+    cout<<"Error in ActProductionLibrary::build. The energies need 0 < EStart < EEnd and dE > 0"
+	<<endl;
+    return false;
+  }
+
+  // Check the files here, since ActProdNuclideList::storeTable stops the program
+  std::string dataTables(listOfDataTables != 0 ? listOfDataTables : "");
+  if (dataTables.compare("0") == 0) {dataTables = "";}
+  _decayDataHash = ActModelVersion::calcFileHash(decayDataFile);
+  if (_decayDataHash == 0) {
+    cout<<"Error in ActProductionLibrary::build. Can not read "<<decayDataFile<<endl;
+    return false;
+  }
+  if (dataTables.size() > 0 && ActModelVersion::calcFileHash(dataTables) == 0) {
+    cout<<"Error in ActProductionLibrary::build. Can not read "<<dataTables<<endl;
+    return false;
+  }
+
+  ActNaturalAbundance abundances;
+  if (abundances.storeTable(abundanceFile) == false) {return false;}
+
+  _dataTablesHash = ActModelVersion::calcDataTablesHash(dataTables);
+  _minDataXSec = minDataXSec;
+  _EStart = EStart; _EEnd = EEnd; _dE = dE;
+
+  // Create the singletons before any threads use them
+  ActRunStatistics::getInstance();
+  ActNuclideFactory::getInstance();
+  ActTrace::getInstance();
+
+  ActProdNuclideList prodList;
+  prodList.setVerbose(false);
+  prodList.storeTable(decayDataFile);
+
+  // The list of isotopes to calculate; only elements with Z > 5 can be targets
+  std::vector<Isotope*> jobs;
+  std::vector<int> elements = abundances.getElements();
+  int iZ, i;
+  for (iZ = 0; iZ < (int) elements.size(); iZ++) {
+
+    int Z = elements[iZ];
+    if (Z < 6) {continue;}
+
+    std::vector<double> massNumbers, fractions;
+    abundances.getIsotopes(Z, massNumbers, fractions);
+    for (i = 0; i < (int) massNumbers.size(); i++) {
+      Isotope& isotope = _isotopes[std::make_pair(Z, massNumbers[i])];
+      isotope.z = Z; isotope.a = massNumbers[i]; isotope.fraction = fractions[i];
+      jobs.push_back(&isotope);
+    }
+
+  }
+
+  if (nThreads < 1) {nThreads = (int) std::thread::hardware_concurrency();}
+  if (nThreads < 1) {nThreads = 1;}
+  if (nThreads > (int) jobs.size()) {nThreads = (int) jobs.size();}
+
+  cout<<"Calculating the library for "<<jobs.size()<<" isotopes and "
+      <<prodList.getNProdNuclides()<<" products using "<<nThreads<<" threads"<<endl;
+
+  // Each thread has its own engine and takes the next isotope
+  std::vector<ActXSecEngine*> engines;
+  for (i = 0; i < nThreads; i++) {
+    engines.push_back(new ActXSecEngine(&prodList, dataTables.c_str(), minDataXSec, false));
+  }
+
+  _modelVersion = ActModelVersion::ModelVersion;
+  _modelHash = ActModelVersion::calcModelHash(engines[0]);
+
+  std::atomic<int> nextJob(0), nDone(0);
+  int nJobs = (int) jobs.size();
+
+  std::vector<std::thread> workers;
+  for (i = 0; i < nThreads; i++) {
+    ActXSecEngine* engine = engines[i];
+    workers.push_back(std::thread([this, engine, &jobs, &nextJob, &nDone, nJobs] {
+	  int iJob;
+	  while ((iJob = nextJob++) < nJobs) {
+	    this->calcIsotope(engine, *jobs[iJob]);
+	    std::lock_guard<std::mutex> lock(_messageMutex);
+	    cout<<"Done isotope Z = "<<jobs[iJob]->z<<", A = "<<jobs[iJob]->a
+		<<" ("<<++nDone<<" of "<<nJobs<<")"<<endl;
+	  }
+	}));
+  }
+
+  for (i = 0; i < nThreads; i++) {workers[i].join();}
+  for (i = 0; i < nThreads; i++) {delete engines[i];}
+
+  cout<<"The library has "<<this->getNEntries()<<" entries"<<endl;
+
+  return true;
+
+}
+
+void ActProductionLibrary::calcIsotope(ActXSecEngine* engine, Isotope& isotope) {
+
+  isotope.entries.clear();
+
+  // The formulae use the median A of all isotopes in the target, so the isotope
+  // is calculated (with fraction 1) within the natural isotopes of its element
+  std::vector<double> massNumbers, fractions;
+  std::map<std::pair<int, double>, Isotope>::const_iterator iter =
+    _isotopes.lower_bound(std::make_pair(isotope.z, 0.0));
+  for (; iter != _isotopes.end() && iter->first.first == isotope.z; ++iter) {
+    massNumbers.push_back(iter->first.second);
+    fractions.push_back(iter->first.second == isotope.a ? 1.0 : 0.0);
+  }
+
+  ActTarget* target = engine->getTarget(isotope.z, massNumbers, fractions);
+  if (target == 0) {return;}
+
+  // All products of the decay data that can be made from the isotope
+  ActProdNuclideList* prodList = engine->getProdNuclideList();
+  std::vector<ActXSecEngine::Product> products;
+  int i;
+  for (i = 0; i < prodList->getNProdNuclides(); i++) {
+    ActProdNuclide* prodNuclide = prodList->getProdNuclide(i);
+    if (prodNuclide == 0) {continue;}
+    if (prodNuclide->getZ() > isotope.z || prodNuclide->getA() > isotope.a) {continue;}
+    ActXSecEngine::Product product;
+    product.z = prodNuclide->getZ(); product.a = prodNuclide->getA();
+    product.sigma = 0.0; product.prodRate = 0.0; product.halfLife = 0.0;
+    products.push_back(product);
+  }
+
+  int nProducts = (int) products.size();
+  std::vector<Entry> entries(nProducts);
+
+  // The cross-sections do not depend on the spectrum, so all spectra are done in one pass
+  std::vector<ActBeamSpectrum*> spectra(ActProductionLibrary::NSpectra);
+  spectra[ActProductionLibrary::Cosmic] = new ActCosmicSpectrum("CosmicRays", 1, 1.0);
+  spectra[ActProductionLibrary::Gordon] = new ActGordonSpectrum("GordonSpectrum", 1, 1.0);
+  int iS;
+  for (iS = 0; iS < ActProductionLibrary::NSpectra; iS++) {
+    spectra[iS]->setEnergies(_EStart, _EEnd, _dE);
+  }
+
+  std::vector<std::vector<ActXSecEngine::Product> > results(1, products);
+  engine->calcProduction(target, spectra, results);
+
+  for (iS = 0; iS < ActProductionLibrary::NSpectra; iS++) {
+
+    for (i = 0; i < nProducts; i++) {
+      const ActXSecEngine::Product& product = results[iS][i];
+      Entry& entry = entries[i];
+      entry.z = product.z; entry.a = product.a;
+      entry.halfLife = product.halfLife;
+      entry.sigma = product.sigma;
+      entry.prodRates[iS] = product.prodRate;
+    }
+
+    delete spectra[iS];
+
+  }
+
+  for (i = 0; i < nProducts; i++) {
+    if (entries[i].sigma > 0.0) {isotope.entries.push_back(entries[i]);}
+  }
+  std::sort(isotope.entries.begin(), isotope.entries.end(), actLessEntry);
+
+}
+
+int ActProductionLibrary::getNEntries() const {
+
+  int nEntries(0);
+  std::map<std::pair<int, double>, Isotope>::const_iterator iter;
+  for (iter = _isotopes.begin(); iter != _isotopes.end(); ++iter) {
+    nEntries += (int) iter->second.entries.size();
+  }
+  return nEntries;
+
+}
+
+const ActProductionLibrary::Isotope* ActProductionLibrary::getIsotope(int Z, double A) const {
+
+  std::map<std::pair<int, double>, Isotope>::const_iterator iter =
+    _isotopes.find(std::make_pair(Z, A));
+  if (iter == _isotopes.end()) {return 0;}
+  return &(iter->second);
+
+}
+
+bool ActProductionLibrary::write(const std::string& fileName) const {
+
+  std::vector<unsigned char> bytes;
+  ActBinaryFormat::putUInt(bytes, ActProductionLibrary::FormatVersion, 4);
+  ActBinaryFormat::putUInt(bytes, _modelVersion, 4);
+  ActBinaryFormat::putUInt(bytes, _modelHash, 8);
+  ActBinaryFormat::putUInt(bytes, _decayDataHash, 8);
+  ActBinaryFormat::putUInt(bytes, _dataTablesHash, 8);
+  actPutDouble(bytes, _minDataXSec);
+  actPutDouble(bytes, _EStart);
+  actPutDouble(bytes, _EEnd);
+  actPutDouble(bytes, _dE);
+
+  int iS;
+  ActBinaryFormat::putUInt(bytes, ActProductionLibrary::NSpectra, 4);
+  for (iS = 0; iS < ActProductionLibrary::NSpectra; iS++) {
+    ActBinaryFormat::putString(bytes, ActProductionLibrary::getSpectrumName(iS));
+  }
+
+  // The index of the isotopes
+  ActBinaryFormat::putUInt(bytes, _isotopes.size(), 4);
+  unsigned long long first(0);
+  std::map<std::pair<int, double>, Isotope>::const_iterator iter;
+  for (iter = _isotopes.begin(); iter != _isotopes.end(); ++iter) {
+    const Isotope& isotope = iter->second;
+    ActBinaryFormat::putUInt(bytes, isotope.z, 4);
+    actPutDouble(bytes, isotope.a);
+    actPutDouble(bytes, isotope.fraction);
+    ActBinaryFormat::putUInt(bytes, first, 8);
+    ActBinaryFormat::putUInt(bytes, isotope.entries.size(), 4);
+    first += isotope.entries.size();
+  }
+
+  // The entries, in the order of the index
+  ActBinaryFormat::putUInt(bytes, first, 8);
+  for (iter = _isotopes.begin(); iter != _isotopes.end(); ++iter) {
+    const std::vector<Entry>& entries = iter->second.entries;
+    int i;
+    for (i = 0; i < (int) entries.size(); i++) {
+      ActBinaryFormat::putUInt(bytes, entries[i].z, 4);
+      actPutDouble(bytes, entries[i].a);
+      actPutDouble(bytes, entries[i].halfLife);
+      actPutDouble(bytes, entries[i].sigma);
+      for (iS = 0; iS < ActProductionLibrary::NSpectra; iS++) {
+	actPutDouble(bytes, entries[i].prodRates[iS]);
+      }
+    }
+  }
+
+  std::ofstream file(fileName.c_str(), std::ios::binary);
+  if (!file.is_open()) {
+    cout<<"Error in ActProductionLibrary::write. Can not create "<<fileName<<endl;
+    return false;
+  }
+  const char* magic = "ACTLIB01";
+  file.write(magic, strlen(magic));
+  file.write((const char*) &bytes[0], bytes.size());
+  return file.good();
+
+}
+
+bool ActProductionLibrary::read(const std::string& fileName) {
+
+  _isotopes.clear();
+
+  std::ifstream file(fileName.c_str(), std::ios::binary);
+  if (!file.is_open()) {
+    cout<<"Error in ActProductionLibrary::read. Can not open "<<fileName<<endl;
+    return false;
+  }
+  std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)),
+				   std::istreambuf_iterator<char>());
+
+  if (bytes.size() < 8 || memcmp(&bytes[0], "ACTLIB01", 8) != 0) {
+    cout<<"Error in ActProductionLibrary::read. "<<fileName<<" is not a library file"<<endl;
+    return false;
+  }
+
+  size_t pos(8);
+  unsigned long long version(0), nSpectra(0), nIsotopes(0), nEntries(0);
+  bool ok = ActBinaryFormat::getUInt(bytes, pos, version, 4);
+  if (ok == true && version != ActProductionLibrary::FormatVersion) {
+    cout<<"Error in ActProductionLibrary::read. "<<fileName<<" has format version "
+	<<version<<" instead of "<<ActProductionLibrary::FormatVersion<<endl;
+    return false;
+  }
+
+  ok = ok && ActBinaryFormat::getUInt(bytes, pos, _modelVersion, 4);
+  ok = ok && ActBinaryFormat::getUInt(bytes, pos, _modelHash, 8);
+  ok = ok && ActBinaryFormat::getUInt(bytes, pos, _decayDataHash, 8);
+  ok = ok && ActBinaryFormat::getUInt(bytes, pos, _dataTablesHash, 8);
+  ok = ok && actGetDouble(bytes, pos, _minDataXSec);
+  ok = ok && actGetDouble(bytes, pos, _EStart);
+  ok = ok && actGetDouble(bytes, pos, _EEnd);
+  ok = ok && actGetDouble(bytes, pos, _dE);
+
+  ok = ok && ActBinaryFormat::getUInt(bytes, pos, nSpectra, 4);
+  ok = ok && nSpectra == ActProductionLibrary::NSpectra;
+  int iS;
+  for (iS = 0; ok == true && iS < ActProductionLibrary::NSpectra; iS++) {
+    std::string name("");
+    ok = ActBinaryFormat::getString(bytes, pos, name);
+    ok = ok && name.compare(ActProductionLibrary::getSpectrumName(iS)) == 0;
+  }
+
+  ok = ok && ActBinaryFormat::getUInt(bytes, pos, nIsotopes, 4);
+
+  std::vector<Isotope*> index;
+  std::vector<unsigned long long> firstEntries, nIsotopeEntries;
+  unsigned long long i;
+  for (i = 0; ok == true && i < nIsotopes; i++) {
+    unsigned long long z(0), first(0), n(0);
+    double a(0.0), fraction(0.0);
+    ok = ActBinaryFormat::getUInt(bytes, pos, z, 4);
+    ok = ok && actGetDouble(bytes, pos, a);
+    ok = ok && actGetDouble(bytes, pos, fraction);
+    ok = ok && ActBinaryFormat::getUInt(bytes, pos, first, 8);
+    ok = ok && ActBinaryFormat::getUInt(bytes, pos, n, 4);
+    if (ok == false) {break;}
+    Isotope& isotope = _isotopes[std::make_pair((int) z, a)];
+    isotope.z = (int) z; isotope.a = a; isotope.fraction = fraction;
+    index.push_back(&isotope);
+    firstEntries.push_back(first); nIsotopeEntries.push_back(n);
+  }
+
+  ok = ok && ActBinaryFormat::getUInt(bytes, pos, nEntries, 8);
+
+  // Each entry has a 4 byte Z and 3+NSpectra doubles
+  size_t entrySize = 4 + 8*(3 + ActProductionLibrary::NSpectra);
+  ok = ok && nEntries <= (bytes.size() - pos)/entrySize;
+  size_t entriesStart = pos;
+
+  for (i = 0; ok == true && i < (unsigned long long) index.size(); i++) {
+
+    if (firstEntries[i] + nIsotopeEntries[i] > nEntries) {ok = false; break;}
+    pos = entriesStart + firstEntries[i]*entrySize;
+
+    std::vector<Entry>& entries = index[i]->entries;
+    entries.resize(nIsotopeEntries[i]);
+    unsigned long long j;
+    for (j = 0; ok == true && j < nIsotopeEntries[i]; j++) {
+      unsigned long long z(0);
+      ok = ActBinaryFormat::getUInt(bytes, pos, z, 4);
+      entries[j].z = (int) z;
+      ok = ok && actGetDouble(bytes, pos, entries[j].a);
+      ok = ok && actGetDouble(bytes, pos, entries[j].halfLife);
+      ok = ok && actGetDouble(bytes, pos, entries[j].sigma);
+      for (iS = 0; iS < ActProductionLibrary::NSpectra; iS++) {
+	ok = ok && actGetDouble(bytes, pos, entries[j].prodRates[iS]);
+      }
+    }
+
+  }
+
+  if (ok == false) {
+    cout<<"Error in ActProductionLibrary::read. "<<fileName<<" is not valid"<<endl;
+    _isotopes.clear();
+    return false;
+  }
+
+  return true;
+
+}
+
+bool ActProductionLibrary::isCurrent(const char* decayDataFile, const char* listOfDataTables,
+				     double minDataXSec, std::string& reason) const {
+
+  reason = "";
+
+  std::string dataTables(listOfDataTables != 0 ? listOfDataTables : "");
+  if (dataTables.compare("0") == 0) {dataTables = "";}
+
+  if (_modelVersion != ActModelVersion::ModelVersion) {
+    reason = "the model version has changed (library " + std::to_string(_modelVersion) +
+      ", current " + std::to_string(ActModelVersion::ModelVersion) + ")";
+    return false;
+  }
+
+  unsigned long long decayDataHash = ActModelVersion::calcFileHash(decayDataFile);
+  if (decayDataHash == 0) {
+    reason = std::string("can not read the decay data file ") + decayDataFile;
+    return false;
+  }
+  if (decayDataHash != _decayDataHash) {
+    reason = std::string("the decay data file ") + decayDataFile + " has changed";
+    return false;
+  }
+  if (ActModelVersion::calcDataTablesHash(dataTables) != _dataTablesHash ||
+      minDataXSec != _minDataXSec) {
+    reason = "the data tables or the minimum data cross-section are different";
+    return false;
+  }
+
+  ActProdNuclideList prodList;
+  prodList.setVerbose(false);
+  prodList.storeTable(decayDataFile);
+  ActXSecEngine engine(&prodList, dataTables.c_str(), minDataXSec, false);
+
+  unsigned long long modelHash = ActModelVersion::calcModelHash(&engine);
+  if (modelHash != _modelHash) {
+    reason = "the models have changed (library " + ActModelVersion::toString(_modelHash) +
+      ", current " + ActModelVersion::toString(modelHash) + ")";
+    return false;
+  }
+
+  return true;
+
+}
+
+bool ActProductionLibrary::addTarget(int Z, const std::vector<double>& massNumbers,
+				     const std::vector<double>& fractions, int spectrum,
+				     double weight, bool allProducts,
+				     std::map<std::pair<int, double>, ActXSecEngine::Product>& totals,
+				     std::string& error) const {
+
+  if (spectrum < 0 || spectrum >= ActProductionLibrary::NSpectra) {
+    error = "unknown spectrum"; return false;
+  }
+
+  // Find the isotopes first, using the natural abundances if none are given
+  std::vector<const Isotope*> isotopes;
+  std::vector<double> isotopeFractions;
+  int i;
+  if (massNumbers.size() == 0) {
+    std::map<std::pair<int, double>, Isotope>::const_iterator iter =
+      _isotopes.lower_bound(std::make_pair(Z, 0.0));
+    for (; iter != _isotopes.end() && iter->first.first == Z; ++iter) {
+      isotopes.push_back(&(iter->second));
+      isotopeFractions.push_back(iter->second.fraction);
+    }
+    if (isotopes.size() == 0) {
+      error = "element Z = " + std::to_string(Z) + " is not in the library"; return false;
+    }
+  } else {
+    for (i = 0; i < (int) massNumbers.size(); i++) {
+      const Isotope* isotope = this->getIsotope(Z, massNumbers[i]);
+      if (isotope == 0) {
+	ActNumberFormat format(ActNumberFormat::Shortest);
+	error = "isotope Z = " + std::to_string(Z) + ", A = " + format.toString(massNumbers[i]) +
+	  " is not in the library";
+	return false;
+      }
+      isotopes.push_back(isotope);
+      isotopeFractions.push_back(fractions[i]);
+    }
+  }
+
+  for (i = 0; i < (int) isotopes.size(); i++) {
+
+    const std::vector<Entry>& entries = isotopes[i]->entries;
+    double fraction = isotopeFractions[i];
+
+    if (allProducts == true) {
+
+      int j;
+      for (j = 0; j < (int) entries.size(); j++) {
+	const Entry& entry = entries[j];
+	ActXSecEngine::Product& product = totals[std::make_pair(entry.z, entry.a)];
+	product.z = entry.z; product.a = entry.a; product.halfLife = entry.halfLife;
+	product.sigma += entry.sigma*fraction*weight;
+	product.prodRate += entry.prodRates[spectrum]*fraction*weight;
+      }
+
+    } else {
+
+      std::map<std::pair<int, double>, ActXSecEngine::Product>::iterator iter;
+      for (iter = totals.begin(); iter != totals.end(); ++iter) {
+	Entry key;
+	key.z = iter->first.first; key.a = iter->first.second;
+	std::vector<Entry>::const_iterator found =
+	  std::lower_bound(entries.begin(), entries.end(), key, actLessEntry);
+	if (found == entries.end() || found->z != key.z || found->a != key.a) {continue;}
+	ActXSecEngine::Product& product = iter->second;
+	product.halfLife = found->halfLife;
+	product.sigma += found->sigma*fraction*weight;
+	product.prodRate += found->prodRates[spectrum]*fraction*weight;
+      }
+
+    }
+
+  }
+
+  return true;
+
+}
+
+void ActProductionLibrary::serveStream(std::istream& input, std::ostream& output) const {
+
+  std::string line("");
+  while (std::getline(input, line)) {
+    if (line.find_first_not_of(" \t\r") == std::string::npos) {continue;}
+    output << this->answer(line) << '\n';
+    output.flush();
+  }
+
+}
+
+std::string ActProductionLibrary::answer(const std::string& request) const {
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  ActJSONValue value;
+  std::string error("");
+  std::string text("{\"id\":");
+
+  bool ok = value.parse(request, error);
+
+  // Give the answer the same id as the request
+  ActNumberFormat format(ActNumberFormat::Shortest);
+  const ActJSONValue* id = value.get("id");
+  if (id != 0 && id->isNumber()) {
+    format.append(text, id->getNumber());
+  } else if (id != 0 && id->isString()) {
+    ActJSONValue::appendString(text, id->getString());
+  } else {
+    text += "null";
+  }
+
+  if (ok == true && value.isObject() == false) {
+    ok = false; error = "the request must be an object";
+  }
+
+  if (ok == true) {
+
+    std::string command = value.getString("command", "production");
+
+    if (command.compare("ping") == 0) {
+      text += ",\"result\":\"pong\"";
+    } else if (command.compare("info") == 0) {
+      text += ",\"result\":{\"isotopes\":"; format.append(text, this->getNIsotopes());
+      text += ",\"entries\":"; format.append(text, this->getNEntries());
+      text += ",\"EStart\":"; format.append(text, _EStart);
+      text += ",\"EEnd\":"; format.append(text, _EEnd);
+      text += ",\"dE\":"; format.append(text, _dE);
+      text += ",\"modelVersion\":"; format.append(text, (int) _modelVersion);
+      text += ",\"modelHash\":";
+      ActJSONValue::appendString(text, ActModelVersion::toString(_modelHash));
+      text += '}';
+    } else if (command.compare("production") == 0) {
+      ok = this->answerProduction(value, text, error);
+    } else {
+      ok = false; error = "unknown command " + command;
+    }
+
+  }
+
+  if (ok == false) {
+    text += ",\"error\":";
+    ActJSONValue::appendString(text, error);
+  } else {
+    std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+    text += ",\"time\":";
+    format.append(text, time.count());
+  }
+
+  text += '}';
+  return text;
+
+}
+
+bool ActProductionLibrary::answerProduction(const ActJSONValue& request, std::string& answer,
+					    std::string& error) const {
+
+  ActNumberFormat format(ActNumberFormat::Shortest);
+
+  // The spectrum: its type, and the energies, which must be those of the library
+  int spectrum(ActProductionLibrary::Cosmic);
+  const ActJSONValue* spectrumValue = request.get("spectrum");
+  if (spectrumValue != 0) {
+
+    std::string type("cosmic");
+    if (spectrumValue->isString()) {
+      type = spectrumValue->getString();
+    } else if (spectrumValue->isObject()) {
+      type = spectrumValue->getString("type", "cosmic");
+      double EStart = spectrumValue->getNumber("EStart", _EStart);
+      double EEnd = spectrumValue->getNumber("EEnd", _EEnd);
+      double dE = spectrumValue->getNumber("dE", _dE);
+      if (EStart != _EStart || EEnd != _EEnd || dE != _dE) {
+	error = "the library only has the energies " + format.toString(_EStart) + " to " +
+	  format.toString(_EEnd) + " MeV in steps of " + format.toString(_dE);
+	return false;
+      }
+    }
+
+    if (type.compare("gordon") == 0) {
+      spectrum = ActProductionLibrary::Gordon;
+    } else if (type.compare("cosmic") != 0) {
+      error = "unknown spectrum type " + type; return false;
+    }
+
+  }
+
+  // The products, each given as [Z, A] or {"Z": Z, "A": A}; all products if there are none
+  std::map<std::pair<int, double>, ActXSecEngine::Product> totals;
+  std::vector<std::pair<int, double> > order;
+  const ActJSONValue* productArray = request.get("products");
+  int i;
+  if (productArray != 0 && productArray->isArray()) {
+
+    for (i = 0; i < productArray->size(); i++) {
+
+      const ActJSONValue* entry = productArray->at(i);
+      int z(0);
+      double a(0.0);
+      if (entry->isArray() && entry->size() == 2 &&
+	  entry->at(0)->isNumber() && entry->at(1)->isNumber()) {
+	z = (int) entry->at(0)->getNumber(); a = entry->at(1)->getNumber();
+      } else if (entry->isObject()) {
+	z = (int) entry->getNumber("Z", 0.0); a = entry->getNumber("A", 0.0);
+      }
+
+      if (z < 1 || a < z) {
+	error = "invalid product " + std::to_string(i); return false;
+      }
+      ActXSecEngine::Product& product = totals[std::make_pair(z, a)];
+      product.z = z; product.a = a;
+      product.sigma = 0.0; product.prodRate = 0.0; product.halfLife = 0.0;
+      order.push_back(std::make_pair(z, a));
+
+    }
+
+  }
+
+  // The target: an element Z with optional isotopes, each given as [A, fraction]
+  // or {"A": A, "fraction": f}, or a material with the mass fractions of
+  // natural elements, given as [Z, fraction] or {"Z": Z, "fraction": f}
+  const ActJSONValue* target = request.get("target");
+  if (target == 0 || target->isObject() == false) {
+    error = "the request needs a target object"; return false;
+  }
+
+  const ActJSONValue* elements = target->get("elements");
+  if (elements != 0) {
+
+    if (elements->isArray() == false || elements->size() < 1) {
+      error = "the target elements must be an array"; return false;
+    }
+
+    std::vector<double> noIsotopes;
+    for (i = 0; i < elements->size(); i++) {
+
+      const ActJSONValue* element = elements->at(i);
+      int Z(0);
+      double massFraction(-1.0);
+      if (element->isArray() && element->size() == 2 &&
+	  element->at(0)->isNumber() && element->at(1)->isNumber()) {
+	Z = (int) element->at(0)->getNumber(); massFraction = element->at(1)->getNumber();
+      } else if (element->isObject()) {
+	Z = (int) element->getNumber("Z", 0.0); massFraction = element->getNumber("fraction", -1.0);
+      }
+
+      if (Z < 1 || massFraction < 0.0 || massFraction > 1.0) {
+	error = "invalid target element " + std::to_string(i); return false;
+      }
+      if (this->addTarget(Z, noIsotopes, noIsotopes, spectrum, massFraction,
+			  order.size() == 0, totals, error) == false) {return false;}
+
+    }
+
+  } else {
+
+    int Z = (int) target->getNumber("Z", 0.0);
+    if (Z < 1) {error = "the target needs a positive Z"; return false;}
+
+    std::vector<double> massNumbers, fractions;
+    const ActJSONValue* isotopes = target->get("isotopes");
+    if (isotopes != 0) {
+
+      if (isotopes->isArray() == false || isotopes->size() < 1) {
+	error = "the target isotopes must be an array"; return false;
+      }
+
+      for (i = 0; i < isotopes->size(); i++) {
+
+	const ActJSONValue* isotope = isotopes->at(i);
+	double A(0.0), fraction(-1.0);
+	if (isotope->isArray() && isotope->size() == 2 &&
+	    isotope->at(0)->isNumber() && isotope->at(1)->isNumber()) {
+	  A = isotope->at(0)->getNumber(); fraction = isotope->at(1)->getNumber();
+	} else if (isotope->isObject()) {
+	  A = isotope->getNumber("A", 0.0); fraction = isotope->getNumber("fraction", -1.0);
+	}
+
+	if (A < Z || fraction < 0.0 || fraction > 1.0) {
+	  error = "invalid target isotope " + std::to_string(i); return false;
+	}
+	massNumbers.push_back(A); fractions.push_back(fraction);
+
+      }
+
+    }
+
+    if (this->addTarget(Z, massNumbers, fractions, spectrum, 1.0,
+			order.size() == 0, totals, error) == false) {return false;}
+
+  }
+
+  // Give the requested products in their order, otherwise in order of Z and A
+  if (order.size() == 0) {
+    std::map<std::pair<int, double>, ActXSecEngine::Product>::iterator iter;
+    for (iter = totals.begin(); iter != totals.end(); ++iter) {order.push_back(iter->first);}
+  }
+
+  answer += ",\"results\":[";
+  for (i = 0; i < (int) order.size(); i++) {
+
+    const ActXSecEngine::Product& product = totals[order[i]];
+    if (i > 0) {answer += ',';}
+    answer += "{\"Z\":"; format.append(answer, product.z);
+    answer += ",\"A\":"; format.append(answer, product.a);
+    answer += ",\"halfLife\":"; format.append(answer, product.halfLife);
+    answer += ",\"sigma\":"; format.append(answer, product.sigma);
+    answer += ",\"prodRate\":"; format.append(answer, product.prodRate);
+    answer += '}';
+
+  }
+  answer += ']';
+
+  return true;
+
+}
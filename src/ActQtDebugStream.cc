@@ -2,6 +2,8 @@
 
 #include "Activia/ActQtDebugStream.hh"
 
+#include "QtCore/qmetaobject.h"
+
 ActQtDebugStream::ActQtDebugStream(std::ostream &stream, QTextEdit* text_edit) : m_stream(stream)
 {
   log_window = text_edit;
@@ -13,17 +15,27 @@ ActQtDebugStream::~ActQtDebugStream()
 {
   // output anything that is left
   if (!m_string.empty()) {
-    log_window->append(m_string.c_str());
+    this->appendLine(m_string);
   }
 
   m_stream.rdbuf(m_old_buf);
 
 }
 
+void ActQtDebugStream::appendLine(const std::string& line) {
+
+  // Calls the slot directly in the GUI thread, otherwise queues the call
+  QMetaObject::invokeMethod(log_window, "append", Qt::AutoConnection,
+			    Q_ARG(QString, QString::fromLocal8Bit(line.c_str())));
+
+}
+
 std::streambuf::int_type ActQtDebugStream::overflow(std::streambuf::int_type v) {
 
+  std::lock_guard<std::mutex> lock(m_mutex);
+
   if (v == '\n') {
-    log_window->append(m_string.c_str());
+    this->appendLine(m_string);
     m_string.erase(m_string.begin(), m_string.end());
   } else {
     m_string += v;
@@ -34,6 +46,8 @@ std::streambuf::int_type ActQtDebugStream::overflow(std::streambuf::int_type v)
 
 std::streamsize ActQtDebugStream::xsputn(const char *p, std::streamsize n) {
 
+  std::lock_guard<std::mutex> lock(m_mutex);
+
   m_string.append(p, p + n);
 
   std::string::size_type pos = 0;
@@ -43,7 +57,7 @@ std::streamsize ActQtDebugStream::xsputn(const char *p, std::streamsize n) {
 
     if (pos != std::string::npos) {
       std::string tmp(m_string.begin(), m_string.begin() + pos);
-      log_window->append(tmp.c_str());
+      this->appendLine(tmp);
       m_string.erase(m_string.begin(), m_string.begin() + pos + 1);
     }
   }
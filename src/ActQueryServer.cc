@@ -0,0 +1,537 @@
+// Class for answering production requests, given as lines of JSON text,
+// in one long-running process
+
+#include "Activia/ActQueryServer.hh"
+#include "Activia/ActCosmicSpectrum.hh"
+#include "Activia/ActGordonSpectrum.hh"
+#include "Activia/ActJSONValue.hh"
+#include "Activia/ActNuclideFactory.hh"
+#include "Activia/ActNumberFormat.hh"
+#include "Activia/ActProdNuclideList.hh"
+#include "Activia/ActRunStatistics.hh"
+#include "Activia/ActTrace.hh"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+using std::cout;
+using std::endl;
+
+ActQueryServer::Connection::Connection(std::ostream* theStream, int theFd) :
+  stream(theStream), fd(theFd), mutex()
+{
+  // Constructor
+}
+
+ActQueryServer::Connection::~Connection()
+{
+  // Destructor. The socket is closed when all of its answers have been written
+  if (fd >= 0) {close(fd);}
+}
+
+void ActQueryServer::Connection::writeLine(const std::string& line) {
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  if (stream != 0) {
+    *stream << line << '\n';
+    stream->flush();
+    return;
+  }
+
+  std::string text(line); text += '\n';
+  size_t written(0);
+  while (written < text.size()) {
+    // Do not raise SIGPIPE if the client has gone away
+    ssize_t n = send(fd, text.c_str() + written, text.size() - written, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) {continue;}
+    if (n <= 0) {break;}
+    written += (size_t) n;
+  }
+
+}
+
+ActQueryServer::ActQueryServer(const char* decayDataFile, const char* listOfDataTables,
+			       double minDataXSec, int nThreads) :
+  _prodList(new ActProdNuclideList()),
+  _engines(),
+  _workers(),
+  _queueMutex(),
+  _queueCondition(),
+  _jobs(),
+  _finished(false),
+  _cache(),
+  _cacheMutex(),
+  _maxCacheSize(100000),
+  _listenFd(-1),
+  _connections(),
+  _connectionMutex(),
+  _stopping(false)
+{
+  // Constructor
+
+  // Create the singletons before any threads use them
+  ActRunStatistics::getInstance();
+  ActNuclideFactory::getInstance();
+  ActTrace::getInstance();
+
+  _prodList->storeTable(decayDataFile);
+
+  if (nThreads < 1) {nThreads = (int) std::thread::hardware_concurrency();}
+  if (nThreads < 1) {nThreads = 1;}
+
+  int i;
+  for (i = 0; i < nThreads; i++) {
+    _engines.push_back(new ActXSecEngine(_prodList, listOfDataTables, minDataXSec));
+  }
+
+}
+
+ActQueryServer::~ActQueryServer()
+{
+  // Destructor
+  this->stopWorkers();
+
+  int i;
+  for (i = 0; i < (int) _engines.size(); i++) {
+    delete _engines[i];
+  }
+  _engines.clear();
+
+  delete _prodList;
+}
+
+void ActQueryServer::startWorkers() {
+
+  std::lock_guard<std::mutex> lock(_queueMutex);
+  if (_workers.size() > 0) {return;}
+
+  _finished = false;
+  int i;
+  for (i = 0; i < (int) _engines.size(); i++) {
+    _workers.push_back(std::thread(&ActQueryServer::work, this, _engines[i]));
+  }
+
+}
+
+void ActQueryServer::stopWorkers() {
+
+  {
+    std::lock_guard<std::mutex> lock(_queueMutex);
+    _finished = true;
+  }
+  _queueCondition.notify_all();
+
+  int i;
+  for (i = 0; i < (int) _workers.size(); i++) {
+    if (_workers[i].joinable()) {_workers[i].join();}
+  }
+  _workers.clear();
+
+}
+
+void ActQueryServer::addJob(const std::string& request, std::shared_ptr<Connection> connection) {
+
+  {
+    std::lock_guard<std::mutex> lock(_queueMutex);
+    Job job;
+    job.request = request;
+    job.connection = connection;
+    _jobs.push_back(job);
+  }
+  _queueCondition.notify_one();
+
+}
+
+void ActQueryServer::work(ActXSecEngine* engine) {
+
+  for (;;) {
+
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(_queueMutex);
+      _queueCondition.wait(lock, [this] {return _finished || _jobs.size() > 0;});
+      // Answer all remaining requests before stopping
+      if (_jobs.size() == 0) {return;}
+      job = _jobs.front();
+      _jobs.pop_front();
+    }
+
+    job.connection->writeLine(this->answer(job.request, engine));
+
+  }
+
+}
+
+void ActQueryServer::serveStream(std::istream& input, std::ostream& output) {
+
+  std::shared_ptr<Connection> connection(new Connection(&output, -1));
+
+  this->startWorkers();
+
+  std::string line("");
+  while (_stopping == false && std::getline(input, line)) {
+    if (line.find_first_not_of(" \t\r") == std::string::npos) {continue;}
+    this->addJob(line, connection);
+  }
+
+  this->stopWorkers();
+
+}
+
+bool ActQueryServer::serveSocket(const std::string& path) {
+
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+
+  if (path.size() == 0 || path.size() >= sizeof(address.sun_path)) {
+    cout<<"Error in ActQueryServer::serveSocket. Invalid socket path "<<path<<endl;
+    return false;
+  }
+  strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+  _listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (_listenFd < 0) {
+    cout<<"Error in ActQueryServer::serveSocket. Could not create a socket"<<endl;
+    return false;
+  }
+
+  // Remove the socket left by a previous server
+  unlink(path.c_str());
+
+  if (bind(_listenFd, (struct sockaddr*) &address, sizeof(address)) != 0 ||
+      listen(_listenFd, 16) != 0) {
+    cout<<"Error in ActQueryServer::serveSocket. Could not listen on "<<path
+	<<": "<<strerror(errno)<<endl;
+    close(_listenFd); _listenFd = -1;
+    return false;
+  }
+
+  this->startWorkers();
+
+  std::vector<std::thread> readers;
+
+  while (_stopping == false) {
+
+    int fd = accept(_listenFd, 0, 0);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) {continue;}
+      // The listening socket is shut down by stop()
+      break;
+    }
+
+    std::lock_guard<std::mutex> lock(_connectionMutex);
+    if (_stopping) {close(fd); break;}
+    _connections.insert(fd);
+    readers.push_back(std::thread(&ActQueryServer::readConnection, this, fd));
+
+  }
+
+  // Stop reading from the open connections; their queued requests are still answered
+  {
+    std::lock_guard<std::mutex> lock(_connectionMutex);
+    std::set<int>::iterator iter;
+    for (iter = _connections.begin(); iter != _connections.end(); ++iter) {
+      shutdown(*iter, SHUT_RD);
+    }
+  }
+
+  int i;
+  for (i = 0; i < (int) readers.size(); i++) {
+    readers[i].join();
+  }
+
+  this->stopWorkers();
+
+  close(_listenFd); _listenFd = -1;
+  unlink(path.c_str());
+
+  return true;
+
+}
+
+void ActQueryServer::readConnection(int fd) {
+
+  // The connection closes the socket once the reader and all answers are done with it
+  std::shared_ptr<Connection> connection(new Connection(0, fd));
+
+  std::string buffer("");
+  char data[4096];
+
+  for (;;) {
+
+    ssize_t n = read(fd, data, sizeof(data));
+    if (n < 0 && errno == EINTR) {continue;}
+    if (n <= 0) {break;}
+
+    buffer.append(data, (size_t) n);
+
+    size_t start(0), end(0);
+    while ((end = buffer.find('\n', start)) != std::string::npos) {
+      std::string line = buffer.substr(start, end - start);
+      if (line.find_first_not_of(" \t\r") != std::string::npos) {
+	this->addJob(line, connection);
+      }
+      start = end + 1;
+    }
+    buffer.erase(0, start);
+
+  }
+
+  // A last request without a new line
+  if (buffer.find_first_not_of(" \t\r") != std::string::npos) {
+    this->addJob(buffer, connection);
+  }
+
+  std::lock_guard<std::mutex> lock(_connectionMutex);
+  _connections.erase(fd);
+
+}
+
+void ActQueryServer::stop() {
+
+  std::lock_guard<std::mutex> lock(_connectionMutex);
+  _stopping = true;
+  // Wake up accept() in serveSocket
+  if (_listenFd >= 0) {shutdown(_listenFd, SHUT_RDWR);}
+
+}
+
+std::string ActQueryServer::answer(const std::string& request, ActXSecEngine* engine) {
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  ActJSONValue value;
+  std::string error("");
+  std::string text("{\"id\":");
+
+  bool ok = value.parse(request, error);
+
+  // Give the answer the same id as the request
+  ActNumberFormat format(ActNumberFormat::Shortest);
+  const ActJSONValue* id = value.get("id");
+  if (id != 0 && id->isNumber()) {
+    format.append(text, id->getNumber());
+  } else if (id != 0 && id->isString()) {
+    ActJSONValue::appendString(text, id->getString());
+  } else {
+    text += "null";
+  }
+
+  if (ok == true && value.isObject() == false) {
+    ok = false; error = "the request must be an object";
+  }
+
+  if (ok == true) {
+
+    std::string command = value.getString("command", "production");
+
+    if (command.compare("ping") == 0) {
+      text += ",\"result\":\"pong\"";
+    } else if (command.compare("shutdown") == 0) {
+      text += ",\"result\":\"stopping\"";
+      this->stop();
+    } else if (command.compare("production") == 0) {
+      ok = this->answerProduction(value, engine, text, error);
+    } else {
+      ok = false; error = "unknown command " + command;
+    }
+
+  }
+
+  if (ok == false) {
+    text += ",\"error\":";
+    ActJSONValue::appendString(text, error);
+  } else {
+    std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+    text += ",\"time\":";
+    format.append(text, time.count());
+  }
+
+  text += '}';
+  return text;
+
+}
+
+bool ActQueryServer::answerProduction(const ActJSONValue& request, ActXSecEngine* engine,
+				      std::string& answer, std::string& error) {
+
+  ActNumberFormat format(ActNumberFormat::Shortest);
+
+  // The target: Z and the isotopes, each given as [A, fraction] or {"A": A, "fraction": f}
+  const ActJSONValue* target = request.get("target");
+  if (target == 0 || target->isObject() == false) {
+    error = "the request needs a target object"; return false;
+  }
+
+  int Z = (int) target->getNumber("Z", 0.0);
+  if (Z < 1) {error = "the target needs a positive Z"; return false;}
+
+  const ActJSONValue* isotopes = target->get("isotopes");
+  if (isotopes == 0 || isotopes->isArray() == false || isotopes->size() < 1) {
+    error = "the target needs an array of isotopes"; return false;
+  }
+
+  std::vector<double> massNumbers, fractions;
+  int i;
+  for (i = 0; i < isotopes->size(); i++) {
+
+    const ActJSONValue* isotope = isotopes->at(i);
+    double A(0.0), fraction(-1.0);
+    if (isotope->isArray() && isotope->size() == 2 &&
+	isotope->at(0)->isNumber() && isotope->at(1)->isNumber()) {
+      A = isotope->at(0)->getNumber(); fraction = isotope->at(1)->getNumber();
+    } else if (isotope->isObject()) {
+      A = isotope->getNumber("A", 0.0); fraction = isotope->getNumber("fraction", -1.0);
+    }
+
+    if (A < Z || fraction < 0.0 || fraction > 1.0) {
+      error = "invalid target isotope " + std::to_string(i); return false;
+    }
+    massNumbers.push_back(A); fractions.push_back(fraction);
+
+  }
+
+  // The spectrum
+  const ActJSONValue* spectrum = request.get("spectrum");
+  if (spectrum == 0 || spectrum->isObject() == false) {
+    error = "the request needs a spectrum object"; return false;
+  }
+
+  std::string type = spectrum->getString("type", "cosmic");
+  double EStart = spectrum->getNumber("EStart", -1.0);
+  double EEnd = spectrum->getNumber("EEnd", -1.0);
+  double dE = spectrum->getNumber("dE", -1.0);
+
+  if (type.compare("cosmic") != 0 && type.compare("gordon") != 0) {
+    error = "unknown spectrum type " + type; return false;
+  }
+  if (EStart <= 0.0 || EEnd <= EStart || dE <= 0.0) {
+    error = "the spectrum needs 0 < EStart < EEnd and dE > 0"; return false;
+  }
+  if ((EEnd - EStart)/dE > 1.0e7) {
+    error = "the spectrum has too many energy bins"; return false;
+  }
+
+  // The products: each given as [Z, A] or {"Z": Z, "A": A}
+  const ActJSONValue* productArray = request.get("products");
+  if (productArray == 0 || productArray->isArray() == false || productArray->size() < 1) {
+    error = "the request needs an array of products"; return false;
+  }
+
+  std::vector<ActXSecEngine::Product> products;
+  for (i = 0; i < productArray->size(); i++) {
+
+    const ActJSONValue* entry = productArray->at(i);
+    ActXSecEngine::Product product;
+    product.z = 0; product.a = 0.0;
+    product.sigma = 0.0; product.prodRate = 0.0; product.halfLife = 0.0;
+
+    if (entry->isArray() && entry->size() == 2 &&
+	entry->at(0)->isNumber() && entry->at(1)->isNumber()) {
+      product.z = (int) entry->at(0)->getNumber(); product.a = entry->at(1)->getNumber();
+    } else if (entry->isObject()) {
+      product.z = (int) entry->getNumber("Z", 0.0); product.a = entry->getNumber("A", 0.0);
+    }
+
+    if (product.z < 1 || product.a < product.z) {
+      error = "invalid product " + std::to_string(i); return false;
+    }
+    products.push_back(product);
+
+  }
+
+  // Describe the question, without the products, for the cache keys
+  std::string question("");
+  format.append(question, Z);
+  for (i = 0; i < (int) massNumbers.size(); i++) {
+    question += ' '; format.append(question, massNumbers[i]);
+    question += ':'; format.append(question, fractions[i]);
+  }
+  question += ' '; question += type;
+  question += ' '; format.append(question, EStart);
+  question += ' '; format.append(question, EEnd);
+  question += ' '; format.append(question, dE);
+
+  int nProducts = (int) products.size();
+  std::vector<std::string> keys(nProducts);
+  std::vector<bool> found(nProducts, false);
+  int nCached(0);
+
+  {
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    for (i = 0; i < nProducts; i++) {
+      keys[i] = question; keys[i] += " -> ";
+      format.append(keys[i], products[i].z);
+      keys[i] += ' '; format.append(keys[i], products[i].a);
+      std::map<std::string, ActXSecEngine::Product>::iterator iter = _cache.find(keys[i]);
+      if (iter != _cache.end()) {
+	products[i] = iter->second;
+	found[i] = true; nCached++;
+      }
+    }
+  }
+
+  // Calculate the products that have not been asked about before
+  if (nCached < nProducts) {
+
+    std::vector<ActXSecEngine::Product> missing;
+    for (i = 0; i < nProducts; i++) {
+      if (found[i] == false) {missing.push_back(products[i]);}
+    }
+
+    ActBeamSpectrum* beam(0);
+    if (type.compare("gordon") == 0) {
+      beam = new ActGordonSpectrum("GordonSpectrum", 1, 1.0);
+    } else {
+      beam = new ActCosmicSpectrum("CosmicRays", 1, 1.0);
+    }
+    beam->setEnergies(EStart, EEnd, dE);
+
+    ActTarget* theTarget = engine->getTarget(Z, massNumbers, fractions);
+    bool calculated = engine->calcProduction(theTarget, beam, missing);
+    delete beam;
+
+    if (calculated == false) {
+      error = "the production could not be calculated"; return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    if (_cache.size() + missing.size() > _maxCacheSize) {_cache.clear();}
+
+    int j(0);
+    for (i = 0; i < nProducts; i++) {
+      if (found[i] == true) {continue;}
+      products[i] = missing[j++];
+      _cache[keys[i]] = products[i];
+    }
+
+  }
+
+  answer += ",\"results\":[";
+  for (i = 0; i < nProducts; i++) {
+
+    const ActXSecEngine::Product& product = products[i];
+    if (i > 0) {answer += ',';}
+    answer += "{\"Z\":"; format.append(answer, product.z);
+    answer += ",\"A\":"; format.append(answer, product.a);
+    answer += ",\"halfLife\":"; format.append(answer, product.halfLife);
+    answer += ",\"sigma\":"; format.append(answer, product.sigma);
+    answer += ",\"prodRate\":"; format.append(answer, product.prodRate);
+    answer += '}';
+
+  }
+  answer += "],\"cached\":";
+  format.append(answer, nCached);
+
+  return true;
+
+}
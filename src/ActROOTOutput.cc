@@ -2,6 +2,7 @@
 #ifdef ACT_USE_ROOT
 
 #include "Activia/ActROOTOutput.hh"
+#include "Activia/ActTrace.hh"
 #include "Activia/ActGraphPoint.hh"
 #include "Activia/ActOutputSelection.hh"
 
@@ -16,6 +17,7 @@ ActROOTOutput::ActROOTOutput(const char* fileName, int levelOfDetail) : ActAbsOu
   _typeName = "ROOT";
   _theFile = 0; _theTrees.clear(); 
   _currentTree = 0; _nTrees = 0;
+  _tableTree = 0; _tableValues.clear();
 }
 
 ActROOTOutput::~ActROOTOutput() 
@@ -74,6 +76,22 @@ void ActROOTOutput::outputLineOfText(std::vector<ActString>& strings) {
 
 void ActROOTOutput::outputTable(ActOutputTable& table) {
 
+  ACT_TRACE_SCOPE("ActROOTOutput::outputTable", "output");
+
+  this->beginTable(table);
+
+  int nRows = table.getNRows();
+  int iRow;
+  for (iRow = 0; iRow < nRows; iRow++) {
+    this->outputTableRow(table, table.getRowData(iRow));
+  }
+
+  this->endTable(table);
+
+}
+
+void ActROOTOutput::beginTable(ActOutputTable& table) {
+
   // A table represents a single "ntuple", where each row
   // corresponds to a new "event". Columns represent the
   // different variables in the table.
@@ -81,14 +99,16 @@ void ActROOTOutput::outputTable(ActOutputTable& table) {
   std::string ntupleName = table.getName();
   cout<<"Creating ROOT ntuple "<<ntupleName.c_str()<<endl;
 
-  TTree* theTree = new TTree(ntupleName.c_str(), ntupleName.c_str());
+  _tableTree = new TTree(ntupleName.c_str(), ntupleName.c_str());
   // Let the tree be written to disk as it is filled.
-  theTree->SetDirectory(_theFile);
+  _tableTree->SetDirectory(_theFile);
 
   int nColumns = table.getNColumns();
   std::vector<ActString> columnNames = table.getColumnNames();
 
-  std::vector<double> varValues(nColumns);
+  // The branch addresses point to this vector, so it must not be resized
+  // until the table is finished
+  _tableValues.assign(nColumns, 0.0);
 
   // Set the branch information
   int iCol;
@@ -99,38 +119,41 @@ void ActROOTOutput::outputTable(ActOutputTable& table) {
     std::string varAndType = varName;
     varAndType += "/D"; // always doubles in the table
 
-    varValues[iCol] = 0.0; // initialise the value
-    theTree->Branch(varName.c_str(), &varValues[iCol], varAndType.c_str());
+    _tableTree->Branch(varName.c_str(), &_tableValues[iCol], varAndType.c_str());
 
   }
 
-  std::vector< std::vector <double> > rows = table.getRows();
-  int nRows = (int) rows.size();
-  int iRow;
-  for (iRow = 0; iRow < nRows; iRow++) {
+}
 
-    std::vector<double> row = rows[iRow];
+void ActROOTOutput::outputTableRow(ActOutputTable& table, const double* values) {
 
-    int nCol = (int) row.size();
-    if (nCol != nColumns) {
-      cout << "Error in outputTable. Row " << iRow << " has " << nCol 
-	   << " columns which should be " << nColumns << endl;
-      continue;
-    }
+  if (_tableTree == 0 || values == 0) {return;}
+
+  int nColumns = table.getNColumns();
+  if (nColumns != (int) _tableValues.size()) {
+    cout << "Error in ActROOTOutput::outputTableRow. Row has " << nColumns 
+	 << " columns which should be " << _tableValues.size() << endl;
+    return;
+  }
 
-    for (iCol = 0; iCol < nColumns; iCol++) {
+  int iCol;
+  for (iCol = 0; iCol < nColumns; iCol++) {
+    _tableValues[iCol] = values[iCol];
+  }
 
-      varValues[iCol] = row[iCol];
-    }
+  _tableTree->Fill();
 
-    theTree->Fill();
+}
 
-  } // Loop over rows
+void ActROOTOutput::endTable(ActOutputTable&) {
+
+  if (_tableTree == 0) {return;}
 
   // Store the TTree pointer in internal vector. These pointers should
   // all be attached to the file pointer, _theFile.
-  _theTrees.push_back(theTree);
+  _theTrees.push_back(_tableTree);
   _nTrees = (int) _theTrees.size();
+  _tableTree = 0;
 
 }
 
@@ -167,6 +190,8 @@ TTree* ActROOTOutput::findNtuple(TString& ntupleName) {
 void ActROOTOutput::outputGraph(ActNucleiData& data,
 				ActAbsGraph& graph) {
 
+  ACT_TRACE_SCOPE("ActROOTOutput::outputGraph", "output");
+
   // Write out the graph of values (e.g. sigma vs energy) 
   // for the given set of nuclei data (Z,A values). The graph is represented
   // by an array of values for the ntuple row defined by the Z and A values from
@@ -220,6 +245,16 @@ void ActROOTOutput::outputGraph(ActNucleiData& data,
     }
   }
 
+  // Grid description for sparse graphs: the lengths of the runs of bins
+  // that are alternately omitted and stored, starting with omitted bins
+  bool hasGrid = graph.hasGrid();
+  double gridStart = graph.getGridStart();
+  double gridStep = graph.getGridStep();
+  std::vector<int> runs = graph.getGridRuns();
+  int nGridRuns = (int) runs.size();
+  int gridRuns[nGridRuns+1];
+  for (iPoint = 0; iPoint < nGridRuns; iPoint++) {gridRuns[iPoint] = runs[iPoint];}
+
   if (theTree == 0) {
  
     // Create a new tree with the appropriate variables
@@ -251,6 +286,13 @@ void ActROOTOutput::outputGraph(ActNucleiData& data,
 
     }
 
+    if (hasGrid == true) {
+      theTree->Branch("gridStart", &gridStart, "gridStart/D");
+      theTree->Branch("gridStep", &gridStep, "gridStep/D");
+      theTree->Branch("nGridRuns", &nGridRuns, "nGridRuns/I");
+      theTree->Branch("gridRuns", gridRuns, "gridRuns[nGridRuns]/I");
+    }
+
   }
 
   // Set the branch addresses for the tree variables and fill in the data
@@ -269,6 +311,13 @@ void ActROOTOutput::outputGraph(ActNucleiData& data,
       theTree->SetBranchAddress(yAxesNames[iY].c_str(), yValues);
     }
 
+    if (hasGrid == true) {
+      theTree->SetBranchAddress("gridStart", &gridStart);
+      theTree->SetBranchAddress("gridStep", &gridStep);
+      theTree->SetBranchAddress("nGridRuns", &nGridRuns);
+      theTree->SetBranchAddress("gridRuns", gridRuns);
+    }
+
     // Fill in data
 
     theTree->Fill();
@@ -282,6 +331,8 @@ void ActROOTOutput::outputGraph(ActNucleiData& data,
 
 void ActROOTOutput::closeFile() {
 
+  ACT_TRACE_SCOPE("ActROOTOutput::closeFile", "output");
+
   _theFile->cd();
 
   cout<<"Writing ROOT output"<<endl;
@@ -0,0 +1,292 @@
+// Class for recording the timing of the calculation phases, the number of
+// cross-section evaluations and the cache hit rates, written out as a JSON report
+
+#include "Activia/ActRunStatistics.hh"
+#include "Activia/ActNumberFormat.hh"
+
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+
+using std::cout;
+using std::endl;
+
+ActRunStatistics::ActRunStatistics() : _reportFileName("")
+{
+  // Constructor
+  this->reset();
+}
+
+ActRunStatistics::~ActRunStatistics()
+{
+  // Destructor
+}
+
+ActRunStatistics* ActRunStatistics::getInstance() {
+
+  // The local static is only initialised once, even if several
+  // threads ask for the statistics at the same time
+  static ActRunStatistics* theStatistics = new ActRunStatistics();
+  return theStatistics;
+
+}
+
+void ActRunStatistics::reset() {
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  _phases.clear(); _phaseNames.clear();
+  _counters.clear();
+  _lookups.clear(); _lookupNames.clear();
+
+}
+
+double ActRunStatistics::wallClock() {
+
+  std::chrono::duration<double> now = std::chrono::steady_clock::now().time_since_epoch();
+  return now.count();
+
+}
+
+double ActRunStatistics::cpuClock() {
+
+  return ((double) std::clock())/CLOCKS_PER_SEC;
+
+}
+
+ActRunStatistics::Phase& ActRunStatistics::findPhase(const std::string& name) {
+
+  std::map<std::string, Phase>::iterator iter = _phases.find(name);
+  if (iter != _phases.end()) {return iter->second;}
+
+  Phase phase;
+  phase.nCalls = 0;
+  phase.wallTime = 0.0; phase.cpuTime = 0.0;
+  phase.wallStart = 0.0; phase.cpuStart = 0.0;
+  phase.depth = 0;
+
+  _phaseNames.push_back(name);
+  return _phases.insert(std::make_pair(name, phase)).first->second;
+
+}
+
+void ActRunStatistics::startPhase(const std::string& name) {
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  Phase& phase = this->findPhase(name);
+
+  // Only the outermost start of a nested phase is timed
+  if (phase.depth == 0) {
+    phase.wallStart = ActRunStatistics::wallClock();
+    phase.cpuStart = ActRunStatistics::cpuClock();
+  }
+  phase.depth += 1;
+
+}
+
+void ActRunStatistics::stopPhase(const std::string& name) {
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  std::map<std::string, Phase>::iterator iter = _phases.find(name);
+  if (iter == _phases.end() || iter->second.depth == 0) {
+    cout<<"Error in ActRunStatistics::stopPhase. The phase "<<name<<" has not been started"<<endl;
+    return;
+  }
+
+  Phase& phase = iter->second;
+  phase.depth -= 1;
+  if (phase.depth == 0) {
+    phase.wallTime += ActRunStatistics::wallClock() - phase.wallStart;
+    phase.cpuTime += ActRunStatistics::cpuClock() - phase.cpuStart;
+    phase.nCalls += 1;
+  }
+
+}
+
+void ActRunStatistics::addSigmaEvaluations(const std::string& model, unsigned long nEvaluations,
+					   double wallTime) {
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  std::map<std::string, Counter>::iterator iter = _counters.find(model);
+
+  if (iter == _counters.end()) {
+    Counter counter;
+    counter.nEvaluations = 0; counter.wallTime = 0.0;
+    iter = _counters.insert(std::make_pair(model, counter)).first;
+  }
+
+  iter->second.nEvaluations += nEvaluations;
+  iter->second.wallTime += wallTime;
+
+}
+
+void ActRunStatistics::addCacheLookups(const std::string& name, unsigned long nHits,
+				       unsigned long nMisses) {
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  std::map<std::string, Lookups>::iterator iter = _lookups.find(name);
+
+  if (iter == _lookups.end()) {
+    Lookups lookups;
+    lookups.nHits = 0; lookups.nMisses = 0;
+    iter = _lookups.insert(std::make_pair(name, lookups)).first;
+    _lookupNames.push_back(name);
+  }
+
+  iter->second.nHits += nHits;
+  iter->second.nMisses += nMisses;
+
+}
+
+double ActRunStatistics::getWallTime(const std::string& name) {
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  std::map<std::string, Phase>::iterator iter = _phases.find(name);
+  if (iter == _phases.end()) {return 0.0;}
+  return iter->second.wallTime;
+
+}
+
+double ActRunStatistics::getCPUTime(const std::string& name) {
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  std::map<std::string, Phase>::iterator iter = _phases.find(name);
+  if (iter == _phases.end()) {return 0.0;}
+  return iter->second.cpuTime;
+
+}
+
+unsigned long ActRunStatistics::getNSigmaEvaluations(const std::string& model) {
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  std::map<std::string, Counter>::iterator iter = _counters.find(model);
+  if (iter == _counters.end()) {return 0;}
+  return iter->second.nEvaluations;
+
+}
+
+unsigned long ActRunStatistics::getNCacheHits(const std::string& name) {
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  std::map<std::string, Lookups>::iterator iter = _lookups.find(name);
+  if (iter == _lookups.end()) {return 0;}
+  return iter->second.nHits;
+
+}
+
+void ActRunStatistics::writeString(std::ostream& stream, const std::string& text) {
+
+  stream << '"';
+  int n = (int) text.size();
+  int i;
+  for (i = 0; i < n; i++) {
+    char c = text[i];
+    if (c == '"' || c == '\\') {
+      stream << '\\' << c;
+    } else if ((unsigned char) c < 0x20) {
+      stream << ' ';
+    } else {
+      stream << c;
+    }
+  }
+  stream << '"';
+
+}
+
+void ActRunStatistics::writeReport(std::ostream& stream) {
+
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  // Numbers are written using the shortest exact representation
+  ActNumberFormat format(ActNumberFormat::Shortest);
+
+  stream << "{\n  \"phases\": [";
+
+  int nPhases = (int) _phaseNames.size();
+  int i;
+  for (i = 0; i < nPhases; i++) {
+
+    Phase& phase = _phases[_phaseNames[i]];
+    if (i > 0) {stream << ",";}
+    stream << "\n    {\"name\": ";
+    this->writeString(stream, _phaseNames[i]);
+    stream << ", \"calls\": " << phase.nCalls
+	   << ", \"wallTime\": " << format.toString(phase.wallTime)
+	   << ", \"cpuTime\": " << format.toString(phase.cpuTime) << "}";
+
+  }
+
+  stream << "\n  ],\n  \"sigmaEvaluations\": [";
+
+  unsigned long nTotal(0);
+  double totalTime(0.0);
+
+  std::map<std::string, Counter>::iterator iter;
+  for (iter = _counters.begin(); iter != _counters.end(); ++iter) {
+
+    Counter& counter = iter->second;
+    double rate(0.0);
+    if (counter.wallTime > 0.0) {rate = counter.nEvaluations/counter.wallTime;}
+
+    if (iter != _counters.begin()) {stream << ",";}
+    stream << "\n    {\"model\": ";
+    this->writeString(stream, iter->first);
+    stream << ", \"evaluations\": " << counter.nEvaluations
+	   << ", \"wallTime\": " << format.toString(counter.wallTime)
+	   << ", \"evaluationsPerSecond\": " << format.toString(rate) << "}";
+
+    nTotal += counter.nEvaluations;
+    totalTime += counter.wallTime;
+
+  }
+
+  double totalRate(0.0);
+  if (totalTime > 0.0) {totalRate = nTotal/totalTime;}
+
+  stream << "\n  ],\n  \"totalSigmaEvaluations\": " << nTotal
+	 << ",\n  \"evaluationsPerSecond\": " << format.toString(totalRate)
+	 << ",\n  \"cacheLookups\": [";
+
+  int nLookups = (int) _lookupNames.size();
+  for (i = 0; i < nLookups; i++) {
+
+    Lookups& lookups = _lookups[_lookupNames[i]];
+    unsigned long nCalls = lookups.nHits + lookups.nMisses;
+    double hitRate(0.0);
+    if (nCalls > 0) {hitRate = (1.0*lookups.nHits)/(1.0*nCalls);}
+
+    if (i > 0) {stream << ",";}
+    stream << "\n    {\"name\": ";
+    this->writeString(stream, _lookupNames[i]);
+    stream << ", \"hits\": " << lookups.nHits << ", \"misses\": " << lookups.nMisses
+	   << ", \"hitRate\": " << format.toString(hitRate) << "}";
+
+  }
+
+  stream << "\n  ]\n}\n";
+
+}
+
+void ActRunStatistics::finalise() {
+
+  // Stop any phases that are still running, e.g. after the calculation was stopped
+  int nPhases = (int) _phaseNames.size();
+  int i;
+  for (i = 0; i < nPhases; i++) {
+    while (_phases[_phaseNames[i]].depth > 0) {this->stopPhase(_phaseNames[i]);}
+  }
+
+  if (_reportFileName.size() == 0) {return;}
+
+  std::ofstream report(_reportFileName.c_str());
+  if (report.is_open() == false) {
+    cout<<"Error in ActRunStatistics::finalise. Could not open "<<_reportFileName<<endl;
+    return;
+  }
+
+  this->writeReport(report);
+  report.close();
+
+  cout<<"Written run statistics to "<<_reportFileName<<endl;
+
+}
@@ -0,0 +1,598 @@
+// Class providing array versions of the ActFormulae power and expfun
+// functions using AVX-512, AVX2 or scalar code, chosen at run time
+
+#include "Activia/ActSIMDMath.hh"
+#include "Activia/ActFormulae.hh"
+
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ACT_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+  // Scalar versions; these must be the same as ActFormulae::power and expfun
+  inline double scalarPower(double x, double n) {
+
+    if (std::fabs(x) < 1e-30 && n < 0.0) {return 0.0;}
+
+    double power = pow(x, n);
+    if (std::isnan(power) == 1) {
+      power = std::pow(std::fabs(x), n);
+      if (std::isnan(power) == 1) {power = 0.0;}
+    }
+
+    return power;
+
+  }
+
+  inline double scalarExpfun(double x) {
+
+    double expVal(0.0);
+    if (std::fabs(x) < 70.0) {expVal = exp(x);}
+    return expVal;
+
+  }
+
+  // The power kernels use a stride of 0 for a constant exponent
+  void powerScalar(const double* x, const double* n, int nStride,
+		   double* result, int nValues) {
+    int i;
+    for (i = 0; i < nValues; i++) {
+      result[i] = scalarPower(x[i], n[i*nStride]);
+    }
+  }
+
+  void expfunScalar(const double* x, double* result, int nValues) {
+    int i;
+    for (i = 0; i < nValues; i++) {
+      result[i] = scalarExpfun(x[i]);
+    }
+  }
+
+#ifdef ACT_SIMD_X86
+
+  // Constants for exp(x) = 2^k exp(r), with r = x - k ln2 and |r| < ln2/2.
+  // ln2 is split into high and low parts so that k*ln2Hi is exact.
+  const double log2e = 1.4426950408889634;
+  const double ln2Hi = 6.93147180369123816490e-01;
+  const double ln2Lo = 1.90821492927058770002e-10;
+  // Adding 1.5*2^52 rounds to the nearest integer
+  const double roundMagic = 6755399441055744.0;
+  const double sqrt2 = 1.41421356237309504880;
+
+  // Taylor series coefficients 1/n! for exp(r), n = 13 down to 2.
+  // The truncation error is below 1e-17 for |r| < ln2/2.
+  const double expCoeff[12] = {1.0/6227020800.0, 1.0/479001600.0, 1.0/39916800.0,
+			       1.0/3628800.0, 1.0/362880.0, 1.0/40320.0, 1.0/5040.0,
+			       1.0/720.0, 1.0/120.0, 1.0/24.0, 1.0/6.0, 0.5};
+
+  // Polynomial coefficients for log(1+f), from fdlibm e_log.c
+  const double Lg1 = 6.666666666666735130e-01;
+  const double Lg2 = 3.999999999940941908e-01;
+  const double Lg3 = 2.857142874366239149e-01;
+  const double Lg4 = 2.222219843214978396e-01;
+  const double Lg5 = 1.818357216161805012e-01;
+  const double Lg6 = 1.531383769920937332e-01;
+  const double Lg7 = 1.479819860511658591e-01;
+
+  // Largest |n log(x)| for which the vectorised exp does not overflow
+  const double maxExpArg = 700.0;
+
+  // AVX2 kernels (4 doubles)
+
+  __attribute__((target("avx2,fma")))
+  inline __m256d exp4(__m256d x) {
+
+    __m256d magic = _mm256_set1_pd(roundMagic);
+    __m256d kd = _mm256_fmadd_pd(x, _mm256_set1_pd(log2e), magic);
+    __m256i ki = _mm256_castpd_si256(kd);
+    kd = _mm256_sub_pd(kd, magic);
+
+    __m256d r = _mm256_fnmadd_pd(kd, _mm256_set1_pd(ln2Hi), x);
+    r = _mm256_fnmadd_pd(kd, _mm256_set1_pd(ln2Lo), r);
+
+    __m256d p = _mm256_set1_pd(expCoeff[0]);
+    int i;
+    for (i = 1; i < 12; i++) {
+      p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(expCoeff[i]));
+    }
+    __m256d one = _mm256_set1_pd(1.0);
+    p = _mm256_fmadd_pd(p, r, one);
+    p = _mm256_fmadd_pd(p, r, one);
+
+    // Multiply by 2^k by adding k to the exponent bits of 1.0
+    __m256i scale = _mm256_add_epi64(_mm256_slli_epi64(ki, 52), _mm256_castpd_si256(one));
+    return _mm256_mul_pd(p, _mm256_castsi256_pd(scale));
+
+  }
+
+  __attribute__((target("avx2,fma")))
+  inline __m256d log4(__m256d x) {
+
+    // Split x = m*2^e, with sqrt(2)/2 < m < sqrt(2). Valid for normal, positive x
+    __m256i bits = _mm256_castpd_si256(x);
+    __m256i expBits = _mm256_srli_epi64(bits, 52);
+    __m256i mantBits = _mm256_and_si256(bits, _mm256_set1_epi64x(0x000fffffffffffffLL));
+
+    __m256d one = _mm256_set1_pd(1.0);
+    __m256d m = _mm256_castsi256_pd(_mm256_or_si256(mantBits, _mm256_castpd_si256(one)));
+
+    // Convert the biased exponent to a double using 2^52 + e
+    __m256i twoTo52 = _mm256_set1_epi64x(0x4330000000000000LL);
+    __m256d e = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(expBits, twoTo52)),
+			      _mm256_set1_pd(4503599627370496.0 + 1023.0));
+
+    __m256d big = _mm256_cmp_pd(m, _mm256_set1_pd(sqrt2), _CMP_GT_OQ);
+    m = _mm256_blendv_pd(m, _mm256_mul_pd(m, _mm256_set1_pd(0.5)), big);
+    e = _mm256_add_pd(e, _mm256_and_pd(big, one));
+
+    __m256d f = _mm256_sub_pd(m, one);
+    __m256d s = _mm256_div_pd(f, _mm256_add_pd(_mm256_set1_pd(2.0), f));
+    __m256d z = _mm256_mul_pd(s, s);
+    __m256d w = _mm256_mul_pd(z, z);
+
+    __m256d t1 = _mm256_fmadd_pd(w, _mm256_set1_pd(Lg6), _mm256_set1_pd(Lg4));
+    t1 = _mm256_fmadd_pd(w, t1, _mm256_set1_pd(Lg2));
+    t1 = _mm256_mul_pd(w, t1);
+    __m256d t2 = _mm256_fmadd_pd(w, _mm256_set1_pd(Lg7), _mm256_set1_pd(Lg5));
+    t2 = _mm256_fmadd_pd(w, t2, _mm256_set1_pd(Lg3));
+    t2 = _mm256_fmadd_pd(w, t2, _mm256_set1_pd(Lg1));
+    t2 = _mm256_mul_pd(z, t2);
+    __m256d R = _mm256_add_pd(t1, t2);
+
+    __m256d hfsq = _mm256_mul_pd(_mm256_set1_pd(0.5), _mm256_mul_pd(f, f));
+
+    // log(x) = e*ln2Hi - ((hfsq - (s*(hfsq + R) + e*ln2Lo)) - f)
+    __m256d inner = _mm256_fmadd_pd(s, _mm256_add_pd(hfsq, R),
+				    _mm256_mul_pd(e, _mm256_set1_pd(ln2Lo)));
+    __m256d logm = _mm256_sub_pd(_mm256_sub_pd(hfsq, inner), f);
+    return _mm256_fmsub_pd(e, _mm256_set1_pd(ln2Hi), logm);
+
+  }
+
+  __attribute__((target("avx2,fma")))
+  inline void power4(const double* x, const double* n, int nStride, double* result) {
+
+    __m256d vx = _mm256_loadu_pd(x);
+    __m256d vn = (nStride == 0) ? _mm256_set1_pd(n[0]) : _mm256_loadu_pd(n);
+
+    __m256d y = _mm256_mul_pd(vn, log4(vx));
+    __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+    __m256d infinity = _mm256_set1_pd(HUGE_VAL);
+
+    // Lanes that need the NaN and zero checks of the scalar function
+    __m256d good = _mm256_cmp_pd(vx, _mm256_set1_pd(1e-30), _CMP_GE_OQ);
+    good = _mm256_and_pd(good, _mm256_cmp_pd(vx, infinity, _CMP_LT_OQ));
+    good = _mm256_and_pd(good, _mm256_cmp_pd(_mm256_and_pd(vn, absMask), infinity, _CMP_LT_OQ));
+    good = _mm256_and_pd(good, _mm256_cmp_pd(_mm256_and_pd(y, absMask),
+					     _mm256_set1_pd(maxExpArg), _CMP_LT_OQ));
+
+    _mm256_storeu_pd(result, exp4(y));
+
+    int goodBits = _mm256_movemask_pd(good);
+    if (goodBits != 0xf) {
+      int i;
+      for (i = 0; i < 4; i++) {
+	if (((goodBits >> i) & 1) == 0) {result[i] = scalarPower(x[i], n[i*nStride]);}
+      }
+    }
+
+  }
+
+  __attribute__((target("avx2,fma")))
+  inline void expfun4(const double* x, double* result) {
+
+    __m256d vx = _mm256_loadu_pd(x);
+    __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+    __m256d good = _mm256_cmp_pd(_mm256_and_pd(vx, absMask), _mm256_set1_pd(70.0), _CMP_LT_OQ);
+    _mm256_storeu_pd(result, _mm256_and_pd(exp4(vx), good));
+
+  }
+
+  __attribute__((target("avx2,fma")))
+  void powerAVX2(const double* x, const double* n, int nStride,
+		 double* result, int nValues) {
+
+    int i(0);
+    for (i = 0; i + 4 <= nValues; i += 4) {
+      power4(x + i, n + i*nStride, nStride, result + i);
+    }
+
+    // Use padded copies for the remaining values so that all results come from the same kernel
+    int nLeft = nValues - i;
+    if (nLeft > 0) {
+      double xTmp[4] = {1.0, 1.0, 1.0, 1.0}, nTmp[4] = {1.0, 1.0, 1.0, 1.0}, rTmp[4];
+      int j;
+      for (j = 0; j < nLeft; j++) {
+	xTmp[j] = x[i+j]; nTmp[j] = n[(i+j)*nStride];
+      }
+      power4(xTmp, nTmp, 1, rTmp);
+      for (j = 0; j < nLeft; j++) {result[i+j] = rTmp[j];}
+    }
+
+  }
+
+  __attribute__((target("avx2,fma")))
+  void expfunAVX2(const double* x, double* result, int nValues) {
+
+    int i(0);
+    for (i = 0; i + 4 <= nValues; i += 4) {
+      expfun4(x + i, result + i);
+    }
+
+    int nLeft = nValues - i;
+    if (nLeft > 0) {
+      double xTmp[4] = {0.0, 0.0, 0.0, 0.0}, rTmp[4];
+      int j;
+      for (j = 0; j < nLeft; j++) {xTmp[j] = x[i+j];}
+      expfun4(xTmp, rTmp);
+      for (j = 0; j < nLeft; j++) {result[i+j] = rTmp[j];}
+    }
+
+  }
+
+  // AVX-512 kernels (8 doubles). The zero-masked forms of the shift and scalef
+  // intrinsics avoid spurious gcc uninitialised warnings from _mm512_undefined.
+
+  __attribute__((target("avx512f")))
+  inline __m512d exp8(__m512d x) {
+
+    __m512d magic = _mm512_set1_pd(roundMagic);
+    __m512d kd = _mm512_fmadd_pd(x, _mm512_set1_pd(log2e), magic);
+    kd = _mm512_sub_pd(kd, magic);
+
+    __m512d r = _mm512_fnmadd_pd(kd, _mm512_set1_pd(ln2Hi), x);
+    r = _mm512_fnmadd_pd(kd, _mm512_set1_pd(ln2Lo), r);
+
+    __m512d p = _mm512_set1_pd(expCoeff[0]);
+    int i;
+    for (i = 1; i < 12; i++) {
+      p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(expCoeff[i]));
+    }
+    __m512d one = _mm512_set1_pd(1.0);
+    p = _mm512_fmadd_pd(p, r, one);
+    p = _mm512_fmadd_pd(p, r, one);
+
+    return _mm512_maskz_scalef_pd(0xff, p, kd);
+
+  }
+
+  __attribute__((target("avx512f")))
+  inline __m512d log8(__m512d x) {
+
+    __m512i bits = _mm512_castpd_si512(x);
+    __m512i expBits = _mm512_maskz_srli_epi64(0xff, bits, 52);
+    __m512i mantBits = _mm512_and_si512(bits, _mm512_set1_epi64(0x000fffffffffffffLL));
+
+    __m512d one = _mm512_set1_pd(1.0);
+    __m512d m = _mm512_castsi512_pd(_mm512_or_si512(mantBits, _mm512_castpd_si512(one)));
+
+    __m512i twoTo52 = _mm512_set1_epi64(0x4330000000000000LL);
+    __m512d e = _mm512_sub_pd(_mm512_castsi512_pd(_mm512_or_si512(expBits, twoTo52)),
+			      _mm512_set1_pd(4503599627370496.0 + 1023.0));
+
+    __mmask8 big = _mm512_cmp_pd_mask(m, _mm512_set1_pd(sqrt2), _CMP_GT_OQ);
+    m = _mm512_mask_mul_pd(m, big, m, _mm512_set1_pd(0.5));
+    e = _mm512_mask_add_pd(e, big, e, one);
+
+    __m512d f = _mm512_sub_pd(m, one);
+    __m512d s = _mm512_div_pd(f, _mm512_add_pd(_mm512_set1_pd(2.0), f));
+    __m512d z = _mm512_mul_pd(s, s);
+    __m512d w = _mm512_mul_pd(z, z);
+
+    __m512d t1 = _mm512_fmadd_pd(w, _mm512_set1_pd(Lg6), _mm512_set1_pd(Lg4));
+    t1 = _mm512_fmadd_pd(w, t1, _mm512_set1_pd(Lg2));
+    t1 = _mm512_mul_pd(w, t1);
+    __m512d t2 = _mm512_fmadd_pd(w, _mm512_set1_pd(Lg7), _mm512_set1_pd(Lg5));
+    t2 = _mm512_fmadd_pd(w, t2, _mm512_set1_pd(Lg3));
+    t2 = _mm512_fmadd_pd(w, t2, _mm512_set1_pd(Lg1));
+    t2 = _mm512_mul_pd(z, t2);
+    __m512d R = _mm512_add_pd(t1, t2);
+
+    __m512d hfsq = _mm512_mul_pd(_mm512_set1_pd(0.5), _mm512_mul_pd(f, f));
+
+    __m512d inner = _mm512_fmadd_pd(s, _mm512_add_pd(hfsq, R),
+				    _mm512_mul_pd(e, _mm512_set1_pd(ln2Lo)));
+    __m512d logm = _mm512_sub_pd(_mm512_sub_pd(hfsq, inner), f);
+    return _mm512_fmsub_pd(e, _mm512_set1_pd(ln2Hi), logm);
+
+  }
+
+  __attribute__((target("avx512f")))
+  inline void power8(const double* x, const double* n, int nStride, double* result) {
+
+    __m512d vx = _mm512_loadu_pd(x);
+    __m512d vn = (nStride == 0) ? _mm512_set1_pd(n[0]) : _mm512_loadu_pd(n);
+
+    __m512d y = _mm512_mul_pd(vn, log8(vx));
+    __m512d infinity = _mm512_set1_pd(HUGE_VAL);
+
+    __mmask8 good = _mm512_cmp_pd_mask(vx, _mm512_set1_pd(1e-30), _CMP_GE_OQ);
+    good &= _mm512_cmp_pd_mask(vx, infinity, _CMP_LT_OQ);
+    good &= _mm512_cmp_pd_mask(_mm512_abs_pd(vn), infinity, _CMP_LT_OQ);
+    good &= _mm512_cmp_pd_mask(_mm512_abs_pd(y), _mm512_set1_pd(maxExpArg), _CMP_LT_OQ);
+
+    _mm512_storeu_pd(result, exp8(y));
+
+    if (good != 0xff) {
+      int i;
+      for (i = 0; i < 8; i++) {
+	if (((good >> i) & 1) == 0) {result[i] = scalarPower(x[i], n[i*nStride]);}
+      }
+    }
+
+  }
+
+  __attribute__((target("avx512f")))
+  inline void expfun8(const double* x, double* result) {
+
+    __m512d vx = _mm512_loadu_pd(x);
+    __mmask8 good = _mm512_cmp_pd_mask(_mm512_abs_pd(vx), _mm512_set1_pd(70.0), _CMP_LT_OQ);
+    _mm512_storeu_pd(result, _mm512_maskz_mov_pd(good, exp8(vx)));
+
+  }
+
+  __attribute__((target("avx512f")))
+  void powerAVX512(const double* x, const double* n, int nStride,
+		   double* result, int nValues) {
+
+    int i(0);
+    for (i = 0; i + 8 <= nValues; i += 8) {
+      power8(x + i, n + i*nStride, nStride, result + i);
+    }
+
+    int nLeft = nValues - i;
+    if (nLeft > 0) {
+      double xTmp[8], nTmp[8], rTmp[8];
+      int j;
+      for (j = 0; j < 8; j++) {
+	xTmp[j] = 1.0; nTmp[j] = 1.0;
+	if (j < nLeft) {xTmp[j] = x[i+j]; nTmp[j] = n[(i+j)*nStride];}
+      }
+      power8(xTmp, nTmp, 1, rTmp);
+      for (j = 0; j < nLeft; j++) {result[i+j] = rTmp[j];}
+    }
+
+  }
+
+  __attribute__((target("avx512f")))
+  void expfunAVX512(const double* x, double* result, int nValues) {
+
+    int i(0);
+    for (i = 0; i + 8 <= nValues; i += 8) {
+      expfun8(x + i, result + i);
+    }
+
+    int nLeft = nValues - i;
+    if (nLeft > 0) {
+      double xTmp[8], rTmp[8];
+      int j;
+      for (j = 0; j < 8; j++) {
+	xTmp[j] = 0.0;
+	if (j < nLeft) {xTmp[j] = x[i+j];}
+      }
+      expfun8(xTmp, rTmp);
+      for (j = 0; j < nLeft; j++) {result[i+j] = rTmp[j];}
+    }
+
+  }
+
+#endif
+
+  void powerKernel(const double* x, const double* n, int nStride,
+		   double* result, int nValues) {
+
+    if (nValues <= 0) {return;}
+
+#ifdef ACT_SIMD_X86
+    int set = ActSIMDMath::getInstructionSet();
+    if (set == ActSIMDMath::AVX512) {
+      powerAVX512(x, n, nStride, result, nValues); return;
+    } else if (set == ActSIMDMath::AVX2) {
+      powerAVX2(x, n, nStride, result, nValues); return;
+    }
+#endif
+
+    powerScalar(x, n, nStride, result, nValues);
+
+  }
+
+}
+
+int& ActSIMDMath::currentSet() {
+
+  static int theSet = ActSIMDMath::getSupportedInstructionSet();
+  return theSet;
+
+}
+
+int ActSIMDMath::getInstructionSet() {
+
+  return ActSIMDMath::currentSet();
+
+}
+
+int ActSIMDMath::getSupportedInstructionSet() {
+
+  int set(ActSIMDMath::Scalar);
+
+#ifdef ACT_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    set = ActSIMDMath::AVX512;
+  } else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    set = ActSIMDMath::AVX2;
+  }
+#endif
+
+  return set;
+
+}
+
+void ActSIMDMath::setInstructionSet(int instructionSet) {
+
+  int supported = ActSIMDMath::getSupportedInstructionSet();
+  if (instructionSet < ActSIMDMath::Scalar) {instructionSet = ActSIMDMath::Scalar;}
+  if (instructionSet > supported) {instructionSet = supported;}
+
+  ActSIMDMath::currentSet() = instructionSet;
+
+}
+
+std::string ActSIMDMath::getName(int instructionSet) {
+
+  std::string name("Scalar");
+  if (instructionSet == ActSIMDMath::AVX2) {
+    name = "AVX2";
+  } else if (instructionSet == ActSIMDMath::AVX512) {
+    name = "AVX512";
+  }
+
+  return name;
+
+}
+
+void ActSIMDMath::power_n(const double* x, const double* n, double* result, int nValues) {
+
+  powerKernel(x, n, 1, result, nValues);
+
+}
+
+void ActSIMDMath::power_n(const double* x, double n, double* result, int nValues) {
+
+  powerKernel(x, &n, 0, result, nValues);
+
+}
+
+void ActSIMDMath::expfun_n(const double* x, double* result, int nValues) {
+
+  if (nValues <= 0) {return;}
+
+#ifdef ACT_SIMD_X86
+  int set = ActSIMDMath::getInstructionSet();
+  if (set == ActSIMDMath::AVX512) {
+    expfunAVX512(x, result, nValues); return;
+  } else if (set == ActSIMDMath::AVX2) {
+    expfunAVX2(x, result, nValues); return;
+  }
+#endif
+
+  expfunScalar(x, result, nValues);
+
+}
+
+namespace {
+
+  // Compare an array result with the scalar reference value. Special values
+  // (zero, non-finite) must be identical, otherwise the relative difference
+  // must be within the given bound.
+  bool compareValue(double value, double reference, double bound, double& maxRelDiff) {
+
+    if (std::isnan(reference) == true || std::isnan(value) == true) {
+      return std::isnan(reference) == std::isnan(value);
+    }
+    if (std::isfinite(reference) == false || reference == 0.0) {return value == reference;}
+
+    double relDiff = std::fabs(value - reference)/std::fabs(reference);
+    if (relDiff > maxRelDiff) {maxRelDiff = relDiff;}
+    return relDiff <= bound;
+
+  }
+
+}
+
+bool ActSIMDMath::checkAccuracy(std::string& message) {
+
+  const double ulp = std::numeric_limits<double>::epsilon();
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  const double inf = std::numeric_limits<double>::infinity();
+  const double denorm = std::numeric_limits<double>::denorm_min();
+
+  double special[] = {nan, -nan, inf, -inf, denorm, -denorm, 1e-310, 0.0, -0.0,
+		      1e-31, -1e-31, 1e-30, -1.0, -8.0, -700.0, 69.999, -69.999,
+		      70.0, -70.0, 700.0, -745.0, 1e300, 1.0};
+  int nSpecial = (int) (sizeof(special)/sizeof(double));
+
+  // The special values, then random values of the energy range and the
+  // exponent range of the formulae; the number is not a multiple of the
+  // vector length so that the padded remainder is also checked
+  std::mt19937 generator(12345);
+  std::uniform_real_distribution<double> logX(-6.0, 6.0), expX(-80.0, 80.0), power(-4.0, 4.0);
+
+  const int nValues(1003);
+  std::vector<double> x(nValues), n(nValues), xExp(nValues);
+  int i;
+  for (i = 0; i < nValues; i++) {
+    if (i < nSpecial) {
+      x[i] = special[i]; xExp[i] = special[i];
+    } else {
+      x[i] = std::pow(10.0, logX(generator)); xExp[i] = expX(generator);
+    }
+    n[i] = power(generator);
+  }
+  n[0] = 0.5; n[1] = -0.5; n[2] = nan;
+
+  ActFormulae formulae;
+  std::vector<double> powers(nValues), constPowers(nValues), exps(nValues);
+  int previousSet = ActSIMDMath::getInstructionSet();
+  int bestSet = ActSIMDMath::getSupportedInstructionSet();
+  int iSet;
+  bool ok(true);
+  double maxRelDiff(0.0);
+
+  for (iSet = ActSIMDMath::Scalar; ok == true && iSet <= bestSet; iSet++) {
+
+    ActSIMDMath::setInstructionSet(iSet);
+    ActSIMDMath::power_n(&x[0], &n[0], &powers[0], nValues);
+    ActSIMDMath::power_n(&x[0], -(2.0/3.0), &constPowers[0], nValues);
+    ActSIMDMath::expfun_n(&xExp[0], &exps[0], nValues);
+
+    for (i = 0; ok == true && i < nValues; i++) {
+
+      // The error of x^n = exp(n log x) grows with |n log x|
+      double logTerm = std::fabs(std::log(std::fabs(x[i])));
+      double nBound = (2.0 + std::fabs(n[i])*logTerm)*ulp;
+      double constBound = (2.0 + (2.0/3.0)*logTerm)*ulp;
+
+      std::string function("");
+      if (compareValue(powers[i], formulae.power(x[i], n[i]), nBound, maxRelDiff) == false) {
+	function = "power(x, n)";
+      } else if (compareValue(constPowers[i], formulae.power(x[i], -(2.0/3.0)),
+			      constBound, maxRelDiff) == false) {
+	function = "power(x, -2/3)";
+      } else if (compareValue(exps[i], formulae.expfun(xExp[i]), 2.0*ulp, maxRelDiff) == false) {
+	function = "expfun(x)";
+      }
+
+      if (function.size() > 0) {
+	std::ostringstream stream;
+	stream << std::setprecision(17) << function << " differs from the scalar value using "
+	       << ActSIMDMath::getName(iSet) << " for x = " << x[i] << ", n = " << n[i]
+	       << ", exp x = " << xExp[i];
+	message = stream.str();
+	ok = false;
+      }
+
+    }
+
+  }
+
+  ActSIMDMath::setInstructionSet(previousSet);
+  if (ok == true) {
+    std::ostringstream stream;
+    stream << "largest relative difference = " << maxRelDiff << " using "
+	   << ActSIMDMath::getName(bestSet);
+    message = stream.str();
+  }
+
+  return ok;
+
+}
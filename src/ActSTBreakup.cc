@@ -1,6 +1,7 @@
 // Class to select cross-section formula
 
 #include "Activia/ActSTBreakup.hh"
+#include "Activia/ActTrace.hh"
 #include "Activia/ActFormulae.hh"
 #include "Activia/ActSTSpallation.hh"
 #include "Activia/ActNucleiData.hh"
@@ -26,6 +27,8 @@ ActSTBreakup::~ActSTBreakup()
 }
 
 double ActSTBreakup::calcCrossSection(ActNucleiData* data) {
+
+  ACT_TRACE_SCOPE(_traceName, "model");
   
   if (data == 0) {
     cout<<"Error in ActSTBreakup. Data object is null"<<endl;
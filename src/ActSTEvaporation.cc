@@ -1,6 +1,7 @@
 // Class to calculate light evaporation products, eqns 8-11, paper II
 
 #include "Activia/ActSTEvaporation.hh"
+#include "Activia/ActTrace.hh"
 #include "Activia/ActFormulae.hh"
 #include "Activia/ActNucleiData.hh"
 #include "Activia/ActSTSigUpdates.hh"
@@ -26,6 +27,8 @@ ActSTEvaporation::~ActSTEvaporation()
 
 double ActSTEvaporation::calcCrossSection(ActNucleiData* data) {
 
+  ACT_TRACE_SCOPE(_traceName, "model");
+
   if (data == 0) {
     cout<<"Error in ActSTEvaporation. Data object is null"<<endl;
     return 0.0;
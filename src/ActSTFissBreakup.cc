@@ -3,6 +3,7 @@
 // for sigma (in Ap J Supp 220,25,335(1973))
 
 #include "Activia/ActSTFissBreakup.hh"
+#include "Activia/ActTrace.hh"
 #include "Activia/ActSTBreakup.hh"
 #include "Activia/ActSTFission.hh"
 #include "Activia/ActNucleiData.hh"
@@ -29,6 +30,8 @@ ActSTFissBreakup::~ActSTFissBreakup()
 
 double ActSTFissBreakup::calcCrossSection(ActNucleiData* data) {
 
+  ACT_TRACE_SCOPE(_traceName, "model");
+
   if (data == 0) {
     cout<<"Error in ActSTFissBreakup. Data object is null"<<endl;
     return 0.0;
@@ -3,6 +3,8 @@
 // for sigma (in Ap J Supp 220,25,335(1973))
 
 #include "Activia/ActSTFissSpallGamma.hh"
+#include "Activia/ActTrace.hh"
+#include "Activia/ActEnergyFactorCache.hh"
 #include "Activia/ActSTSpallation.hh"
 #include "Activia/ActSTFission.hh"
 #include "Activia/ActNucleiData.hh"
@@ -30,6 +32,8 @@ ActSTFissSpallGamma::~ActSTFissSpallGamma()
 
 double ActSTFissSpallGamma::calcCrossSection(ActNucleiData* data) {
 
+  ACT_TRACE_SCOPE(_traceName, "model");
+
   if (data == 0) {
     cout<<"Error in ActSTFissSpallGamma. Data object is null"<<endl;
     return 0.0;
@@ -48,9 +52,9 @@ double ActSTFissSpallGamma::calcCrossSection(ActNucleiData* data) {
   double zt = data->getzt();
   double atgt = data->getat();
   double atbar = data->getatbar();
-  double e = data->gete();
+  double eTerm = this->getEnergyFactor(ActEnergyFactorCache::EPow23, data);
 
-  double gamma = _formulae.gamma(z, a, zt, atgt, atbar, e);
+  double gamma = _formulae.gammaETerm(z, a, zt, atgt, atbar, eTerm);
 
   if (gamma > 0.0 && gamma < 1.0) {
     _sigma = _formulae.power(_sigma, gamma)*_formulae.power(sigmaf, (1.0 - gamma));
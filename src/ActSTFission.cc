@@ -3,6 +3,8 @@
 // for sigma (in Ap J Supp 220,25,335(1973))
 
 #include "Activia/ActSTFission.hh"
+#include "Activia/ActTrace.hh"
+#include "Activia/ActEnergyFactorCache.hh"
 #include "Activia/ActSTSpallation.hh"
 #include "Activia/ActFormulae.hh"
 #include "Activia/ActNucleiData.hh"
@@ -29,6 +31,8 @@ ActSTFission::~ActSTFission()
 
 double ActSTFission::calcCrossSection(ActNucleiData* data) {
 
+  ACT_TRACE_SCOPE(_traceName, "model");
+
   if (data == 0) {
     cout<<"Error in ActSTFission. Data object is null"<<endl;
     return 0.0;
@@ -62,9 +66,9 @@ double ActSTFission::calcCrossSection(ActNucleiData* data) {
   double inve(0.0);
   if (std::fabs(e) > 1e-30) {inve = 1.0/e;}
 
-  double ay = 19.0*_formulae.power((450.0*inve), 0.6);
-  double pow1 = _formulae.power((350.0*inve), 4.0);
-  double pow2 = _formulae.power((130.0*inve), 4.0);
+  double ay = this->getEnergyFactor(ActEnergyFactorCache::FissAy, data);
+  double pow1 = this->getEnergyFactor(ActEnergyFactorCache::FissPow350, data);
+  double pow2 = this->getEnergyFactor(ActEnergyFactorCache::FissPow130, data);
   double dee = _formulae.expfun(pow1*(1.3 - nvzstr)/(1.0 + pow2));
   if (dee < 1.0) {dee = 1.0;}
 
@@ -83,12 +87,13 @@ double ActSTFission::calcCrossSection(ActNucleiData* data) {
   if (aitch < 0.0) {aitch = 0.0;}
 
   // Done with preliminaries on ff of f, plug into eqn 5
-  double logTerm = log(5.5*_formulae.power(inve, 0.07));
+  double logTerm = this->getEnergyFactor(ActEnergyFactorCache::FissLogTerm, data);
   double termAt = 0.0065*(207.0 - at); // update from ST'85, Eq 13.
   double absPow = std::fabs(e - 700.0)/700.0;
   double term2(0.0);
   if (std::fabs(at) > 1e-30) {term2 = (a - 0.46*at)/(0.15*at);}
-  double expPow = ay*(nvzstr - logTerm - termAt*_formulae.expfun(-absPow));
+  double expAbs = this->getEnergyFactor(ActEnergyFactorCache::FissExpAbs, data);
+  double expPow = ay*(nvzstr - logTerm - termAt*expAbs);
   expPow -= gee*term2*term2;
   expPow -= aitch;
   double ffofe = dee*_formulae.expfun(expPow);
@@ -126,7 +131,7 @@ double ActSTFission::calcCrossSection(ActNucleiData* data) {
 
   // Put it all together
   double fofa4 = _formulae.fofa4(zt, at, z, a, atbar);
-  double phi = _formulae.phi(at, e);
+  double phi = this->getEnergyFactor(ActEnergyFactorCache::Phi, data);
 
   _sigma = sigmas*fofa4*ffofe*phi;
 
@@ -3,11 +3,13 @@
 // Cross section given by sig=sig(ezero)*H(E)*Y(At,Zt)     
 
 #include "Activia/ActSTPeripheral.hh"
+#include "Activia/ActTrace.hh"
 #include "Activia/ActFormulae.hh"
 #include "Activia/ActSTSLite.hh"
 #include "Activia/ActSTSpallation.hh"
 #include "Activia/ActSTSLite.hh"
 #include "Activia/ActNucleiData.hh"
+#include "Activia/ActEnergyFactorCache.hh"
 #include "Activia/ActSTSigUpdates.hh"
 
 #include <cmath>
@@ -31,6 +33,8 @@ ActSTPeripheral::~ActSTPeripheral()
 
 double ActSTPeripheral::calcCrossSection(ActNucleiData* data) {
 
+  ACT_TRACE_SCOPE(_traceName, "model");
+
   // Peripheral reactions of the form ypxn
 
   if (data == 0) {
@@ -368,7 +372,7 @@ double ActSTPeripheral::calcpxnSigma(ActNucleiData* data) {
       
       double atmin = 35.0;
       double yieldVal = this->yield(d, at, atbar, atmin, zt);
-      double phiVal = _formulae.phi(at, e);
+      double phiVal = this->getEnergyFactor(ActEnergyFactorCache::Phi, data);
       sigma = sige0*hofe*yieldVal*phiVal;
       
     }
@@ -433,7 +437,7 @@ double ActSTPeripheral::calc2pSigma(ActNucleiData* data) {
   
   // Calculate sigma    
   double yieldVal = this->yield(d, at, atbar, atmin, zt);
-  double phiVal = _formulae.phi(at, e);
+  double phiVal = this->getEnergyFactor(ActEnergyFactorCache::Phi, data);
   sigma = sige0*hofe*yieldVal*phiVal;
   
   // Update from ST'90, p 369
@@ -508,7 +512,7 @@ double ActSTPeripheral::calc2pxnSigma(ActNucleiData* data) {
     
     // Calculate sigma
     double yieldVal = this->yield(d, at, atbar, atmin, zt);
-    double phiVal = _formulae.phi(at, e);
+    double phiVal = this->getEnergyFactor(ActEnergyFactorCache::Phi, data);
     sigma = sige0*hofe*yieldVal*phiVal;
   }
 
@@ -665,7 +669,7 @@ double ActSTPeripheral::calc3pxnSigma(ActNucleiData* data) {
       }
       
       double yieldVal = this->yield(d, at, atbar, atmin, zt);
-      double phiVal = _formulae.phi(at, e);
+      double phiVal = this->getEnergyFactor(ActEnergyFactorCache::Phi, data);
       sigma = factor*sige0*hofe*yieldVal*phiVal;
       
       // Corrections from ST'85, p877 to reduce some yields for 3pxn reactions
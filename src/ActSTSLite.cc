@@ -1,7 +1,9 @@
 // Class to calculate the cross-sections (mb) for Z<29 targets
 
 #include "Activia/ActSTSLite.hh"
-#include "Activia/ActClassify.hh"
+#include "Activia/ActTrace.hh"
+#include "Activia/ActEnergyFactorCache.hh"
+#include "Activia/ActNuclideTable.hh"
 #include "Activia/ActFormulae.hh"
 #include "Activia/ActSTSigUpdates.hh"
 
@@ -14,6 +16,7 @@ using std::endl;
 ActSTSLite::ActSTSLite(std::string name, bool applyUpdates, int debug) : ActAbsXSecModel(name, debug)
 {
   // Constructor
+  _data = 0;
   _updates = new ActSTSigUpdates();
   _applyUpdates = applyUpdates;
 }
@@ -26,6 +29,7 @@ ActSTSLite::~ActSTSLite()
 
 void ActSTSLite::setUp(ActNucleiData& data) {
 
+  _data = &data;
   _zt = data.getzt();
   _at = data.getat();
   _atbar = data.getatbar();
@@ -40,7 +44,7 @@ void ActSTSLite::setUp(ActNucleiData& data) {
   _iat = data.getiat();
   
   _logat = 0.0; if (_at > 0.0) {_logat = log(_at);}
-  _loge = 0.0; if (_e > 0.0) {_loge = log(_e);}
+  _loge = this->getEnergyFactor(ActEnergyFactorCache::LogE, _data);
 
   this->initLiteParam();
 
@@ -77,6 +81,8 @@ void ActSTSLite::initLiteParam() {
 
 double ActSTSLite::calcCrossSection(ActNucleiData* data) {
 
+  ACT_TRACE_SCOPE(_traceName, "model");
+
   if (data == 0) {
     cout<<"Error in ActSTSLite. Data object is null"<<endl;
     return 0.0;
@@ -117,8 +123,7 @@ double ActSTSLite::calcSLiteSigma(std::string name) {
   double sigma(0.0);
 
   // First get classification for pairing factor eta
-  ActClassify classify(_ia, _iz);
-  int ioe = classify.classif();
+  int ioe = ActNuclideTable::getPairing(_ia, _iz);
 
   // Next check for large deltaA correction; eqn 2, ST'73 I
   double dela = _at - _a;
@@ -189,10 +194,10 @@ void ActSTSLite::calcLite1Values(int ioe) {
   if (_e < 1250.0) {
 
     double e1250 = 1.0 - _e/1250.0;
-    double f3Val = _formulae.f3(_zt, _e);
+    double f3Val = this->getEnergyFactor(ActEnergyFactorCache::F3, _data);
     _sig0 = 13.0*f3Val*_formulae.expfun(1.15*e1250);
     _p = 0.16*e1250;
-    if (_izt <= 20) {_r = 10.7*_formulae.power(_e, -0.25);}
+    if (_izt <= 20) {_r = 10.7*this->getEnergyFactor(ActEnergyFactorCache::EPowM025, _data);}
 
   } else {
     _sig0 = 13.0; _p = 0.0;
@@ -202,9 +207,9 @@ void ActSTSLite::calcLite1Values(int ioe) {
   if (_izt <= 28 && _izt >= 21) {
 
     if (_e < _ezero || _e > 2500.0) {
-      _corr = _formulae.f11(_e, _ezero);
+      _corr = this->getEnergyFactor(ActEnergyFactorCache::F11, _data);
     } else {
-      double term1 = _formulae.f11(_e, _ezero);
+      double term1 = this->getEnergyFactor(ActEnergyFactorCache::F11, _data);
       double eratio(0.0);
       if (std::fabs(_ezero) > 1e-30) {eratio = 2262.0*_e/_ezero;}
       double term2 = _formulae.f11(eratio, _ezero);
@@ -223,7 +228,7 @@ void ActSTSLite::calcLite2Values(int ioe) {
   if (_ezero > 1250.0) {elit2 = _ezero;}
   if (_e < elit2 && _e > 0.0) {
     _p = 2.6/sqrt(_e);
-    _r = 10.2*_formulae.power(_e, -0.26);
+    _r = 10.2*this->getEnergyFactor(ActEnergyFactorCache::EPowM026, _data);
   } else {
     _p = 0.075;
     if (_ezero > 1250.0) {_p = 0.77*_formulae.power(_at, -0.6667);}
@@ -272,7 +277,7 @@ void ActSTSLite::calcLite3Values(int ioe) {
   // Light target nuclei, table 1C, AP J 220, 318 (1973)
   double g(1.0);
   if (_e < 1250.0) {
-    _r = 10.2*_formulae.power(_e, -0.26);
+    _r = 10.2*this->getEnergyFactor(ActEnergyFactorCache::EPowM026, _data);
   } else {
     _r = 1.6;
   }
@@ -292,7 +297,7 @@ void ActSTSLite::calcLite3Values(int ioe) {
   double term1 = _formulae.power(_at, (2.0/3.0)) - 1.0;
   double term2 = -0.3*(_logat - log(20.0)) + 1.0;
 
-  double f2pVal = _formulae.f2p(_e);
+  double f2pVal = this->getEnergyFactor(ActEnergyFactorCache::F2p, _data);
   _sig0 = 28.0*f2pVal*term1*term2;
 
   // Update from ST'90, p369
@@ -337,8 +342,8 @@ void ActSTSLite::calcLite4Values(int ioe) {
   if (_e >= fmin(3000.0, _ezero)) {_p = 1.97*_formulae.power(_at, -0.9);}
 
   if (_e < _ezero) {
-    double cpVal = _formulae.cp(_at, _zt, _e, _ezero);
-    _p = 20.0*cpVal*_formulae.power(_e, -0.77);
+    double cpVal = this->getEnergyFactor(ActEnergyFactorCache::Cp, _data);
+    _p = 20.0*cpVal*this->getEnergyFactor(ActEnergyFactorCache::EPowM077, _data);
   }
 
   _r = 1.29*_formulae.power(_a, 0.15);
@@ -348,17 +353,17 @@ void ActSTSLite::calcLite4Values(int ioe) {
   double delad = _at - _a;
 
   if (delad > dacVal) {
-    _corr = _formulae.f22(_e, _ezero);
+    _corr = this->getEnergyFactor(ActEnergyFactorCache::F22, _data);
     cout<<"lit4 corr f22 = "<<_corr<<endl;
   }
 
   if (delad >= 7.0 && delad <= (dacVal - 13.0)) {
-    _corr = _formulae.f33(_e, _ezero);
+    _corr = this->getEnergyFactor(ActEnergyFactorCache::F33, _data);
     cout<<"lit4 corr f33 = "<<_corr<<endl;
   }
 
-  double f1Val = _formulae.f1(_at, _e, _ezero);
-  double f2Val = _formulae.f2(_e);
+  double f1Val = this->getEnergyFactor(ActEnergyFactorCache::F1, _data);
+  double f2Val = this->getEnergyFactor(ActEnergyFactorCache::F2, _data);
   _sig0 = 144.0*_p*f1Val*f2Val*_formulae.power(_at, 0.367);
 
   double invpatVal = _formulae.invpat(_p, _at);
@@ -4,6 +4,7 @@
 // all can refer to.
 
 #include "Activia/ActSTSigUpdates.hh"
+#include "Activia/ActEnergyFactorCache.hh"
 
 #include <cmath>
 #include <iostream>
@@ -14,17 +15,65 @@ using std::endl;
 ActSTSigUpdates::ActSTSigUpdates()
 {
   // Constructor
+  _izt = -1; _iat = -1; _iz = -1; _ia = -1;
+  _preFactors.clear(); _postFactors.clear();
+  _useEnergyTerm = false;
+  _dzTerm = 0.0;
 }
 
 ActSTSigUpdates::~ActSTSigUpdates() 
 {
   // Destructor
+  _preFactors.clear(); _postFactors.clear();
 }
 
 void ActSTSigUpdates::updateSigma(ActNucleiData& data, double& sigma) {
 
-  // Update the cross-section sigma by reference
-  // Updated factors
+  // Update the cross-section sigma by reference.
+  // First make sure we have the factors for this target and product
+  if (data.getizt() != _izt || data.getiat() != _iat ||
+      data.getiz() != _iz || data.getia() != _ia) {
+    this->setPairFactors(data);
+  }
+
+  // The product of all factors is also kept, e.g. for uncertainty ensembles.
+  // The factors are still applied one at a time so that sigma is unchanged.
+  double factor(1.0);
+
+  int i;
+  int nPre = (int) _preFactors.size();
+  for (i = 0; i < nPre; i++) {sigma *= _preFactors[i]; factor *= _preFactors[i];}
+
+  // 17. Energy correction for products with large deltaZ for heavy targets
+  if (_useEnergyTerm == true) {
+
+    double eTerm(0.0);
+    ActEnergyFactorCache* cache = data.getEnergyFactorCache();
+    if (cache != 0) {
+      eTerm = cache->getFactor(ActEnergyFactorCache::Gauss1230, data);
+    } else {
+      ActFormulae formulae;
+      eTerm = ActEnergyFactorCache::calcFactor(formulae, ActEnergyFactorCache::Gauss1230,
+					       data.getat(), data.getzt(), data.gete(), 
+					       data.getezero());
+    }
+
+    double F = 0.9*eTerm*_dzTerm + 1.0;
+    sigma *= F; factor *= F;
+
+  }
+
+  int nPost = (int) _postFactors.size();
+  for (i = 0; i < nPost; i++) {sigma *= _postFactors[i]; factor *= _postFactors[i];}
+
+  data.setUpdateFactor(factor);
+
+}
+
+void ActSTSigUpdates::setPairFactors(ActNucleiData& data) {
+
+  // Store the energy independent update factors for the target and product
+  // nuclei, in the order that they are applied to the cross-section
   // 1. Enhanced prod of C12 and O16 from Ne, Na, Mg and Al targets (10<=Zt<=13):
   int izt = data.getizt();
   int iz = data.getiz();
@@ -32,28 +81,33 @@ void ActSTSigUpdates::updateSigma(ActNucleiData& data, double& sigma) {
   int iat = data.getiat();
   int idnp = data.getidnp();
 
+  _izt = izt; _iat = iat; _iz = iz; _ia = ia;
+  _preFactors.clear(); _postFactors.clear();
+  _useEnergyTerm = false;
+  _dzTerm = 0.0;
+
   if (izt >= 10 && izt <= 13) {
     if ((iz == 6 && ia == 12) || (iz == 8 && ia == 16)) {
-      sigma *= 2.0;
+      _preFactors.push_back(2.0);
     }
   }
 
   // 2. Suppression of F from Ne to S
-  if (izt >= 10 && izt <= 16 && iz == 9) {sigma *= 0.8;}
+  if (izt >= 10 && izt <= 16 && iz == 9) {_preFactors.push_back(0.8);}
 
   // 3. Futher suppression factors
   if (izt >= 9 && izt <= 16) {
-    if (iz >= 8 && idnp == -1) {sigma *= 0.7;}
+    if (iz >= 8 && idnp == -1) {_preFactors.push_back(0.7);}
   }
 
   if (izt >= 6 && izt <= 11) {
-    if (idnp == -2) {sigma *= 0.4;}
+    if (idnp == -2) {_preFactors.push_back(0.4);}
   }
 
   // 4. Futher suppression factors
   if (izt >= 17 && izt <= 20 && iz > 10) {
     if (idnp <= -1 || idnp >= 3) {
-      sigma *= 0.5;
+      _preFactors.push_back(0.5);
     }
   }
 
@@ -62,16 +116,16 @@ void ActSTSigUpdates::updateSigma(ActNucleiData& data, double& sigma) {
     int in = data.getin(); // integer number of neutrons
     if (iz == in) {
       int idz = izt - iz; // deltaZ
-      if (idz == 1 || idz == 3) {sigma *= 0.7;}
+      if (idz == 1 || idz == 3) {_preFactors.push_back(0.7);}
     }
   }  
 
   // 6. Production of Mg, Si, Ar and S from Ca-40:
   if (izt == 20 && iat == 40) {
     if (iz == 12 || iz == 14) {
-      sigma *= 2.4;
+      _preFactors.push_back(2.4);
     } else if (iz == 16 || iz == 18) {
-      sigma *= 1.6;
+      _preFactors.push_back(1.6);
     }
   }
 
@@ -79,44 +133,43 @@ void ActSTSigUpdates::updateSigma(ActNucleiData& data, double& sigma) {
   // Production of Z=19-22 from Ni-58.
   if (iz == 16 || iz == 18 || iz == 20) {
     if ((izt == 24 && iat == 52) || (izt == 26 && iat == 56)) {
-      sigma *= 1.3;
+      _preFactors.push_back(1.3);
     }
   }
   if (izt == 28 && iat == 58) {
-    if (iz >= 19 && iz <= 22) {sigma *= 1.4;}
+    if (iz >= 19 && iz <= 22) {_preFactors.push_back(1.4);}
   }
 
   // 8. Production of N-14 and N-15 from Ne-20 and Mg-24
   if (iz == 7 && (ia == 14 || ia == 15)) {
     if ((izt == 10 && iat == 20) || (izt == 12 && iat == 24)) {
-      sigma *= 1.5;
+      _preFactors.push_back(1.5);
     }
   }
 
   // 15. Reduction of neutron-rich products from O-16 and Ne-20
   if ((izt == 8 || izt == 10) && (iat == 2*izt)) {
-    if (idnp > 1 && iz > 4) {sigma *= 0.7;}
+    if (idnp > 1 && iz > 4) {_preFactors.push_back(0.7);}
   }
       
   // 16. Reduction of n-rich products from Cr to Ni
   if (izt >= 24 && izt <= 28 && iz >= 21 
-      && iz <= 23 && idnp >= 6) {sigma *= 0.5;}
+      && iz <= 23 && idnp >= 6) {_preFactors.push_back(0.5);}
 
-  // 17. Energy correction for products with large deltaZ for heavy targets
+  // 17. Energy correction for products with large deltaZ for heavy targets.
+  // The energy part is applied in updateSigma
   if (izt > 30) {
     int idz = izt - iz;
     if (idz >= 5) {
-      double e = data.gete();
-      double exp1 = std::fabs(e - 1230.0)/150.0;
       double exp2 = std::fabs(idz*1.0 - 12.0)/5.0;
-      double F = 0.9*exp(-exp1*exp1)*exp(-exp2*exp2) + 1.0;
-      sigma *= F;
+      _dzTerm = exp(-exp2*exp2);
+      _useEnergyTerm = true;
     }   
   }
 
   // Correction from ST'85, p876 for even charge products
   if (iat <= 68 && izt >= 17) {
-    if (iz <= 16 && iz%2 == 0 && ia >= iat/2) {sigma *= 1.25;}
+    if (iz <= 16 && iz%2 == 0 && ia >= iat/2) {_postFactors.push_back(1.25);}
   }
 
 }
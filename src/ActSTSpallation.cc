@@ -1,7 +1,8 @@
 // Class to calculate cross-sections (mb) for various targets Z > 28
 
 #include "Activia/ActSTSpallation.hh"
-#include "Activia/ActClassify.hh"
+#include "Activia/ActTrace.hh"
+#include "Activia/ActEnergyFactorCache.hh"
 #include "Activia/ActFormulae.hh"
 #include "Activia/ActNucleiData.hh"
 #include "Activia/ActSTSigUpdates.hh"
@@ -51,10 +52,44 @@ void ActSTSpallation::setUp() {
   _EMaxDiff = _EMaxLimit - _E1GeV;
 
   _etasel = 0.0;
+
+  this->clearFixedSigmas();
+}
+
+void ActSTSpallation::clearFixedSigmas() {
+
+  _fixedKey.assign(7, 0.0);
+  _gotSigE0 = false; _gotSig1 = false;
+  _sigE0 = 0.0; _delaE0 = 0.0; _sig1 = 0.0;
+  _gotPairTerms = false;
+  _atpow = 0.0; _dacE0 = 0.0; _dac300 = 0.0; _rpow = 0.0; _omega = 0.0;
+  _pHigh = 0.0; _invpatHigh = 0.0;
+
+}
+
+void ActSTSpallation::checkFixedSigmas(ActNucleiData* data) {
+
+  // The sigmas at E0 and 1 GeV, and the energy-independent terms of the formula,
+  // only depend on the target and product isotopes (and the pairing factor), so
+  // keep them while these are the same
+  double key[7] = {data->getat(), data->getzt(), data->geta(), data->getz(),
+		   data->getatbar(), data->getezero(), _etasel};
+
+  int i;
+  for (i = 0; i < 7; i++) {
+    if (key[i] != _fixedKey[i]) {
+      this->clearFixedSigmas();
+      _fixedKey.assign(key, key + 7);
+      break;
+    }
+  }
+
 }
 
 double ActSTSpallation::calcCrossSection(ActNucleiData* data) {
 
+  ACT_TRACE_SCOPE(_traceName, "model");
+
   if (data == 0) {
     cout<<"Error in ActSTSpallation. Data object is null"<<endl;
     return 0.0;
@@ -77,8 +112,7 @@ double ActSTSpallation::calcCrossSection(ActNucleiData* data) {
   double energy = data->gete();
 
   // First get classification for pairing factor eta
-  ActClassify classify(ia, iz);
-  int ioe = classify.classif();
+  int ioe = data->getioe();
   if (_debug == 1) {
     cout<<"a,z,ia,iz,ioe = "<<a<<" "<<z<<" "<<ia<<" "<<iz<<" "<<ioe<<endl;
   }
@@ -89,15 +123,26 @@ double ActSTSpallation::calcCrossSection(ActNucleiData* data) {
   double dela(0.0);
   _sigma = this->calcSpallSigma(data, dela);
 
+  // The stored sigmas have been checked by calcSpallSigma.
+  // The debug printout needs all sigmas to be recalculated
+  if (_debug == 1) {
+    this->clearFixedSigmas();
+    this->checkFixedSigmas(data);
+    this->calcPairTerms(data);
+  }
+
   // Need to calculate sigma(Ezero)
-  double dela0(0.0);
-  data->setEnergy(ezero);
-  double sige0 = this->calcSpallSigma(data, dela0);
+  if (_gotSigE0 == false) {
+    data->setEnergy(ezero);
+    _sigE0 = this->calcSpallSigma(data, _delaE0);
+    _gotSigE0 = true;
+    data->setEnergy(energy);
+  }
+  double sige0 = _sigE0;
   if (_debug == 1) {cout<<"sige0 = "<<sige0<<endl;}
-  data->setEnergy(energy);
 
   // ST'73 II, pg 339
-  double delac = _formulae.dac(at, 300.0, ezero);
+  double delac = _dac300;
   double delaCut = delac*(200.0 + energy)*0.002;
   if (_debug == 1) {cout<<"delaCut = "<<delaCut<<endl;}
 
@@ -147,9 +192,13 @@ double ActSTSpallation::calcCrossSection(ActNucleiData* data) {
 	// Sigma at the EMaxLimit if set to the minimum of sige0 or _sigma.
 
 	// Get sigma at 1 GeV
-	double dela1(0.0);
-	data->setEnergy(_E1GeV);
-	double sig1 = this->calcSpallSigma(data, dela1);
+	if (_gotSig1 == false) {
+	  double dela1(0.0);
+	  data->setEnergy(_E1GeV);
+	  _sig1 = this->calcSpallSigma(data, dela1);
+	  _gotSig1 = true;
+	}
+	double sig1 = _sig1;
 
 	// We don't need sig1 = fmin(sige0, sig1) here since we know that
 	// the sigma at 1 GeV is OK when calculated by the spallation formulae.
@@ -195,9 +244,6 @@ double ActSTSpallation::calcSpallSigma(ActNucleiData* data, double& dela) {
   // Check for large deltaA correction, Eq 2, p319
   double at = data->getat();
   double a  = data->geta();
-  double zt = data->getzt();
-  double atbar = data->getatbar();
-  double z = data->getz();
   int iz = data->getiz();
   int ia = data->getia();
   int izt = data->getizt();
@@ -205,34 +251,27 @@ double ActSTSpallation::calcSpallSigma(ActNucleiData* data, double& dela) {
   double energy = data->gete();
   double ezero = data->getezero();
 
+  // The terms that do not depend on the energy are calculated once for each pair
+  this->checkFixedSigmas(data);
+  if (_gotPairTerms == false) {this->calcPairTerms(data);}
+
   dela = at - a;
-  double delac = _formulae.dac(at, energy, ezero);
+  double delac = this->getEnergyFactor(ActEnergyFactorCache::DAC, data);
   if (dela > delac) {dela = delac;}
   
-  // Now define parameters for the cross-section calculation
-  // Use Table 1D, ST'73 I and updates
-  double sratio(0.0);
-  if (std::fabs(zt) > 1e-30) {sratio = (at - atbar)/zt;}
-  
-  // Using the update from ST'90, pg 368
-  double s = 0.482 - 0.07*sratio;
-  double t = 0.00028;
-  double zstar = ((3.0e-7*a + t)*a - s)*a + z;
-  double nu(0.0);
-  if (zstar < -1.0) {
-    nu = 1.3;
-  } else if (zstar >= -1.0 && zstar <= 1.0) {
-    nu = 1.5;
-  } else {
-    nu = 1.75;
+  // Above E0, p (and so the invpat factor) only depends on the target
+  double p(_pHigh), invpatVal(_invpatHigh);
+  if (energy < ezero) {
+    p = this->calcPValue(data);
+    invpatVal = _formulae.invpat(p, at);
   }
 
-  double p = this->calcPValue(data);
-  double f1Val = _formulae.f1(at, energy, ezero);
-  double f2Val = _formulae.f2(energy);
-  double atpow = _formulae.power(at, 0.367);
-
-  if (energy >= fmin(_EMaxLimit, ezero)) {f1Val = 1.0;}
+  double f1Val(1.0);
+  if (energy < fmin(_EMaxLimit, ezero)) {
+    f1Val = this->getEnergyFactor(ActEnergyFactorCache::F1, data);
+  }
+  double f2Val = this->getEnergyFactor(ActEnergyFactorCache::F2, data);
+  double atpow = _atpow;
 
   //Highly uncertain p formula from ST'90, p 368
   //if (energy > _E1GeV && energy < _EMaxLimit) {
@@ -244,54 +283,40 @@ double ActSTSpallation::calcSpallSigma(ActNucleiData* data, double& dela) {
   // Implement p 320 pgh 2- spallation production of 7-Be is not suppressed by exp-p*dela
   double psup(p);
   if (iz >= 2 && iz <= 4 && ia >= 6 && ia <= 12 && energy >= 1250.0) {psup = 0.0;}
-  
-  double r = 1.29*_formulae.power(a, 0.15);
-  if (ia >= 40) {r = 11.8*_formulae.power(a, -0.45);}
 
   double sig0 = 144.0*p*f1Val*f2Val*atpow;
-
-  double invpatVal = _formulae.invpat(p, at);
   sig0 *= invpatVal;
 
   if (_debug == 1) {cout<<"sig0 = "<<sig0<<endl;}
 
-  // Calculate M of last-but-one paragraph p 338 for magic number yield curve shift
-  double m = this->calcMValue(_name, izt, iz);
-
-  double aprm = a + m;
+  double dacVal = _dacE0;
+  double expTerm = -psup*dela - _rpow;
   
-  double dacVal = _formulae.dac(at, ezero, ezero);
-
-  double absTerm = std::fabs(((3.0e-7*aprm + t)*aprm - s)*aprm + z);
-  double omega = _formulae.calcOmega(z, a, _name);
-  double rpow = r*_formulae.power(absTerm, nu);
-  double expTerm = -psup*dela - rpow;
-  
-  double omegaEta = omega*_etasel;
+  double omegaEta = _omega*_etasel;
   double prod = _formulae.expfun(expTerm)*omegaEta;
 
   // Correction factors
   // Update from ST'85, p876 Eq 5-11
   double corr(1.0);
   if (izt > 28 && ia <= 56 && dela > dacVal) {
-    corr = _formulae.f22(energy, ezero);
+    corr = this->getEnergyFactor(ActEnergyFactorCache::F22, data);
   }
   if (izt > 21 && dela >= 7.0 && dela <= (dacVal - 13.0)) {
-    corr = _formulae.f33(energy, ezero);
+    corr = this->getEnergyFactor(ActEnergyFactorCache::F33, data);
   }
   if (izt > 90 && ia > 56 && dela >= 7.0) {
-    corr = _formulae.f44(energy, ezero);
+    corr = this->getEnergyFactor(ActEnergyFactorCache::F44, data);
   }
   // Production of Boron from targets with zt >= 21
   if (izt >= 21 && iz == 5) {
-    double corr1 = _formulae.f11(energy, ezero);
-    double corr2 = _formulae.f22(energy, ezero);
+    double corr1 = this->getEnergyFactor(ActEnergyFactorCache::F11, data);
+    double corr2 = this->getEnergyFactor(ActEnergyFactorCache::F22, data);
     double corrProd = corr1*corr2;
     if (corrProd > 0.0) {corr = sqrt(corrProd);}
   }
   //Update from ST'90, p368, Eq 17. Only do for 76<=Zt<=83.
   if (izt >= 76 && izt <= 83 && energy > 200.0 && energy < 1001.0) {
-    double fETerm = _formulae.power(energy*1.0e-3, -(2.0/3.0));
+    double fETerm = this->getEnergyFactor(ActEnergyFactorCache::EGeVPowM23, data);
     double deltaA(dela);
     if (deltaA < 15.0) {deltaA = 15.0;}
     double fdAE = 0.0;
@@ -327,13 +352,67 @@ double ActSTSpallation::calcSpallSigma(ActNucleiData* data, double& dela) {
 
 }
 
+void ActSTSpallation::calcPairTerms(ActNucleiData* data) {
+
+  double at = data->getat();
+  double a  = data->geta();
+  double zt = data->getzt();
+  double atbar = data->getatbar();
+  double z = data->getz();
+  double ezero = data->getezero();
+  int izt = data->getizt();
+  int iz = data->getiz();
+  int ia = data->getia();
+
+  // Now define parameters for the cross-section calculation
+  // Use Table 1D, ST'73 I and updates
+  double sratio(0.0);
+  if (std::fabs(zt) > 1e-30) {sratio = (at - atbar)/zt;}
+  
+  // Using the update from ST'90, pg 368
+  double s = 0.482 - 0.07*sratio;
+  double t = 0.00028;
+  double zstar = ((3.0e-7*a + t)*a - s)*a + z;
+  double nu(0.0);
+  if (zstar < -1.0) {
+    nu = 1.3;
+  } else if (zstar >= -1.0 && zstar <= 1.0) {
+    nu = 1.5;
+  } else {
+    nu = 1.75;
+  }
+
+  _atpow = _formulae.power(at, 0.367);
+
+  // Same as calcPValue for E >= E0
+  _pHigh = 1.97*_formulae.power(at, -0.9);
+  _invpatHigh = _formulae.invpat(_pHigh, at);
+
+  double r = 1.29*_formulae.power(a, 0.15);
+  if (ia >= 40) {r = 11.8*_formulae.power(a, -0.45);}
+
+  // Calculate M of last-but-one paragraph p 338 for magic number yield curve shift
+  double m = this->calcMValue(_name, izt, iz);
+
+  double aprm = a + m;
+  
+  _dacE0 = _formulae.dac(at, ezero, ezero);
+  _dac300 = _formulae.dac(at, 300.0, ezero);
+
+  double absTerm = std::fabs(((3.0e-7*aprm + t)*aprm - s)*aprm + z);
+  _omega = _formulae.calcOmega(z, a, _name);
+  _rpow = r*_formulae.power(absTerm, nu);
+
+  _gotPairTerms = true;
+
+}
+
 double ActSTSpallation::calcPValue(ActNucleiData* data) {
 
   if (data == 0) {return 0.0;}
 
   double p(0.0);
 
-  double zt = data->getzt();
   double at = data->getat();
   double energy = data->gete();
   double ezero = data->getezero();
@@ -345,15 +424,15 @@ double ActSTSpallation::calcPValue(ActNucleiData* data) {
   }
   
   if (energy < ezero) {
-    double cpVal = _formulae.cp(at, zt, energy, ezero);
-    p = 20.0*cpVal*_formulae.power(energy, -0.77);
+    double cpVal = this->getEnergyFactor(ActEnergyFactorCache::Cp, data);
+    p = 20.0*cpVal*this->getEnergyFactor(ActEnergyFactorCache::EPowM077, data);
   }
 
   return p;
 
 }
 
-double ActSTSpallation::calcMValue(std::string name, int izt, int iz) {
+double ActSTSpallation::calcMValue(const std::string& name, int izt, int iz) {
 
   double m(0.0);
   if (name != "fiss") {
@@ -20,12 +20,16 @@
 #include "Activia/ActSTFissBreakup.hh"
 #include "Activia/ActSTFissSpallGamma.hh"
 #include "Activia/ActXSecDataModel.hh"
+#include "Activia/ActRunStatistics.hh"
+#include "Activia/ActTrace.hh"
 
-ActSTXSecAlgorithm::ActSTXSecAlgorithm(const char* listOfDataTables, double minDataXSec) : 
+ActSTXSecAlgorithm::ActSTXSecAlgorithm(const char* listOfDataTables, double minDataXSec,
+				       bool verbose) : 
   ActAbsXSecAlgorithm()
 {
   // Constructor
   _nucleiData = 0;
+  _verbose = verbose;
   _listOfDataTables = std::string(listOfDataTables);
   this->createListOfModels();
   _currentModel = 0;
@@ -40,6 +44,7 @@ ActSTXSecAlgorithm::~ActSTXSecAlgorithm()
   delete _lit2;
   delete _lit3;
   delete _lit4;
+  delete _lit5;
   delete _evap;
   delete _prph;
   delete _spal;
@@ -75,7 +80,7 @@ void ActSTXSecAlgorithm::createListOfModels() {
   _fgsg = new ActSTFissSpallGamma("fgsg", applyUpdates, debug);
   _dataModel = 0;
   if (_listOfDataTables.size() > 0) {
-    _dataModel = new ActXSecDataModel("dataModel", _listOfDataTables, debug);
+    _dataModel = new ActXSecDataModel("dataModel", _listOfDataTables, debug, _verbose);
   }
 
 }
@@ -145,6 +150,8 @@ bool ActSTXSecAlgorithm::passESelection(ActNucleiData* data) {
 
 double ActSTXSecAlgorithm::calcCrossSection() {
 
+  ACT_TRACE_SCOPE("ActSTXSecAlgorithm::calcCrossSection", "xsec");
+
   double sigma(0.0);
 
   if (_nucleiData != 0) {
@@ -168,12 +175,43 @@ double ActSTXSecAlgorithm::calcCrossSection() {
 
     }
 
+    _usedData = gotDataValue;
+
   }
 
   return sigma;
 
 }
 
+void ActSTXSecAlgorithm::calcCrossSections(const std::vector<double>& energies,
+					   std::vector<double>& sigmas, std::vector<int>& passed) {
+
+  double wallStart = ActRunStatistics::wallClock();
+
+  ActAbsXSecAlgorithm::calcCrossSections(energies, sigmas, passed);
+
+  // Count the evaluations (energies passing the selection) for the model
+  unsigned long nEvaluations(0);
+  int nE = (int) passed.size();
+  int iE;
+  for (iE = 0; iE < nE; iE++) {nEvaluations += passed[iE];}
+
+  std::string modelName("None");
+  if (_currentModel != 0) {modelName = _currentModel->getName();}
+
+  ActRunStatistics::getInstance()->addSigmaEvaluations(modelName, nEvaluations,
+						       ActRunStatistics::wallClock() - wallStart);
+
+}
+
+std::string ActSTXSecAlgorithm::getModelName() {
+
+  std::string modelName("None");
+  if (_currentModel != 0) {modelName = _currentModel->getName();}
+  return modelName;
+
+}
+
 void ActSTXSecAlgorithm::selectXSecModel(ActNucleiData* data) {
 
   _currentModel = 0;
@@ -0,0 +1,25 @@
+// Class to define a beam spectrum that is another spectrum multiplied by a constant
+#include "Activia/ActScaledSpectrum.hh"
+
+ActScaledSpectrum::ActScaledSpectrum(const char* name, ActBeamSpectrum* spectrum, double scale) : 
+  ActBeamSpectrum(name, spectrum != 0 ? spectrum->getZ() : 1, spectrum != 0 ? spectrum->getA() : 1.0),
+  _spectrum(spectrum), _scale(scale)
+{
+  // Constructor
+}
+
+ActScaledSpectrum::~ActScaledSpectrum() 
+{
+  // Destructor
+  delete _spectrum;
+}
+
+double ActScaledSpectrum::fluxdE(double e) {
+
+  // Calculate the f(flux)/dE spectrum.
+  // Flux in cm^-2 s^-1, E in MeV.
+  double flux(0.0);
+  if (_spectrum != 0) {flux = _scale*_spectrum->fluxdE(e);}
+  return flux;
+
+}
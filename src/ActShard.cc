@@ -0,0 +1,206 @@
+// Class for splitting one cross-section calculation across several
+// processes and merging their partial results
+
+#include "Activia/ActShard.hh"
+#include "Activia/ActNuclide.hh"
+#include "Activia/ActXSecGraph.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+using std::cout;
+using std::endl;
+
+namespace {
+
+  // Order the results by the number of the product that calculated them
+  bool actResultBefore(const ActCheckpoint::Result& first, const ActCheckpoint::Result& second) {
+    return first.iProduct < second.iProduct;
+  }
+
+}
+
+ActShard::ActShard(const std::string& baseName, int nShards, int iShard) :
+  _baseName(baseName), _runKey(""), _nShards(nShards), _iShard(iShard)
+{
+  // Constructor
+  if (_nShards < 1) {_nShards = 1;}
+  if (_iShard < 0 || _iShard > _nShards) {_iShard = 0;}
+  _iTarget = -1;
+  _results.clear();
+}
+
+ActShard::~ActShard()
+{
+  // Destructor
+}
+
+std::string ActShard::getTag(int iShard, int nShards) {
+
+  std::string tag("_shard");
+  tag += std::to_string(iShard); tag += "of"; tag += std::to_string(nShards);
+  return tag;
+
+}
+
+std::string ActShard::getFileName(int iShard) const {
+
+  std::string fileName(_baseName);
+  fileName += ActShard::getTag(iShard, _nShards); fileName += ".dat";
+  return fileName;
+
+}
+
+void ActShard::setTargetIsotope(int iIsotope) {
+
+  _iTarget = iIsotope;
+  if (_iTarget >= (int) _results.size()) {_results.resize(_iTarget + 1);}
+
+}
+
+int ActShard::getFirstProduct(int nProducts) const {
+
+  if (this->isMerging() == true || _iShard - 1 > nProducts) {return nProducts;}
+  return _iShard - 1;
+
+}
+
+bool ActShard::hasProduct(int iProduct) const {
+
+  if (this->isMerging() == true || iProduct < 0) {return false;}
+  return iProduct%_nShards == _iShard - 1;
+
+}
+
+void ActShard::addResults(ActProdXSecData::ActProdXSecMap& xSecData,
+			  ActProdXSecData::ActProdIndexMap& products) {
+
+  if (this->isMerging() == true || _iTarget < 0) {return;}
+
+  std::vector<ActCheckpoint::Result>& results = _results[_iTarget];
+  results.clear();
+
+  ActProdXSecData::ActProdXSecMap::iterator iter;
+  for (iter = xSecData.begin(); iter != xSecData.end(); ++iter) {
+
+    ActNuclide* isotope = iter->first;
+    if (isotope == 0) {continue;}
+
+    ActCheckpoint::Result result;
+    result.z = isotope->getfZ();
+    result.a = isotope->getA();
+    result.halfLife = isotope->getHalfLife();
+    result.sigma = iter->second.getTotalSigma();
+    result.prodRate = iter->second.getTotalProdRate();
+    ActProdXSecData::ActProdIndexMap::iterator product = products.find(isotope);
+    result.iProduct = (product != products.end()) ? product->second : 0;
+    results.push_back(result);
+
+  }
+
+}
+
+void ActShard::restoreResults(ActProdXSecData::ActProdXSecMap& xSecData,
+			      ActProdXSecData::ActProdIndexMap& products) {
+
+  if (this->isMerging() == false || _iTarget < 0) {return;}
+
+  // An isotope can be stored by several products, e.g. as a product and as the
+  // side branch of another one, when the last one is kept. Adding the results in
+  // the order of the product numbers gives the same map as a single process.
+  std::vector<ActCheckpoint::Result> results(_results[_iTarget]);
+  std::stable_sort(results.begin(), results.end(), actResultBefore);
+  ActCheckpoint::fillXSecData(results, xSecData, products);
+
+}
+
+bool ActShard::write() {
+
+  if (this->isMerging() == true) {return false;}
+
+  // Write to a temporary file first, so that the merge can not use an incomplete file
+  std::string fileName = this->getFileName(_iShard);
+  std::string tmpFileName(fileName); tmpFileName += ".tmp";
+  std::ofstream file(tmpFileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (file.is_open() == false) {
+    cout<<"Error in ActShard::write. Could not open "<<tmpFileName<<endl;
+    return false;
+  }
+
+  file << "ACTIVIA shard2\n";
+  file << "key " << _runKey.size() << "\n" << _runKey << "\n";
+  file << "shard " << _iShard << " " << _nShards << "\n";
+  ActCheckpoint::writeResults(file, _results);
+  file << "end\n";
+  file.close();
+
+  if (file.fail() || std::rename(tmpFileName.c_str(), fileName.c_str()) != 0) {
+    cout<<"Error in ActShard::write. Could not write "<<fileName<<endl;
+    return false;
+  }
+
+  cout<<"Wrote the results of shard "<<_iShard<<" of "<<_nShards<<" to "<<fileName<<endl;
+  return true;
+
+}
+
+bool ActShard::read() {
+
+  if (this->isMerging() == false) {return false;}
+
+  _results.clear();
+
+  int iShard;
+  for (iShard = 1; iShard <= _nShards; iShard++) {
+
+    std::string fileName = this->getFileName(iShard);
+    std::ifstream input(fileName.c_str(), std::ios::in | std::ios::binary);
+    if (input.is_open() == false) {
+      cout<<"Error in ActShard::read. Could not open "<<fileName<<endl;
+      return false;
+    }
+
+    std::string word, version;
+    input >> word >> version;
+    if (word.compare("ACTIVIA") != 0 || version.compare("shard2") != 0) {
+      cout<<"Error in ActShard::read. "<<fileName<<" is not a shard result file"<<endl;
+      return false;
+    }
+
+    size_t nBytes(0);
+    input >> word >> nBytes;
+    input.get();
+    std::string runKey(nBytes, ' ');
+    if (nBytes > 0) {input.read(&runKey[0], nBytes);}
+
+    int fileShard(0), fileNShards(0);
+    input >> word >> fileShard >> fileNShards;
+
+    if (input.fail() || runKey != _runKey || fileShard != iShard || fileNShards != _nShards) {
+      cout<<"Error in ActShard::read. "<<fileName<<" is for a different run"<<endl;
+      return false;
+    }
+
+    std::vector< std::vector<ActCheckpoint::Result> > results;
+    bool gotResults = ActCheckpoint::readResults(input, results);
+    input >> word;
+    if (gotResults == false || input.fail() || word.compare("end") != 0) {
+      cout<<"Error in ActShard::read. Could not read the results in "<<fileName<<endl;
+      return false;
+    }
+
+    // Append the results of each target isotope; they are ordered when restored
+    if (results.size() > _results.size()) {_results.resize(results.size());}
+    size_t it;
+    for (it = 0; it < results.size(); it++) {
+      _results[it].insert(_results[it].end(), results[it].begin(), results[it].end());
+    }
+
+  }
+
+  cout<<"Merging the results of "<<_nShards<<" shards"<<endl;
+  return true;
+
+}
@@ -0,0 +1,326 @@
+// Class for storing the cross-sections of all products at all energies
+// for each target isotope, so that later runs only calculate new pairs
+
+#include "Activia/ActSigmaMatrix.hh"
+#include "Activia/ActBinaryFormat.hh"
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+using std::cout;
+using std::endl;
+
+namespace {
+
+  // Append a column block: its type, codec, size and the encoded values
+  void actPutColumn(std::vector<unsigned char>& bytes, const std::vector<double>& values, int type) {
+
+    std::vector<unsigned char> block;
+    int codec = ActBinaryFormat::encode(values, type, block);
+    ActBinaryFormat::putUInt(bytes, type, 1);
+    ActBinaryFormat::putUInt(bytes, codec, 1);
+    ActBinaryFormat::putUInt(bytes, block.size(), 8);
+    bytes.insert(bytes.end(), block.begin(), block.end());
+
+  }
+
+  // Read a column block of nValues values
+  bool actGetColumn(const std::vector<unsigned char>& bytes, size_t& pos, int nValues,
+		    std::vector<double>& values) {
+
+    unsigned long long type(0), codec(0), nBytes(0);
+    bool ok = ActBinaryFormat::getUInt(bytes, pos, type, 1);
+    ok = ok && ActBinaryFormat::getUInt(bytes, pos, codec, 1);
+    ok = ok && ActBinaryFormat::getUInt(bytes, pos, nBytes, 8);
+    ok = ok && nBytes <= bytes.size() - pos;
+    if (ok == false) {return false;}
+
+    std::vector<unsigned char> block(bytes.begin() + pos, bytes.begin() + pos + nBytes);
+    pos += nBytes;
+
+    return ActBinaryFormat::decode(block, (int) type, (int) codec, nValues, values);
+
+  }
+
+}
+
+ActSigmaMatrix::ActSigmaMatrix(const std::string& fileName, double minSigma, int precision) :
+  _fileName(fileName), _runKey(""), _minSigma(minSigma), _precision(precision)
+{
+  // Constructor
+  _iBlock = -1; _nFound = 0; _nAdded = 0;
+}
+
+ActSigmaMatrix::~ActSigmaMatrix()
+{
+  // Destructor
+}
+
+int ActSigmaMatrix::getNRows() const {
+
+  int nRows(0);
+  int ib;
+  for (ib = 0; ib < (int) _blocks.size(); ib++) {nRows += (int) _blocks[ib].rows.size();}
+  return nRows;
+
+}
+
+bool ActSigmaMatrix::read() {
+
+  std::ifstream file(_fileName.c_str(), std::ios::binary);
+  if (!file.is_open()) {return false;}
+  std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)),
+				   std::istreambuf_iterator<char>());
+
+  if (bytes.size() < 8 || memcmp(&bytes[0], "ACTSIG02", 8) != 0) {
+    cout<<"Error in ActSigmaMatrix::read. "<<_fileName<<" is not a sigma matrix file"<<endl;
+    return false;
+  }
+
+  size_t pos(8);
+  std::string runKey("");
+  bool ok = ActBinaryFormat::getString(bytes, pos, runKey);
+  if (ok == true && runKey != _runKey) {
+    cout<<"The sigma matrix "<<_fileName<<" is for a different calculation; it is replaced"<<endl;
+    return false;
+  }
+
+  unsigned long long nBlocks(0);
+  ok = ok && ActBinaryFormat::getUInt(bytes, pos, nBlocks, 4);
+  ok = ok && nBlocks < 0x7fffffffULL;
+
+  std::vector<Block> blocks;
+  if (ok == true) {blocks.resize(nBlocks);}
+  int ib;
+  for (ib = 0; ok == true && ib < (int) blocks.size(); ib++) {
+    std::vector<double> target;
+    ok = actGetColumn(bytes, pos, 2, target);
+    ok = ok && this->decodeRows(bytes, pos, blocks[ib].rows);
+    if (ok == false) {break;}
+    blocks[ib].z = (int) target[0]; blocks[ib].a = target[1];
+    this->makeIndex(blocks[ib]);
+  }
+
+  if (ok == false || pos != bytes.size()) {
+    cout<<"Error in ActSigmaMatrix::read. Could not read "<<_fileName<<endl;
+    return false;
+  }
+
+  _blocks.swap(blocks);
+  _iBlock = -1; _nFound = 0; _nAdded = 0;
+
+  cout<<"Using the "<<this->getNRows()<<" stored cross-sections in "<<_fileName<<endl;
+
+  return true;
+
+}
+
+bool ActSigmaMatrix::write() {
+
+  std::vector<unsigned char> bytes;
+  ActBinaryFormat::putString(bytes, _runKey);
+  ActBinaryFormat::putUInt(bytes, _blocks.size(), 4);
+  int ib;
+  for (ib = 0; ib < (int) _blocks.size(); ib++) {
+    std::vector<double> target(2);
+    target[0] = _blocks[ib].z; target[1] = _blocks[ib].a;
+    actPutColumn(bytes, target, ActBinaryFormat::findColumnType(target));
+    this->encodeRows(_blocks[ib].rows, bytes);
+  }
+
+  std::ofstream file(_fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (file.is_open() == false) {
+    cout<<"Error in ActSigmaMatrix::write. Could not open "<<_fileName<<endl;
+    return false;
+  }
+
+  file.write("ACTSIG02", 8);
+  file.write((const char*) &bytes[0], bytes.size());
+  file.close();
+
+  if (file.fail()) {
+    cout<<"Error in ActSigmaMatrix::write. Could not write "<<_fileName<<endl;
+    return false;
+  }
+
+  return true;
+
+}
+
+void ActSigmaMatrix::setTargetIsotope(int zTarget, double aTarget) {
+
+  // Find the rows of the target isotope, or start a new block for them
+  int ib;
+  for (ib = 0; ib < (int) _blocks.size(); ib++) {
+    if (_blocks[ib].z == zTarget && _blocks[ib].a == aTarget) {
+      _iBlock = ib;
+      return;
+    }
+  }
+
+  Block block;
+  block.z = zTarget; block.a = aTarget;
+  _blocks.push_back(block);
+  _iBlock = (int) _blocks.size() - 1;
+
+}
+
+bool ActSigmaMatrix::hasRows() const {
+
+  if (_iBlock < 0) {return false;}
+  return _blocks[_iBlock].rows.size() > 0;
+
+}
+
+bool ActSigmaMatrix::findRow(int z, double a, int nE, std::vector<double>& sigmas) {
+
+  if (_iBlock < 0) {return false;}
+
+  const Block& block = _blocks[_iBlock];
+  std::map<std::pair<int, double>, int>::const_iterator iter = block.index.find(std::make_pair(z, a));
+  if (iter == block.index.end()) {return false;}
+
+  const Row& row = block.rows[iter->second];
+  int nValues = (int) row.values.size();
+  if (row.first + nValues > nE) {return false;}
+  _nFound++;
+
+  sigmas.assign(nE, 0.0);
+  int iE;
+  for (iE = 0; iE < nValues; iE++) {sigmas[row.first + iE] = row.values[iE];}
+
+  return true;
+
+}
+
+void ActSigmaMatrix::addRow(int z, double a, bool sideBranch, const std::vector<double>& sigmas) {
+
+  if (_iBlock < 0) {return;}
+
+  // Only keep the range of values that are not below the minimum sigma
+  int nE = (int) sigmas.size();
+  int iFirst(-1), iLast(-1);
+  int iE;
+  for (iE = 0; iE < nE; iE++) {
+    if (sigmas[iE] != 0.0 && std::fabs(sigmas[iE]) >= _minSigma) {
+      if (iFirst < 0) {iFirst = iE;}
+      iLast = iE;
+    }
+  }
+
+  Row row;
+  row.z = z; row.a = a; row.sideBranch = sideBranch;
+  row.first = 0;
+  if (iFirst >= 0) {
+    row.first = iFirst;
+    row.values.resize(iLast - iFirst + 1, 0.0);
+    for (iE = iFirst; iE <= iLast; iE++) {
+      if (std::fabs(sigmas[iE]) < _minSigma) {continue;}
+      if (_precision == ActSigmaMatrix::Double) {
+	row.values[iE - iFirst] = sigmas[iE];
+      } else {
+	row.values[iE - iFirst] = (float) sigmas[iE];
+      }
+    }
+  }
+
+  // Replace any stored row of the same product
+  Block& block = _blocks[_iBlock];
+  std::pair<int, double> key(z, a);
+  std::map<std::pair<int, double>, int>::iterator iter = block.index.find(key);
+  if (iter != block.index.end()) {
+    block.rows[iter->second] = row;
+  } else {
+    block.index[key] = (int) block.rows.size();
+    block.rows.push_back(row);
+  }
+  _nAdded++;
+
+}
+
+void ActSigmaMatrix::makeIndex(Block& block) const {
+
+  block.index.clear();
+  int ir;
+  for (ir = 0; ir < (int) block.rows.size(); ir++) {
+    block.index[std::make_pair(block.rows[ir].z, block.rows[ir].a)] = ir;
+  }
+
+}
+
+void ActSigmaMatrix::encodeRows(const std::vector<Row>& rows, std::vector<unsigned char>& bytes) const {
+
+  int nRows = (int) rows.size();
+  std::vector<double> zValues(nRows), aValues(nRows), sbValues(nRows);
+  std::vector<double> firstValues(nRows), nValues(nRows), sigmas;
+
+  int ir;
+  for (ir = 0; ir < nRows; ir++) {
+    const Row& row = rows[ir];
+    zValues[ir] = row.z; aValues[ir] = row.a;
+    sbValues[ir] = row.sideBranch ? 1.0 : 0.0;
+    firstValues[ir] = row.first;
+    nValues[ir] = row.values.size();
+    sigmas.insert(sigmas.end(), row.values.begin(), row.values.end());
+  }
+
+  ActBinaryFormat::putUInt(bytes, nRows, 4);
+  ActBinaryFormat::putUInt(bytes, sigmas.size(), 8);
+  actPutColumn(bytes, zValues, ActBinaryFormat::Int32);
+  actPutColumn(bytes, aValues, ActBinaryFormat::findColumnType(aValues));
+  actPutColumn(bytes, sbValues, ActBinaryFormat::Int32);
+  actPutColumn(bytes, firstValues, ActBinaryFormat::Int32);
+  actPutColumn(bytes, nValues, ActBinaryFormat::Int32);
+  int sigmaType(ActBinaryFormat::Float32);
+  if (_precision == ActSigmaMatrix::Double) {sigmaType = ActBinaryFormat::Float64;}
+  actPutColumn(bytes, sigmas, sigmaType);
+
+}
+
+bool ActSigmaMatrix::decodeRows(const std::vector<unsigned char>& bytes, size_t& pos,
+				std::vector<Row>& rows) const {
+
+  rows.clear();
+
+  unsigned long long nRows(0), nSigmas(0);
+  bool ok = ActBinaryFormat::getUInt(bytes, pos, nRows, 4);
+  ok = ok && ActBinaryFormat::getUInt(bytes, pos, nSigmas, 8);
+  ok = ok && nRows < 0x7fffffffULL && nSigmas < 0x7fffffffULL;
+  if (ok == false) {return false;}
+
+  std::vector<double> zValues, aValues, sbValues, firstValues, nValues, sigmas;
+  ok = actGetColumn(bytes, pos, (int) nRows, zValues);
+  ok = ok && actGetColumn(bytes, pos, (int) nRows, aValues);
+  ok = ok && actGetColumn(bytes, pos, (int) nRows, sbValues);
+  ok = ok && actGetColumn(bytes, pos, (int) nRows, firstValues);
+  ok = ok && actGetColumn(bytes, pos, (int) nRows, nValues);
+  ok = ok && actGetColumn(bytes, pos, (int) nSigmas, sigmas);
+  if (ok == false) {return false;}
+
+  rows.resize(nRows);
+  size_t iSigma(0);
+  int ir;
+  for (ir = 0; ir < (int) nRows; ir++) {
+
+    Row& row = rows[ir];
+    row.z = (int) zValues[ir]; row.a = aValues[ir];
+    row.sideBranch = (sbValues[ir] != 0.0);
+    row.first = (int) firstValues[ir];
+
+    size_t n = (size_t) nValues[ir];
+    if (nValues[ir] < 0.0 || row.first < 0 || n > sigmas.size() - iSigma) {
+      rows.clear();
+      return false;
+    }
+
+    row.values.assign(sigmas.begin() + iSigma, sigmas.begin() + iSigma + n);
+    iSigma += n;
+
+  }
+
+  return iSigma == sigmas.size();
+
+}
@@ -94,6 +94,8 @@ void ActSimpleDecayAlgorithm::calculateDecays(ActAbsOutput* output) {
   columns[6] = ActString("R_tot");
   columns[7] = ActString("I0");
   ActOutputTable initialData("initialYields", columns);
+  // Write each row as soon as it is available, instead of storing the whole table
+  initialData.streamTo(_outputData);
 
   // Calculation status
   ActAbsCalcStatus* calcStatus = _outputData->getCalcStatus();
@@ -241,9 +243,8 @@ void ActSimpleDecayAlgorithm::calculateDecays(ActAbsOutput* output) {
 
   } // close target isotope loop (nisott)
 
-  // Print initial yields to output file
-  
-  _outputData->outputTable(initialData);
+  // Finish writing the initial yields to the output file
+  initialData.endStream();
 
   // Store the decay rates for the product nuclides in graphs
   for (ip = 0; ip < nisotp; ip++) {
@@ -280,6 +281,7 @@ void ActSimpleDecayAlgorithm::calculateDecays(ActAbsOutput* output) {
   summaryCols[4] = ActString("dndti");
   summaryCols[5] = ActString("dndtf");
   ActOutputTable summaryTable("decaySummary", summaryCols);
+  summaryTable.streamTo(_outputData);
 
   for (ip = 0; ip < nisotp; ip++) {
     
@@ -317,7 +319,7 @@ void ActSimpleDecayAlgorithm::calculateDecays(ActAbsOutput* output) {
     } // prodNuclide exists
   } // Loop over prod nuclides
 
-  _outputData->outputTable(summaryTable);
+  summaryTable.endStream();
 
 }
 
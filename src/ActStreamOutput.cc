@@ -1,9 +1,12 @@
 // Class for output data to an output text file
 
 #include "Activia/ActStreamOutput.hh"
+#include "Activia/ActTrace.hh"
 #include "Activia/ActGraphPoint.hh"
 #include "Activia/ActOutputSelection.hh"
 
+#include <cstdlib>
+#include <filesystem>
 #include <vector>
 
 using std::cout;
@@ -14,21 +17,171 @@ ActStreamOutput::ActStreamOutput(const char* fileName, int levelOfDetail) : ActA
   // Constructor
   _precision = 6;
   _minWidth = 7;
-  _stream.flags(std::ios::left);
-  _stream.precision(_precision);
+  _buffer.clear();
+  _format.setMode(ActNumberFormat::Stream);
+  _format.setPrecision(_precision);
   _type = ActOutputSelection::Stream;
   _typeName = "Stream";
+  _async = true;
+  _bufferSize = 1048576;
+  _maxBlocks = 4;
+  _blocks.clear();
+  _finished = false;
+  _writeFailed = false;
 }
 
 ActStreamOutput::~ActStreamOutput() 
 {
   // Destructor
-
+  // Make sure that all text is written and the writer thread has finished
+  this->closeFile();
 }
 
 void ActStreamOutput::openFile() {
 
   _stream.open(_fileName.c_str());
+  _writeFailed = false;
+  this->startWriter();
+
+}
+
+void ActStreamOutput::startWriter() {
+
+  _finished = false;
+  if (_async == true && _writer.joinable() == false) {
+    _writer = std::thread(&ActStreamOutput::writeBlocks, this);
+  }
+
+}
+
+void ActStreamOutput::stopWriter() {
+
+  if (_writer.joinable() == true) {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _finished = true;
+    }
+    _condition.notify_one();
+    _writer.join();
+  }
+
+}
+
+bool ActStreamOutput::saveState(std::string& state) {
+
+  if (_stream.is_open() == false) {return false;}
+
+  // Write all text so far, then restart the writer thread
+  this->handOff(true);
+  this->stopWriter();
+  _stream.flush();
+
+  std::streamoff offset = _stream.tellp();
+  this->startWriter();
+
+  if (_writeFailed == true || _stream.fail() || offset < 0) {
+    cout<<"Error in ActStreamOutput::saveState. Could not write "<<_fileName<<endl;
+    return false;
+  }
+
+  state = std::to_string((long long) offset);
+  return true;
+
+}
+
+bool ActStreamOutput::resumeFile(const std::string& state) {
+
+  char* end(0);
+  long long offset = strtoll(state.c_str(), &end, 10);
+  if (state.empty() || end == 0 || *end != '\0' || offset < 0) {return false;}
+
+  // Discard anything written after the saved state
+  std::error_code error;
+  if (std::filesystem::file_size(_fileName, error) < (std::uintmax_t) offset || error) {
+    cout<<"Error in ActStreamOutput::resumeFile. "<<_fileName<<" is shorter than the checkpoint"<<endl;
+    return false;
+  }
+  std::filesystem::resize_file(_fileName, offset, error);
+  if (error) {return false;}
+
+  _buffer.clear();
+  _stream.open(_fileName.c_str(), std::ios::out | std::ios::app);
+  if (_stream.is_open() == false) {return false;}
+  _writeFailed = false;
+
+  this->startWriter();
+  return true;
+
+}
+
+void ActStreamOutput::handOff(bool force) {
+
+  if (force == false && _buffer.size() < _bufferSize) {return;}
+
+  std::string block;
+  block.swap(_buffer);
+  // Keep the next buffer large enough to avoid repeated reallocation
+  _buffer.reserve(_bufferSize + _bufferSize/8);
+  if (block.size() == 0) {return;}
+
+  if (_writer.joinable() == true) {
+
+    {
+      // Wait for the writer if the queue is full, so that it can not grow without limit
+      std::unique_lock<std::mutex> lock(_mutex);
+      _spaceCondition.wait(lock, [this] {return _blocks.size() < _maxBlocks;});
+      _blocks.push_back(std::string());
+      _blocks.back().swap(block);
+    }
+    _condition.notify_one();
+
+  } else if (_stream.is_open() == true) {
+
+    this->writeBlock(block);
+
+  }
+
+}
+
+void ActStreamOutput::writeBlock(const std::string& block) {
+
+  // Once writing has failed, the rest of the text is discarded
+  if (_writeFailed == true) {return;}
+
+  _stream.write(block.data(), block.size());
+  if (_stream.fail()) {_writeFailed = true;}
+
+}
+
+void ActStreamOutput::writeBlocks() {
+
+  std::unique_lock<std::mutex> lock(_mutex);
+
+  for (;;) {
+
+    _condition.wait(lock, [this] {return _finished == true || _blocks.empty() == false;});
+
+    while (_blocks.empty() == false) {
+
+      std::string block;
+      block.swap(_blocks.front());
+      _blocks.pop_front();
+      _spaceCondition.notify_one();
+
+      // Don't hold the lock while writing. Only this thread uses the stream
+      // and the failure flag until it is stopped.
+      lock.unlock();
+      {
+	ACT_TRACE_SCOPE("ActStreamOutput::writeBlocks", "output");
+	this->writeBlock(block);
+      }
+      lock.lock();
+
+    }
+
+    if (_finished == true) {break;}
+
+  }
 
 }
 
@@ -38,19 +191,22 @@ void ActStreamOutput::setOptions() {
 
 void ActStreamOutput::outputLineOfText(const char* line) {
   
-  _stream << line << endl;
+  _buffer += line; _buffer += '\n';
+  this->handOff();
 
 }
 
 void ActStreamOutput::outputLineOfText(std::string& line) {
 
-  _stream << line << endl;
+  _buffer += line; _buffer += '\n';
+  this->handOff();
 
 }
 
 void ActStreamOutput::outputLineOfText(ActString& line) {
   
-  _stream << line.getData() << endl;
+  _buffer += line.getData(); _buffer += '\n';
+  this->handOff();
 
 }
 
@@ -62,82 +218,127 @@ void ActStreamOutput::outputLineOfText(std::vector<ActString>& strings) {
   for (i = 0; i < nStrings; i++) {
     ActString s = strings[i];
     int nS = s.size() + 1;
-    _stream.width(nS); _stream << s.getData();
+    ActNumberFormat::append(_buffer, s.getData(), nS);
   }
 
-  _stream << endl;
+  _buffer += '\n';
+  this->handOff();
 
 }
 
 void ActStreamOutput::outputTable(ActOutputTable& table) {
 
+  ACT_TRACE_SCOPE("ActStreamOutput::outputTable", "output");
+
+  this->beginTable(table);
+
+  int nRows = table.getNRows();
+  int iRow;
+  for (iRow = 0; iRow < nRows; iRow++) {
+    this->outputTableRow(table, table.getRowData(iRow));
+  }
+
+  this->endTable(table);
+  
+}
+
+void ActStreamOutput::beginTable(ActOutputTable& table) {
+
   int nColumns = table.getNColumns();
   std::vector<ActString> columnNames = table.getColumnNames();
-  std::vector<int> colWidths(nColumns);
+  _colWidths.assign(nColumns, 0);
   int iCol;
 
   int minWidth = table.getColumnSpacing();
 
-  _stream.precision(_precision);
+  _format.setPrecision(_precision);
 
-  // Print out column names first, then the data row by row
+  // Print out column names first; the rows then follow one by one
   for (iCol = 0; iCol < nColumns; iCol++) {
 
     ActString column = columnNames[iCol];
     int width = column.size() + 1;
     if (width < minWidth) {width = minWidth;}
 
-    colWidths[iCol] = width;
+    _colWidths[iCol] = width;
 
-    std::string name = column.getString();
-    _stream.width(width); _stream << name;
+    ActNumberFormat::append(_buffer, column.getData(), width);
 
   }
 
-  _stream << endl;
+  _buffer += '\n';
 
-  std::vector< std::vector <double> > rows = table.getRows();
-  int nRows = (int) rows.size();
-  int iRow;
-  for (iRow = 0; iRow < nRows; iRow++) {
+}
 
-    std::vector<double> row = rows[iRow];
+void ActStreamOutput::outputTableRow(ActOutputTable& table, const double* values) {
 
-    int nCol = (int) row.size();
-    if (nCol != nColumns) {
-      cout << "Error in outputTable. Row " << iRow << " has " << nCol 
-	   << " columns which should be " << nColumns << endl;
-      continue;
-    }
+  if (values == 0) {return;}
 
-    for (iCol = 0; iCol < nColumns; iCol++) {
+  int nColumns = table.getNColumns();
+  if (nColumns != (int) _colWidths.size()) {
+    cout << "Error in ActStreamOutput::outputTableRow. Row has " << nColumns
+	 << " columns which should be " << _colWidths.size() << endl;
+    return;
+  }
 
-      int width = colWidths[iCol];
-      double value = row[iCol];
-      _stream.width(width); _stream << value;
+  int iCol;
+  for (iCol = 0; iCol < nColumns; iCol++) {
+    _format.append(_buffer, values[iCol], _colWidths[iCol]);
+  }
 
-    }
+  _buffer += '\n';
 
-    _stream << endl;
+  // Pass the rows on if the buffer is full
+  this->handOff();
+
+}
+
+void ActStreamOutput::endTable(ActOutputTable&) {
+
+  _colWidths.clear();
+
+  // The table is complete; pass it on if the buffer is full
+  this->handOff();
 
-  } // Loop over rows
-  
 }
 
 void ActStreamOutput::outputGraph(ActNucleiData& data,
 				  ActAbsGraph& graph) {
 
+  ACT_TRACE_SCOPE("ActStreamOutput::outputGraph", "output");
+
   double zt = data.getzt();
   double at = data.getat();
   double z = data.getz();
   double a = data.geta();
 
+  // For sparse graphs, first describe the full x grid, giving the lengths
+  // of the runs of bins that are alternately omitted and written out
+  if (graph.hasGrid() == true) {
+
+    _format.setPrecision(_precision);
+    _buffer += "Grid for "; _buffer += graph.getXAxisName();
+    _buffer += ": start = "; _format.append(_buffer, graph.getGridStart());
+    _buffer += ", step = "; _format.append(_buffer, graph.getGridStep());
+    _buffer += ", omitted/stored bin runs =";
+
+    std::vector<int> runs = graph.getGridRuns();
+    int nRuns = (int) runs.size();
+    int iR;
+    for (iR = 0; iR < nRuns; iR++) {
+      _buffer += ' '; _format.append(_buffer, runs[iR]);
+    }
+
+    _buffer += '\n';
+
+  }
+
   // Print out the (Z,A) columns of the target and product nuclei
   int zWidth = 7;
-  _stream.width(zWidth); _stream << "Z(tgt)";
-  _stream.width(zWidth); _stream << "A(tgt)";
-  _stream.width(zWidth); _stream << "Z(pro)";
-  _stream.width(zWidth); _stream << "A(pro)";
+  ActNumberFormat::append(_buffer, "Z(tgt)", zWidth);
+  ActNumberFormat::append(_buffer, "A(tgt)", zWidth);
+  ActNumberFormat::append(_buffer, "Z(pro)", zWidth);
+  ActNumberFormat::append(_buffer, "A(pro)", zWidth);
 
   // Retrieve names of the x and y axes
   std::string xAxis = graph.getXAxisName();
@@ -146,7 +347,7 @@ void ActStreamOutput::outputGraph(ActNucleiData& data,
   ActString xString(xAxis); xString += " (";
   xString += xUnits; xString += ")";
   int xWidth = xString.size() + 1;
-  _stream.width(xWidth); _stream << xString.getData();
+  ActNumberFormat::append(_buffer, xString.getData(), xWidth);
 
   int nYAxes = graph.getnYAxes();
   std::vector<std::string> yAxesNames = graph.getYAxesNames();
@@ -165,17 +366,18 @@ void ActStreamOutput::outputGraph(ActNucleiData& data,
     yString += yUnits; yString += ")";
     int ySize = yString.size() + 1;
     yWidths[iY] = ySize;
-    _stream.width(ySize); _stream << yString.getData();
+    ActNumberFormat::append(_buffer, yString.getData(), ySize);
 
   }
 
-  _stream << endl;
+  _buffer += '\n';
 
   // Write out the (Z,A) values for the target and product nuclei
-  _stream.width(zWidth); _stream << zt;
-  _stream.width(zWidth); _stream << at;
-  _stream.width(zWidth); _stream << z;
-  _stream.width(zWidth); _stream << a;
+  _format.setPrecision(_precision);
+  _format.append(_buffer, zt, zWidth);
+  _format.append(_buffer, at, zWidth);
+  _format.append(_buffer, z, zWidth);
+  _format.append(_buffer, a, zWidth);
 
   // Get the vector of points for this graph
   std::vector<ActGraphPoint> points = graph.getPoints();
@@ -186,15 +388,13 @@ void ActStreamOutput::outputGraph(ActNucleiData& data,
   // Loop over all points
   for (iX = 0; iX < nPoints; iX++) {
 
-    if (iX != 0) {_stream.width(emptyWidth); _stream << "";}
+    if (iX != 0) {_buffer.append(emptyWidth, ' ');}
 
     // Write out the x point value
     ActGraphPoint point = points[iX];
     double xVar = point.getX();
 
-    _stream.width(xWidth); 
-    _stream.precision(_precision);
-    _stream << xVar;
+    _format.append(_buffer, xVar, xWidth);
 
     // Retrieve and loop over all y values
     std::vector<double> yValues = point.getYValues();
@@ -203,28 +403,41 @@ void ActStreamOutput::outputGraph(ActNucleiData& data,
     for (iY = 0; iY < nYValues; iY++) {
 
       double yValue = yValues[iY];
-      _stream.width(yWidths[iY]);
-      _stream.precision(_precision);
-      _stream << yValue;
+      _format.append(_buffer, yValue, yWidths[iY]);
 
       yTotals[iY] += yValue;
 
     }
 
-    _stream << endl;
+    _buffer += '\n';
 
   }
 
-  _stream.width(emptyWidth+xWidth); _stream << "Totals:";
+  ActNumberFormat::append(_buffer, "Totals:", emptyWidth+xWidth);
   for (iY = 0; iY < nYAxes; iY++) {
-    _stream.width(yWidths[iY]); 
-    _stream << yTotals[iY];
+    _format.append(_buffer, yTotals[iY], yWidths[iY]);
   }
 
-  _stream << endl;
+  _buffer += '\n';
+
+  // The graph is complete; pass it on if the buffer is full
+  this->handOff();
 
 }
 
 void ActStreamOutput::closeFile() {
-  _stream.close();
+
+  ACT_TRACE_SCOPE("ActStreamOutput::closeFile", "output");
+
+  // Write any remaining text and stop the writer thread
+  this->handOff(true);
+  this->stopWriter();
+
+  if (_stream.is_open() == true) {
+    _stream.close();
+    if (_writeFailed == true || _stream.fail()) {
+      cout<<"Error in ActStreamOutput::closeFile. Could not write "<<_fileName<<endl;
+    }
+  }
+
 }
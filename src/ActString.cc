@@ -3,6 +3,7 @@
 // words and numbers
 
 #include "Activia/ActString.hh"
+#include "Activia/ActNumberFormat.hh"
 
 #include <iostream>
 #include <ctype.h>
@@ -11,6 +12,9 @@
 using std::cout;
 using std::endl;
 
+// Number conversion buffer shared by all strings of the same thread
+static thread_local ActNumberFormat actStringFormat;
+
 ActString::ActString() : _theString("")
 {
   // Constructor
@@ -33,17 +37,14 @@ ActString::~ActString()
 
 void ActString::addInteger(int integer) {
 
-  std::ostringstream o;
-  o << integer;
-  _theString += o.str();
+  actStringFormat.append(_theString, integer);
 
 }
 
 void ActString::addDouble(double value) {
 
-  std::ostringstream o;
-  o << value;
-  _theString += o.str();
+  // Same text as the default iostream output with 6 significant figures
+  actStringFormat.append(_theString, value);
 
 }
 
@@ -15,6 +15,11 @@
 #include "Activia/ActProdNuclideList.hh"
 #include "Activia/ActProdNuclide.hh"
 #include "Activia/ActXSecGraph.hh"
+#include "Activia/ActRunStatistics.hh"
+#include "Activia/ActCheckpoint.hh"
+#include "Activia/ActShard.hh"
+#include "Activia/ActSigmaMatrix.hh"
+#include "Activia/ActEnsemble.hh"
 
 #include <iostream>
 #include <cmath>
@@ -33,6 +38,8 @@ ActTarget::ActTarget(int Z)
   _xSections.clear();
 
   _output = 0; _inputBeam = 0;
+  _otherSpectra.clear(); _spectra.clear();
+  _verbose = true;
 
 }
 
@@ -60,8 +67,10 @@ void ActTarget::addIsotope(double A, double fraction, double halfLife) {
   ActTargetNuclide* isotope = new ActTargetNuclide(_Z, A, halfLife, fraction);
   _isotopes.push_back(isotope);
 
-  cout<<"Added isotope "<<A<<" with halfLife = "<<halfLife<<" and abundance fraction "
-      <<fraction<<" to element "<<_Z<<endl;
+  if (_verbose) {
+    cout<<"Added isotope "<<A<<" with halfLife = "<<halfLife<<" and abundance fraction "
+	<<fraction<<" to element "<<_Z<<endl;
+  }
   // Update number of isotopes
   _nIsotopes = (int) _isotopes.size();
 
@@ -96,11 +105,24 @@ void ActTarget::calcXSections(ActProdNuclideList* prodList, ActBeamSpectrum* inp
   this->clearProdXSecData();
 
   _inputBeam = inputBeam;
+  _spectra.assign(1, inputBeam);
+  _spectra.insert(_spectra.end(), _otherSpectra.begin(), _otherSpectra.end());
 
   // Write info to output file (if it exists)
+  // A run resumed from a checkpoint has already written the first lines
   ActAbsCalcStatus* calcStatus = 0;
+  ActCheckpoint* checkpoint = 0;
+  ActShard* shard = 0;
+  ActSigmaMatrix* sigmaMatrix = 0;
+  ActEnsemble* ensemble = 0;
   if (_output != 0) {
-    _output->outputLineOfText("Cross-sections for target-product nuclide pairs");
+    checkpoint = _output->getCheckpoint();
+    shard = _output->getShard();
+    sigmaMatrix = _output->getSigmaMatrix();
+    ensemble = _output->getEnsemble();
+    if (checkpoint == 0 || checkpoint->isResuming() == false) {
+      _output->outputLineOfText("Cross-sections for target-product nuclide pairs");
+    }
     calcStatus = _output->getCalcStatus();
     if (calcStatus != 0) {calcStatus->setNTargetIsotopes(_nIsotopes);}
   }
@@ -118,10 +140,30 @@ void ActTarget::calcXSections(ActProdNuclideList* prodList, ActBeamSpectrum* inp
 
     if (targetIsotope != 0) {
 
+      if (checkpoint != 0) {checkpoint->setTargetIsotope(it);}
+      if (shard != 0) {shard->setTargetIsotope(it);}
+      if (sigmaMatrix != 0) {
+	sigmaMatrix->setTargetIsotope(targetIsotope->getZ(), targetIsotope->getA());
+      }
+      if (ensemble != 0) {ensemble->setTargetIsotope(it);}
+
       ActProdXSecData* xSecData = new ActProdXSecData(targetIsotope, prodList, 
 						      inputBeam, algorithm, _output);
+      xSecData->setOtherSpectra(_otherSpectra);
       xSecData->calculate();
 
+      // Keep the results of this shard for the partial result file
+      if (shard != 0 && shard->isMerging() == false) {
+	ActProdXSecData::ActProdXSecMap xSecMap = xSecData->getXSecData();
+	ActProdXSecData::ActProdIndexMap products = xSecData->getXSecProducts();
+	shard->addResults(xSecMap, products);
+      }
+
+      // Save a checkpoint, unless the calculation has been stopped
+      if (checkpoint != 0 && (calcStatus == 0 || calcStatus->canRunCode() == true)) {
+	checkpoint->endTargetIsotope(_output);
+      }
+
       _xSections.push_back(xSecData);
       
     } else {
@@ -131,11 +173,34 @@ void ActTarget::calcXSections(ActProdNuclideList* prodList, ActBeamSpectrum* inp
   } // Loop over target isotopes
 
   // Now print out the cross-section data for all product nuclei
-  // knowing the relative weights of the target isotopes
+  // knowing the relative weights of the target isotopes. This has already
+  // been written if the run is resumed after the cross-sections were complete,
+  // and a shard only has some of the products, so it is written by the merge.
+  if (checkpoint != 0 && checkpoint->isXSecDone() == true) {return;}
+  if (shard != 0 && shard->isMerging() == false) {return;}
+  ActRunStatistics::getInstance()->startPhase("output");
   this->outputXSecSummary(prodList);
+  ActRunStatistics::getInstance()->stopPhase("output");
   
 }
 
+void ActTarget::useSpectrum(int iSpectrum) {
+
+  if (iSpectrum < 0 || iSpectrum >= (int) _spectra.size()) {
+    cout<<"Error in ActTarget::useSpectrum. Spectrum "<<iSpectrum
+	<<" is out of range [0,"<<(int) _spectra.size()-1<<"]"<<endl;
+    return;
+  }
+
+  _inputBeam = _spectra[iSpectrum];
+
+  int it;
+  for (it = 0; it < (int) _xSections.size(); it++) {
+    if (_xSections[it] != 0) {_xSections[it]->useSpectrum(iSpectrum);}
+  }
+
+}
+
 void ActTarget::outputXSecSummary(ActProdNuclideList* prodList) {
   
   // Output a summary table of the cross-sections of all of the products
@@ -160,12 +225,28 @@ void ActTarget::outputXSecSummary(ActProdNuclideList* prodList) {
     }
   }
   
+  if (_inputBeam != 0) {
+    ActString beamWords("Input beam is ");
+    beamWords += _inputBeam->getName().c_str();
+    _output->outputLineOfText(beamWords);
+
+    beamWords = ActString("E(start) = ");
+    beamWords += _inputBeam->getEStart();
+    beamWords += " MeV, delta(E) = ";
+    beamWords += _inputBeam->getdE();
+    beamWords += " MeV, n(E) = ";
+    beamWords += _inputBeam->getnE();
+    _output->outputLineOfText(beamWords);
+  }
+
   std::vector<ActString> columns(4);
   columns[0] = ActString("ProdZ");
   columns[1] = ActString("ProdA");
   columns[2] = ActString("TotSigma");
   columns[3] = ActString("TotProdRate");
   ActOutputTable xSecSummary("xSecSummary", columns);
+  // Write each row as soon as it is available, instead of storing the whole table
+  xSecSummary.streamTo(_output);
 
   int nProducts = prodList->getNProdNuclides();
   int ip;
@@ -210,21 +291,8 @@ void ActTarget::outputXSecSummary(ActProdNuclideList* prodList) {
 
   } // Loop over all product nuclei
   
-  if (_inputBeam != 0) {
-    ActString beamWords("Input beam is ");
-    beamWords += _inputBeam->getName().c_str();
-    _output->outputLineOfText(beamWords);
-
-    beamWords = ActString("E(start) = ");
-    beamWords += _inputBeam->getEStart();
-    beamWords += " MeV, delta(E) = ";
-    beamWords += _inputBeam->getdE();
-    beamWords += " MeV, n(E) = ";
-    beamWords += _inputBeam->getnE();
-    _output->outputLineOfText(beamWords);
-  }
-
-  _output->outputTable(xSecSummary);
+  // Finish writing the table
+  xSecSummary.endStream();
 
 }
 
@@ -0,0 +1,163 @@
+// Class for recording the timing of scoped code regions in per-thread
+// ring buffers, written out in the Chrome trace event format
+
+#include "Activia/ActTrace.hh"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+using std::cout;
+using std::endl;
+
+// The buffer of each thread, owned by the trace object
+static thread_local ActTrace::Buffer* actTraceBuffer = 0;
+
+ActTrace::ActTrace() : _bufferSize(262144)
+{
+  // Constructor
+  _origin = 0;
+  _origin = this->now();
+  _buffers.clear();
+}
+
+ActTrace::~ActTrace()
+{
+  // Destructor
+  int nBuffers = (int) _buffers.size();
+  int i;
+  for (i = 0; i < nBuffers; i++) {delete _buffers[i];}
+  _buffers.clear();
+}
+
+ActTrace* ActTrace::getInstance() {
+
+  // The local static is only initialised once, even if several
+  // threads ask for the trace at the same time
+  static ActTrace* theTrace = new ActTrace();
+  return theTrace;
+
+}
+
+long long ActTrace::now() const {
+
+  std::chrono::nanoseconds time = std::chrono::duration_cast<std::chrono::nanoseconds>
+    (std::chrono::steady_clock::now().time_since_epoch());
+  return time.count() - _origin;
+
+}
+
+const char* ActTrace::intern(const std::string& name) {
+
+  // Set nodes never move, so the string data stays valid
+  static std::set<std::string> names;
+  static std::mutex namesMutex;
+
+  std::lock_guard<std::mutex> lock(namesMutex);
+  return names.insert(name).first->c_str();
+
+}
+
+ActTrace::Buffer* ActTrace::getBuffer() {
+
+  if (actTraceBuffer != 0) {return actTraceBuffer;}
+
+  Buffer* buffer = new Buffer();
+  buffer->events.resize(_bufferSize > 0 ? _bufferSize : 1);
+  buffer->next = 0;
+  buffer->wrapped = false;
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  buffer->threadId = (int) _buffers.size() + 1;
+  _buffers.push_back(buffer);
+
+  actTraceBuffer = buffer;
+  return buffer;
+
+}
+
+void ActTrace::addEvent(const char* name, const char* category, long long start, long long duration) {
+
+  // Only the thread that owns the buffer writes to it, so no lock is needed
+  Buffer* buffer = this->getBuffer();
+
+  Event& event = buffer->events[buffer->next];
+  event.name = name;
+  event.category = category;
+  event.start = start;
+  event.duration = duration;
+
+  buffer->next += 1;
+  if (buffer->next == buffer->events.size()) {
+    buffer->next = 0;
+    buffer->wrapped = true;
+  }
+
+}
+
+void ActTrace::clear() {
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  int nBuffers = (int) _buffers.size();
+  int i;
+  for (i = 0; i < nBuffers; i++) {
+    _buffers[i]->next = 0;
+    _buffers[i]->wrapped = false;
+  }
+
+}
+
+bool ActTrace::writeChromeTrace(const std::string& fileName) {
+
+  std::ofstream stream(fileName.c_str());
+  if (stream.is_open() == false) {
+    cout<<"Error in ActTrace::writeChromeTrace. Could not open "<<fileName<<endl;
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  // Complete ("X") events, with times in microseconds
+  stream << std::fixed << std::setprecision(3);
+  stream << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+
+  bool first(true);
+  unsigned long nEvents(0);
+  int nBuffers = (int) _buffers.size();
+  int iB;
+
+  for (iB = 0; iB < nBuffers; iB++) {
+
+    Buffer* buffer = _buffers[iB];
+    size_t nStored = buffer->wrapped ? buffer->events.size() : buffer->next;
+    size_t begin = buffer->wrapped ? buffer->next : 0;
+    size_t i;
+
+    for (i = 0; i < nStored; i++) {
+
+      const Event& event = buffer->events[(begin + i) % buffer->events.size()];
+
+      if (first == false) {stream << ",";}
+      first = false;
+
+      stream << "\n{\"name\": \"" << (event.name ? event.name : "")
+	     << "\", \"cat\": \"" << (event.category ? event.category : "")
+	     << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer->threadId
+	     << ", \"ts\": " << event.start*1e-3
+	     << ", \"dur\": " << event.duration*1e-3 << "}";
+
+      nEvents++;
+
+    }
+
+  }
+
+  stream << "\n]}\n";
+  stream.close();
+
+  cout<<"Written "<<nEvents<<" trace events to "<<fileName<<endl;
+
+  return true;
+
+}
@@ -2,6 +2,7 @@
 // Ref.: A.Yu. Konobeyev and Yu.A. Korovin, NIM B82 (1993) 103-115
 
 #include "Activia/ActTritiumModel.hh"
+#include "Activia/ActTrace.hh"
 #include "Activia/ActFormulae.hh"
 #include "Activia/ActNucleiData.hh"
 
@@ -22,6 +23,8 @@ ActTritiumModel::~ActTritiumModel()
 }
 
 double ActTritiumModel::calcCrossSection(ActNucleiData* data) {
+
+  ACT_TRACE_SCOPE(_traceName, "model");
   
   if (data == 0) {
     cout<<"Error in ActTritiumModel. Data object is null"<<endl;
@@ -8,6 +8,7 @@
 #include "Activia/ActProdNuclideList.hh"
 #include "Activia/ActString.hh"
 #include "Activia/ActNuclideFactory.hh"
+#include "Activia/ActTrace.hh"
 
 #include <cmath>
 #include <cstdlib>
@@ -18,10 +19,12 @@
 using std::cout;
 using std::endl;
 
-ActXSecDataModel::ActXSecDataModel(std::string name, std::string inputList, int debug) : ActAbsXSecModel(name, debug)
+ActXSecDataModel::ActXSecDataModel(std::string name, std::string inputList, int debug,
+				   bool verbose) : ActAbsXSecModel(name, debug)
 {
   // Constructor
   _inputList = inputList;
+  _verbose = verbose;
   _listOfDataFiles.clear();
   _dataTables.clear();
 
@@ -48,7 +51,7 @@ void ActXSecDataModel::initialise() {
   // Product Z A
   // E (MeV)  sigma (mb)
 
-  cout<<"Within ActXSecDataModel::initialise; inputList = "<<_inputList<<endl;
+  if (_verbose) {cout<<"Within ActXSecDataModel::initialise; inputList = "<<_inputList<<endl;}
   std::ifstream getData(_inputList.c_str());
 
   // Check if the file exists
@@ -71,7 +74,7 @@ void ActXSecDataModel::initialise() {
     
   }
 
-  cout<<"There are "<<_listOfDataFiles.size()<<" data files loaded"<<endl;
+  if (_verbose) {cout<<"There are "<<_listOfDataFiles.size()<<" data files loaded"<<endl;}
 
 }
 
@@ -232,7 +235,7 @@ void ActXSecDataModel::storeXSecGraphs(std::string fileName,
 }
 
 
-ActXSecGraph ActXSecDataModel::getXSecGraph(ActNucleiData* data) {
+ActXSecGraph& ActXSecDataModel::getXSecGraph(ActNucleiData* data) {
 
   // Get the target and product isotopes, then get the graph from the map
   if (data != 0) {
@@ -280,7 +283,7 @@ ActXSecGraph ActXSecDataModel::getXSecGraph(ActNucleiData* data) {
 
 	// Get the product nuclide and the <product, graph> map
 	ActNuclide* prodNuclide = data->getProduct();
-	ActDataModelMap dataMap = iter->second;
+	ActDataModelMap& dataMap = iter->second;
 
 	// Loop over the map to get the graph for the given product
 	ActDataModelMap::iterator mapIter = dataMap.find(prodNuclide);
@@ -323,6 +326,8 @@ ActXSecGraph ActXSecDataModel::getXSecGraph(ActNucleiData* data) {
 
 double ActXSecDataModel::calcCrossSection(ActNucleiData* data) {
 
+  ACT_TRACE_SCOPE("ActXSecDataModel::calcCrossSection", "data");
+
   // If the target isotope already exists, just retrieve the stored data.
   // Find out if the energy range is valid, and perform a linear
   // interpolation to get the cross-section
@@ -330,7 +335,8 @@ double ActXSecDataModel::calcCrossSection(ActNucleiData* data) {
   _sigma = 0.0;
   if (data == 0) {return _sigma;}
 
-  ActXSecGraph xSecGraph = this->getXSecGraph(data);
+  // Use the stored graph, without copying its points for every energy
+  ActXSecGraph& xSecGraph = this->getXSecGraph(data);
 
   double energy = data->gete();
   _sigma = xSecGraph.calcSigma(energy);
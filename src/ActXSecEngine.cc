@@ -0,0 +1,393 @@
+// Class for calculating the cross-sections and production rates of
+// a few products, keeping the models and data tables between calculations
+
+#include "Activia/ActXSecEngine.hh"
+#include "Activia/ActBeamSpectrum.hh"
+#include "Activia/ActConstants.hh"
+#include "Activia/ActEnergyFactorCache.hh"
+#include "Activia/ActNucleiData.hh"
+#include "Activia/ActNuclideFactory.hh"
+#include "Activia/ActNumberFormat.hh"
+#include "Activia/ActProdNuclide.hh"
+#include "Activia/ActProdNuclideList.hh"
+#include "Activia/ActSTXSecAlgorithm.hh"
+#include "Activia/ActTarget.hh"
+#include "Activia/ActTargetNuclide.hh"
+
+#include <algorithm>
+
+ActXSecEngine::ActXSecEngine(ActProdNuclideList* prodList, const char* listOfDataTables,
+			     double minDataXSec, bool verbose) :
+  _prodList(prodList), _algorithm(0), _verbose(verbose)
+{
+  // Constructor
+  std::string dataTables(listOfDataTables);
+  if (dataTables.size() == 0 || dataTables.compare("0") == 0) {
+    _algorithm = new ActSTXSecAlgorithm("", 0.0, verbose);
+  } else {
+    _algorithm = new ActSTXSecAlgorithm(dataTables.c_str(), minDataXSec, verbose);
+  }
+  _targets.clear();
+  _products.clear();
+}
+
+ActXSecEngine::~ActXSecEngine()
+{
+  // Destructor
+  std::map<std::string, ActTarget*>::iterator iter;
+  for (iter = _targets.begin(); iter != _targets.end(); ++iter) {
+    delete iter->second;
+  }
+  _targets.clear();
+
+  std::map<std::pair<int, double>, ActProdNuclide*>::iterator pIter;
+  for (pIter = _products.begin(); pIter != _products.end(); ++pIter) {
+    delete pIter->second;
+  }
+  _products.clear();
+
+  delete _algorithm;
+}
+
+ActTarget* ActXSecEngine::getTarget(int Z, const std::vector<double>& massNumbers,
+				    const std::vector<double>& fractions) {
+
+  // The Silberberg-Tsao formulae need Z > 5
+  int nIsotopes = (int) massNumbers.size();
+  if (Z < 6 || nIsotopes < 1 || nIsotopes != (int) fractions.size()) {return 0;}
+
+  // Describe the target using the exact values
+  ActNumberFormat format(ActNumberFormat::Shortest);
+  std::string key("");
+  format.append(key, Z);
+  int i;
+  for (i = 0; i < nIsotopes; i++) {
+    key += ' '; format.append(key, massNumbers[i]);
+    key += ':'; format.append(key, fractions[i]);
+  }
+
+  std::map<std::string, ActTarget*>::iterator iter = _targets.find(key);
+  if (iter != _targets.end()) {return iter->second;}
+
+  ActTarget* target = new ActTarget(Z);
+  target->setVerbose(_verbose);
+  for (i = 0; i < nIsotopes; i++) {
+    target->addIsotope(massNumbers[i], fractions[i]);
+  }
+  _targets[key] = target;
+
+  return target;
+
+}
+
+ActProdNuclide* ActXSecEngine::getProduct(int z, double a) {
+
+  // Use the decay data (with any side branches) if the product is in the list
+  ActProdNuclide* product(0);
+  if (_prodList != 0) {product = _prodList->getProdNuclide(z, a);}
+  if (product != 0) {return product;}
+
+  std::pair<int, double> key(z, a);
+  std::map<std::pair<int, double>, ActProdNuclide*>::iterator iter = _products.find(key);
+  if (iter != _products.end()) {return iter->second;}
+
+  product = new ActProdNuclide(z, a, 0.0);
+  _products[key] = product;
+  return product;
+
+}
+
+bool ActXSecEngine::calcBranchSigmas(ActNucleiData* data, ActProdNuclide* product, int iSB,
+				     const std::vector<double>& energies,
+				     std::vector<double>& sigmas, std::vector<int>& passed) {
+
+  // The same selections as in ActProdXSecData::calculate: the side branches
+  // (iSB < nSideBranches) come first, then the product itself
+  int nSideBranches = product->getNSideBranches();
+
+  if (iSB < nSideBranches) {
+
+    ActNuclide* sbNuclide = product->getSideBranch(iSB);
+    if (sbNuclide == 0) {return false;}
+    data->setProductData(sbNuclide);
+    if (_algorithm->passSelection(data) == false) {return false;}
+
+  } else {
+
+    data->setProductData(product);
+
+  }
+
+  data->setOtherQuantities();
+  _algorithm->setNucleiData(data);
+  _algorithm->calcCrossSections(energies, sigmas, passed);
+
+  return true;
+
+}
+
+bool ActXSecEngine::calcProduction(ActTarget* target, ActBeamSpectrum* spectrum,
+				   std::vector<Product>& products) {
+
+  if (spectrum == 0) {return false;}
+
+  std::vector<ActBeamSpectrum*> spectra(1, spectrum);
+  std::vector<std::vector<Product> > results(1);
+  results[0].swap(products);
+  bool ok = this->calcProduction(target, spectra, results);
+  products.swap(results[0]);
+
+  return ok;
+
+}
+
+bool ActXSecEngine::calcProduction(ActTarget* target, const std::vector<ActBeamSpectrum*>& spectra,
+				   std::vector<std::vector<Product> >& products) {
+
+  int nSpectra = (int) spectra.size();
+  if (target == 0 || nSpectra < 1 || products.size() < 1 || _prodList == 0) {return false;}
+
+  // All spectra must have the same energies
+  int iS;
+  for (iS = 0; iS < nSpectra; iS++) {
+    if (spectra[iS] == 0) {return false;}
+    if (spectra[iS]->getnE() != spectra[0]->getnE() ||
+	spectra[iS]->getEStart() != spectra[0]->getEStart() ||
+	spectra[iS]->getdE() != spectra[0]->getdE()) {return false;}
+  }
+
+  int nE = spectra[0]->getnE();
+  if (nE < 1) {return false;}
+
+  double EStart = spectra[0]->getEStart();
+  double dE = spectra[0]->getdE();
+  int nE1 = nE - 1;
+
+  // The energies and fluxes are the same for all target isotopes and products
+  std::vector<double> energies(nE);
+  std::vector<std::vector<double> > fluxes(nSpectra, std::vector<double>(nE, 0.0));
+  int iE;
+  for (iE = 0; iE < nE; iE++) {
+    energies[iE] = iE*dE + EStart;
+    for (iS = 0; iS < nSpectra; iS++) {fluxes[iS][iE] = spectra[iS]->fluxdE(energies[iE]);}
+  }
+
+  int nProducts = (int) products[0].size();
+  std::vector<ActProdNuclide*> prodNuclides(nProducts);
+  int ip;
+  for (ip = 0; ip < nProducts; ip++) {
+    Product& product = products[0][ip];
+    product.sigma = 0.0; product.prodRate = 0.0;
+    prodNuclides[ip] = this->getProduct(product.z, product.a);
+    product.halfLife = prodNuclides[ip]->getHalfLife();
+  }
+  products.resize(nSpectra, products[0]);
+  for (iS = 1; iS < nSpectra; iS++) {products[iS] = products[0];}
+
+  std::vector<double> sigmas(nE, 0.0);
+  std::vector<int> passed(nE, 0);
+  std::vector<double> totalProdRates(nSpectra, 0.0);
+
+  int nIsotopes = target->getNIsotopes();
+  int it;
+  for (it = 0; it < nIsotopes; it++) {
+
+    ActTargetNuclide* isotope = target->getIsotope(it);
+    if (isotope == 0) {continue;}
+
+    // Isotopes without any abundance do not add anything
+    if (target->getFraction(it) <= 0.0) {continue;}
+
+    // Load the data tables using the list of all products, so that they do
+    // not depend on which products are calculated first. They are only read once.
+    _algorithm->loadDataTables(isotope, _prodList);
+
+    ActNucleiData data;
+    data.setBeamData(spectra[0]->getNuclide());
+    data.setTargetData(isotope);
+
+    double factor(0.0);
+    double atgt = data.getat();
+    if (atgt > 1e-30) {factor = ActConstants::pps/atgt;}
+    double fraction = data.getFraction();
+
+    ActEnergyFactorCache eFactorCache;
+    eFactorCache.build(&data, energies);
+
+    for (ip = 0; ip < nProducts; ip++) {
+
+      ActProdNuclide* prodNuclide = prodNuclides[ip];
+      data.setProductData(prodNuclide);
+      if (_algorithm->passSelection(&data) == false) {continue;}
+
+      // Sum the cross-sections and production rates in the same order as
+      // ActProdXSecData, so that the totals are the same as for a complete run
+      double totalProdSigma(0.0);
+      totalProdRates.assign(nSpectra, 0.0);
+
+      int nSideBranches = prodNuclide->getNSideBranches();
+      int iSB;
+      for (iSB = 0; iSB < nSideBranches+1; iSB++) {
+
+	if (this->calcBranchSigmas(&data, prodNuclide, iSB, energies, sigmas, passed) == false) {
+	  continue;
+	}
+
+	for (iE = 0; iE < nE; iE++) {
+
+	  if (passed[iE] == 0) {continue;}
+
+	  double pfac(1.0);
+	  if (iE == 0 || iE == nE1) {pfac = 0.5;}
+
+	  double sigma = sigmas[iE];
+	  totalProdSigma += sigma;
+	  for (iS = 0; iS < nSpectra; iS++) {
+	    totalProdRates[iS] += pfac*sigma*factor*fraction*fluxes[iS][iE]*dE;
+	  }
+
+	}
+
+      }
+
+      // Sum over the target isotopes as for the xSecSummary table
+      for (iS = 0; iS < nSpectra; iS++) {
+	products[iS][ip].sigma += totalProdSigma*target->getFraction(it);
+	products[iS][ip].prodRate += totalProdRates[iS];
+      }
+
+    }
+
+  }
+
+  return true;
+
+}
+
+bool ActXSecEngine::calcCrossSections(ActTarget* target, const std::vector<int>& z,
+				      const std::vector<double>& a,
+				      const std::vector<double>& energies,
+				      std::vector<double>& sigmas) {
+
+  int n = (int) energies.size();
+  sigmas.assign(n, 0.0);
+
+  if (target == 0 || (int) z.size() != n || (int) a.size() != n) {return false;}
+  if (n == 0) {return true;}
+
+  // Group the entries by product, so that each product is selected once
+  // and its energies are calculated together
+  std::map<std::pair<int, double>, std::vector<int> > productEntries;
+  int i;
+  for (i = 0; i < n; i++) {productEntries[std::make_pair(z[i], a[i])].push_back(i);}
+
+  std::vector<double> productEnergies, productSigmas;
+
+  std::map<std::pair<int, double>, std::vector<int> >::iterator iter;
+  for (iter = productEntries.begin(); iter != productEntries.end(); ++iter) {
+
+    const std::vector<int>& entries = iter->second;
+    int nEntries = (int) entries.size();
+    productEnergies.resize(nEntries);
+    for (i = 0; i < nEntries; i++) {productEnergies[i] = energies[entries[i]];}
+
+    this->calcProductSigmas(target, this->getProduct(iter->first.first, iter->first.second),
+			    productEnergies, productSigmas);
+
+    for (i = 0; i < nEntries; i++) {sigmas[entries[i]] = productSigmas[i];}
+
+  }
+
+  return true;
+
+}
+
+bool ActXSecEngine::calcSigmaVsEnergy(ActTarget* target, int z, double a,
+				      const std::vector<double>& energies,
+				      std::vector<double>& sigmas) {
+
+  sigmas.assign(energies.size(), 0.0);
+  if (target == 0) {return false;}
+
+  this->calcProductSigmas(target, this->getProduct(z, a), energies, sigmas);
+  return true;
+
+}
+
+void ActXSecEngine::calcProductSigmas(ActTarget* target, ActProdNuclide* prodNuclide,
+				      const std::vector<double>& energies,
+				      std::vector<double>& sigmas) {
+
+  int n = (int) energies.size();
+  sigmas.assign(n, 0.0);
+
+  // Skip the energies that are not positive (or not numbers),
+  // for which the cross-section is zero
+  std::vector<int> valid;
+  valid.reserve(n);
+  int i;
+  for (i = 0; i < n; i++) {
+    if (energies[i] > 0.0) {valid.push_back(i);}
+  }
+
+  int nValid = (int) valid.size();
+  if (nValid == 0) {return;}
+
+  // The beam is a proton, as for the cosmic ray and Gordon spectra
+  ActNuclide* beamNuclide = ActNuclideFactory::getInstance()->getNuclide(1, 1.0, 0.0);
+
+  int nSideBranches = prodNuclide->getNSideBranches();
+  std::vector<double> batch, productSigmas, branchSigmas;
+  std::vector<int> passed;
+
+  int nIsotopes = target->getNIsotopes();
+  int it;
+  for (it = 0; it < nIsotopes; it++) {
+
+    ActTargetNuclide* isotope = target->getIsotope(it);
+    if (isotope == 0) {continue;}
+
+    _algorithm->loadDataTables(isotope, _prodList);
+
+    ActNucleiData data;
+    data.setBeamData(beamNuclide);
+    data.setTargetData(isotope);
+
+    data.setProductData(prodNuclide);
+    if (_algorithm->passSelection(&data) == false) {continue;}
+
+    double fraction = target->getFraction(it);
+
+    // Calculate the energies in batches, in their given order, so that the table
+    // of energy factors (shared by the side branches) and the cross-sections stay
+    // in the cache. Sorting them does not help, since the energies from transport
+    // codes are rarely repeated.
+    ActEnergyFactorCache eFactorCache;
+    int start;
+    for (start = 0; start < nValid; start += ActXSecEngine::BatchSize) {
+
+      int nBatch = std::min(ActXSecEngine::BatchSize, nValid - start);
+      batch.resize(nBatch);
+      for (i = 0; i < nBatch; i++) {batch[i] = energies[valid[start + i]];}
+      eFactorCache.buildList(&data, batch);
+
+      // Sum the product and its side branches
+      productSigmas.assign(nBatch, 0.0);
+      int iSB;
+      for (iSB = 0; iSB < nSideBranches+1; iSB++) {
+	if (this->calcBranchSigmas(&data, prodNuclide, iSB, batch,
+				   branchSigmas, passed) == false) {continue;}
+	for (i = 0; i < nBatch; i++) {
+	  if (passed[i] == 1) {productSigmas[i] += branchSigmas[i];}
+	}
+      }
+
+      for (i = 0; i < nBatch; i++) {
+	sigmas[valid[start + i]] += productSigmas[i]*fraction;
+      }
+
+    }
+
+  }
+
+}
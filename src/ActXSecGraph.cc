@@ -89,11 +89,23 @@ double ActXSecGraph::calcSigma(double energy) {
   double E1(0.0), E2(0.0), sigma1(0.0), sigma2(0.0);
   
   int nPoints = (int) _points.size();
-  int iE;
 
-  for (iE = 0; iE < nPoints; iE++) {
+  // Skip the points that are well below the energy using a binary search.
+  // The loop would only have stored each of them as the lower bin, so
+  // start it after storing the last one.
+  double lowE = energy - 2e-6;
+  int iE = (int) (std::partition_point(_points.begin(), _points.end(),
+				       [lowE](ActGraphPoint& point) {return point.getX() <= lowE;})
+		  - _points.begin());
+  if (iE > 0) {
+    ActGraphPoint& below = _points[iE-1];
+    E1 = below.getX(); sigma1 = below.getY();
+    E2 = E1; sigma2 = sigma1;
+  }
+
+  for (; iE < nPoints; iE++) {
     
-    ActGraphPoint point = _points[iE];
+    ActGraphPoint& point = _points[iE];
 
     double EVal = point.getX();
     double SVal = point.getY();
@@ -0,0 +1,647 @@
+// Regression and performance harness for the validation run files.
+//
+// Each job runs the answers of runFiles/run<job>.sh in-process, writing the
+// cross-section and decay yield summaries in the binary format. The values of
+// the xSecSummary and decaySummary tables are compared with the golden files
+// golden/<job>.txt, and the run time and peak memory of each job are written
+// to a JSON report. Run from the workdir/validation directory ("make validate").
+//
+// Usage: validateRuns [-u] [-r relTol] [-a absTol] [-o report] [-k] [job ...]
+//  -u         write (update) the golden files instead of comparing with them
+//  -r relTol  relative tolerance of the comparison (default 1e-6)
+//  -a absTol  absolute tolerance of the comparison (default 1e-12)
+//  -o report  JSON report file (default output/validation.json)
+//  -k         keep the binary output files of the jobs
+// Without any job names, all run files listed in runComparisons.sh are used,
+// followed by the checks of the SIMD kernels and of the shards (see
+// ActSIMDMath::checkAccuracy and checkShards).
+
+#include "Activia/ActAbsRun.hh"
+#include "Activia/ActInput.hh"
+#include "Activia/ActBinaryReader.hh"
+#include "Activia/ActRunStatistics.hh"
+#include "Activia/ActNumberFormat.hh"
+#include "Activia/ActShard.hh"
+#include "Activia/ActSIMDMath.hh"
+#include "Activia/ActString.hh"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using std::cout;
+using std::endl;
+
+// Stream buffer that discards the (very verbose) output of the runs
+class NullBuffer : public std::streambuf {
+ protected:
+  virtual int overflow(int c) {return c;}
+};
+
+// Run the code using the answers of a run file
+class ValidationRun : public ActAbsRun {
+
+ public:
+
+  ValidationRun(const std::string& answers) : ActAbsRun(), _answers(answers) {;}
+
+  virtual void defineInput() {
+    ActInput* input = new ActInput(_outputSelection);
+    input->setInputStream(_answers);
+    _input = input;
+  }
+
+ private:
+
+  std::istringstream _answers;
+
+};
+
+// Summary table values, stored as values[row][column]
+struct SummaryTable {
+  std::string name;
+  std::vector<std::string> columns;
+  std::vector< std::vector<double> > values;
+};
+
+// The summary tables that are compared
+const char* summaryNames[2] = {"xSecSummary", "decaySummary"};
+
+// Get the job names from the run files used in runComparisons.sh
+std::vector<std::string> readJobNames(const std::string& fileName) {
+
+  std::vector<std::string> jobs;
+  std::ifstream script(fileName.c_str());
+  std::string word;
+
+  while (script >> word) {
+    size_t start = word.find("runFiles/run");
+    size_t end = word.rfind(".sh");
+    if (start == std::string::npos || end == std::string::npos) {continue;}
+    start += 12;
+    if (end <= start) {continue;}
+    jobs.push_back(word.substr(start, end - start));
+  }
+
+  return jobs;
+
+}
+
+// Read the answers of the run file, i.e. the lines of its "<< quit" here-document.
+// The output file lines are replaced by binary summary output with the given names.
+bool readAnswers(const std::string& job, const std::string& xSecFile,
+		 const std::string& yieldFile, std::string& answers) {
+
+  std::string fileName("runFiles/run"); fileName += job; fileName += ".sh";
+  std::ifstream runFile(fileName.c_str());
+  if (runFile.is_open() == false) {
+    cout<<"Error in validateRuns. Could not open "<<fileName<<endl;
+    return false;
+  }
+
+  std::vector<std::string> lines;
+  std::string line;
+  bool inHereDoc(false);
+
+  while (std::getline(runFile, line)) {
+    if (inHereDoc == false) {
+      if (line.find("<< quit") != std::string::npos) {inHereDoc = true;}
+    } else if (line.compare("quit") == 0) {
+      break;
+    } else {
+      lines.push_back(line);
+    }
+  }
+
+  // The last two answers are the output file names, formats and levels of detail
+  int nLines = (int) lines.size();
+  if (nLines < 2) {
+    cout<<"Error in validateRuns. Could not find the answers in "<<fileName<<endl;
+    return false;
+  }
+
+  lines[nLines - 2] = xSecFile + " 2 0";
+  lines[nLines - 1] = yieldFile + " 2 0";
+
+  answers = "";
+  int i;
+  for (i = 0; i < nLines; i++) {answers += lines[i]; answers += "\n";}
+
+  return true;
+
+}
+
+// Read the summary tables from the binary output files
+bool readSummaries(const std::string& xSecFile, const std::string& yieldFile,
+		   std::vector<SummaryTable>& tables) {
+
+  tables.clear();
+  std::string fileNames[2] = {xSecFile, yieldFile};
+
+  int iT;
+  for (iT = 0; iT < 2; iT++) {
+
+    ActBinaryReader reader(fileNames[iT].c_str());
+    if (reader.isOpen() == false) {
+      cout<<"Error in validateRuns. Could not read "<<fileNames[iT]<<endl;
+      return false;
+    }
+
+    SummaryTable table;
+    table.name = summaryNames[iT];
+    table.columns = reader.getColumnNames(table.name);
+
+    std::vector< std::vector<double> > columnValues;
+    if (table.columns.size() > 0 &&
+	reader.readColumns(table.name, table.columns, columnValues) == false) {
+      cout<<"Error in validateRuns. Could not read the "<<table.name
+	  <<" table from "<<fileNames[iT]<<endl;
+      return false;
+    }
+
+    int nColumns = (int) table.columns.size();
+    int nRows = nColumns > 0 ? (int) columnValues[0].size() : 0;
+    table.values.resize(nRows);
+
+    int iR, iC;
+    for (iR = 0; iR < nRows; iR++) {
+      table.values[iR].resize(nColumns);
+      for (iC = 0; iC < nColumns; iC++) {table.values[iR][iC] = columnValues[iC][iR];}
+    }
+
+    tables.push_back(table);
+
+  }
+
+  return true;
+
+}
+
+// Write the summary tables to the golden file. The values use the shortest
+// representation that can be read back exactly.
+bool writeGolden(const std::string& fileName, const std::string& job,
+		 std::vector<SummaryTable>& tables) {
+
+  std::ofstream golden(fileName.c_str());
+  if (golden.is_open() == false) {
+    cout<<"Error in validateRuns. Could not write "<<fileName<<endl;
+    return false;
+  }
+
+  ActNumberFormat format(ActNumberFormat::Shortest);
+  golden << "# Golden summary values for the validation job " << job << "\n";
+
+  int nTables = (int) tables.size();
+  int iT;
+  for (iT = 0; iT < nTables; iT++) {
+
+    SummaryTable& table = tables[iT];
+    int nColumns = (int) table.columns.size();
+    int nRows = (int) table.values.size();
+
+    golden << "table " << table.name << " " << nColumns << " " << nRows << "\n";
+
+    int iR, iC;
+    for (iC = 0; iC < nColumns; iC++) {golden << (iC > 0 ? " " : "") << table.columns[iC];}
+    golden << "\n";
+
+    for (iR = 0; iR < nRows; iR++) {
+      std::string text("");
+      for (iC = 0; iC < nColumns; iC++) {
+	if (iC > 0) {text += " ";}
+	format.append(text, table.values[iR][iC]);
+      }
+      golden << text << "\n";
+    }
+
+  }
+
+  golden.close();
+  return true;
+
+}
+
+// Read the summary tables from the golden file
+bool readGolden(const std::string& fileName, std::vector<SummaryTable>& tables) {
+
+  tables.clear();
+  std::ifstream golden(fileName.c_str());
+  if (golden.is_open() == false) {
+    cout<<"Error in validateRuns. Could not open the golden file "<<fileName<<endl;
+    return false;
+  }
+
+  std::string line;
+  while (std::getline(golden, line)) {
+
+    if (line.size() == 0 || line[0] == '#') {continue;}
+
+    std::istringstream header(line);
+    std::string word;
+    SummaryTable table;
+    int nColumns(0), nRows(0);
+    header >> word >> table.name >> nColumns >> nRows;
+    if (word.compare("table") != 0 || header.fail()) {
+      cout<<"Error in validateRuns. Unexpected line \""<<line<<"\" in "<<fileName<<endl;
+      return false;
+    }
+
+    int iR, iC;
+    table.columns.resize(nColumns);
+    for (iC = 0; iC < nColumns; iC++) {golden >> table.columns[iC];}
+
+    table.values.resize(nRows);
+    for (iR = 0; iR < nRows; iR++) {
+      table.values[iR].resize(nColumns);
+      for (iC = 0; iC < nColumns; iC++) {
+	golden >> word;
+	table.values[iR][iC] = strtod(word.c_str(), 0);
+      }
+    }
+
+    if (golden.fail()) {
+      cout<<"Error in validateRuns. Could not read the "<<table.name<<" table from "<<fileName<<endl;
+      return false;
+    }
+
+    // Finish the last line of the table
+    std::getline(golden, line);
+    tables.push_back(table);
+
+  }
+
+  return true;
+
+}
+
+// Compare the tables with the golden ones. Returns the number of values outside
+// the tolerances, or -1 if the tables have different shapes.
+int compareTables(std::vector<SummaryTable>& tables, std::vector<SummaryTable>& goldenTables,
+		  double relTol, double absTol, double& maxRelDiff, std::string& message) {
+
+  maxRelDiff = 0.0;
+  message = "";
+
+  int nTables = (int) tables.size();
+  if (nTables != (int) goldenTables.size()) {
+    message = "different number of tables";
+    return -1;
+  }
+
+  int nFailed(0);
+  int iT, iR, iC;
+
+  for (iT = 0; iT < nTables; iT++) {
+
+    SummaryTable& table = tables[iT];
+    SummaryTable& golden = goldenTables[iT];
+
+    if (table.name != golden.name || table.columns != golden.columns) {
+      message = "different columns for the " + golden.name + " table";
+      return -1;
+    }
+
+    int nRows = (int) table.values.size();
+    if (nRows != (int) golden.values.size()) {
+      message = "different number of rows for the " + golden.name + " table";
+      return -1;
+    }
+
+    int nColumns = (int) table.columns.size();
+    for (iR = 0; iR < nRows; iR++) {
+      for (iC = 0; iC < nColumns; iC++) {
+
+	double value = table.values[iR][iC];
+	double goldenValue = golden.values[iR][iC];
+	double diff = std::fabs(value - goldenValue);
+
+	bool sameSpecial = (std::isnan(value) && std::isnan(goldenValue)) || value == goldenValue;
+	if (sameSpecial == true) {continue;}
+
+	if (std::fabs(goldenValue) > 0.0 && std::isfinite(diff)) {
+	  double relDiff = diff/std::fabs(goldenValue);
+	  if (relDiff > maxRelDiff) {maxRelDiff = relDiff;}
+	}
+
+	if (std::isfinite(diff) == false || diff > absTol + relTol*std::fabs(goldenValue)) {
+
+	  if (nFailed == 0) {
+	    std::ostringstream first;
+	    first.precision(17);
+	    first << golden.name << " row " << iR << " " << golden.columns[iC]
+		  << " = " << value << ", golden = " << goldenValue;
+	    message = first.str();
+	  }
+	  nFailed++;
+
+	}
+
+      }
+    }
+
+  }
+
+  return nFailed;
+
+}
+
+// A check of the code, which returns false (with a message) if it fails
+typedef bool (*CheckFunction)(std::string& message);
+
+// Check that the shards calculate every product exactly once, and that merging
+// them gives the same summaries as a single run, for all products of natural copper
+bool checkShards(std::string& message) {
+
+  const int nShards(3);
+  std::string baseName("output/validate_Shards");
+  int nProducts, iShard, ip;
+  for (nProducts = 0; nProducts <= 300; nProducts++) {
+
+    std::vector<int> counts(nProducts, 0);
+    for (iShard = 1; iShard <= nShards; iShard++) {
+      ActShard shard(baseName, nShards, iShard);
+      for (ip = shard.getFirstProduct(nProducts); ip < nProducts; ip++) {
+	if (shard.hasProduct(ip) == true) {counts[ip]++;}
+      }
+    }
+
+    ActShard merge(baseName, nShards, 0);
+    for (ip = 0; ip < nProducts; ip++) {
+      if (counts[ip] != 1 || merge.hasProduct(ip) == true) {
+	message = "product " + std::to_string(ip) + " of " + std::to_string(nProducts) +
+	  " is calculated by " + std::to_string(counts[ip]) + " shards";
+	return false;
+      }
+    }
+
+  }
+
+  std::string xSecFile(baseName + "_xSec.bin"), yieldFile(baseName + "_Yields.bin");
+  std::string answers("29\n2\n63 0.6917\n65 0.3083\na\ndecayData.dat\n100.0 10000.0 100.0\n0\n90.0 180.0\n");
+  answers += xSecFile + " 2 0\n" + yieldFile + " 2 0\n";
+
+  std::vector<SummaryTable> tables, mergedTables;
+  bool ok(true);
+
+  // The single run, then the shards and their merge (iShard = 0)
+  for (iShard = -1; ok == true && iShard <= nShards; iShard++) {
+    if (iShard == 0) {continue;}
+    ValidationRun run(answers);
+    if (iShard > 0) {run.setShard(iShard, nShards);}
+    run.run();
+    if (iShard < 0) {ok = readSummaries(xSecFile, yieldFile, tables);}
+  }
+  if (ok == true) {
+    ValidationRun run(answers);
+    run.setShard(0, nShards);
+    run.run();
+    ok = readSummaries(xSecFile, yieldFile, mergedTables);
+  }
+
+  remove(xSecFile.c_str()); remove(yieldFile.c_str());
+  for (iShard = 1; iShard <= nShards; iShard++) {
+    std::string tag = ActShard::getTag(iShard, nShards);
+    remove((baseName + "_xSec" + tag + ".dat").c_str());
+    remove((baseName + "_xSec" + tag + ".bin").c_str());
+  }
+
+  if (ok == false) {
+    message = "could not read the output files";
+    return false;
+  }
+
+  // The merged values must be exactly the same
+  double maxRelDiff(0.0);
+  int nFailed = compareTables(mergedTables, tables, 0.0, 0.0, maxRelDiff, message);
+  if (nFailed == 0 && tables[0].values.size() < 10) {
+    message = "too few products in the xSecSummary table";
+    return false;
+  }
+
+  return nFailed == 0;
+
+}
+
+// Reset the peak resident memory of the process. Returns false if this is not
+// supported, in which case the peak is the maximum over all previous jobs.
+bool resetPeakMemory() {
+
+  std::ofstream clearRefs("/proc/self/clear_refs");
+  if (clearRefs.is_open() == false) {return false;}
+  clearRefs << "5";
+  clearRefs.close();
+  return clearRefs.fail() == false;
+
+}
+
+// Get the peak resident memory of the process (kB)
+long getPeakMemory() {
+
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.compare(0, 6, "VmHWM:") == 0) {return atol(line.c_str() + 6);}
+  }
+  return 0;
+
+}
+
+// Escape a string for the JSON report
+std::string jsonString(const std::string& text) {
+
+  std::string result("\"");
+  int n = (int) text.size();
+  int i;
+  for (i = 0; i < n; i++) {
+    char c = text[i];
+    if (c == '"' || c == '\\') {result += '\\';}
+    result += c;
+  }
+  result += "\"";
+  return result;
+
+}
+
+int main(int argc, char** argv) {
+
+  bool update(false), keepFiles(false);
+  double relTol(1e-6), absTol(1e-12);
+  std::string reportFile("output/validation.json");
+  std::vector<std::string> jobs;
+
+  int iArg;
+  for (iArg = 1; iArg < argc; iArg++) {
+    std::string arg(argv[iArg]);
+    if (arg.compare("-u") == 0) {
+      update = true;
+    } else if (arg.compare("-k") == 0) {
+      keepFiles = true;
+    } else if (arg.compare("-r") == 0 && iArg + 1 < argc) {
+      relTol = atof(argv[++iArg]);
+    } else if (arg.compare("-a") == 0 && iArg + 1 < argc) {
+      absTol = atof(argv[++iArg]);
+    } else if (arg.compare("-o") == 0 && iArg + 1 < argc) {
+      reportFile = argv[++iArg];
+    } else if (arg.size() > 0 && arg[0] == '-') {
+      cout<<"Usage: validateRuns [-u] [-r relTol] [-a absTol] [-o report] [-k] [job ...]"<<endl;
+      return 1;
+    } else {
+      jobs.push_back(arg);
+    }
+  }
+
+  // The checks are only done when all jobs are run
+  bool allJobs = (jobs.size() == 0 && update == false);
+  if (jobs.size() == 0) {jobs = readJobNames("runComparisons.sh");}
+  if (jobs.size() == 0) {
+    cout<<"Error in validateRuns. No validation jobs found. Run from workdir/validation."<<endl;
+    return 1;
+  }
+
+  std::ofstream report(reportFile.c_str());
+  if (report.is_open() == false) {
+    cout<<"Error in validateRuns. Could not open "<<reportFile<<endl;
+    return 1;
+  }
+
+  ActNumberFormat format(ActNumberFormat::Shortest);
+  ActRunStatistics* statistics = ActRunStatistics::getInstance();
+  NullBuffer nullBuffer;
+
+  int nJobs = (int) jobs.size();
+  int nFailedJobs(0);
+  double totalTime(0.0);
+
+  report << "{\n  \"relTolerance\": " << format.toString(relTol)
+	 << ",\n  \"absTolerance\": " << format.toString(absTol)
+	 << ",\n  \"jobs\": [";
+
+  int iJ;
+  for (iJ = 0; iJ < nJobs; iJ++) {
+
+    std::string job = jobs[iJ];
+    std::string xSecFile("output/validate_"); xSecFile += job; xSecFile += "_xSec.bin";
+    std::string yieldFile("output/validate_"); yieldFile += job; yieldFile += "_Yields.bin";
+    std::string goldenFile("golden/"); goldenFile += job; goldenFile += ".txt";
+
+    std::string status("passed"), message("");
+    double maxRelDiff(0.0), wallTime(0.0), cpuTime(0.0);
+    int nFailed(0);
+    bool memoryReset(false);
+    long peakMemory(0);
+
+    std::string answers;
+    if (readAnswers(job, xSecFile, yieldFile, answers) == false) {
+
+      status = "error"; message = "could not read the run file";
+
+    } else {
+
+      memoryReset = resetPeakMemory();
+
+      // Hide the output of the run
+      std::streambuf* coutBuffer = cout.rdbuf(&nullBuffer);
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+      ValidationRun run(answers);
+      run.run();
+
+      wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      cout.rdbuf(coutBuffer);
+
+      cpuTime = statistics->getCPUTime("total");
+      peakMemory = getPeakMemory();
+      totalTime += wallTime;
+
+      std::vector<SummaryTable> tables, goldenTables;
+
+      if (readSummaries(xSecFile, yieldFile, tables) == false) {
+	status = "error"; message = "could not read the output files";
+      } else if (update == true) {
+	status = writeGolden(goldenFile, job, tables) ? "updated" : "error";
+      } else if (readGolden(goldenFile, goldenTables) == false) {
+	status = "error"; message = "could not read the golden file";
+      } else {
+	nFailed = compareTables(tables, goldenTables, relTol, absTol, maxRelDiff, message);
+	if (nFailed != 0) {status = "failed";}
+      }
+
+      if (keepFiles == false) {
+	remove(xSecFile.c_str());
+	remove(yieldFile.c_str());
+      }
+
+    }
+
+    if (status.compare("failed") == 0 || status.compare("error") == 0) {nFailedJobs++;}
+
+    cout<<"Job "<<job<<": "<<status<<", time = "<<wallTime<<" s, peak memory = "
+	<<peakMemory<<" kB";
+    if (nFailed > 0) {cout<<", "<<nFailed<<" values outside tolerances";}
+    if (message.size() > 0) {cout<<" ("<<message<<")";}
+    cout<<endl;
+
+    if (iJ > 0) {report << ",";}
+    report << "\n    {\"job\": " << jsonString(job)
+	   << ", \"status\": " << jsonString(status)
+	   << ", \"wallTime\": " << format.toString(wallTime)
+	   << ", \"cpuTime\": " << format.toString(cpuTime)
+	   << ", \"peakMemoryKB\": " << peakMemory
+	   << ", \"peakMemoryPerJob\": " << (memoryReset ? "true" : "false")
+	   << ", \"failedValues\": " << nFailed
+	   << ", \"maxRelDiff\": " << format.toString(maxRelDiff)
+	   << ", \"message\": " << jsonString(message) << "}";
+
+  }
+
+  report << "\n  ],\n  \"checks\": [";
+
+  // Checks of the code that are not covered by the jobs
+  const int nChecks(2);
+  const char* checkNames[nChecks] = {"SIMDMath", "Shards"};
+  CheckFunction checkFunctions[nChecks] = {ActSIMDMath::checkAccuracy, checkShards};
+
+  int iC;
+  for (iC = 0; allJobs == true && iC < nChecks; iC++) {
+
+    std::string message("");
+    std::streambuf* coutBuffer = cout.rdbuf(&nullBuffer);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    bool passed = checkFunctions[iC](message);
+
+    double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    cout.rdbuf(coutBuffer);
+    totalTime += wallTime;
+    if (passed == false) {nFailedJobs++;}
+    nJobs++;
+
+    cout<<"Check "<<checkNames[iC]<<": "<<(passed ? "passed" : "failed")<<", time = "<<wallTime<<" s";
+    if (message.size() > 0) {cout<<" ("<<message<<")";}
+    cout<<endl;
+
+    if (iC > 0) {report << ",";}
+    report << "\n    {\"check\": " << jsonString(checkNames[iC])
+	   << ", \"status\": " << jsonString(passed ? "passed" : "failed")
+	   << ", \"wallTime\": " << format.toString(wallTime)
+	   << ", \"message\": " << jsonString(message) << "}";
+
+  }
+
+  report << "\n  ],\n  \"failedJobs\": " << nFailedJobs
+	 << ",\n  \"totalWallTime\": " << format.toString(totalTime) << "\n}\n";
+  report.close();
+
+  cout<<nJobs - nFailedJobs<<" of "<<nJobs<<" jobs and checks "<<(update ? "updated" : "passed")
+      <<" in "<<totalTime<<" s. Report written to "<<reportFile<<endl;
+
+  return nFailedJobs > 0 ? 1 : 0;
+
+}